@@ -33,7 +33,7 @@ typedef enum {
 } flash_mem_Stat;
 /*Low level statuses*/
 
-uint32_t FlashAddresscntr;/** The flash address counter which will always point to next empty address*/
+extern uint32_t FlashAddresscntr;/** The flash address counter which will always point to next empty address*/
 
 /**
  * @brief This function erases a page of the flash memory.
@@ -52,11 +52,13 @@ flash_mem_Stat WritePage(uint32_t *ptrToEditedData, uint32_t *AddressOfPage,
 		size_t NumberOfBytes);
 
 /**
- * @brief This function will erase the Flash between the addresses given by MICROCDB_START_ADDR and MICROCDB_END_ADDR if
+ * @brief This function will erase the Flash between the given addresses(normally MICROCDB_START_ADDR and MICROCDB_END_ADDR) if
  * not erased before and writes 0xDB to end address to indicate the flash is initialized for microcDB.
+ * @param StartAddress : The start address of the region of DB
+ * @param EndAddress : The end address of the region of DB
  * @returns the #flash_mem_Stat #ERASE_SUCCESS or #ERASE_FAILED
  * */
-flash_mem_Stat EraseDB();
+flash_mem_Stat EraseDB(uint32_t StartAddress, uint32_t EndAddress);
 
 /**
  * @brief This function will write the data bytes to Flash memory. It accepts arguments:
@@ -67,4 +69,15 @@ flash_mem_Stat EraseDB();
 flash_mem_Stat WriteToFLASH(uint8_t data1, uint8_t data2, uint8_t data3,
 		uint8_t data4);
 
+/**
+ * @brief This function will write the given number of bytes to Flash memory at the given address using half word access. Unlike
+ * WriteToFLASH() it does not use or change the FlashAddresscntr.
+ * @param *data : The bytes to be written
+ * @param Address : The flash address where the first byte will be written. It should be half word aligned
+ * @param NumberOfBytes : The number of bytes to be written. If odd then the last half word is padded with FL_EMPTY_BYTE
+ * @returns the #flash_mem_Stat #FL_STORE_SUCCESS or #FL_STORE_FAILED
+ * */
+flash_mem_Stat WriteBytesToFLASH(uint8_t *data, uint32_t Address,
+		size_t NumberOfBytes);
+
 #endif /* FLASH_DRIVERS_H_ */
@@ -13,6 +13,7 @@
 #define MICROCDB_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "microcDB_config.h"
 #include "flash_drivers.h"
 
@@ -56,7 +57,38 @@ typedef enum {
 	/** This status indicates that the path given for update operation is ArrayList type */
 	DATA_IS_ARRAY = 16,
 	/** This status indicates that the Database is empty */
-	DB_EMPTY = 17
+	DB_EMPTY = 17,
+	/** This status indicates that the schema was registered successfully */
+	SCHEMA_REGISTERED = 18,
+	/** This status indicates that the given schema string is not valid */
+	SCHEMA_INVALID = 19,
+	/** This status indicates that the records stored in flash were stored with a different schema */
+	SCHEMA_MISMATCH = 20,
+	/** This status indicates that the given JSON string does not follow the registered schema */
+	SCHEMA_VIOLATION = 21,
+	/** This status indicates that the update can't be done while a snapshot is pinned as it would change the data seen by it */
+	SNAPSHOT_CONFLICT = 22,
+	/** This status indicates that the DB was written by the writer task while the iterator was reading it so it should be begun again */
+	READ_CONFLICT = 23,
+	/** This status indicates that the update job has pages remaining to be rewritten by MicrocDB_UpdateStep() */
+	UPDATE_PENDING = 24,
+	/** This status indicates that the backup stream given to restore has a wrong format or checksum or it ended before its last chunk */
+	BACKUP_CORRUPT = 25,
+	/** This status indicates that the change record given to apply has a wrong format */
+	CHANGE_INVALID = 26,
+	/** This status indicates that the change record given to apply is not the next one after the last applied record */
+	CHANGE_OUT_OF_ORDER = 27,
+	/** This status indicates that the path is in a member moved to the cold tier, it is updated after MicrocDB_TierStep() moves it back */
+	DATA_IS_COLD = 28,
+	/** This status indicates that all the blocks of the RAM cache are pinned by the found data not given to MicrocDB_Release() */
+	CACHE_FULL = 29,
+	/** This status indicates that adding the delta to the counter would overflow int32_t, the counter is not changed */
+	COUNTER_OVERFLOW = 30,
+	/** This status indicates that the update doesn't fit in the slack of the object and the object can't be relocated, the DB is not changed */
+	NOT_ENOUGH_SPACE = 31,
+	/** This status indicates that the incremental backup stream given to restore isn't since the generation restored last on the DB or
+	 * the DB was changed after it, the DB is not changed */
+	BACKUP_MISMATCH = 32
 } microcDB_Status;
 /*MicrocDB Status enums typedef*/
 
@@ -102,11 +134,23 @@ typedef struct {
 
 /**
  * @brief This function initializes the Flash memory for MicrocDB. This should be called before using
- * MicrocDB other functions.
+ * MicrocDB other functions. If collections are configured then every collection is initialized.
  ** @returns #microcDB_Status INIT_CMPLT = 4, INIT_FAILED = 5, FLASH_FULL = 7
  * */
 microcDB_Status MicrocDB_Init();
 
+#if MICROCDB_COLLECTIONS > 0
+/**
+ * @brief This function selects the collection on which the next MicrocDB_Insert, MicrocDB_Find and MicrocDB_Update calls operate.
+ * Every collection is a separate JSON tree in its own region(see MICROCDB_COLLECTION_TABLE) so these calls only touch the selected
+ * collection. The default collection at MICROCDB_START_ADDR is selected after MicrocDB_Init().
+ * @param *name : The name of collection terminated with '/' like "logs/". "/" or 0 selects the default collection.
+ * @returns  The #microcDB_Status #FOUND_SUCCESS = 3 if selected or #NOT_FOUND = 2 if there is no such collection, in this case the
+ * selected collection is not changed.
+ */
+microcDB_Status MicrocDB_SelectCollection(uint8_t *name);
+#endif
+
 /**
  * @brief This function will insert the JSON object to Database. The JSON string may have multiple objects
  * but should be separated by '/'. If there is already a JSON object then using this command will add JSON object next to old object.
@@ -114,7 +158,13 @@ microcDB_Status MicrocDB_Init();
  * @param numberofobjects : The number of JSON objects
  *
  * @note Though you are storing only one object but you should add '/' at the end of object string.
- * @returns  The #microcDB_Status enum. #STORE_SUCCESS = 0, #STORE_FAILED = 1
+ * @note If MICROCDB_COMPRESSION is enabled then the objects are packed in blocks of MICROCDB_COMP_BLOCK_SIZE and compressed. Each object
+ * including its '/' should fit in a block. In this case #FLASH_FULL = 7 is returned if the block doesn't fit in DB memory and
+ * #CACHE_FULL = 29 if all the blocks of RAM cache are pinned, see MicrocDB_Release().
+ * @note If MICROCDB_MEMTABLE_BYTES is enabled then the objects are buffered and written to DB with the other buffered writes, see
+ * MicrocDB_Sync().
+ * @returns  The #microcDB_Status enum. #STORE_SUCCESS = 0, #STORE_FAILED = 1 or #UPDATE_PENDING = 24 if an update job begun by
+ * MicrocDB_UpdateBegin() is pending
  * */
 microcDB_Status MicrocDB_Insert(uint8_t *JSONString,
 		unsigned int numberofobjects);
@@ -129,10 +179,67 @@ microcDB_Status MicrocDB_Insert(uint8_t *JSONString,
  * <li>DBEndptr: This is the pointer to MicrocDB memory which will point to the end of the data which needs to be find by query.</li></ul>
  * @note Check the #microcDB_Status value first if its #NOT_FOUND then it means the requested data was not found, and hence no need to
  * see at the DBStartptr or DBEndptr.
+ * @note If an update job begun by MicrocDB_UpdateBegin() is pending then DBstatus is #UPDATE_PENDING = 24 as the DB is partly shifted.
+ * The other reading functions of DB give it too. It is found after MicrocDB_UpdateStep() completes the job.
+ * @note If MICROCDB_COMPRESSION is enabled then every stored document is searched and the pointers point to the decompressed copy in
+ * RAM cache. Its block is pinned in the cache so they are valid till the data is given to MicrocDB_Release(), which should be called
+ * for every data found. If all the blocks of cache are pinned then DBstatus is #CACHE_FULL = 29.
+ * @note If MICROCDB_SEQLOCK is enabled then the search is done again when the writer task writes the DB during it, so the result is
+ * consistent. The data pointed can still be changed by the next write, see MicrocDB_ReadBegin().
+ * @note If MICROCDB_MEMTABLE_BYTES is enabled then the buffered writes are not applied by the search. The value of a buffered path, or
+ * the value found in DB with the buffered values in it, is copied to a RAM buffer of MICROCDB_MEMTABLE_FIND_BYTES which is valid till
+ * the next MicrocDB_Find(). If it doesn't fit in it then DBstatus is #NO_MEMORY = 15. The other reading functions don't see the
+ * buffered writes, see MicrocDB_Sync().
+ * @note If MICROCDB_TIERING is enabled then the query not found in DB is searched in the cold tier, and the accesses of the first part
+ * of query are counted to decide the tier of its member, see MicrocDB_TierStep().
+ * @note If MICROCDB_ARRAY_SEGMENTS is enabled then the array list found is joined with the elements appended by
+ * MicrocDB_UpdateArrayList() in a RAM buffer which is valid till the next MicrocDB_Find(). If they don't fit in it then DBstatus is
+ * #NO_MEMORY = 15, use MicrocDB_ArrayIterBegin() instead.
+ * @note If MICROCDB_OBJECT_SLACK is enabled then the object or array list found is copied without the slack to a RAM buffer of
+ * MICROCDB_SLACK_FIND_BYTES which is valid till the next MicrocDB_Find(). If it doesn't fit in it then the pointers point to it in
+ * flash with the empty bytes of slack and the forwarding markers of relocated members, use MicrocDB_StreamFound() to read it.
  * @param *query : The query string by dot operators like "A.B.C./". The "./" is <b>VERY IMPORTANT</b> at the end of query string!
  * */
 microcDB_Data MicrocDB_Find(uint8_t *query);
 
+#if MICROCDB_OBJECT_SLACK > 0
+/**
+ * @brief The callback which is given the bytes of the data by MicrocDB_StreamFound(). The data is given in several calls.
+ * @param *Bytes : The bytes of data. They are valid only in the callback
+ * @param Length : The number of bytes
+ * @param *Context : The context given to MicrocDB_StreamFound()
+ * @returns true if the bytes were used or false to stop the stream.
+ */
+typedef bool (*microcDB_FoundWrite)(uint8_t *Bytes, uint16_t Length,
+		void *Context);
+
+/**
+ * @brief This function gives the data found by MicrocDB_Find() through the callback without the empty bytes of slack, and the members
+ * which were relocated from their latest copy. Nothing is copied to RAM so it is used for the object or array list which doesn't fit in
+ * the buffer of MICROCDB_SLACK_FIND_BYTES.
+ * @param *Data : The data found
+ * @param Write : The callback which is given the bytes
+ * @param *Context : This is given to callback as it is
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if the data was given #FOUND_SUCCESS = 3</li>
+ * <li>if the data was not found #NOT_FOUND = 2</li>
+ * <li>if the callback returned false #STORE_FAILED = 1</li>
+ * <li>if an update job begun by MicrocDB_UpdateBegin() is pending #UPDATE_PENDING = 24, the data may have been moved by it</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_StreamFound(microcDB_Data *Data,
+		microcDB_FoundWrite Write, void *Context);
+#endif
+
+#if MICROCDB_COMPRESSION == 1
+/**
+ * @brief This function releases the data found by MicrocDB_Find() or MicrocDB_IndexFind(), so the block of the RAM cache it points to
+ * can be replaced by the next lookups. The pointers of the data should not be used after it. The data which was not found is ignored.
+ * @param *Data : The data found
+ */
+void MicrocDB_Release(microcDB_Data *Data);
+#endif
+
 /**
  * @brief 	Updates the DB with given data at given path.
  * @brief This function updates the value/data of path given.Path is the same as query language. For example:
@@ -152,7 +259,15 @@ microcDB_Data MicrocDB_Find(uint8_t *query);
  * <li>if given path not found #PATH_NOT_FOUND = 11,</li>
  * <li>if given update operation crosses the MICROCDB_END_ADDR boundary then #NO_MEMORY = 15 in this case data is not changed.</li>
  * <li>if the object to be updated is <b>ARRAY_LIST</b> then #DATA_IS_ARRAY = 16, use MicrocDB_UpdateArrayList() instead. </li>
+ * <li>if MICROCDB_COMPRESSION is enabled then #UPDATE_FAILED = 10 as the compressed documents can't be updated.</li>
+ * <li>if a snapshot is pinned and the object having the value can't be relocated #SNAPSHOT_CONFLICT = 22</li>
+ * <li>if an update job begun by MicrocDB_UpdateBegin() is pending #UPDATE_PENDING = 24</li>
+ * <li>if MICROCDB_TIERING is enabled and the path is in the cold tier #DATA_IS_COLD = 28</li>
+ * <li>if MICROCDB_OBJECT_SLACK and MICROCDB_RELOCATION are enabled and the update doesn't fit in the slack of the object, which
+ * can't be relocated, or if the value is in an array list #NOT_ENOUGH_SPACE = 31</li>
  * </ul>
+ * @note If MICROCDB_MEMTABLE_BYTES is enabled then the update is buffered and #UPDATE_SUCCESSFUL = 9 is given if the path is found.
+ * The status of applying it is given by MicrocDB_Sync().
  * @note <ul>
  * <li>This function should only be use for updating a single key's value or adding a new object to a object.</li>
  * <li>If used for updating a object then it should be correct or else microcDB_Status INVALID_JSON = 6 will be returned and
@@ -163,26 +278,854 @@ microcDB_Data MicrocDB_Find(uint8_t *query);
  */
 microcDB_Status MicrocDB_Update(uint8_t *path, uint8_t *value);
 
+#if MICROCDB_ARRAY_SEGMENTS == 1
+/*Array list segments*/
+
+/**
+ * @brief This struct typedef is the iterator of an array list which gives its elements including the ones appended by
+ * MicrocDB_UpdateArrayList(). Initialize it using MicrocDB_ArrayIterBegin() and don't edit its members.
+ */
+typedef struct {
+	/** The element which will be given on next call*/
+	uint8_t *Element;
+	/** The ending bracket of the array list or overflow segment being iterated*/
+	uint8_t *End;
+	/** The next overflow segment to be iterated or 0 if there is none*/
+	uint8_t *Segment;
+#if MICROCDB_SEQLOCK == 1
+	/** The sequence of the writes of DB when the iteration began*/
+	uint32_t Sequence;
+#endif
+} microcDB_ArrayIterator;
+
 /**
  * @brief This function will append the given data to the array list at given path. Path is the same as query language. For example:
  * @brief if DB is {"users":{"groups":["Jack","David","Mario"]}} so for appending "Chris" the path and data
- * @brief would be like this: "users.groups./","Chris".
+ * @brief would be like this: "users.groups./","'Chris'/".
+ * @brief The data is stored in an overflow segment in the region MICROCDB_ARRAY_START_ADDR..MICROCDB_ARRAY_END_ADDR and the last
+ * segment of the array list is linked to it, so the DB is not shifted. The appended elements are given by MicrocDB_ArrayNext(),
+ * MicrocDB_Aggregate() and MicrocDB_Filter(). MicrocDB_Find() of the array list joins them in a RAM buffer of MICROCDB_ARRAY_FIND_BYTES,
+ * but the Find of an object having the array list gives only the elements stored in DB.
  * @param *path : The DB path whose value to be changed.
- * @param *data : The data to be appended to the path.
+ * @param *data : The data to be appended to the path terminated with '/'. It can be several elements separated by comma like "1,2,3/"
  * @returns  The #microcDB_Status. <ul>
  * <li>if Update was successful #UPDATE_SUCCESSFUL = 9</li>
- * <li>if Update failed #UPDATE_FAILED = 10</li>
+ * <li>if Update failed or data is empty #UPDATE_FAILED = 10</li>
  * <li>if given path not found #PATH_NOT_FOUND = 11,</li>
- * <li>if given update operation crosses the #MICROCDB_END_ADDR boundary then #NO_MEMORY = 15 in this case data is not changed.</li>
- * <li>if the path to be updated is not <b>ARRAY_LIST</b> then #PATH_NOT_ARRAYLIST = 16</li>
+ * <li>if the region of overflow segments is full then #NO_MEMORY = 15 in this case data is not changed.</li>
+ * <li>if the path to be updated is not <b>ARRAY_LIST</b> then #PATH_NOT_ARRAYLIST = 12</li>
+ * <li>if an update job begun by MicrocDB_UpdateBegin() is pending #UPDATE_PENDING = 24</li>
  * </ul>
  */
 microcDB_Status MicrocDB_UpdateArrayList(uint8_t *path, uint8_t*data);
 
+/**
+ * @brief This function initializes the iterator to the first element of the array list at given path.
+ * @param *path : The path of array list same as the query of MicrocDB_Find()
+ * @param *Iterator : The iterator to be initialized
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if initialized #FOUND_SUCCESS = 3</li>
+ * <li>if given path not found #PATH_NOT_FOUND = 11</li>
+ * <li>if the path is not <b>ARRAY_LIST</b> #PATH_NOT_ARRAYLIST = 12</li>
+ * <li>if an update job begun by MicrocDB_UpdateBegin() is pending #UPDATE_PENDING = 24</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_ArrayIterBegin(uint8_t *path,
+		microcDB_ArrayIterator *Iterator);
+
+/**
+ * @brief This function gives the next element of the array list. The elements stored in DB are given first and then the appended ones
+ * in the order they were appended.
+ * @param *Iterator : The iterator initialized by MicrocDB_ArrayIterBegin()
+ * @returns the #microcDB_Data struct same as MicrocDB_Find(). DBstatus is #NOT_FOUND if there are no more elements, or
+ * #READ_CONFLICT = 23 if the DB was written since the iteration began when MICROCDB_SEQLOCK is enabled, or #UPDATE_PENDING = 24 if an
+ * update job was begun since then.
+ */
+microcDB_Data MicrocDB_ArrayNext(microcDB_ArrayIterator *Iterator);
+
+/*Array list segments*/
+#endif
+
+#if MICROCDB_SNAPSHOTS > 0
+/*Snapshots*/
+
+/**
+ * @brief This struct typedef is a snapshot of DB pinned by MicrocDB_SnapshotBegin(). Don't edit its members.
+ */
+typedef struct {
+	/** The generation of DB seen by the snapshot*/
+	uint32_t Generation;
+} microcDB_Snapshot;
+
+/**
+ * @brief This function pins a snapshot of the DB as it is now. MicrocDB_SnapshotFind() with the snapshot gives the values as they were
+ * when it was pinned, even after the DB is updated. While any snapshot is pinned the updates only relocate the objects (see
+ * MICROCDB_RELOCATION) so the pinned data is not changed, and an update which can't be done so returns #SNAPSHOT_CONFLICT = 22.
+ * @param *Snapshot : The snapshot to be pinned
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if pinned #FOUND_SUCCESS = 3</li>
+ * <li>if MICROCDB_SNAPSHOTS snapshots are already pinned #NO_MEMORY = 15</li>
+ * </ul>
+ * @note The snapshot gives a consistent view of the DB across several finds while updates are done between them. Every task uses its
+ * own snapshot, so with MICROCDB_SEQLOCK the reader tasks pin and read their snapshots while the writer task updates the DB.
+ */
+microcDB_Status MicrocDB_SnapshotBegin(microcDB_Snapshot *Snapshot);
+
+/**
+ * @brief This function searches the query in the DB as it was when the snapshot was pinned.
+ * @param *Snapshot : The snapshot pinned by MicrocDB_SnapshotBegin()
+ * @param *query : The query string same as MicrocDB_Find()
+ * @returns the #microcDB_Data struct same as MicrocDB_Find()
+ */
+microcDB_Data MicrocDB_SnapshotFind(microcDB_Snapshot *Snapshot,
+		uint8_t *query);
+
+/**
+ * @brief This function unpins the snapshot. The updates change the objects in place again once no snapshot is pinned, and the copies
+ * superseded while it was pinned are reclaimed when the relocation region is full.
+ * @param *Snapshot : The snapshot pinned by MicrocDB_SnapshotBegin()
+ */
+void MicrocDB_SnapshotEnd(microcDB_Snapshot *Snapshot);
+
+/*Snapshots*/
+#endif
+
+#if MICROCDB_SEQLOCK == 1
+/*Single writer*/
+
+/**
+ * @brief This function gives the sequence of the writes of DB to be checked by MicrocDB_ReadRetry(). If the writer task is writing
+ * the DB then it waits till the write is completed. MicrocDB_Find() does this itself, these are used by the reader task to check that
+ * the value found was not changed while it was copied. For example:
+ * @code
+ * do {
+ * 	Sequence = MicrocDB_ReadBegin();
+ * 	Data = MicrocDB_Find((uint8_t*) "sensor.mode./");
+ * 	memcpy(Mode, Data.DBStartptr, Data.DBEndptr - Data.DBStartptr + 1);
+ * } while (MicrocDB_ReadRetry(Sequence));
+ * @endcode
+ * @returns the sequence of the writes
+ */
+uint32_t MicrocDB_ReadBegin();
+
+/**
+ * @brief This function checks if the DB was written since MicrocDB_ReadBegin() gave the sequence.
+ * @param Sequence : The sequence given by MicrocDB_ReadBegin()
+ * @returns true if the DB was written and so the data read should be read again, otherwise false
+ */
+bool MicrocDB_ReadRetry(uint32_t Sequence);
+
+/*Single writer*/
+#endif
+
+#if MICROCDB_UPDATE_JOBS == 1
+/*Update jobs*/
+
+/**
+ * @brief This struct typedef gives the progress of the update job begun by MicrocDB_UpdateBegin(). Don't edit its members.
+ */
+typedef struct {
+	/** The number of pages rewritten by the job*/
+	uint16_t PagesDone;
+	/** The number of pages which the job rewrites*/
+	uint16_t Pages;
+} microcDB_UpdateJob;
+
+/**
+ * @brief This function begins the update of value at path as a job. The path and value are the same as MicrocDB_Update(). Nothing is
+ * changed in DB yet, the job is journaled and MicrocDB_UpdateStep() should be called till it completes. Only one job can be pending,
+ * and while it is pending MicrocDB_Insert(), MicrocDB_Update(), MicrocDB_UpdateArrayList(), MicrocDB_Find() and the other functions
+ * which read the DB return #UPDATE_PENDING = 24 as the DB is partly shifted.
+ * @param *path : The DB path whose value to be changed
+ * @param *value : The value terminated with '/'. With the journal of job it should fit in a page
+ * @param *Job : The progress of job
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if the job was begun #UPDATE_PENDING = 24</li>
+ * <li>if the journal couldn't be written or a job is already pending #UPDATE_FAILED = 10</li>
+ * <li>if given path not found #PATH_NOT_FOUND = 11</li>
+ * <li>if the value would cross MICROCDB_END_ADDR or doesn't fit in the journal #NO_MEMORY = 15</li>
+ * <li>if the path is <b>ARRAY_LIST</b> #DATA_IS_ARRAY = 16</li>
+ * <li>if a snapshot is pinned #SNAPSHOT_CONFLICT = 22</li>
+ * <li>if MICROCDB_TIERING is enabled and the path is in the cold tier #DATA_IS_COLD = 28</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_UpdateBegin(uint8_t *path, uint8_t *value,
+		microcDB_UpdateJob *Job);
+
+/**
+ * @brief This function continues the pending update job. Every page of DB is rewritten by two page operations, one writes its backup
+ * and other writes the page, and one more completes the job.
+ * @param *Job : The progress of job given by MicrocDB_UpdateBegin()
+ * @param PageOps : The maximum number of page operations(erase and write of a page) done by this call. It should be at least 1
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if the job is completed or no job is pending #UPDATE_SUCCESSFUL = 9</li>
+ * <li>if pages are remaining #UPDATE_PENDING = 24</li>
+ * <li>if writing flash failed #UPDATE_FAILED = 10, then the job is still pending and can be continued</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_UpdateStep(microcDB_UpdateJob *Job, uint16_t PageOps);
+
+/*Update jobs*/
+#endif
+
+#if MICROCDB_MEMTABLE_BYTES > 0
+/*Memtable*/
+
+/**
+ * @brief This function applies the writes buffered by MicrocDB_Insert() and MicrocDB_Update() to DB and erases their journal. The
+ * inserted documents are written first, then the values of same length are written with one rewrite of every page having them and
+ * the others are updated from the highest address. Every page of DB is saved to the undo log before it is first changed, so if power is
+ * lost while applying them MicrocDB_Init() restores the pages and applies the writes again.
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if all the writes buffered since the last call were applied #UPDATE_SUCCESSFUL = 9</li>
+ * <li>if a write failed when it was applied, the status of the first one which failed, like #PATH_NOT_FOUND = 11 or #NO_MEMORY = 15.
+ * The failed write is dropped</li>
+ * <li>if the journal couldn't be erased or a page couldn't be saved to the undo log #UPDATE_FAILED = 10</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_Sync();
+
+/*Memtable*/
+#endif
+
+#if MICROCDB_TIERING == 1
+/*Tiering*/
+
+/**
+ * @brief This function moves at most one top level member of a document between the DB and the cold tier. It should be called
+ * periodically when the application is idle, as the counts of accesses are halved after every MICROCDB_TIER_AGE_STEPS calls. A member
+ * of the cold tier which was found MICROCDB_TIER_PROMOTE_HITS times recently, or whose update returned #DATA_IS_COLD, is moved back
+ * to its document if it fits in MICROCDB_TIER_HOT_BYTES. Otherwise if the DB uses more than MICROCDB_TIER_HOT_BYTES then the first
+ * member which wasn't found recently is moved to the cold tier. The member is moved by an update job of which every call does at most
+ * MICROCDB_TIER_STEP_PAGE_OPS page operations.
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if a member was moved or the pending update job was completed #UPDATE_SUCCESSFUL = 9</li>
+ * <li>if the update job has pages remaining #UPDATE_PENDING = 24, then it is continued by the next call. Till then the functions which
+ * read the DB return #UPDATE_PENDING = 24 too</li>
+ * <li>if no member needs to be moved #NOT_FOUND = 2</li>
+ * <li>if writing flash failed #UPDATE_FAILED = 10, then the job is continued by the next call</li>
+ * <li>if the cold tier is full #NO_MEMORY = 15</li>
+ * </ul>
+ * @note When the cold tier is full, the records of the members moved back or moved again are removed by copying the other records to
+ * the other half of its region. The cold tier is erased with DB.
+ */
+microcDB_Status MicrocDB_TierStep();
+
+/*Tiering*/
+#endif
+
+#if MICROCDB_BACKUP == 1
+/*Incremental backup*/
+
+/**
+ * @brief The callback which is given the bytes of backup stream by MicrocDB_Backup(). A stream is given in several calls.
+ * @param *Bytes : The bytes of stream. They are valid only in the callback
+ * @param Length : The number of bytes
+ * @param *Context : The context given to MicrocDB_Backup()
+ * @returns true if the bytes were written or false to stop the backup.
+ */
+typedef bool (*microcDB_BackupWrite)(uint8_t *Bytes, uint16_t Length,
+		void *Context);
+
+/**
+ * @brief The callback which gives the bytes of backup stream to MicrocDB_Restore().
+ * @param *Bytes : The buffer where the bytes should be copied
+ * @param Length : The number of bytes to be copied
+ * @param *Context : The context given to MicrocDB_Restore()
+ * @returns true if all the bytes were copied or false if the stream has ended or couldn't be read.
+ */
+typedef bool (*microcDB_BackupRead)(uint8_t *Bytes, uint16_t Length,
+		void *Context);
+
+/**
+ * @brief This function takes a checkpoint. The pages changed after it are streamed by MicrocDB_Backup() with the generation given
+ * here, so it should be taken after the backup of the previous checkpoint is stored.
+ * @param *Generation : The generation of the checkpoint
+ * @returns  The #microcDB_Status #STORE_SUCCESS = 0 or #STORE_FAILED = 1 if the log of changed pages couldn't be written
+ */
+microcDB_Status MicrocDB_BackupCheckpoint(uint32_t *Generation);
+
+/**
+ * @brief This function streams the pages of region MICROCDB_START_ADDR..MICROCDB_END_ADDR which were changed since the checkpoint of
+ * given generation through the callback. If the generation is 0 or older than the log of changed pages then all the pages are streamed.
+ * The stream is little endian and has a header followed by a chunk for every page:
+ * <ul>
+ * <li>Header: |'m'|'B'|Page size(2 bytes)|Since generation(4 bytes)|Current generation(4 bytes)|Number of pages(2 bytes)|0(2 bytes)|
+ * Checksum(4 bytes)|</li>
+ * <li>Page: |Page number from MICROCDB_START_ADDR(2 bytes)|0(2 bytes)|Bytes of page(PAGE_SIZE bytes)|Checksum(4 bytes)|</li>
+ * </ul>
+ * The checksum is the FNV-1a hash of the bytes of header or page chunk before it.
+ * @param Since : The generation given by MicrocDB_BackupCheckpoint() or 0 for a full backup
+ * @param Write : The callback which writes the stream
+ * @param *Context : This is given to callback as it is
+ * @note The stream can be restored only on the DB whose last restore was of a stream of Since generation or newer and which wasn't changed
+ * after it.
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if the stream was written #STORE_SUCCESS = 0</li>
+ * <li>if the callback returned false #STORE_FAILED = 1</li>
+ * <li>if an update job begun by MicrocDB_UpdateBegin() is pending #UPDATE_PENDING = 24</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_Backup(uint32_t Since, microcDB_BackupWrite Write,
+		void *Context);
+
+/**
+ * @brief This function writes the pages of the backup stream given by MicrocDB_Backup() to DB. Every page is checked with its checksum
+ * and staged in the region of MICROCDB_BACKUP_STAGE_START_ADDR before any page of DB is written, so a corrupt stream doesn't change the
+ * DB. If the power is lost while the staged pages are written to DB then MicrocDB_Init() writes them again. The restore takes a checkpoint
+ * and stores the current generation of stream, which is kept till the DB is changed other than by a restore. A full stream is always
+ * restored, an incremental one only if its Since generation is not newer than the stored one and its current generation is not older.
+ * @param Read : The callback which reads the stream
+ * @param *Context : This is given to callback as it is
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if all the pages were written #STORE_SUCCESS = 0</li>
+ * <li>if writing flash failed #STORE_FAILED = 1. If the stage was written then MicrocDB_Init() writes it to DB again</li>
+ * <li>if the stream is corrupt or ended early #BACKUP_CORRUPT = 25, the DB is not changed</li>
+ * <li>if the stream is incremental and doesn't follow the generation stored by the last restore #BACKUP_MISMATCH = 32</li>
+ * <li>if an update job begun by MicrocDB_UpdateBegin() is pending #UPDATE_PENDING = 24</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_Restore(microcDB_BackupRead Read, void *Context);
+
+/*Incremental backup*/
+#endif
+
+#if MICROCDB_CHANGE_FEED == 1
+/*Change feed*/
+
+/**
+ * @brief This enum typedef gives the type of change of a change record.
+ */
+typedef enum {
+	/** MicrocDB_Insert(). The value has the objects each terminated with '/' and the count is the number of objects*/
+	CHANGE_INSERT = 1,
+	/** MicrocDB_Update() or MicrocDB_UpdateBegin()*/
+	CHANGE_UPDATE,
+	/** MicrocDB_UpdateArrayList()*/
+	CHANGE_APPEND,
+	/** MicrocDB_Increment() or MicrocDB_Decrement(). The value is the signed decimal delta added*/
+	CHANGE_INCREMENT,
+	/** MicrocDB_CappedAppend(). The path is empty*/
+	CHANGE_CAPPED_APPEND,
+	/** MicrocDB_InsertRecord(). The path is empty*/
+	CHANGE_INSERT_RECORD
+} microcDB_ChangeType;
+
+/**
+ * @brief The callback which is given the bytes of a change record. A record is given in several calls, the record is complete after
+ * the number of bytes given in its header. The record is little endian:
+ * |Sequence number(4 bytes)|#microcDB_ChangeType(1 byte)|0(1 byte)|Count(2 bytes)|Path length(2 bytes)|Value length(2 bytes)|Path|Value|
+ * The path and value are terminated with '/' which is included in their lengths. The path is empty for #CHANGE_INSERT,
+ * #CHANGE_CAPPED_APPEND and #CHANGE_INSERT_RECORD.
+ * @param *Bytes : The bytes of record. They are valid only in the callback
+ * @param Length : The number of bytes
+ * @param *Context : The context given to MicrocDB_ChangeFeed()
+ * @returns true if the bytes were written. If false is returned the record is lost and the replica finds the gap from the sequence
+ * number of next record.
+ */
+typedef bool (*microcDB_ChangeWrite)(uint8_t *Bytes, uint16_t Length,
+		void *Context);
+
+/**
+ * @brief This function registers the callback which is given the record of every change of DB. The sequence numbers are kept in
+ * the region MICROCDB_CHANGE_FEED_START_ADDR..MICROCDB_CHANGE_FEED_END_ADDR, so they continue after a reset. The number of a change
+ * is stored before it is done, so if the power was lost during a change, whose record may not have been given, the feed continues
+ * after a gap which makes the replica synchronize again.
+ * @param Callback : The callback or 0 to stop the feed
+ * @param *Context : This is given to callback as it is
+ */
+void MicrocDB_ChangeFeed(microcDB_ChangeWrite Callback, void *Context);
+
+/**
+ * @brief This function gives the sequence number of the last record given by the change feed. It is given to
+ * MicrocDB_ChangeSynced() of the replica which is synchronized with a copy of this DB.
+ * @returns The sequence number or 0 if no record was given
+ */
+uint32_t MicrocDB_ChangeSequence(void);
+
+/**
+ * @brief This function sets the sequence number of the last record applied on the replica after it is synchronized with a copy of
+ * the primary DB, like by MicrocDB_Restore(). The next record applied should have the next number.
+ * @param Sequence : The number given by MicrocDB_ChangeSequence() of primary when it was copied, or 0 to accept any number for the
+ * next record
+ * @returns  The #microcDB_Status #STORE_SUCCESS = 0, #STORE_FAILED = 1 if the number couldn't be stored or #CHANGE_INVALID = 26 if it
+ * is too large
+ */
+microcDB_Status MicrocDB_ChangeSynced(uint32_t Sequence);
+
+/**
+ * @brief This function does the change of the record given by the change feed of other DB. The first record applied on a new
+ * device or after MicrocDB_ChangeSynced() with 0 can have any sequence number and then every record should have the next sequence
+ * number. The number applied is stored so it is checked also after a reset.
+ * @param *Record : The complete record. The path and value in it may be changed like by MicrocDB_Update()
+ * @param Length : The number of bytes of record
+ * @returns  The #microcDB_Status of the change same as the function of its #microcDB_ChangeType, or <ul>
+ * <li>if the record has a wrong format #CHANGE_INVALID = 26</li>
+ * <li>if the record is not the next one #CHANGE_OUT_OF_ORDER = 27, then the replica should be synchronized again</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_ApplyChange(uint8_t *Record, uint16_t Length);
+
+/*Change feed*/
+#endif
+
 /*
  */
 microcDB_Status MicrocDB_Delete(uint8_t *path, uint8_t*data);
 
+#if MICROCDB_SCHEMA_SUPPORT == 1
+/*Schema support*/
+
+/**
+ * @brief This function registers the schema from which the fixed binary layout of the records is derived. The schema is a JSON object
+ * whose keys are the field names and values are the field types. The types are "u8","i8","u16","i16","u32","i32","f32","bool" and
+ * "sN" which is a fixed size string of N bytes. For example: {'temp':'i16','hum':'u8','name':'s8'}/
+ * @brief The records are stored in the region MICROCDB_SCHEMA_START_ADDR..MICROCDB_SCHEMA_END_ADDR with every field at a constant
+ * offset. This should be called after MicrocDB_Init() on every boot with the same schema.
+ * @param *SchemaString : The schema JSON string terminated with '/'. It should not have any white spaces.
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if schema was registered #SCHEMA_REGISTERED = 18</li>
+ * <li>if schema is not valid or the record exceeds MICROCDB_SCHEMA_MAX_RECORD_SIZE #SCHEMA_INVALID = 19</li>
+ * <li>if the records stored in flash have a different layout #SCHEMA_MISMATCH = 20, use MicrocDB_EraseRecords() to discard them.</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_RegisterSchema(uint8_t *SchemaString);
+
+/**
+ * @brief This function validates the JSON object against the registered schema and stores it as a fixed layout record. Every field of
+ * the schema should be present exactly once and no other field is allowed. For example: {'temp':-12,'hum':40,'name':'node1'}/
+ * @param *JSONString : The JSON object string terminated with '/'. It should not have any white spaces.
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if stored #STORE_SUCCESS = 0</li>
+ * <li>if the flash writing failed or no schema is registered #STORE_FAILED = 1</li>
+ * <li>if the record region is full #FLASH_FULL = 7</li>
+ * <li>if the JSON does not follow the schema #SCHEMA_VIOLATION = 21 in this case nothing is stored.</li>
+ * </ul>
+ * @note The record takes its index before it is written, so if the writing failed or the power was lost during it the index is
+ * skipped and MicrocDB_FindRecord() gives #NOT_FOUND for it.
+ */
+microcDB_Status MicrocDB_InsertRecord(uint8_t *JSONString);
+
+/**
+ * @brief This function will get the field of the record. No parsing is done, the location of field is calculated from the
+ * record index and the offset of field in the layout.
+ * @param RecordIndex : The index of the record. The first stored record has index 0
+ * @param *query : The field name terminated with "./" like "temp./"
+ * @returns the #microcDB_Data struct. DBStartptr and DBEndptr point to the binary value of the field stored in flash(little endian)
+ * and JSON_type is JSON_PRIMITIVE for numeric fields, JSON_BOOL for bool and JSON_STRING for strings. For strings the DBEndptr
+ * points to the last char of string. DBstatus is #FOUND_SUCCESS or #NOT_FOUND or #QUERY_INVALID. It is #NOT_FOUND for the index of a
+ * record which was not completely stored.
+ */
+microcDB_Data MicrocDB_FindRecord(uint32_t RecordIndex, uint8_t *query);
+
+/**
+ * @brief This function returns the number of records stored with the registered schema, including the ones not completely stored.
+ */
+uint32_t MicrocDB_RecordCount();
+
+/**
+ * @brief This function erases all the records stored in MICROCDB_SCHEMA_START_ADDR..MICROCDB_SCHEMA_END_ADDR.
+ * @returns  The #microcDB_Status #INIT_CMPLT = 4 or #INIT_FAILED = 5
+ */
+microcDB_Status MicrocDB_EraseRecords();
+
+/*Schema support*/
+#endif
+
+#if MICROCDB_CAPPED_SUPPORT == 1
+/*Capped collection*/
+
+/**
+ * @brief This struct typedef is the iterator of the capped collection which gives the documents from newest to oldest.
+ * Initialize it using MicrocDB_CappedIterNewest() and don't edit its members.
+ */
+typedef struct {
+	/** The index of page being iterated*/
+	uint32_t Page;
+	/** The sequence number of page being iterated*/
+	uint32_t Sequence;
+	/** This points after the entry which will be given on next call*/
+	uint8_t *Entry;
+#if MICROCDB_CAPPED_TS_INDEX == 1
+	/** The first timestamp of the range to be iterated*/
+	uint32_t From;
+	/** The last timestamp of the range to be iterated*/
+	uint32_t To;
+#endif
+} microcDB_CappedIterator;
+
+/**
+ * @brief This function appends the JSON document to the capped collection. The append is done at the end of the newest page, if the
+ * document doesn't fit in it then the page having oldest documents is erased and used. Database is never shifted.
+ * @param *JSONString : The JSON object string terminated with '/'. It should not have any white spaces.
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if stored #STORE_SUCCESS = 0</li>
+ * <li>if flash erasing or writing failed or the document doesn't fit in a page #STORE_FAILED = 1</li>
+ * <li>if MICROCDB_CAPPED_TS_INDEX is enabled and the document has no timestamp at MICROCDB_CAPPED_TS_PATH #QUERY_INVALID = 8</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_CappedAppend(uint8_t *JSONString);
+
+/**
+ * @brief This function initializes the iterator to the newest document of the capped collection.
+ * @param *Iterator : The iterator to be initialized
+ */
+void MicrocDB_CappedIterNewest(microcDB_CappedIterator *Iterator);
+
+#if MICROCDB_CAPPED_TS_INDEX == 1
+/**
+ * @brief This function initializes the iterator to give only the documents whose timestamp is between From and To(both inclusive),
+ * from newest to oldest. The pages whose timestamp range is outside From..To are skipped without reading their documents.
+ * @param *Iterator : The iterator to be initialized
+ * @param From : The first timestamp of the range
+ * @param To : The last timestamp of the range
+ */
+void MicrocDB_CappedIterRange(microcDB_CappedIterator *Iterator, uint32_t From,
+		uint32_t To);
+#endif
+
+/**
+ * @brief This function gives the next document of the iterator i.e the newest document on first call and older documents after it.
+ * @param *Iterator : The iterator initialized by MicrocDB_CappedIterNewest()
+ * @param *query : If 0 then the whole document is given. Otherwise it is the query same as MicrocDB_Find() like "temp./" and the value of
+ * the query in the next document having it is given.
+ * @returns the #microcDB_Data struct same as MicrocDB_Find(). DBstatus is #NOT_FOUND if there are no more documents, or
+ * #READ_CONFLICT = 23 if MICROCDB_SEQLOCK is enabled and the page of iterator was reused by MicrocDB_CappedAppend() since the last
+ * document was given.
+ */
+microcDB_Data MicrocDB_CappedNext(microcDB_CappedIterator *Iterator,
+		uint8_t *query);
+
+/*Capped collection*/
+#endif
+
+#if MICROCDB_HASH_INDEX == 1
+/*Hash index*/
+
+/**
+ * @brief This function finds the document whose value at MICROCDB_HASH_INDEX_PATH is same as given value using the persistent hash
+ * index. Only the bucket page of the value and the document are read, the other documents are not parsed.
+ * @param *value : The value terminated with '/' like "dev42/" or "1200/". Strings are given without quotes.
+ * @param *query : If 0 then the whole document is given. Otherwise the query in the document same as MicrocDB_Find() like "name./"
+ * @returns the #microcDB_Data struct same as MicrocDB_Find(). If MICROCDB_COMPRESSION is enabled then the pointers point to the
+ * decompressed block in RAM cache which is pinned till the data is given to MicrocDB_Release(). DBstatus is #NOT_FOUND if no document
+ * has the value or the query, #CACHE_FULL = 29 if all the blocks of RAM cache are pinned, or #UPDATE_PENDING = 24 if an update job
+ * begun by MicrocDB_UpdateBegin() is pending.
+ * @note If the index has a stale slot, i.e its document doesn't have the value anymore, or all its slots were used then all the
+ * documents are searched for the value. The stale slot is dropped.
+ * @note If MICROCDB_MEMTABLE_BYTES is enabled then the documents buffered by MicrocDB_Insert() are found after MicrocDB_Sync().
+ */
+microcDB_Data MicrocDB_IndexFind(uint8_t *value, uint8_t *query);
+
+/*Hash index*/
+#endif
+
+#if MICROCDB_AGGREGATES == 1
+/*Aggregates*/
+
+/**
+ * @brief This struct typedef has the result of an aggregate query. Sum, Min, Max and Mean are 0 if Count is 0.
+ */
+typedef struct {
+	/** The number of numbers aggregated*/
+	uint32_t Count;
+	/** The sum of numbers*/
+	float Sum;
+	/** The minimum number*/
+	float Min;
+	/** The maximum number*/
+	float Max;
+	/** The mean of numbers*/
+	float Mean;
+} microcDB_Aggregate;
+
+/**
+ * @brief This function aggregates the numbers of the array list or object at given path in one pass over the stored bytes, without
+ * parsing every element separately. For example: if DB is {"temp":[21,22.5,-3],"nodes":{"a":{"t":20},"b":{"t":24}}} then path
+ * "temp./" and field 0 aggregates 21, 22.5 and -3, and path "nodes./" and field "t./" aggregates 20 and 24.
+ * @param *path : The path of array list or object. Path is the same as query language.
+ * @param *field : If 0 then the numbers which are elements of array list or values of object are aggregated. Otherwise it is the key
+ * terminated with "./" like "temp./" and the number of this key in every element(which is an object) is aggregated. The elements
+ * without the key or having non numeric value are skipped.
+ * @param *Result : The struct where the result is given
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if aggregated #FOUND_SUCCESS = 3, even if no numbers were found in which case Count is 0</li>
+ * <li>if given path not found #PATH_NOT_FOUND = 11</li>
+ * <li>if the path is not an array list or object #PATH_NOT_ARRAYLIST = 12</li>
+ * <li>if an update job begun by MicrocDB_UpdateBegin() is pending #UPDATE_PENDING = 24</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_Aggregate(uint8_t *path, uint8_t *field,
+		microcDB_Aggregate *Result);
+
+#if MICROCDB_CAPPED_SUPPORT == 1
+/**
+ * @brief This function aggregates the number of the field in the documents of capped collection given by the iterator. For example to
+ * get the average temperature of the documents of a time range initialize the iterator with MicrocDB_CappedIterRange() and give
+ * "temp./" as field.
+ * @param *Iterator : The iterator initialized by MicrocDB_CappedIterNewest() or MicrocDB_CappedIterRange(). It is at the end after this.
+ * @param *field : The query of the number in every document like "temp./". The documents without it are skipped.
+ * @param *Result : The struct where the result is given
+ * @returns  The #microcDB_Status #FOUND_SUCCESS = 3, or #READ_CONFLICT = 23 if MICROCDB_SEQLOCK is enabled and the iterator was
+ * overtaken by MicrocDB_CappedAppend(). The result has the documents given before it.
+ */
+microcDB_Status MicrocDB_CappedAggregate(microcDB_CappedIterator *Iterator,
+		uint8_t *field, microcDB_Aggregate *Result);
+#endif
+
+/*Aggregates*/
+#endif
+
+#if MICROCDB_FILTER == 1
+/*Filter scans*/
+
+/**
+ * @brief This enum typedef indicates the condition of the filter scan between the value of field and the given value.
+ */
+typedef enum {
+	/** The value of field is same as the given value. Numbers are compared as numbers so 25 is same as 25.0*/
+	FILTER_EQ = 0,
+	/** The value of field is not same as the given value*/
+	FILTER_NE,
+	/** The value of field is less than the given value. If any of them is not a number then they are compared char by char*/
+	FILTER_LT,
+	/** The value of field is greater than the given value. If any of them is not a number then they are compared char by char*/
+	FILTER_GT,
+	/** The value of field starts with the given value*/
+	FILTER_PREFIX
+} microcDB_FilterOp;
+
+/**
+ * @brief The callback which is called for every matching object by MicrocDB_Filter().
+ * @param *Match : The matching object. DBStartptr points to its '{' and DBEndptr to its '}'
+ * @param *Key : The key of the matching object if the path is an object, in this case DBStartptr and DBEndptr point to first and
+ * last char of the key. If the path is an array list then DBstatus is #NOT_FOUND.
+ * @param *Context : The context given to MicrocDB_Filter()
+ * @returns true to continue the scan or false to stop it.
+ */
+typedef bool (*microcDB_FilterCallback)(microcDB_Data *Match, microcDB_Data *Key,
+		void *Context);
+
+/**
+ * @brief This function scans the elements of the array list or the values of the object at given path and calls the callback for every
+ * element which is an object having the field matching the condition. Only the members of every element are compared, the objects and
+ * array lists inside them are skipped without parsing. For example: if DB is
+ * {"devices":{"d1":{"status":"ok"},"d2":{"status":"fault"}}} then path "devices./", field "status./", #FILTER_EQ and value "fault/"
+ * calls the callback for the object of "d2".
+ * @param *path : The path of array list or object. Path is the same as query language.
+ * @param *field : The key of the member to be compared terminated with "./" like "status./"
+ * @param Op : The condition. See #microcDB_FilterOp
+ * @param *value : The value to be compared terminated with '/' like "fault/" or "30/". Strings are given without quotes.
+ * @param Callback : The function called for every match
+ * @param *Context : This is given to callback as it is
+ * @note The pointers given to callback are valid only in the callback if MICROCDB_COMPRESSION is enabled. The callback should not
+ * change the DB.
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if at least one object matched #FOUND_SUCCESS = 3</li>
+ * <li>if no object matched #NOT_FOUND = 2</li>
+ * <li>if given path not found #PATH_NOT_FOUND = 11</li>
+ * <li>if the path is not an array list or object #PATH_NOT_ARRAYLIST = 12</li>
+ * <li>if an update job begun by MicrocDB_UpdateBegin() is pending #UPDATE_PENDING = 24</li>
+ * <li>if MICROCDB_SEQLOCK is enabled and the DB was written during the scan #READ_CONFLICT = 23. The callback is not called after
+ * the write so the scan should be done again</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_Filter(uint8_t *path, uint8_t *field,
+		microcDB_FilterOp Op, uint8_t *value, microcDB_FilterCallback Callback,
+		void *Context);
+
+/*Filter scans*/
+#endif
+
+#if MICROCDB_PROJECTION == 1
+/*Projection*/
+
+/**
+ * @brief This function gives the values of several members of the object at given path by visiting the object once, instead of
+ * calling MicrocDB_Find() for each of them. For example: if DB is {"status":{"temp":21,"hum":40,"name":"node1"}} then path
+ * "status./" and keys {"temp./","name./"} gives the values 21 and node1.
+ * @param *path : The path of object. Path is the same as query language.
+ * @param **keys : The keys of members terminated with "./" like "temp./"
+ * @param numberofkeys : The number of keys
+ * @param *Results : The array of numberofkeys structs where the value of every key is given at the index of key. They are same as
+ * given by MicrocDB_Find() for the path of member i.e DBstatus is #FOUND_SUCCESS = 3 if the member is present or #NOT_FOUND = 2.
+ * @note If MICROCDB_COMPRESSION is enabled then the pointers are valid only till the next call which reads DB.
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if the object is found #FOUND_SUCCESS = 3, the members may or may not be present</li>
+ * <li>if given path not found #PATH_NOT_FOUND = 11</li>
+ * <li>if the path is not an object #QUERY_INVALID = 8</li>
+ * <li>if an update job begun by MicrocDB_UpdateBegin() is pending #UPDATE_PENDING = 24</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_Project(uint8_t *path, uint8_t **keys,
+		uint8_t numberofkeys, microcDB_Data *Results);
+
+/*Projection*/
+#endif
+
+#if MICROCDB_COUNTERS == 1
+/*Counters*/
+
+/**
+ * @brief This function adds delta to the counter of the path. The counter is stored in its own flash region where every change is
+ * programmed once in a slot of the counter so the flash is not erased till the region is full. The counter starts at the integer value
+ * at the path in DB or 0 if the path is not present.
+ * @note The value in DB is not changed, the counter is read using MicrocDB_GetCounter().
+ * @param *path : The path of counter same as the query of MicrocDB_Find() like "trip.odometer./". It should not be longer than
+ * MICROCDB_COUNTER_KEY_SIZE including '/'
+ * @param delta : The value to be added
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if added #UPDATE_SUCCESSFUL = 9</li>
+ * <li>if the path is longer than MICROCDB_COUNTER_KEY_SIZE #QUERY_INVALID = 8</li>
+ * <li>if the value at the path in DB is not an integer #UPDATE_FAILED = 10</li>
+ * <li>if the counter would overflow int32_t #COUNTER_OVERFLOW = 30</li>
+ * <li>if the region of counters is full #FLASH_FULL = 7</li>
+ * <li>if writing to flash failed #STORE_FAILED = 1</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_Increment(uint8_t *path, int32_t delta);
+
+/**
+ * @brief This function subtracts delta from the counter of the path. It is same as MicrocDB_Increment() with -delta. If delta is
+ * INT32_MIN then #COUNTER_OVERFLOW = 30 is returned as -delta is not an int32_t.
+ */
+microcDB_Status MicrocDB_Decrement(uint8_t *path, int32_t delta);
+
+/**
+ * @brief This function gives the value of the counter of the path.
+ * @param *path : The path of counter same as given to MicrocDB_Increment()
+ * @param *Value : The value of counter. If the counter was never changed then it is the integer value at the path in DB
+ * @returns  The #microcDB_Status. <ul>
+ * <li>if the value is given #FOUND_SUCCESS = 3</li>
+ * <li>if the counter was never changed and the path has no integer in DB #NOT_FOUND = 2</li>
+ * </ul>
+ */
+microcDB_Status MicrocDB_GetCounter(uint8_t *path, int32_t *Value);
+
+/*Counters*/
+#endif
+
+#if MICROCDB_STATS == 1
+/*Engine statistics*/
+
+/**
+ * @brief This enum typedef indicates the type of API call to which the engine statistics are accounted. The work done inside a call is
+ * accounted to the type of that call even if it is done by other functions of microcDB.
+ */
+typedef enum {
+	/** MicrocDB_Init()*/
+	STATS_OP_INIT = 0,
+	/** MicrocDB_Insert(), MicrocDB_InsertRecord() and MicrocDB_CappedAppend()*/
+	STATS_OP_INSERT,
+	/** MicrocDB_Find(), MicrocDB_FindRecord(), MicrocDB_CappedNext(), MicrocDB_IndexFind(), MicrocDB_GetCounter() and
+	 * the aggregate, filter and projection queries*/
+	STATS_OP_FIND,
+	/** MicrocDB_Update(), MicrocDB_Increment() and MicrocDB_Decrement()*/
+	STATS_OP_UPDATE,
+	/** The other API calls like MicrocDB_RegisterSchema() or MicrocDB_SelectCollection()*/
+	STATS_OP_OTHER,
+	/** The number of types, not a type*/
+	STATS_OP_COUNT
+} microcDB_StatsOp;
+
+/**
+ * @brief This struct typedef has the counters of the work done by the engine for a type of API call.
+ */
+typedef struct {
+	/** The number of API calls of this type*/
+	uint32_t Calls;
+	/** The number of bytes examined by the JSON parser including the bytes scanned to find the matching brace or bracket*/
+	uint32_t ParserBytes;
+	/** The number of times the parser scanned an object or array list to find its matching brace or bracket and went back*/
+	uint32_t BracketRescans;
+	/** The number of ErasePage() calls*/
+	uint32_t PageErases;
+	/** The number of WritePage() calls*/
+	uint32_t PageWrites;
+	/** The number of word or half word program operations of flash*/
+	uint32_t WordsProgrammed;
+	/** The number of pages moved by shifting the database right to make space for an update*/
+	uint32_t ShiftPagesMoved;
+	/** The number of CalculateStringLength() calls i.e the walks till '/'*/
+	uint32_t StringLengthCalls;
+} microcDB_Stats;
+
+/**
+ * @brief This function copies the counters of the given type of API call.
+ * @param Op : The type of API call. #STATS_OP_COUNT gives the sum of all the types
+ * @param *Stats : The struct where the counters are copied
+ */
+void MicrocDB_GetStats(microcDB_StatsOp Op, microcDB_Stats *Stats);
+
+/**
+ * @brief This function sets all the counters to 0.
+ */
+void MicrocDB_ResetStats();
+
+/*Engine statistics*/
+#endif
+
+#if MICROCDB_LATENCY == 1
+/*Latency histograms*/
+
+/**
+ * @brief The number of buckets of every latency histogram. Bucket 0 has the latencies of 0 ticks and bucket n has the latencies from
+ * 2^(n-1) to 2^n - 1 ticks, the last bucket has all the longer latencies.
+ */
+#define MICROCDB_LATENCY_BUCKETS 32
+
+/**
+ * @brief This enum typedef indicates the operation whose latency is recorded.
+ */
+typedef enum {
+	/** MicrocDB_Insert()*/
+	LATENCY_OP_INSERT = 0,
+	/** MicrocDB_Find()*/
+	LATENCY_OP_FIND,
+	/** MicrocDB_Update()*/
+	LATENCY_OP_UPDATE,
+	/** ErasePage()*/
+	LATENCY_OP_ERASE_PAGE,
+	/** WritePage()*/
+	LATENCY_OP_WRITE_PAGE,
+	/** A word or half word program of WriteToFLASH() or WriteBytesToFLASH() including its verification*/
+	LATENCY_OP_PROGRAM,
+	/** The number of operations, not a operation*/
+	LATENCY_OP_COUNT
+} microcDB_LatencyOp;
+
+/**
+ * @brief This struct typedef has the latency distribution of an operation in ticks of MICROCDB_LATENCY_CLOCK(). The percentiles are the
+ * upper limit of the bucket where they lie so they are never less than the actual, and never more than Max.
+ */
+typedef struct {
+	/** The number of recorded latencies*/
+	uint32_t Count;
+	/** The median latency*/
+	uint32_t P50;
+	/** The 99th percentile latency*/
+	uint32_t P99;
+	/** The maximum latency*/
+	uint32_t Max;
+	/** The histogram. See MICROCDB_LATENCY_BUCKETS*/
+	uint32_t Buckets[MICROCDB_LATENCY_BUCKETS];
+} microcDB_Latency;
+
+/**
+ * @brief This function gives the latency distribution of the operation.
+ * @param Op : The operation
+ * @param *Latency : The struct where the distribution is copied
+ */
+void MicrocDB_GetLatency(microcDB_LatencyOp Op, microcDB_Latency *Latency);
+
+/**
+ * @brief This function clears the latency histograms of all the operations.
+ */
+void MicrocDB_ResetLatency();
+
+/*Latency histograms*/
+#endif
+
 /*Function prototypes of MicrocDB*/
 
 #endif /* MICROCDB_H_ */
@@ -51,6 +51,542 @@
 /*The maximum DB size*/
 #define MAX_DB_SIZE (MICROCDB_END_ADDR-MICROCDB_START_ADDR)
 
+/*Collections*/
+/**
+ * @brief The number of named collections other than the default collection at MICROCDB_START_ADDR..MICROCDB_END_ADDR. Every
+ * collection is a separate JSON tree in its own region with its own root and append address. Set to 0 to disable collections.
+ */
+#define MICROCDB_COLLECTIONS 0
+
+/**
+ * @brief The table of named collections. Every entry is {"name/", start address, end address}. The name should be terminated with '/'.
+ * The regions should start at first address of a page and should not overlap. Like MICROCDB_END_ADDR the end address of each region
+ * is used for the 0xDB init flag. For example:
+ * @code
+ * #define MICROCDB_COLLECTION_TABLE {"config/", 0x0800E000, 0x0800E7FF}, {"logs/", 0x0800E800, 0x0800F7FF}
+ * @endcode
+ */
+#define MICROCDB_COLLECTION_TABLE
+/*Collections*/
+
+/*Flash devices*/
+/**
+ * @brief The number of flash devices other than the internal flash, like SPI NOR chips. microcDB reads the flash through pointers so
+ * every device should be memory mapped(like the memory mapped mode of QSPI) and the addresses in its window are erased and programmed
+ * by its functions in MICROCDB_DEVICE_TABLE instead of the internal flash. The collections, the DB and the other regions can be
+ * placed in any window so they are sharded across the devices. An erase of a device is only begun and is waited for before the next
+ * erase or program of that device or at the beginning of the next call of microcDB. So a call does its other work while a device
+ * erases, and the erases of different devices overlap only within a call which erases both. The pages of one device are erased one
+ * after another. Set to 0 to disable it.
+ */
+#define MICROCDB_DEVICES 0
+
+/**
+ * @brief The table of flash devices. Every entry is {start address of window, end address of window, EraseBegin, Busy, Program}
+ * where the functions are:
+ * <ul>
+ * <li>bool EraseBegin(uint32_t PageAddress): begins the erase of PAGE_SIZE bytes from PageAddress and returns false if it couldn't.
+ * It should not wait for the erase to be completed</li>
+ * <li>bool Busy(void): returns true while the device is erasing or programming</li>
+ * <li>bool Program(uint32_t Address, uint8_t *Data, size_t NumberOfBytes): programs the bytes and returns false if it couldn't. It
+ * can return before the bytes are programmed</li>
+ * </ul>
+ * The window should start at first address of a page. For example:
+ * @code
+ * #define MICROCDB_DEVICE_TABLE {0x90000000, 0x907FFFFF, NorEraseBegin, NorBusy, NorProgram}
+ * @endcode
+ */
+#define MICROCDB_DEVICE_TABLE
+
+/**
+ * @brief The header file which declares the functions of MICROCDB_DEVICE_TABLE.
+ */
+#define MICROCDB_DEVICE_HEADER "flash_devices.h"
+/*Flash devices*/
+
+/*Object slack*/
+/**
+ * @brief The number of empty bytes reserved before the closing brace of every object when it is inserted. An update which adds a member
+ * to the object is only programmed in these bytes and an update which makes a value of the object longer or shorter rewrites only the
+ * pages of the object, so the DB is not shifted while the update fits in the slack. When it doesn't fit and MICROCDB_RELOCATION is
+ * disabled, the DB after the object is shifted by an even number of bytes to give it more slack. 0 disables it.
+ */
+#define MICROCDB_OBJECT_SLACK 0
+
+/**
+ * @brief The size of the RAM buffer in which MicrocDB_Find() copies the object or array list found without the slack. The data found is
+ * valid till the next MicrocDB_Find() of the same task. The larger ones are read by MicrocDB_StreamFound().
+ */
+#define MICROCDB_SLACK_FIND_BYTES 256
+/*Object slack*/
+
+/*Object relocation*/
+/**
+ * @brief Set this macro to 1 to relocate an object which outgrows its slack instead of shifting the DB after it. The grown object is
+ * written at the end of the relocation region and a forwarding marker to it is programmed in the old object, which MicrocDB_Find()
+ * follows. The last 9 bytes of the slack of every object are kept for the marker so MICROCDB_OBJECT_SLACK should be at least 9.
+ * The region is used as two banks, the superseded copies are reclaimed by copying the latest ones to the other bank when it is full.
+ */
+#define MICROCDB_RELOCATION 0
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory from where the relocated objects will be stored. It should be
+ * the first address of a page and outside the other regions of microcDB.
+ */
+#define MICROCDB_RELOCATION_START_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory till where the relocated objects will be stored. It should be
+ * the last address of a page and the region should have an even number of pages.
+ */
+#define MICROCDB_RELOCATION_END_ADDR -1
+/*Object relocation*/
+
+/*Snapshots*/
+/**
+ * @brief The number of snapshots which can be pinned at a time using MicrocDB_SnapshotBegin(). A pinned snapshot keeps seeing the DB as
+ * it was when it was pinned while the DB is updated, as the updates then only relocate the objects and don't change them in place.
+ * Every task has its own snapshot, so with MICROCDB_SEQLOCK the reader tasks read their snapshots while the writer task updates. It
+ * needs MICROCDB_RELOCATION. 0 disables it.
+ */
+#define MICROCDB_SNAPSHOTS 0
+/*Snapshots*/
+
+/*Key index*/
+/**
+ * @brief The number of slots of the RAM hash index of the top level keys of the root object. MicrocDB_Find() looks up the first part
+ * of query in it and searches the rest of query only in its value. It should be more than the number of top level keys, the keys which
+ * don't fit are searched as before. Every slot takes 16 bytes of RAM. Set to 0 to disable. It can't be used with MICROCDB_COMPRESSION.
+ */
+#define MICROCDB_KEY_INDEX_SIZE 0
+/*Key index*/
+
+/*Schema support*/
+/**
+ * @brief Set this macro to 1 to enable the schema compiled fixed layout records. See MicrocDB_RegisterSchema()
+ */
+#define MICROCDB_SCHEMA_SUPPORT 0
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory from where the schema records storage will begin. It should be
+ * the first address of a page and outside MICROCDB_START_ADDR..MICROCDB_END_ADDR
+ */
+#define MICROCDB_SCHEMA_START_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory till where the schema records will be stored
+ */
+#define MICROCDB_SCHEMA_END_ADDR -1
+
+/**
+ * @brief The maximum number of fields a schema can have. It should not be more than 32
+ */
+#define MICROCDB_SCHEMA_MAX_FIELDS 16
+
+/**
+ * @brief The maximum number of chars of a key of the schema field
+ */
+#define MICROCDB_SCHEMA_KEY_SIZE 16
+
+/**
+ * @brief The maximum size of a single record in bytes including the 2 bytes record header and the 2 bytes commit mark
+ */
+#define MICROCDB_SCHEMA_MAX_RECORD_SIZE 128
+/*Schema support*/
+
+/*Compression*/
+/**
+ * @brief Set this macro to 1 to store the documents compressed with LZ compression in blocks. MicrocDB_Find() decompresses the blocks
+ * transparently through a small cache of decompressed blocks.
+ * @note The compressed documents can't be updated in place, so MicrocDB_Update() returns UPDATE_FAILED when this is enabled.
+ */
+#define MICROCDB_COMPRESSION 0
+
+/**
+ * @brief The maximum number of uncompressed bytes of a block. A document including its '/' should fit in a single block. Every
+ * cached block takes this much RAM. It should be less than 8192 and even.
+ */
+#define MICROCDB_COMP_BLOCK_SIZE FLASH_PAGE_SIZE
+
+/**
+ * @brief The number of decompressed blocks kept in the RAM cache
+ */
+#define MICROCDB_COMP_CACHE_BLOCKS 2
+
+/**
+ * @brief The maximum number of bytes of the Bloom filter kept in the header of every block over the keys of its documents.
+ * MicrocDB_Find() doesn't decompress the blocks whose filter rules out any part of the query, so the lookups of keys which are not
+ * stored don't decompress the whole DB. The filter of a block has about 14 bits for every key of it, which rules out more than 99% of
+ * the blocks without the key, so a block of few documents has a small filter. By default it is a bit for every byte of block, which
+ * is enough for a full block of members of about 14 bytes. It should be even. Set to 0 to disable, which makes the stored blocks unreadable. The filter is only in the
+ * compressed blocks, the uncompressed DB is not filtered, see MICROCDB_KEY_INDEX_SIZE for its top level keys.
+ */
+#define MICROCDB_COMP_BLOOM_BYTES ((MICROCDB_COMP_BLOCK_SIZE / 16) * 2)
+
+/**
+ * @brief Set this macro to 1 to keep a persistent hash index on the value at MICROCDB_HASH_INDEX_PATH of every stored document.
+ * See MicrocDB_IndexFind(). Without MICROCDB_COMPRESSION the index is kept current by the updates, and the shifts of DB move the
+ * slots of the documents after the shift which costs two programmings of every such slot.
+ */
+#define MICROCDB_HASH_INDEX 0
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory from where the hash index will be stored. It should be the first
+ * address of a page and outside the other regions of microcDB. Every page is a bucket of FLASH_PAGE_SIZE / 8 documents.
+ */
+#define MICROCDB_HASH_INDEX_START_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory till where the hash index will be stored. It should be the last
+ * address of a page. The number of pages should be enough for all the documents as the index can't be grown.
+ */
+#define MICROCDB_HASH_INDEX_END_ADDR -1
+
+/**
+ * @brief The query of the indexed value in every document like "id./"
+ */
+#define MICROCDB_HASH_INDEX_PATH "id./"
+/*Compression*/
+
+/*Capped collection*/
+/**
+ * @brief Set this macro to 1 to enable the capped collection. It is a ring buffer of documents in its own flash region, when the region
+ * is full the page having the oldest documents is erased and reused. See MicrocDB_CappedAppend()
+ */
+#define MICROCDB_CAPPED_SUPPORT 0
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory from where the capped collection will begin. It should be
+ * the first address of a page and outside the other regions of microcDB
+ */
+#define MICROCDB_CAPPED_START_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory till where the capped collection will be stored. It should be
+ * the last address of a page. The region should have at least 2 pages
+ */
+#define MICROCDB_CAPPED_END_ADDR -1
+
+/**
+ * @brief Set this macro to 1 to keep the minimum and maximum timestamp of the documents of each page of capped collection in the page
+ * header. The time range iteration using MicrocDB_CappedIterRange() then skips the pages which don't have documents of the range.
+ */
+#define MICROCDB_CAPPED_TS_INDEX 0
+
+/**
+ * @brief The query of the timestamp in every document of capped collection. The timestamp should be an unsigned integer like
+ * seconds since epoch.
+ */
+#define MICROCDB_CAPPED_TS_PATH "t./"
+/*Capped collection*/
+
+/*Engine statistics*/
+/**
+ * @brief Set this macro to 1 to count the work done by the engine like bytes scanned by parser, flash erases and programs per type of
+ * API call. See MicrocDB_GetStats(). When 0 the counters are not compiled.
+ */
+#define MICROCDB_STATS 0
+/*Engine statistics*/
+
+/*Latency histograms*/
+/**
+ * @brief Set this macro to 1 to record the latency of MicrocDB_Insert(), MicrocDB_Find(), MicrocDB_Update() and the flash primitives
+ * in log2 bucketed histograms. See MicrocDB_GetLatency(). When 0 the clock is never read and nothing is compiled.
+ */
+#define MICROCDB_LATENCY 0
+
+/**
+ * @brief The clock used for latency. It should give a free running uint32_t count of ticks, the wrap around is handled. For example
+ * on Cortex-M3/M4 the DWT cycle counter (DWT->CYCCNT) after enabling it, or on Linux emulator a function returning the nanoseconds
+ * from clock_gettime(). If it is a function then declare it in this file also. The default HAL_GetTick() gives milliseconds.
+ */
+#define MICROCDB_LATENCY_CLOCK() HAL_GetTick()
+/*Latency histograms*/
+
+/*Aggregates*/
+/**
+ * @brief Set this macro to 1 to enable the aggregate queries which give count, sum, minimum, maximum and mean of the numbers of an array
+ * list or object in a single pass over flash. See MicrocDB_Aggregate().
+ */
+#define MICROCDB_AGGREGATES 0
+/*Aggregates*/
+
+/*Filter scans*/
+/**
+ * @brief Set this macro to 1 to enable the filter scans which give the objects of an array list or object whose field matches a
+ * condition. See MicrocDB_Filter().
+ */
+#define MICROCDB_FILTER 0
+/*Filter scans*/
+
+/*Projection*/
+/**
+ * @brief Set this macro to 1 to enable the projection queries which give several members of an object in a single pass. See
+ * MicrocDB_Project().
+ */
+#define MICROCDB_PROJECTION 0
+/*Projection*/
+
+/*Counters*/
+/**
+ * @brief Set this macro to 1 to enable the counters which are incremented and decremented without erasing the flash. See
+ * MicrocDB_Increment().
+ */
+#define MICROCDB_COUNTERS 0
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory from where the counters will be stored. It should be the first
+ * address of a page and outside the other regions of microcDB.
+ */
+#define MICROCDB_COUNTER_START_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory till where the counters will be stored. It should be the last
+ * address of a page. The region is used as two banks so it should have even number of pages, at least 2.
+ */
+#define MICROCDB_COUNTER_END_ADDR -1
+
+/**
+ * @brief The maximum length of path of a counter including the '/'. It should be even.
+ */
+#define MICROCDB_COUNTER_KEY_SIZE 16
+
+/**
+ * @brief The number of increments or decrements stored in a slot of counter before the slot is moved. Every one of them takes 2 bytes.
+ */
+#define MICROCDB_COUNTER_DELTAS 64
+/*Counters*/
+
+/*Array list segments*/
+/**
+ * @brief Set this macro to 1 to enable MicrocDB_UpdateArrayList(). The appended elements are stored in overflow segments in their own
+ * flash region which are chained to the array list, so the DB is not shifted for an append.
+ */
+#define MICROCDB_ARRAY_SEGMENTS 0
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory from where the overflow segments will be stored. It should be the
+ * first address of a page and outside the other regions of microcDB.
+ */
+#define MICROCDB_ARRAY_START_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory till where the overflow segments will be stored. It should be the
+ * last address of a page.
+ */
+#define MICROCDB_ARRAY_END_ADDR -1
+
+/**
+ * @brief The size of the RAM buffer in which MicrocDB_Find() joins the elements of an array list stored in DB with the ones appended to
+ * it. The array list found is valid till the next MicrocDB_Find() of the same task.
+ */
+#define MICROCDB_ARRAY_FIND_BYTES 256
+/*Array list segments*/
+
+/*Single writer*/
+/**
+ * @brief Set this macro to 1 to call microcDB from one writer task and several reader tasks at the same time without a mutex. The
+ * writer increments a sequence counter before and after MicrocDB_Insert(), MicrocDB_Update(), MicrocDB_UpdateArrayList(),
+ * MicrocDB_CappedAppend(), MicrocDB_InsertRecord() and MicrocDB_EraseRecords(). MicrocDB_Find(), MicrocDB_Aggregate(),
+ * MicrocDB_Project(), MicrocDB_CappedNext(), MicrocDB_FindRecord() and the array list iterator check it and read again if it was
+ * written while they read it. MicrocDB_Filter() gives #READ_CONFLICT instead as its callback can't be called again. The state of the
+ * parser is kept per task so the readers don't wait for each other. The counters are not covered so they should be used only by the
+ * writer task, and MicrocDB_Init() and MicrocDB_RegisterSchema() should be called before the reader tasks are started. It can't be used
+ * with MICROCDB_COMPRESSION, MICROCDB_COLLECTIONS or MICROCDB_KEY_INDEX_SIZE as their state in RAM is shared by all the tasks.
+ */
+#define MICROCDB_SEQLOCK 0
+
+/**
+ * @brief The ports of the single writer mode.
+ */
+#define MICROCDB_PORT_FREERTOS 1
+#define MICROCDB_PORT_PTHREADS 2
+
+/**
+ * @brief The port used by the single writer mode. MICROCDB_PORT_FREERTOS for FreeRTOS tasks, which needs the thread local storage of C
+ * runtime(configUSE_C_RUNTIME_TLS_SUPPORT) for the state of parser, or MICROCDB_PORT_PTHREADS for Linux pthreads for testing on the
+ * host with flash emulator.
+ */
+#define MICROCDB_SEQLOCK_PORT MICROCDB_PORT_FREERTOS
+/*Single writer*/
+
+/*Update jobs*/
+/**
+ * @brief Set this macro to 1 to enable the update jobs. MicrocDB_UpdateBegin() begins an update which shifts the DB as a job and
+ * MicrocDB_UpdateStep() rewrites a given number of pages of it per call, so the time a call takes is bounded. The job is journaled
+ * in flash so if power is lost in the middle of it, it is completed by MicrocDB_Init().
+ */
+#define MICROCDB_UPDATE_JOBS 0
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory from where the journal of update job is stored. The region
+ * should have 2 pages, the first is the journal and the second is the backup of the page being rewritten. It should be the first
+ * address of a page and outside the other regions of microcDB.
+ */
+#define MICROCDB_JOB_START_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory till where the journal of update job is stored. It should be
+ * the last address of a page.
+ */
+#define MICROCDB_JOB_END_ADDR -1
+/*Update jobs*/
+
+/*Incremental backup*/
+/**
+ * @brief Set this macro to 1 to enable the incremental backup. Every page of the region MICROCDB_START_ADDR..MICROCDB_END_ADDR which
+ * is changed is logged once per checkpoint, so MicrocDB_Backup() streams only the pages changed since a checkpoint and
+ * MicrocDB_Restore() writes them back. The regions of MICROCDB_RELOCATION, MICROCDB_ARRAY_SEGMENTS and MICROCDB_COUNTERS are not
+ * streamed so it can't be used with them.
+ */
+#define MICROCDB_BACKUP 0
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory from where the log of changed pages is stored. It should be the
+ * first address of a page and outside the other regions of microcDB. Every change of a page after a checkpoint takes 2 bytes, and
+ * when the log is full it is erased so the older checkpoints are lost and a backup since them streams all the pages.
+ */
+#define MICROCDB_BACKUP_START_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory till where the log of changed pages is stored. It should be
+ * the last address of a page.
+ */
+#define MICROCDB_BACKUP_END_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory from where MicrocDB_Restore() stages the pages of stream before
+ * they are written to DB. It should be the first address of a page and outside the other regions of microcDB.
+ */
+#define MICROCDB_BACKUP_STAGE_START_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory till where the pages of stream are staged. It should be the last
+ * address of a page, and the stage should have a page more than the region of DB.
+ */
+#define MICROCDB_BACKUP_STAGE_END_ADDR -1
+/*Incremental backup*/
+
+/*Change feed*/
+/**
+ * @brief Set this macro to 1 to enable the change feed. Every successful MicrocDB_Insert(), MicrocDB_Update(),
+ * MicrocDB_UpdateArrayList(), MicrocDB_UpdateBegin(), MicrocDB_Increment(), MicrocDB_CappedAppend() and MicrocDB_InsertRecord() gives
+ * a record with a sequence number to the callback registered by MicrocDB_ChangeFeed(), and MicrocDB_ApplyChange() does the change of
+ * a record on a replica.
+ */
+#define MICROCDB_CHANGE_FEED 0
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory from where the sequence numbers of the change feed and of the
+ * records applied are stored. It should be the first address of a page and outside the other regions of microcDB. The region is used
+ * as two banks so it should have even number of pages.
+ */
+#define MICROCDB_CHANGE_FEED_START_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory till where the sequence numbers of the change feed are stored.
+ * It should be the last address of a page.
+ */
+#define MICROCDB_CHANGE_FEED_END_ADDR -1
+/*Change feed*/
+
+/*Memtable*/
+/**
+ * @brief The number of bytes of RAM in which MicrocDB_Insert() and MicrocDB_Update() are buffered. The buffered writes are applied to
+ * DB together when the buffer or its journal is full or MicrocDB_Sync() is called, and the updates of a buffered value replace it. Every
+ * buffered write takes 24 bytes on a 32 bit MCU with its path and value. Set to 0 to disable.
+ */
+#define MICROCDB_MEMTABLE_BYTES 0
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory from where the journal of buffered writes is stored. It should
+ * be the first address of a page and outside the other regions of microcDB. The journal is erased when the writes are applied.
+ */
+#define MICROCDB_MEMTABLE_LOG_START_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory till where the journal of buffered writes is stored. It should
+ * be the last address of a page.
+ */
+#define MICROCDB_MEMTABLE_LOG_END_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory from where the undo log of buffered writes is stored. Every page
+ * of DB is copied to it before it is first changed by applying the writes, so the writes whose applying was interrupted by a power loss
+ * are rolled back and applied again by MicrocDB_Init(). It should be the first address of a page and outside the other regions of
+ * microcDB.
+ */
+#define MICROCDB_MEMTABLE_UNDO_START_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address of Flash memory till where the undo log of buffered writes is stored. It should
+ * be the last address of a page, and the undo log should have a page more than the region of DB.
+ */
+#define MICROCDB_MEMTABLE_UNDO_END_ADDR -1
+
+/**
+ * @brief The size of the RAM buffer in which MicrocDB_Find() copies the value found with the buffered writes in it, or found in a
+ * buffered write. The value is valid till the next MicrocDB_Find().
+ */
+#define MICROCDB_MEMTABLE_FIND_BYTES 256
+/*Memtable*/
+
+/*Tiering*/
+/**
+ * @brief Set this macro to 1 to keep the frequently accessed top level members of the documents in the DB (hot tier) and move the
+ * others to the cold tier, which can be in a slower and larger memory like a memory mapped external flash of MICROCDB_DEVICE_TABLE.
+ * The accesses are counted by MicrocDB_Find() and the members are moved by MicrocDB_TierStep(), which should be called when the
+ * application is idle. MicrocDB_Find() searches the cold tier when the query is not found in the DB. It needs MICROCDB_UPDATE_JOBS.
+ */
+#define MICROCDB_TIERING 0
+
+/**
+ * @brief This macro is used to set the memory address from where the cold tier is stored. It should be the first address of a page
+ * and outside the other regions of microcDB. The region is used as two banks so it should have even number of pages.
+ */
+#define MICROCDB_COLD_START_ADDR -1
+
+/**
+ * @brief This macro is used to set the memory address till where the cold tier is stored. It should be the last address of a page.
+ */
+#define MICROCDB_COLD_END_ADDR -1
+
+/**
+ * @brief The number of top level keys whose accesses are counted in RAM. The keys which are not counted are the coldest. Every key
+ * takes 12 bytes of RAM.
+ */
+#define MICROCDB_TIER_KEYS 16
+
+/**
+ * @brief The number of bytes of DB used above which MicrocDB_TierStep() moves the coldest member to the cold tier.
+ */
+#define MICROCDB_TIER_HOT_BYTES ((MICROCDB_END_ADDR + 1 - MICROCDB_START_ADDR) / 2)
+
+/**
+ * @brief The counts of accesses are halved after every this number of calls of MicrocDB_TierStep(), so they count the recent accesses.
+ * No member is moved to the cold tier before the first halving.
+ */
+#define MICROCDB_TIER_AGE_STEPS 8
+
+/**
+ * @brief The number of recent accesses of a member in the cold tier after which MicrocDB_TierStep() moves it back to the DB.
+ */
+#define MICROCDB_TIER_PROMOTE_HITS 4
+
+/**
+ * @brief The number of bytes of RAM of the Bloom filter of the keys moved to the cold tier. MicrocDB_Find() of a query which is not in
+ * the DB reads the cold tier only if its first part may be in the filter. The filter is the best for about a key per 10 bits. Set this
+ * macro to 0 to read the cold tier for every such query.
+ */
+#define MICROCDB_TIER_BLOOM_BYTES 64
+
+/**
+ * @brief The maximum number of page operations of the update job moving a member done by a call of MicrocDB_TierStep(). The job is
+ * continued by the next calls, so a call takes a bounded time.
+ */
+#define MICROCDB_TIER_STEP_PAGE_OPS 4
+/*Tiering*/
+
 /**
  * @brief Error checkers and indicator macros
  *  **/
@@ -71,4 +607,200 @@
 #error "MicrocDB Error:Please define the macro of ending database address named as MICROCDB_END_ADDR microcDB_config.h file."
 #endif
 
+#if MICROCDB_SCHEMA_SUPPORT == 1
+#if MICROCDB_SCHEMA_START_ADDR == -1 || MICROCDB_SCHEMA_END_ADDR == -1
+#error "MicrocDB Error:Please define the macros MICROCDB_SCHEMA_START_ADDR and MICROCDB_SCHEMA_END_ADDR in microcDB_config.h file or disable MICROCDB_SCHEMA_SUPPORT."
+#endif
+#if MICROCDB_SCHEMA_MAX_FIELDS > 32
+#error "MicrocDB Error:MICROCDB_SCHEMA_MAX_FIELDS should not be more than 32 in microcDB_config.h file."
+#endif
+#endif
+
+#if MICROCDB_COMPRESSION == 1 && MICROCDB_COMP_CACHE_BLOCKS < 1
+#error "MicrocDB Error:MICROCDB_COMP_CACHE_BLOCKS should be at least 1 in microcDB_config.h file."
+#endif
+
+#if MICROCDB_OBJECT_SLACK > 0 && MICROCDB_SLACK_FIND_BYTES < 2
+#error "MicrocDB Error:MICROCDB_SLACK_FIND_BYTES should be at least 2 in microcDB_config.h file."
+#endif
+
+#if MICROCDB_COMPRESSION == 1 && MICROCDB_OBJECT_SLACK > 0
+#error "MicrocDB Error:MICROCDB_OBJECT_SLACK should be 0 when MICROCDB_COMPRESSION is enabled as the compressed documents are not updated in microcDB_config.h file."
+#endif
+
+#if MICROCDB_RELOCATION == 1
+#if MICROCDB_RELOCATION_START_ADDR == -1 || MICROCDB_RELOCATION_END_ADDR == -1
+#error "MicrocDB Error:Please define the macros MICROCDB_RELOCATION_START_ADDR and MICROCDB_RELOCATION_END_ADDR in microcDB_config.h file or disable MICROCDB_RELOCATION."
+#endif
+#if MICROCDB_OBJECT_SLACK < 9
+#error "MicrocDB Error:MICROCDB_OBJECT_SLACK should be at least 9 when MICROCDB_RELOCATION is enabled in microcDB_config.h file."
+#endif
+#if ((MICROCDB_RELOCATION_END_ADDR + 1 - MICROCDB_RELOCATION_START_ADDR) % (2 * PAGE_SIZE)) != 0
+#error "MicrocDB Error:The region of MICROCDB_RELOCATION should have an even number of pages in microcDB_config.h file."
+#endif
+#if MICROCDB_COLLECTIONS > 0
+#error "MicrocDB Error:MICROCDB_RELOCATION can't be used with MICROCDB_COLLECTIONS in microcDB_config.h file."
+#endif
+#endif
+
+#if MICROCDB_SNAPSHOTS > 0 && MICROCDB_RELOCATION == 0
+#error "MicrocDB Error:MICROCDB_SNAPSHOTS needs MICROCDB_RELOCATION to be enabled in microcDB_config.h file."
+#endif
+
+#if MICROCDB_COMPRESSION == 1 && MICROCDB_KEY_INDEX_SIZE > 0
+#error "MicrocDB Error:MICROCDB_KEY_INDEX_SIZE should be 0 when MICROCDB_COMPRESSION is enabled in microcDB_config.h file."
+#endif
+
+#if MICROCDB_HASH_INDEX == 1
+#if MICROCDB_COLLECTIONS > 0
+#error "MicrocDB Error:MICROCDB_HASH_INDEX can't be used with MICROCDB_COLLECTIONS in microcDB_config.h file."
+#endif
+#if MICROCDB_HASH_INDEX_START_ADDR == -1 || MICROCDB_HASH_INDEX_END_ADDR == -1
+#error "MicrocDB Error:Please define the macros MICROCDB_HASH_INDEX_START_ADDR and MICROCDB_HASH_INDEX_END_ADDR in microcDB_config.h file or disable MICROCDB_HASH_INDEX."
+#endif
+#if MAX_DB_SIZE >= 0x100000
+#error "MicrocDB Error:MICROCDB_HASH_INDEX supports the DB of less than 1MB in microcDB_config.h file."
+#endif
+#endif
+
+#if MICROCDB_COMPRESSION == 1 && (MICROCDB_COMP_BLOOM_BYTES & 1)
+#error "MicrocDB Error:MICROCDB_COMP_BLOOM_BYTES should be even in microcDB_config.h file."
+#endif
+
+#if MICROCDB_CAPPED_SUPPORT == 1
+#if MICROCDB_CAPPED_START_ADDR == -1 || MICROCDB_CAPPED_END_ADDR == -1
+#error "MicrocDB Error:Please define the macros MICROCDB_CAPPED_START_ADDR and MICROCDB_CAPPED_END_ADDR in microcDB_config.h file or disable MICROCDB_CAPPED_SUPPORT."
+#endif
+#endif
+
+#if MICROCDB_COUNTERS == 1
+#if MICROCDB_COUNTER_START_ADDR == -1 || MICROCDB_COUNTER_END_ADDR == -1
+#error "MicrocDB Error:Please define the macros MICROCDB_COUNTER_START_ADDR and MICROCDB_COUNTER_END_ADDR in microcDB_config.h file or disable MICROCDB_COUNTERS."
+#endif
+#if ((MICROCDB_COUNTER_END_ADDR + 1 - MICROCDB_COUNTER_START_ADDR) / PAGE_SIZE) < 2 || (((MICROCDB_COUNTER_END_ADDR + 1 - MICROCDB_COUNTER_START_ADDR) / PAGE_SIZE) & 1)
+#error "MicrocDB Error:The region of MICROCDB_COUNTERS should have even number of pages in microcDB_config.h file."
+#endif
+#if (MICROCDB_COUNTER_KEY_SIZE & 1) || MICROCDB_COUNTER_KEY_SIZE < 2 || MICROCDB_COUNTER_DELTAS < 1
+#error "MicrocDB Error:MICROCDB_COUNTER_KEY_SIZE should be even and MICROCDB_COUNTER_DELTAS at least 1 in microcDB_config.h file."
+#endif
+#endif
+
+#if MICROCDB_ARRAY_SEGMENTS == 1
+#if MICROCDB_ARRAY_START_ADDR == -1 || MICROCDB_ARRAY_END_ADDR == -1
+#error "MicrocDB Error:Please define the macros MICROCDB_ARRAY_START_ADDR and MICROCDB_ARRAY_END_ADDR in microcDB_config.h file or disable MICROCDB_ARRAY_SEGMENTS."
+#endif
+#if MICROCDB_COLLECTIONS > 0
+#error "MicrocDB Error:MICROCDB_ARRAY_SEGMENTS can't be used with MICROCDB_COLLECTIONS in microcDB_config.h file."
+#endif
+#if MICROCDB_ARRAY_FIND_BYTES < 2
+#error "MicrocDB Error:MICROCDB_ARRAY_FIND_BYTES should be at least 2 in microcDB_config.h file."
+#endif
+#endif
+
+#if MICROCDB_SEQLOCK == 1
+#if MICROCDB_SEQLOCK_PORT != MICROCDB_PORT_FREERTOS && MICROCDB_SEQLOCK_PORT != MICROCDB_PORT_PTHREADS
+#error "MicrocDB Error:MICROCDB_SEQLOCK_PORT should be MICROCDB_PORT_FREERTOS or MICROCDB_PORT_PTHREADS in microcDB_config.h file."
+#endif
+#if MICROCDB_COMPRESSION == 1 || MICROCDB_COLLECTIONS > 0 || MICROCDB_KEY_INDEX_SIZE > 0
+#error "MicrocDB Error:MICROCDB_SEQLOCK can't be used with MICROCDB_COMPRESSION, MICROCDB_COLLECTIONS or MICROCDB_KEY_INDEX_SIZE in microcDB_config.h file."
+#endif
+#endif
+
+#if MICROCDB_UPDATE_JOBS == 1
+#if MICROCDB_JOB_START_ADDR == -1 || MICROCDB_JOB_END_ADDR == -1
+#error "MicrocDB Error:Please define the macros MICROCDB_JOB_START_ADDR and MICROCDB_JOB_END_ADDR in microcDB_config.h file or disable MICROCDB_UPDATE_JOBS."
+#endif
+#if (MICROCDB_JOB_END_ADDR + 1 - MICROCDB_JOB_START_ADDR) < 2 * PAGE_SIZE
+#error "MicrocDB Error:The region of MICROCDB_UPDATE_JOBS should have 2 pages in microcDB_config.h file."
+#endif
+#if MICROCDB_COMPRESSION == 1 || MICROCDB_COLLECTIONS > 0
+#error "MicrocDB Error:MICROCDB_UPDATE_JOBS can't be used with MICROCDB_COMPRESSION or MICROCDB_COLLECTIONS in microcDB_config.h file."
+#endif
+#endif
+
+#if MICROCDB_DEVICES > 0 && MICROCDB_SEQLOCK == 1
+#error "MicrocDB Error:MICROCDB_DEVICES can't be used with MICROCDB_SEQLOCK as the reader tasks would wait for the erases of devices in microcDB_config.h file."
+#endif
+
+#if MICROCDB_BACKUP == 1
+#if MICROCDB_BACKUP_START_ADDR == -1 || MICROCDB_BACKUP_END_ADDR == -1
+#error "MicrocDB Error:Please define the macros MICROCDB_BACKUP_START_ADDR and MICROCDB_BACKUP_END_ADDR in microcDB_config.h file or disable MICROCDB_BACKUP."
+#endif
+#if (MICROCDB_BACKUP_END_ADDR + 1 - MICROCDB_BACKUP_START_ADDR) < 8 + (4 * ((MICROCDB_END_ADDR + 1 - MICROCDB_START_ADDR) / PAGE_SIZE))
+#error "MicrocDB Error:The region of MICROCDB_BACKUP should have at least 4 bytes for every page of DB in microcDB_config.h file."
+#endif
+#if MICROCDB_COLLECTIONS > 0
+#error "MicrocDB Error:MICROCDB_BACKUP can't be used with MICROCDB_COLLECTIONS in microcDB_config.h file."
+#endif
+#if MICROCDB_RELOCATION == 1 || MICROCDB_ARRAY_SEGMENTS == 1 || MICROCDB_COUNTERS == 1
+#error "MicrocDB Error:MICROCDB_BACKUP can't be used with MICROCDB_RELOCATION, MICROCDB_ARRAY_SEGMENTS or MICROCDB_COUNTERS as their regions are not streamed in microcDB_config.h file."
+#endif
+#if MICROCDB_BACKUP_STAGE_START_ADDR == -1 || MICROCDB_BACKUP_STAGE_END_ADDR == -1
+#error "MicrocDB Error:Please define the macros MICROCDB_BACKUP_STAGE_START_ADDR and MICROCDB_BACKUP_STAGE_END_ADDR in microcDB_config.h file or disable MICROCDB_BACKUP."
+#endif
+#if (MICROCDB_BACKUP_STAGE_END_ADDR + 1 - MICROCDB_BACKUP_STAGE_START_ADDR) < (MICROCDB_END_ADDR + 1 - MICROCDB_START_ADDR) + PAGE_SIZE
+#error "MicrocDB Error:The region of MICROCDB_BACKUP_STAGE should have a page more than the region of DB in microcDB_config.h file."
+#endif
+#if 8 + (2 * ((MICROCDB_END_ADDR + 1 - MICROCDB_START_ADDR) / PAGE_SIZE)) > PAGE_SIZE
+#error "MicrocDB Error:The header of MICROCDB_BACKUP_STAGE should fit in a page, with 2 bytes for every page of DB in microcDB_config.h file."
+#endif
+#endif
+
+#if MICROCDB_CHANGE_FEED == 1
+#if MICROCDB_CHANGE_FEED_START_ADDR == -1 || MICROCDB_CHANGE_FEED_END_ADDR == -1
+#error "MicrocDB Error:Please define the macros MICROCDB_CHANGE_FEED_START_ADDR and MICROCDB_CHANGE_FEED_END_ADDR in microcDB_config.h file or disable MICROCDB_CHANGE_FEED."
+#endif
+#if ((MICROCDB_CHANGE_FEED_END_ADDR + 1 - MICROCDB_CHANGE_FEED_START_ADDR) / PAGE_SIZE) < 2 || (((MICROCDB_CHANGE_FEED_END_ADDR + 1 - MICROCDB_CHANGE_FEED_START_ADDR) / PAGE_SIZE) & 1)
+#error "MicrocDB Error:The region of MICROCDB_CHANGE_FEED should have even number of pages in microcDB_config.h file."
+#endif
+#endif
+
+#if MICROCDB_MEMTABLE_BYTES > 0
+#if MICROCDB_MEMTABLE_LOG_START_ADDR == -1 || MICROCDB_MEMTABLE_LOG_END_ADDR == -1
+#error "MicrocDB Error:Please define the macros MICROCDB_MEMTABLE_LOG_START_ADDR and MICROCDB_MEMTABLE_LOG_END_ADDR in microcDB_config.h file or set MICROCDB_MEMTABLE_BYTES to 0."
+#endif
+#if MICROCDB_MEMTABLE_UNDO_START_ADDR == -1 || MICROCDB_MEMTABLE_UNDO_END_ADDR == -1
+#error "MicrocDB Error:Please define the macros MICROCDB_MEMTABLE_UNDO_START_ADDR and MICROCDB_MEMTABLE_UNDO_END_ADDR in microcDB_config.h file or set MICROCDB_MEMTABLE_BYTES to 0."
+#endif
+#if (MICROCDB_MEMTABLE_UNDO_END_ADDR + 1 - MICROCDB_MEMTABLE_UNDO_START_ADDR) < (MICROCDB_END_ADDR + 1 - MICROCDB_START_ADDR) + PAGE_SIZE
+#error "MicrocDB Error:The undo log of MICROCDB_MEMTABLE_BYTES should have a page more than the region of DB in microcDB_config.h file."
+#endif
+#if 2 + (2 * ((MICROCDB_END_ADDR + 1 - MICROCDB_START_ADDR) / PAGE_SIZE)) > PAGE_SIZE
+#error "MicrocDB Error:The header of undo log of MICROCDB_MEMTABLE_BYTES should fit in a page, with 2 bytes for every page of DB in microcDB_config.h file."
+#endif
+#if MICROCDB_MEMTABLE_BYTES > 0xFFF0
+#error "MicrocDB Error:MICROCDB_MEMTABLE_BYTES should be less than 65520 in microcDB_config.h file."
+#endif
+#if MICROCDB_MEMTABLE_FIND_BYTES < 4
+#error "MicrocDB Error:MICROCDB_MEMTABLE_FIND_BYTES should be at least 4 in microcDB_config.h file."
+#endif
+#if MICROCDB_COMPRESSION == 1 || MICROCDB_COLLECTIONS > 0 || MICROCDB_SEQLOCK == 1 || MICROCDB_SNAPSHOTS > 0 || MICROCDB_UPDATE_JOBS == 1
+#error "MicrocDB Error:MICROCDB_MEMTABLE_BYTES can't be used with MICROCDB_COMPRESSION, MICROCDB_COLLECTIONS, MICROCDB_SEQLOCK, MICROCDB_SNAPSHOTS or MICROCDB_UPDATE_JOBS in microcDB_config.h file."
+#endif
+#if MICROCDB_RELOCATION == 1
+#error "MicrocDB Error:MICROCDB_MEMTABLE_BYTES can't be used with MICROCDB_RELOCATION as the relocated copies are not rolled back with the undo log in microcDB_config.h file."
+#endif
+#endif
+
+#if MICROCDB_TIERING == 1
+#if MICROCDB_COLD_START_ADDR == -1 || MICROCDB_COLD_END_ADDR == -1
+#error "MicrocDB Error:Please define the macros MICROCDB_COLD_START_ADDR and MICROCDB_COLD_END_ADDR in microcDB_config.h file or disable MICROCDB_TIERING."
+#endif
+#if MICROCDB_UPDATE_JOBS == 0
+#error "MicrocDB Error:MICROCDB_TIERING needs MICROCDB_UPDATE_JOBS to be enabled in microcDB_config.h file."
+#endif
+#if MICROCDB_RELOCATION == 1 || MICROCDB_ARRAY_SEGMENTS == 1 || MICROCDB_SEQLOCK == 1 || MICROCDB_BACKUP == 1
+#error "MicrocDB Error:MICROCDB_TIERING can't be used with MICROCDB_RELOCATION, MICROCDB_ARRAY_SEGMENTS, MICROCDB_SEQLOCK or MICROCDB_BACKUP in microcDB_config.h file."
+#endif
+#if MICROCDB_TIER_KEYS < 1 || MICROCDB_TIER_AGE_STEPS < 1 || MICROCDB_TIER_PROMOTE_HITS < 1 || MICROCDB_TIER_PROMOTE_HITS > 255
+#error "MicrocDB Error:MICROCDB_TIER_KEYS, MICROCDB_TIER_AGE_STEPS and MICROCDB_TIER_PROMOTE_HITS should be at least 1 and MICROCDB_TIER_PROMOTE_HITS at most 255 in microcDB_config.h file."
+#endif
+#if MICROCDB_TIER_STEP_PAGE_OPS < 1 || MICROCDB_TIER_STEP_PAGE_OPS > 0xFFFF
+#error "MicrocDB Error:MICROCDB_TIER_STEP_PAGE_OPS should be from 1 to 65535 in microcDB_config.h file."
+#endif
+#if ((MICROCDB_COLD_END_ADDR + 1 - MICROCDB_COLD_START_ADDR) / PAGE_SIZE) < 2 || (((MICROCDB_COLD_END_ADDR + 1 - MICROCDB_COLD_START_ADDR) / PAGE_SIZE) & 1)
+#error "MicrocDB Error:The region of MICROCDB_TIERING should have even number of pages in microcDB_config.h file."
+#endif
+#endif
+
 #endif /* MICROCDB_CONFIG_H_ */
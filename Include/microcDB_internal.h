@@ -0,0 +1,512 @@
+/* Author: Mrunal Ahirao
+ * Description: The internal header file of microcDB. It is included by the sources of microcDB only and has the declarations
+ * which are shared between them. Applications should include microDB.h instead.
+ */
+
+#ifndef MICROCDB_INTERNAL_H_
+#define MICROCDB_INTERNAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "microcDB_config.h"
+#include "flash_drivers.h"
+#include "microDB.h"
+#include "microcDB_jsonparser.h"
+
+/*The region of the selected collection. The sources of microcDB should use these instead of MICROCDB_START_ADDR and
+ * MICROCDB_END_ADDR for the JSON tree*/
+#if MICROCDB_COLLECTIONS > 0
+extern uint32_t DBRegionStart, DBRegionEnd;
+#define DB_START_ADDR DBRegionStart
+#define DB_END_ADDR DBRegionEnd
+#else
+#define DB_START_ADDR MICROCDB_START_ADDR
+#define DB_END_ADDR MICROCDB_END_ADDR
+#endif
+
+/*Flash devices. DEVICES_SYNC waits for the erases begun on the devices so their windows can be read. Every public API function
+ * which reads or writes the DB begins with it so the erases begun by the previous call are completed*/
+#if MICROCDB_DEVICES > 0
+/*Device functions defined in microcDB_devices.c. They are used by the flash drivers for the addresses in the windows of devices*/
+
+/*This function gives the device whose window has the address or -1 if it is in the internal flash*/
+int8_t DeviceOf(uint32_t Address);
+
+/*This function waits for the device and begins the erase of page*/
+flash_mem_Stat DeviceErasePage(int8_t Device, uint32_t PageAddress);
+
+/*This function waits for the device, programs the bytes and verifies them*/
+flash_mem_Stat DeviceProgram(int8_t Device, uint32_t Address, uint8_t *Data,
+		size_t NumberOfBytes);
+
+/*This function waits for all the devices*/
+void DevicesSync();
+
+/*Device functions*/
+#define DEVICES_SYNC() DevicesSync()
+#else
+#define DEVICES_SYNC() do { } while (0)
+#endif
+
+/*Engine statistics. The public API functions mark the type of call using STATS_BEGIN and the counters are added to that type using
+ * STATS_ADD. Both compile to nothing when MICROCDB_STATS is 0*/
+#if MICROCDB_STATS == 1
+extern microcDB_Stats EngineStats[STATS_OP_COUNT];
+extern MICROCDB_THREAD_LOCAL microcDB_StatsOp CurrentStatsOp;
+#define STATS_BEGIN(Op) do { CurrentStatsOp = (Op); EngineStats[(Op)].Calls++; } while (0)
+#define STATS_ADD(Counter, Count) (EngineStats[CurrentStatsOp].Counter += (uint32_t) (Count))
+#else
+#define STATS_BEGIN(Op) do { } while (0)
+#define STATS_ADD(Counter, Count) do { } while (0)
+#endif
+
+/*Latency histograms. LATENCY_BEGIN reads the clock to a local variable so it should be used at the start of a block and LATENCY_END
+ * records the ticks elapsed since then in the histogram of the operation. Both compile to nothing when MICROCDB_LATENCY is 0*/
+#if MICROCDB_LATENCY == 1
+/*This function adds the latency to the histogram of the operation. Defined in microcDB_latency.c*/
+void LatencyRecord(microcDB_LatencyOp Op, uint32_t Ticks);
+#define LATENCY_BEGIN() uint32_t LatencyStart = MICROCDB_LATENCY_CLOCK()
+#define LATENCY_END(Op) LatencyRecord((Op), MICROCDB_LATENCY_CLOCK() - LatencyStart)
+#else
+#define LATENCY_BEGIN() do { } while (0)
+#define LATENCY_END(Op) do { } while (0)
+#endif
+
+/*Internal MISC functions shared between the sources of microcDB. These are defined in microDB.c*/
+
+/*This function calculates the length of string by searching the first occurrence of slash character*/
+size_t CalculateStringLength(uint8_t *string);
+
+/*This function will replace the ' with " in a JSON String of given length*/
+void replacesingleTodouble(uint8_t *JSON_String, size_t len);
+
+/*This function converts the ASCII integer between the Start and End pointers(both inclusive) to int32_t.
+ * Returns false if any char between the pointers is not part of integer*/
+bool AsciiToInteger(uint8_t *Start, uint8_t *End, int32_t *Value);
+
+/*This function converts the ASCII decimal number between the Start and End pointers(both inclusive) to float.
+ * Returns false if any char between the pointers is not part of decimal number*/
+bool AsciiToFloat(uint8_t *Start, uint8_t *End, float *Value);
+
+/*This function skips the JSON value(string, object, array list, number or bool) starting at Value without parsing inside it and
+ * returns the address of its last byte which is not more than End*/
+uint8_t* SkipJSONValue(uint8_t *Value, uint8_t *End);
+
+/*This function skips the empty bytes of the slack reserved in objects(see MICROCDB_OBJECT_SLACK) starting at ptr and returns the first
+ * byte which is not empty or End. The slack is only before the comma or closing brace after a member and after the opening brace*/
+static inline uint8_t* SkipSlack(uint8_t *ptr, uint8_t *End) {
+#if MICROCDB_OBJECT_SLACK > 0
+	while (ptr < End && *ptr == (uint8_t) FL_EMPTY_BYTE)
+		ptr++;
+#else
+	(void) End;
+#endif
+	return ptr;
+}
+
+#if MICROCDB_OBJECT_SLACK > 0
+/*This function gives the closing brace or bracket of the object or array list having the value which starts at Value*/
+uint8_t* EnclosingEnd(uint8_t *Value);
+
+/*This function gives the first empty byte of the slack before ObjectEnd which is the closing brace of object*/
+uint8_t* SlackStartOf(uint8_t *ObjectEnd);
+
+/*This function copies the object or array list found to the RAM buffer of MICROCDB_SLACK_FIND_BYTES without the slack and forwarding
+ * markers and points the data to it. It is used for the data given to the application*/
+void SlackCompact(microcDB_Data *Data);
+
+#define SLACK_COMPACT(Data) SlackCompact((Data))
+#else
+#define SLACK_COMPACT(Data) do { } while (0)
+#endif
+
+/*This function fills the microcDB_Data for the JSON value from Value till ValueEnd in the same way as MicrocDB_Find()*/
+void ValueToData(uint8_t *Value, uint8_t *ValueEnd, microcDB_Data *Data);
+
+/*This function searches the query in the JSON document starting at DocumentStart and terminated with '/'. The document can be
+ * in flash or RAM*/
+microcDB_Data FindInDocument(uint8_t *query, uint8_t *DocumentStart,
+		uint8_t *DocumentEnd);
+
+/*This function searches the query in the selected collection(in the compressed blocks if compression is enabled)*/
+microcDB_Data FindPath(uint8_t *query);
+
+/*This function stores the JSON objects of the string to the selected collection. It is the body of MicrocDB_Insert()*/
+microcDB_Status InsertObjects(uint8_t *JSONString,
+		unsigned int numberofobjects);
+
+/*This function updates the value at the path in the selected collection. It is the body of MicrocDB_Update()*/
+microcDB_Status UpdateValue(uint8_t *path, uint8_t *value);
+
+/*This function sets the FlashAddresscntr to the first empty address of the selected collection. It is used after the DB is written
+ * other than by inserting. Returns INIT_CMPLT or FLASH_FULL*/
+microcDB_Status FindAppendAddress();
+
+/*Internal MISC functions*/
+
+#if MICROCDB_COMPRESSION == 1
+/*Compression functions defined in microcDB_compress.c*/
+
+/*This function invalidates the block cache and returns the address after the last stored block*/
+uint32_t CompressedInit();
+
+/*This function stores the objects of the JSON string compressed in blocks*/
+microcDB_Status CompressedInsert(uint8_t *JSONString,
+		unsigned int numberofobjects);
+
+/*This function searches the query in every document of every stored block*/
+microcDB_Data CompressedFind(uint8_t *query);
+
+/*This function gives the document of given ordinal(0 for first) in the block stored at BlockAddress. The document is decompressed to
+ * cache. Returns 0 if there is no such document, then Status is CACHE_FULL if the block couldn't be decompressed as all the blocks of
+ * cache are pinned or NOT_FOUND*/
+uint8_t* CompressedDocument(uint32_t BlockAddress, uint16_t Ordinal,
+		uint8_t **BlockEnd, microcDB_Status *Status);
+
+/*This function gives the address of the block stored after the block at BlockAddress*/
+uint32_t CompressedNextBlock(uint32_t BlockAddress);
+
+#if MICROCDB_HASH_INDEX == 1
+/*This function erases the hash index and adds all the stored blocks to it. It is used after the DB is restored*/
+microcDB_Status CompressedReindex();
+#endif
+
+/*This function pins the entry of block cache having the found data till it is given to MicrocDB_Release()*/
+void CompressedPin(microcDB_Data *Data);
+
+/*Compression functions*/
+#endif
+
+#if MICROCDB_HASH_INDEX == 1
+/*Hash index functions defined in microcDB_hashindex.c*/
+
+/*This function counts the used slots of the index*/
+void HashIndexInit();
+
+/*This function erases the index. It is used when DB is erased*/
+flash_mem_Stat HashIndexErase();
+
+#if MICROCDB_COMPRESSION == 1
+/*This function checks if the index has free slots for all the documents of the block which have the indexed value*/
+bool HashIndexHasRoom(uint8_t *Data, uint16_t Length);
+
+/*This function adds the documents of the block stored at BlockAddress to the index*/
+microcDB_Status HashIndexAddBlock(uint8_t *Data, uint16_t Length,
+		uint32_t BlockAddress);
+#else
+/*This function adds the documents inserted from Start to FlashAddresscntr to the index*/
+void HashIndexAppend(uint8_t *Start);
+
+/*This function adds the slot of the document whose value at path was updated successfully if its indexed value was changed*/
+void HashIndexUpdated(uint8_t *path);
+
+/*This function moves the slots of the documents after the DB from Cut was shifted by Delta bytes*/
+void HashIndexShift(uint8_t *Cut, int32_t Delta);
+
+/*This function erases the index and adds all the stored documents to it. It is used after the DB is restored*/
+microcDB_Status HashIndexRebuild();
+#endif
+
+/*Hash index functions*/
+#endif
+
+#if MICROCDB_HASH_INDEX == 1 && MICROCDB_COMPRESSION == 0
+#define HASH_INDEX_APPEND(Start) HashIndexAppend(Start)
+#define HASH_INDEX_UPDATED(path) HashIndexUpdated(path)
+#define HASH_INDEX_SHIFT(Cut, Delta) HashIndexShift((Cut), (Delta))
+#else
+#define HASH_INDEX_APPEND(Start) do { (void) (Start); } while (0)
+#define HASH_INDEX_UPDATED(path) do { } while (0)
+#define HASH_INDEX_SHIFT(Cut, Delta) do { (void) (Cut); } while (0)
+#endif
+
+#if MICROCDB_RELOCATION == 1
+/*Object relocation functions defined in microcDB_relocate.c*/
+
+/*The size of forwarding marker. It is programmed in the end of the slack of the relocated object so these bytes of the slack are not
+ * used by the updates*/
+#define RELOCATION_MARKER_SIZE 8
+#define SLACK_RESERVED RELOCATION_MARKER_SIZE
+
+/*This checks if the address is in a relocated object and so not in the region of DB*/
+#define RELOCATED(Address) ((uint8_t*) (Address) >= (uint8_t*) MICROCDB_RELOCATION_START_ADDR \
+		&& (uint8_t*) (Address) <= (uint8_t*) MICROCDB_RELOCATION_END_ADDR)
+
+/*This function finds the active bank and the address after the last relocated object in it*/
+void RelocationInit();
+
+/*This function erases the relocated objects. It is used when DB is erased*/
+flash_mem_Stat RelocationErase();
+
+/*This function follows the forwarding markers of the object from Start till End and gives the latest copy of it in them.
+ * Returns false if the object was not relocated*/
+bool RelocationFollow(uint8_t **Start, uint8_t **End);
+
+/*This function writes the grown copy of the object having the updated value and forwards the object to it. Returns false if the
+ * object can't be relocated, otherwise the status of update is given in Status*/
+bool RelocateUpdate(microcDB_Data *FindResult, uint8_t *value, size_t len,
+		microcDB_Status *Status);
+
+/*This function gives the address where next relocated object will be written. It increases with every relocation till the superseded
+ * records are reclaimed, which is not done while a snapshot is pinned, so it is the generation of the DB seen by a snapshot*/
+uint32_t RelocationGeneration();
+
+/*This function copies the latest record of every relocated object to the other bank and erases the superseded ones. It should not be
+ * called while a snapshot is pinned. Returns false if the flash operations failed*/
+bool RelocationReclaim();
+
+/*Object relocation functions*/
+#else
+#define SLACK_RESERVED 0
+#define RELOCATED(Address) false
+#endif
+
+#if MICROCDB_SNAPSHOTS > 0
+/*Snapshot functions defined in microcDB_snapshot.c*/
+
+/*The address from which the relocated objects are not seen by the snapshot being read by the task. It is 0 when the latest data is
+ * read*/
+extern MICROCDB_THREAD_LOCAL uint8_t *SnapshotLimit;
+
+/*This function checks if any snapshot is pinned*/
+bool SnapshotPinned();
+
+/*This function unpins all the snapshots. It is used when DB is erased*/
+void SnapshotsRelease();
+
+/*Snapshot functions*/
+#define SNAPSHOT_PINNED() SnapshotPinned()
+#else
+#define SNAPSHOT_PINNED() false
+#endif
+
+#if MICROCDB_SEQLOCK == 1
+/*Single writer functions defined in microcDB_seqlock.c*/
+
+/*This function makes the sequence of writes odd as the writer task starts writing the DB*/
+void SeqWriteBegin();
+
+/*This function makes the sequence of writes even again as the writer task completed writing the DB*/
+void SeqWriteEnd();
+
+/*This function waits till the DB is not being written and gives the sequence of writes*/
+uint32_t SeqReadBegin();
+
+/*This function checks if the DB was written since SeqReadBegin() gave the sequence*/
+bool SeqReadRetry(uint32_t Sequence);
+
+/*These functions enter and exit the critical section in which the state in RAM shared by the reader tasks is changed*/
+void SeqCriticalEnter();
+void SeqCriticalExit();
+
+/*Single writer functions*/
+#define SEQ_WRITE_BEGIN() SeqWriteBegin()
+#define SEQ_WRITE_END() SeqWriteEnd()
+#define SEQ_CRITICAL_ENTER() SeqCriticalEnter()
+#define SEQ_CRITICAL_EXIT() SeqCriticalExit()
+/*The reading statement is done again till the DB is not written during it*/
+#define SEQ_READ(Statement) do { uint32_t ReadSequence; do { ReadSequence = SeqReadBegin(); Statement; } \
+		while (SeqReadRetry(ReadSequence)); } while (0)
+#else
+#define SEQ_WRITE_BEGIN() do { } while (0)
+#define SEQ_WRITE_END() do { } while (0)
+#define SEQ_CRITICAL_ENTER() do { } while (0)
+#define SEQ_CRITICAL_EXIT() do { } while (0)
+#define SEQ_READ(Statement) Statement
+#endif
+
+#if MICROCDB_UPDATE_JOBS == 1
+/*Update job functions defined in microcDB_updatejob.c*/
+
+/*This function checks if an update job is journaled and not completed*/
+bool UpdateJobPending();
+
+/*This function completes the update job which was pending when power was lost. Returns false if it couldn't be completed*/
+bool UpdateJobResume();
+
+/*This function journals the job which replaces the bytes of DB from offset Cut till CutEnd(exclusive) with the separator if given and
+ * the len bytes of value. Returns UPDATE_PENDING if journaled, NO_MEMORY or UPDATE_FAILED*/
+microcDB_Status UpdateJobBegin(uint32_t Cut, uint32_t CutEnd,
+		uint8_t *Separator, uint8_t *value, uint16_t len,
+		microcDB_UpdateJob *Job);
+
+/*Update job functions*/
+#define UPDATE_JOB_PENDING() UpdateJobPending()
+#else
+#define UPDATE_JOB_PENDING() false
+#endif
+
+#if MICROCDB_MEMTABLE_BYTES > 0
+/*Memtable functions defined in microcDB_memtable.c*/
+
+/*This function restores the pages of DB changed by the writes whose applying was interrupted by the power loss. It is used by Init
+ * before the DB is initialized. Returns false if they couldn't be restored*/
+bool MemtableRollback();
+
+/*This function applies the writes journaled but not applied when power was lost and erases the journal. It is used by Init after the
+ * DB is initialized. Returns false if they couldn't be applied*/
+bool MemtableInit();
+
+/*This function erases the journal and the undo log and drops the buffered writes. It is used when DB is erased*/
+flash_mem_Stat MemtableErase();
+
+/*This function saves the pages of DB having the bytes from Address which are going to be changed by applying the writes. It is called
+ * by the flash drivers*/
+void MemtableTrack(uint32_t Address, uint32_t NumberOfBytes);
+
+/*This function buffers the JSON objects to be inserted. Returns the status same as MicrocDB_Insert()*/
+microcDB_Status MemtableInsert(uint8_t *JSONString,
+		unsigned int numberofobjects);
+
+/*This function buffers the update of value at path. Returns the status same as MicrocDB_Update()*/
+microcDB_Status MemtableUpdate(uint8_t *path, uint8_t *value);
+
+/*This function searches the query in the buffered writes and DB*/
+microcDB_Data MemtableFind(uint8_t *query);
+
+/*Memtable functions*/
+#define MEMTABLE_TRACK(Address, NumberOfBytes) MemtableTrack((uint32_t) (Address), (NumberOfBytes))
+#else
+#define MEMTABLE_TRACK(Address, NumberOfBytes) do { } while (0)
+#endif
+
+#if MICROCDB_TIERING == 1
+/*Tiering functions defined in microcDB_tiering.c*/
+
+/*This function finds the address after the last complete record of the cold tier*/
+void TierInit();
+
+/*This function erases the cold tier. It is used when DB is erased*/
+flash_mem_Stat TierErase();
+
+/*This function counts an access of the top level key of query found in the hot tier*/
+void TierTouch(uint8_t *query);
+
+/*This function searches the query in the latest record of its top level key in the cold tier and counts the access*/
+microcDB_Data TierFind(uint8_t *query);
+
+/*This function checks if the top level key of path is in the cold tier and if so it is promoted by the next MicrocDB_TierStep()*/
+bool TierCold(uint8_t *path);
+
+/*Tiering functions*/
+#define TIER_COLD(path) TierCold(path)
+#else
+#define TIER_COLD(path) false
+#endif
+
+#if MICROCDB_BACKUP == 1
+/*Incremental backup functions defined in microcDB_backup.c*/
+
+/*This function finds the end of the log of changed pages and the pages changed since the last checkpoint. The stage of a restore
+ * which was interrupted by the power loss is written to DB again*/
+microcDB_Status BackupInit();
+
+/*This function completes the restore whose stage was written by BackupInit(), after the DB is initialized*/
+microcDB_Status BackupResume();
+
+/*This function logs the pages of DB having the bytes from Address which are going to be changed. It is called by the flash drivers*/
+void BackupTrack(uint32_t Address, uint32_t NumberOfBytes);
+
+/*Incremental backup functions*/
+#define BACKUP_TRACK(Address, NumberOfBytes) BackupTrack((uint32_t) (Address), (NumberOfBytes))
+#else
+#define BACKUP_TRACK(Address, NumberOfBytes) do { } while (0)
+#endif
+
+#if MICROCDB_CHANGE_FEED == 1
+/*Change feed functions defined in microcDB_changefeed.c*/
+
+/*This function reads the sequence numbers of the change feed and the replica from their region*/
+microcDB_Status ChangeInit();
+
+/*This function logs the sequence number of the change going to be done, before it is done, so it isn't given again after a reset*/
+void ChangeBegin();
+
+/*This function gives the record of the change to the callback of change feed*/
+void ChangeEmit(microcDB_ChangeType Type, uint16_t Count, uint8_t *path,
+		uint8_t *value);
+
+/*This function gives the record of CHANGE_INCREMENT with the delta as its value*/
+void ChangeEmitIncrement(uint8_t *path, int32_t delta);
+
+/*Change feed functions*/
+#define CHANGE_BEGIN() ChangeBegin()
+#define CHANGE_EMIT(Type, Count, path, value) ChangeEmit((Type), (Count), (path), (value))
+#define CHANGE_EMIT_INCREMENT(path, delta) ChangeEmitIncrement((path), (delta))
+#else
+#define CHANGE_BEGIN() do { } while (0)
+#define CHANGE_EMIT(Type, Count, path, value) do { } while (0)
+#define CHANGE_EMIT_INCREMENT(path, delta) do { } while (0)
+#endif
+
+#if MICROCDB_KEY_INDEX_SIZE > 0
+/*Key index functions defined in microcDB_keyindex.c*/
+
+/*This function rebuilds the index of the top level keys of the documents of selected collection. It is called when the DB is
+ initialized, restored or another collection is selected*/
+void KeyIndexBuild();
+
+/*This function adds the top level keys of the documents inserted from Start to FlashAddresscntr*/
+void KeyIndexAppend(uint8_t *Start);
+
+/*This function updates the entries after the value at path was updated successfully*/
+void KeyIndexUpdated(uint8_t *path);
+
+/*This function moves the entries after the DB from Cut was shifted by Delta bytes*/
+void KeyIndexShift(uint8_t *Cut, int32_t Delta);
+
+/*This function searches the query starting at the value of its first part found using the index*/
+microcDB_Data KeyIndexFind(uint8_t *query);
+
+/*Key index functions*/
+#define KEY_INDEX_BUILD() KeyIndexBuild()
+#define KEY_INDEX_APPEND(Start) KeyIndexAppend(Start)
+#define KEY_INDEX_UPDATED(path) KeyIndexUpdated(path)
+#define KEY_INDEX_SHIFT(Cut, Delta) KeyIndexShift((Cut), (Delta))
+#else
+#define KEY_INDEX_BUILD() do { } while (0)
+#define KEY_INDEX_APPEND(Start) do { (void) (Start); } while (0)
+#define KEY_INDEX_UPDATED(path) do { } while (0)
+#define KEY_INDEX_SHIFT(Cut, Delta) do { } while (0)
+#endif
+
+#if MICROCDB_ARRAY_SEGMENTS == 1
+/*Array list segment functions defined in microcDB_arraylist.c*/
+
+/*This function finds the address after the last overflow segment. The segments which were not completely written are skipped*/
+void ArraySegmentsInit();
+
+/*This function erases the overflow segments. It is used when DB is erased*/
+flash_mem_Stat ArraySegmentsErase();
+
+/*This function gives the first overflow segment of the array list at path or 0 if nothing was appended to it*/
+uint8_t* ArraySegmentFirst(uint8_t *path);
+
+/*This function gives the overflow segment linked after the given one or 0 if it is the last*/
+uint8_t* ArraySegmentNext(uint8_t *Segment);
+
+/*This function gives the starting bracket of the array list of appended elements of the segment and its ending bracket in End*/
+uint8_t* ArraySegmentList(uint8_t *Segment, uint8_t **End);
+
+/*This function joins the appended elements to the array list found at path in the RAM buffer of MICROCDB_ARRAY_FIND_BYTES and points the
+ * data to it. The data is not changed if it is not an array list or nothing was appended to it*/
+void ArraySegmentsJoin(uint8_t *path, microcDB_Data *Data);
+
+#define ARRAY_SEGMENTS_JOIN(path, Data) ArraySegmentsJoin((path), (Data))
+/*Array list segment functions*/
+#else
+#define ARRAY_SEGMENTS_JOIN(path, Data) do { } while (0)
+#endif
+
+#if MICROCDB_COUNTERS == 1
+/*This function finds the active bank of counters and the first free slot in it. Defined in microcDB_counter.c*/
+microcDB_Status CounterInit();
+#endif
+
+#if MICROCDB_CAPPED_SUPPORT == 1
+/*This function finds the newest page and the append address of capped collection. Defined in microcDB_capped.c*/
+microcDB_Status CappedInit();
+#endif
+
+#endif /* MICROCDB_INTERNAL_H_ */
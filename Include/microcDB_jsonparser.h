@@ -6,19 +6,7 @@
 #define MICROCDB_JSONPARSER_H_
 
 #include <stdint.h>
-
-/*
- * JSON types typedef used to indicate the data indicated is of what type of JSON.
- */
-typedef enum{
-	JSON_OBJ,
-	JSON_STRING,
-	JSON_ARRAY,
-	JSON_BOOL,
-	JSON_PRIMITIVE,
-	JSON_END,
-	JSON_UNDEFINED
-}JSON_Type;
+#include "microDB.h" /*The JSON_Type typedef is shared with the interface of microcDB*/
 
 /*
  * The parser typedef which gives following information:
@@ -31,8 +19,16 @@ typedef struct {
 	uint8_t *End;
 } microcDB_json_parser;
 
-extern uint8_t *microcDBStartAddr;
-extern uint8_t *microcDBEndAddr;
+/*In the single writer mode(see MICROCDB_SEQLOCK) the state of parser and of the call being done is kept per task so that the tasks can
+ * parse at the same time*/
+#if MICROCDB_SEQLOCK == 1
+#define MICROCDB_THREAD_LOCAL __thread
+#else
+#define MICROCDB_THREAD_LOCAL
+#endif
+
+extern MICROCDB_THREAD_LOCAL uint8_t *microcDBStartAddr;
+extern MICROCDB_THREAD_LOCAL uint8_t *microcDBEndAddr;
 
 /*Function prototypes of json parser*/
 
@@ -9,11 +9,14 @@
  */
 
 #include "flash_drivers.h"
+#include <microcDB_internal.h>
 
 /*Flash related struct for STM32*/
 static FLASH_EraseInitTypeDef EraseInitStruct;
 static uint32_t PageError = 0;
 
+uint32_t FlashAddresscntr = 0;/*The flash address counter which will always point to next empty address*/
+
 /**************************************************************************************************************************************/
 /*MicrocDB Low level functions*/
 
@@ -24,8 +27,26 @@ static uint32_t PageError = 0;
  * Returns: the flash_mem_Stat ERASE_SUCCESS or ERASE_FAILED
  * */
 inline flash_mem_Stat ErasePage(uint8_t *AddressOfPage) {
+#if MICROCDB_DEVICES > 0
+	flash_mem_Stat DeviceStatus;
+#endif
+	LATENCY_BEGIN();
 
+	BACKUP_TRACK(AddressOfPage, PAGE_SIZE); /*The page is logged before it is changed*/
+	MEMTABLE_TRACK(AddressOfPage, PAGE_SIZE); /*and saved if the buffered writes are being applied*/
 	PageError = 0;
+	STATS_ADD(PageErases, 1);
+
+#if MICROCDB_DEVICES > 0
+	/*The pages in the windows of devices are erased by their functions*/
+	int8_t Device = DeviceOf((uint32_t) AddressOfPage);
+	if (Device >= 0) {
+		/*The latency has the wait for the previous operation of device and the beginning of erase*/
+		DeviceStatus = DeviceErasePage(Device, (uint32_t) AddressOfPage);
+		LATENCY_END(LATENCY_OP_ERASE_PAGE);
+		return DeviceStatus;
+	}
+#endif
 
 	HAL_FLASH_Unlock();
 
@@ -36,9 +57,11 @@ inline flash_mem_Stat ErasePage(uint8_t *AddressOfPage) {
 
 	if (HAL_FLASHEx_Erase(&EraseInitStruct, &PageError) == HAL_OK) {
 		HAL_FLASH_Lock();
+		LATENCY_END(LATENCY_OP_ERASE_PAGE);
 		return ERASE_SUCCESS;
 	} else {
 		HAL_FLASH_Lock();
+		LATENCY_END(LATENCY_OP_ERASE_PAGE);
 		return ERASE_FAILED;
 	}
 }
@@ -52,13 +75,31 @@ inline flash_mem_Stat ErasePage(uint8_t *AddressOfPage) {
  */
 inline flash_mem_Stat WritePage(uint32_t *ptrToEditedData,
 		uint32_t *AddressOfPage, size_t NumberOfBytes) {
-
+#if MICROCDB_DEVICES > 0
+	flash_mem_Stat DeviceStatus;
+#endif
+	LATENCY_BEGIN();
+
+	BACKUP_TRACK(AddressOfPage, NumberOfBytes);
+	MEMTABLE_TRACK(AddressOfPage, NumberOfBytes);
+	STATS_ADD(PageWrites, 1);
+
+#if MICROCDB_DEVICES > 0
+	int8_t Device = DeviceOf((uint32_t) AddressOfPage);
+	if (Device >= 0) {
+		DeviceStatus = DeviceProgram(Device, (uint32_t) AddressOfPage,
+				(uint8_t*) ptrToEditedData, NumberOfBytes);
+		LATENCY_END(LATENCY_OP_WRITE_PAGE);
+		return DeviceStatus;
+	}
+#endif
 	HAL_FLASH_Unlock();
 
 	uint32_t storeddata;
 	uint16_t bytecntr = 0;
 	while (bytecntr < NumberOfBytes) {
 
+		STATS_ADD(WordsProgrammed, 1);
 		if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, (uint32_t) AddressOfPage,
 				*ptrToEditedData) == HAL_OK) {
 
@@ -73,6 +114,7 @@ inline flash_mem_Stat WritePage(uint32_t *ptrToEditedData,
 	};
 
 	HAL_FLASH_Lock();
+	LATENCY_END(LATENCY_OP_WRITE_PAGE);
 
 	if (bytecntr >= PAGE_SIZE) {
 		return FL_STORE_SUCCESS;
@@ -81,35 +123,56 @@ inline flash_mem_Stat WritePage(uint32_t *ptrToEditedData,
 }
 
 /*
- * This function will erase the Flash between the addresses given by MICROCDB_START_ADDR and MICROCDB_END_ADDR if
+ * This function will erase the Flash between the given addresses(normally MICROCDB_START_ADDR and MICROCDB_END_ADDR) if
  * not erased before and writes 0xDB to end address to indicate the flash is initialized for microcDB.
  * Returns: the flash_mem_Stat ERASE_SUCCESS or ERASE_FAILED
  * */
-flash_mem_Stat EraseDB() {
+flash_mem_Stat EraseDB(uint32_t StartAddress, uint32_t EndAddress) {
 
 	uint8_t *i;
-	i = (uint8_t*) MICROCDB_START_ADDR; // Assign the start address of the database to the pointer
+	i = (uint8_t*) StartAddress; // Assign the start address of the database to the pointer
+	BACKUP_TRACK(StartAddress, EndAddress + 1 - StartAddress);
+	MEMTABLE_TRACK(StartAddress, EndAddress + 1 - StartAddress);
 	PageError = 0;
 
+#if MICROCDB_DEVICES > 0
+	int8_t Device = DeviceOf(StartAddress);
+	if (Device >= 0) {
+		/*The pages of the window of one device are erased one after another, every erase waits for the previous one*/
+		uint32_t Page;
+		uint8_t Flag = 0xDB;
+		for (Page = StartAddress; Page < EndAddress; Page = Page + PAGE_SIZE) {
+			if (DeviceErasePage(Device, Page) != ERASE_SUCCESS) {
+				return ERASE_FAILED;
+			}
+		}
+		if (DeviceProgram(Device, EndAddress, &Flag, 1) != FL_STORE_SUCCESS) {
+			return ERASE_FAILED;
+		}
+	} else {
+#endif
+
 	HAL_FLASH_Unlock();
 
 	/* Fill EraseInit structure*/
 	EraseInitStruct.TypeErase = FLASH_TYPEERASE_PAGES;
-	EraseInitStruct.PageAddress = MICROCDB_START_ADDR;
-	EraseInitStruct.NbPages = (MICROCDB_END_ADDR - MICROCDB_START_ADDR)
-			/ PAGE_SIZE;
+	EraseInitStruct.PageAddress = StartAddress;
+	EraseInitStruct.NbPages = (EndAddress - StartAddress) / PAGE_SIZE;
 	EraseInitStruct.NbPages++;
+	STATS_ADD(PageErases, EraseInitStruct.NbPages);
 	HAL_FLASHEx_Erase(&EraseInitStruct, &PageError);
 
 	/*Write the flag 0xDB to last byte to indicate that memory is initialized for microcDB*/
-	HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, (uint32_t) MICROCDB_END_ADDR,
-			0xDB);
+	HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, EndAddress, 0xDB);
 
 	HAL_FLASH_Lock();
+#if MICROCDB_DEVICES > 0
+	}
+#endif
 	uint16_t emp_cntr = 0;
 
 	/*Check if the pages in database are erased successfully*/
-	while (i < (uint8_t*) MICROCDB_END_ADDR) {
+	while (i < (uint8_t*) EndAddress) {
 		if (*i == FL_EMPTY_BYTE) {
 			emp_cntr++; //increment the counter for every empty byte
 		} else {
@@ -119,8 +182,8 @@ flash_mem_Stat EraseDB() {
 	}
 
 	/*The emp_cntr should be equal to MAX bytes as byte by byte checking is done for empty memory area */
-	if (((uint16_t) MAX_DB_SIZE - emp_cntr) <= 2) {
-		FlashAddresscntr = MICROCDB_START_ADDR; // Assign the Start of DB address to counter as this is the first time the database will will be initialized.
+	if (((uint16_t) (EndAddress - StartAddress) - emp_cntr) <= 2) {
+		FlashAddresscntr = StartAddress; // Assign the Start of DB address to counter as this is the first time the database will will be initialized.
 		return ERASE_SUCCESS;
 	} else
 		return ERASE_FAILED;
@@ -135,6 +198,25 @@ flash_mem_Stat EraseDB() {
 flash_mem_Stat WriteToFLASH(uint8_t data1, uint8_t data2, uint8_t data3,
 		uint8_t data4) {
 
+	BACKUP_TRACK(FlashAddresscntr, 4);
+	MEMTABLE_TRACK(FlashAddresscntr, 4);
+
+#if MICROCDB_DEVICES > 0
+	int8_t Device = DeviceOf(FlashAddresscntr);
+	if (Device >= 0) {
+		/*Same as below the half word is written if the third byte is 0*/
+		uint8_t Bytes[4] = { data1, data2, data3, data4 };
+		size_t NumberOfBytes = data3 != 0 ? 4 : 2;
+		STATS_ADD(WordsProgrammed, 1);
+		if (DeviceProgram(Device, FlashAddresscntr, Bytes, NumberOfBytes)
+				!= FL_STORE_SUCCESS) {
+			return FL_STORE_FAILED;
+		}
+		FlashAddresscntr = FlashAddresscntr + NumberOfBytes;
+		return FL_STORE_SUCCESS;
+	}
+#endif
+
 	HAL_FLASH_Unlock();
 
 	if (data3 != 0) { /*If full 32 bit data is given to write then proceed with word write*/
@@ -145,10 +227,14 @@ flash_mem_Stat WriteToFLASH(uint8_t data1, uint8_t data2, uint8_t data3,
 		u32data_to_store |= data2 << 8;
 		u32data_to_store |= data1;
 
+		STATS_ADD(WordsProgrammed, 1);
+		LATENCY_BEGIN();
+
 		if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, FlashAddresscntr,
 				u32data_to_store) == HAL_OK) {
 
 			storeddata = *(uint32_t*) FlashAddresscntr;
+			LATENCY_END(LATENCY_OP_PROGRAM);
 			/*Verify if stored correctly*/
 			if (storeddata == u32data_to_store) {
 				FlashAddresscntr = FlashAddresscntr + 4;
@@ -169,10 +255,13 @@ flash_mem_Stat WriteToFLASH(uint8_t data1, uint8_t data2, uint8_t data3,
 		uint16_t datatostore, storedata;
 		datatostore = data2 << 8;
 		datatostore |= data1;
+		STATS_ADD(WordsProgrammed, 1);
+		LATENCY_BEGIN();
 		if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, FlashAddresscntr,
 				datatostore) == HAL_OK) {
 
 			storedata = *(uint16_t*) FlashAddresscntr;
+			LATENCY_END(LATENCY_OP_PROGRAM);
 			/*Verify if stored correctly*/
 			if (storedata == datatostore) {
 				FlashAddresscntr = FlashAddresscntr + 2;
@@ -186,5 +275,63 @@ flash_mem_Stat WriteToFLASH(uint8_t data1, uint8_t data2, uint8_t data3,
 	}
 }
 
+/*
+ * This function will write the given number of bytes to Flash memory at the given address using half word access.
+ * Unlike WriteToFLASH() the FlashAddresscntr is not used, so it can be used for writing the regions other than the JSON tree.
+ * Arguments: uint8_t *data: The bytes to be written
+ * 			  uint32_t Address: The half word aligned flash address where the first byte will be written
+ * 			  size_t NumberOfBytes: The number of bytes. If odd then the last half word is padded with FL_EMPTY_BYTE
+ * Returns: the flash_mem_Stat FL_STORE_SUCCESS or FL_STORE_FAILED
+ * */
+flash_mem_Stat WriteBytesToFLASH(uint8_t *data, uint32_t Address,
+		size_t NumberOfBytes) {
+
+	uint16_t datatostore, storedata;
+	size_t bytecntr = 0;
+
+	BACKUP_TRACK(Address, NumberOfBytes);
+	MEMTABLE_TRACK(Address, NumberOfBytes);
+
+#if MICROCDB_DEVICES > 0
+	int8_t Device = DeviceOf(Address);
+	if (Device >= 0) {
+		STATS_ADD(WordsProgrammed, (NumberOfBytes + 1) / 2);
+		return DeviceProgram(Device, Address, data, NumberOfBytes);
+	}
+#endif
+
+	HAL_FLASH_Unlock();
+
+	while (bytecntr < NumberOfBytes) {
+		datatostore = data[bytecntr];
+		if ((bytecntr + 1) < NumberOfBytes)
+			datatostore |= data[bytecntr + 1] << 8;
+		else
+			datatostore |= (uint8_t) FL_EMPTY_BYTE << 8; /*Pad the odd byte with the empty byte so it can be programmed later*/
+
+		STATS_ADD(WordsProgrammed, 1);
+		LATENCY_BEGIN();
+
+		if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, Address, datatostore)
+				!= HAL_OK) {
+			HAL_FLASH_Lock();
+			return FL_STORE_FAILED;
+		}
+
+		storedata = *(uint16_t*) Address;
+		LATENCY_END(LATENCY_OP_PROGRAM);
+		/*Verify if stored correctly*/
+		if (storedata != datatostore) {
+			HAL_FLASH_Lock();
+			return FL_STORE_FAILED;
+		}
+		Address = Address + 2;
+		bytecntr = bytecntr + 2;
+	}
+
+	HAL_FLASH_Lock();
+	return FL_STORE_SUCCESS;
+}
+
 /*MicrocDB low level functions*/
 /*****************************************************************************************************************************************************************/
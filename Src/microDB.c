@@ -1,4 +1,3 @@
- */
 /*
  * 		Author: Mrunal Ahirao
  *      Description: The source code for MicrocDB.
@@ -55,7 +54,7 @@ static inline uint16_t CalculateFlashPageNum(uint32_t *ptrToData) {
 	 * 2.And then after reaching the address of the ptrToData the latest pagecounter will be the needed page.
 	 */
 	uint16_t pagecntr = 0, bytecntr = 0;
-	uint32_t *ptr = (uint32_t*) MICROCDB_START_ADDR; /*Set the pointer to point to MICROCDB_START_ADDR*/
+	uint32_t *ptr = (uint32_t*) DB_START_ADDR; /*Set the pointer to point to MICROCDB_START_ADDR*/
 
 	while (ptr < ptrToData) {
 		if (bytecntr == FLASH_PAGE_SIZE) {
@@ -72,8 +71,9 @@ static inline uint16_t CalculateFlashPageNum(uint32_t *ptrToData) {
  * This function calculates the length of string by searching the first occurrence of slash character.
  * Returns the length of string with size_t struct.
  * */
-static inline size_t CalculateStringLength(uint8_t *string) {
+size_t CalculateStringLength(uint8_t *string) {
 	size_t len = 0;
+	STATS_ADD(StringLengthCalls, 1);
 	/*loop while the slash(/)*/
 	while (*string != '/') {
 		string++;
@@ -119,7 +119,7 @@ static inline uint16_t CalculateTotalNumberOfParts(uint8_t *query) {
  * escape chars, the microcDB uses the single quote string fields in JSON which this function
  * converts to double quoted when giving to parser.
  * */
-static inline void replacesingleTodouble(uint8_t *JSON_String, size_t len) {
+void replacesingleTodouble(uint8_t *JSON_String, size_t len) {
 	uint16_t counter = 0;
 
 	while (counter < len) {
@@ -131,15 +131,157 @@ static inline void replacesingleTodouble(uint8_t *JSON_String, size_t len) {
 	};
 }
 
+/*
+ * This function converts the ASCII integer between the Start and End pointers(both inclusive) to int32_t. The integer may have
+ * a leading '-'.
+ * Returns: true if converted or false if any char between the pointers is not part of integer or it doesn't fit in int32_t
+ * */
+bool AsciiToInteger(uint8_t *Start, uint8_t *End, int32_t *Value) {
+	uint32_t number = 0, limit = INT32_MAX, digit;
+	bool negative = false;
+
+	if (*Start == '-') {
+		negative = true;
+		limit = (uint32_t) INT32_MAX + 1;
+		Start++;
+	}
+	if (Start > End) {
+		return false;
+	}
+	while (Start <= End) {
+		if (*Start < '0' || *Start > '9') {
+			return false;
+		}
+		digit = *Start - '0';
+		if (number > (limit - digit) / 10) {
+			return false;
+		}
+		number = (number * 10) + digit;
+		Start++;
+	};
+	*Value = negative ? -(int32_t) (number - 1) - 1 : (int32_t) number;
+	return true;
+}
+
+/*
+ * This function converts the ASCII decimal number between the Start and End pointers(both inclusive) to float. The number may
+ * have a leading '-' and a single '.'.
+ * Returns: true if converted or false if any char between the pointers is not part of decimal number
+ * */
+bool AsciiToFloat(uint8_t *Start, uint8_t *End, float *Value) {
+	float number = 0, divisor = 1;
+	bool negative = false, fraction = false;
+
+	if (*Start == '-') {
+		negative = true;
+		Start++;
+	}
+	if (Start > End) {
+		return false;
+	}
+	while (Start <= End) {
+		if (*Start == '.' && !fraction) {
+			fraction = true;
+		} else if (*Start >= '0' && *Start <= '9') {
+			number = (number * 10) + (*Start - '0');
+			if (fraction)
+				divisor = divisor * 10;
+		} else
+			return false;
+		Start++;
+	};
+	number = number / divisor;
+	*Value = negative ? -number : number;
+	return true;
+}
+
+/*
+ * This function skips the JSON value starting at Value without parsing the values inside it. Objects and array lists are skipped by
+ * counting the braces and brackets outside the strings. It is used by the sources which walk the members of an object.
+ * Returns: The address of the last byte of the value. It is not more than End
+ * */
+uint8_t* SkipJSONValue(uint8_t *Value, uint8_t *End) {
+	int16_t depth = 0;
+
+	if (*Value == '\"') {
+		Value++;
+		while (*Value != '\"' && Value < End)
+			Value++;
+		return Value;
+	}
+
+	if (*Value == '{' || *Value == '[') {
+		while (Value < End) {
+			if (*Value == '\"') {
+				Value++;
+				while (*Value != '\"' && Value < End)
+					Value++;
+			} else if (*Value == '{' || *Value == '[') {
+				depth++;
+			} else if (*Value == '}' || *Value == ']') {
+				depth--;
+				if (depth == 0)
+					break;
+			}
+			Value++;
+		}
+		return Value;
+	}
+
+	/*Primitive or bool which ends before the separator*/
+	while (Value < End && *(Value + 1) != ',' && *(Value + 1) != '}'
+			&& *(Value + 1) != ']')
+		Value++;
+#if MICROCDB_OBJECT_SLACK > 0
+	/*The slack of object after the value is not part of it*/
+	while (*Value == (uint8_t) FL_EMPTY_BYTE)
+		Value--;
+#endif
+	return Value;
+}
+
+/*
+ * This function fills the microcDB_Data for the JSON value from Value till ValueEnd(both inclusive) in the same way as MicrocDB_Find()
+ * i.e the strings without quotes. The ValueEnd can be found using SkipJSONValue().
+ * */
+void ValueToData(uint8_t *Value, uint8_t *ValueEnd, microcDB_Data *Data) {
+	Data->DBstatus = FOUND_SUCCESS;
+	Data->DBStartptr = Value;
+	Data->DBEndptr = ValueEnd;
+
+	switch (*Value) {
+	case '\"':
+		Data->JSON_type = JSON_STRING;
+		Data->DBStartptr = Value + 1;
+		Data->DBEndptr = ValueEnd - 1;
+		break;
+	case '{':
+		Data->JSON_type = JSON_OBJ;
+#if MICROCDB_RELOCATION == 1
+		RelocationFollow(&Data->DBStartptr, &Data->DBEndptr); /*The latest copy of the relocated object is given*/
+#endif
+		break;
+	case '[':
+		Data->JSON_type = JSON_ARRAY;
+		break;
+	case 't':
+	case 'f':
+		Data->JSON_type = JSON_BOOL;
+		break;
+	default:
+		Data->JSON_type = JSON_PRIMITIVE;
+	}
+}
+
 /*
  * This function checks if the diff(which is number of bytes) when added to pre-stored data
  * crosses the MICROCDB_END_ADDR.
  * Returns: True if crosses or False
  * */
 static inline bool checkCrossesMem(uint16_t diff) {
-	uint16_t len = CalculateStringLength((uint8_t*) MICROCDB_START_ADDR);
-	uint32_t Address = MICROCDB_START_ADDR + len + diff;
-	if (Address > MICROCDB_END_ADDR) {
+	uint16_t len = CalculateStringLength((uint8_t*) DB_START_ADDR);
+	uint32_t Address = DB_START_ADDR + len + diff;
+	if (Address > DB_END_ADDR) {
 		return true;
 	} else
 		return false;
@@ -203,13 +345,13 @@ static flash_mem_Stat ShiftDatabaseRight(uint16_t NumberofBytes,
 		 *- Add it to MICROCDB_START_ADDR. This will give the flash address where the last byte of database is stored
 		 */
 
-		latterAddr = (uint8_t*) MICROCDB_START_ADDR
-				+ CalculateStringLength((uint8_t*) MICROCDB_START_ADDR);/*From here the database which is shifted will be copied*/
+		latterAddr = (uint8_t*) DB_START_ADDR
+				+ CalculateStringLength((uint8_t*) DB_START_ADDR);/*From here the database which is shifted will be copied*/
 		priorAddr = latterAddr - NumberofBytes; /*This will point to prior memory address by number of bytes that needs to be shifted*/
 
 		/*Find the first address of the page in which the latterAddr lies*/
 		pageToErase = CalculateFlashPageNum((uint32_t*) latterAddr);
-		addressOfPage = (uint8_t*) (MICROCDB_START_ADDR
+		addressOfPage = (uint8_t*) (DB_START_ADDR
 				+ (pageToErase * FLASH_PAGE_SIZE));
 
 		/*Do shifting until the latterAddr is not equal to the address of page where update needs to be done*/
@@ -235,7 +377,7 @@ static flash_mem_Stat ShiftDatabaseRight(uint16_t NumberofBytes,
 
 			/*Find the first address of the page in which the StartShiftAddress lies*/
 			pageToErase = CalculateFlashPageNum((uint32_t*) latterAddr);
-			addressOfPage = (uint8_t*) (MICROCDB_START_ADDR
+			addressOfPage = (uint8_t*) (DB_START_ADDR
 					+ (pageToErase * FLASH_PAGE_SIZE));
 
 			/*Proceed with storing the prepared buffer*/
@@ -247,6 +389,7 @@ static flash_mem_Stat ShiftDatabaseRight(uint16_t NumberofBytes,
 			FLASH_PAGE_SIZE) != FL_STORE_SUCCESS) {
 				return FL_STORE_FAILED;
 			}
+			STATS_ADD(ShiftPagesMoved, 1);
 
 			/*Make addressOfPage variable to point to previous page*/
 			addressOfPage = addressOfPage - PAGE_SIZE;
@@ -269,8 +412,8 @@ static flash_mem_Stat ShiftDatabaseRight(uint16_t NumberofBytes,
 		gnrlptr = addressOfPage;/*This will act as ptr3 according to logic*/
 
 		/*This will point to old end address of DB*/
-		gnrlptr = (uint8_t*) MICROCDB_START_ADDR
-				+ CalculateStringLength((uint8_t*) MICROCDB_START_ADDR);
+		gnrlptr = (uint8_t*) DB_START_ADDR
+				+ CalculateStringLength((uint8_t*) DB_START_ADDR);
 
 		/*Calculate the new End address of DB which till where the database would end after expanding by number of bytes*/
 		latterAddr = gnrlptr + NumberofBytes;
@@ -308,7 +451,7 @@ static flash_mem_Stat ShiftDatabaseRight(uint16_t NumberofBytes,
 				 * For it multiply the pageToErase with page size. This will give the number of bytes to be incremented from the MICROCDB_START_ADDR
 				 * And add the above calculated value to MICROCDB_START_ADDR. This will give the first Address of the page to be erased
 				 * */
-				addressOfPage = (uint8_t*) (MICROCDB_START_ADDR
+				addressOfPage = (uint8_t*) (DB_START_ADDR
 						+ (pageToErase * FLASH_PAGE_SIZE));
 
 				/*Subtract the amount of bytes from gnrlptr(which is pointing to old End of DB) this will give the address from where the
@@ -334,7 +477,7 @@ static flash_mem_Stat ShiftDatabaseRight(uint16_t NumberofBytes,
 				 * For it multiply the pageToErase with page size. This will give the number of bytes to be incremented from the MICROCDB_START_ADDR
 				 * And add the above calculated value to MICROCDB_START_ADDR. This will give the first Address of the page to be erased
 				 * */
-				addressOfPage = (uint8_t*) (MICROCDB_START_ADDR
+				addressOfPage = (uint8_t*) (DB_START_ADDR
 						+ (pageToErase * FLASH_PAGE_SIZE));
 
 			} else { //if first chunk is copied as above then just decrease the gnrlptr by PAGE_SIZE and copy it to buffer
@@ -361,6 +504,7 @@ static flash_mem_Stat ShiftDatabaseRight(uint16_t NumberofBytes,
 				}
 			} else
 				return SHIFT_FAILED;
+			STATS_ADD(ShiftPagesMoved, 1);
 
 			/*Subtract the latterAddr to point to lesser address by subtracting the amount of bytes copied*/
 			/*if first chunk is written*/
@@ -378,7 +522,7 @@ static flash_mem_Stat ShiftDatabaseRight(uint16_t NumberofBytes,
 				 * For it multiply the pageToErase with page size. This will give the number of bytes to be incremented from the MICROCDB_START_ADDR
 				 * And add the above calculated value to MICROCDB_START_ADDR. This will give the first Address of the page to be erased
 				 * */
-				addressOfPage = (uint8_t*) (MICROCDB_START_ADDR
+				addressOfPage = (uint8_t*) (DB_START_ADDR
 						+ (pageToErase * FLASH_PAGE_SIZE));
 			} else {/*If first chunk was written before then just decrease the latterAddr by PAGE_SIZE this is because after first chunk we will be
 			 writing page by page*/
@@ -394,7 +538,7 @@ static flash_mem_Stat ShiftDatabaseRight(uint16_t NumberofBytes,
 				 * For it multiply the pageToErase with page size. This will give the number of bytes to be incremented from the MICROCDB_START_ADDR
 				 * And add the above calculated value to MICROCDB_START_ADDR. This will give the first Address of the page to be erased
 				 * */
-				addressOfPage = (uint8_t*) (MICROCDB_START_ADDR
+				addressOfPage = (uint8_t*) (DB_START_ADDR
 						+ (pageToErase * FLASH_PAGE_SIZE));
 			}
 		}
@@ -418,6 +562,361 @@ static uint8_t GetIndexofChar(uint8_t* StartPtr, uint8_t* EndPtr,
 	};
 	return 0;
 }
+
+#if MICROCDB_OBJECT_SLACK > 0
+/*
+ * This function adds the byte to the half word and programs the half word at FlashAddresscntr when it has two bytes. The half words
+ * which have only empty bytes are not programmed so the updates can program them later.
+ * Returns: false if writing failed or DB is full
+ */
+static bool SlackPutByte(uint8_t Byte, uint8_t *HalfWord, uint8_t *Count) {
+	HalfWord[(*Count)++] = Byte;
+	if (*Count < 2) {
+		return true;
+	}
+	*Count = 0;
+	if (FlashAddresscntr >= DB_END_ADDR - 1) {
+		return false;
+	}
+	if ((HalfWord[0] != (uint8_t) FL_EMPTY_BYTE
+			|| HalfWord[1] != (uint8_t) FL_EMPTY_BYTE)
+			&& WriteBytesToFLASH(HalfWord, FlashAddresscntr, 2)
+					!= FL_STORE_SUCCESS) {
+		return false;
+	}
+	FlashAddresscntr = FlashAddresscntr + 2;
+	return true;
+}
+
+/*
+ * This function writes the object of JSON string till '/'(inclusive) at FlashAddresscntr with MICROCDB_OBJECT_SLACK empty bytes
+ * before the closing brace of every object in it.
+ * Returns: the address of '/' in the JSON string or 0 if writing failed
+ */
+static uint8_t* WriteObjectWithSlack(uint8_t *JSONString) {
+	uint8_t HalfWord[2], Count = 0;
+	uint16_t Slack;
+	bool InString = false;
+
+	for (;; JSONString++) {
+		if (*JSONString == '\"') {
+			InString = !InString;
+		} else if (*JSONString == '}' && !InString) {
+			for (Slack = 0; Slack < MICROCDB_OBJECT_SLACK; Slack++) {
+				if (!SlackPutByte(FL_EMPTY_BYTE, HalfWord, &Count)) {
+					return 0;
+				}
+			}
+		}
+		if (!SlackPutByte(*JSONString, HalfWord, &Count)) {
+			return 0;
+		}
+		if (*JSONString == '/' && !InString) {
+			break;
+		}
+	}
+	/*Pad the odd byte after '/' so the next object starts at half word*/
+	if (Count == 1 && !SlackPutByte(FL_EMPTY_BYTE, HalfWord, &Count)) {
+		return 0;
+	}
+	return JSONString;
+}
+
+/*
+ * This function gives the address of first byte of the page having the address. The address can be in DB or in a relocated object.
+ */
+static inline uint8_t* SlackPageOf(uint8_t *Address) {
+	uint32_t RegionStart =
+			RELOCATED(Address) ? MICROCDB_RELOCATION_START_ADDR : DB_START_ADDR;
+
+	return (uint8_t*) (RegionStart
+			+ (((uint32_t) Address - RegionStart) / FLASH_PAGE_SIZE)
+					* FLASH_PAGE_SIZE);
+}
+
+/*
+ * This function gives the closing brace or bracket of the object or array list having the value which starts at Value.
+ */
+uint8_t* EnclosingEnd(uint8_t *Value) {
+	uint8_t *RegionEnd =
+			RELOCATED(Value) ?
+					(uint8_t*) MICROCDB_RELOCATION_END_ADDR :
+					(uint8_t*) DB_END_ADDR;
+	int16_t depth = 0;
+
+	while (Value < RegionEnd) {
+		if (*Value == '\"') {
+			Value++;
+			while (Value < RegionEnd && *Value != '\"')
+				Value++;
+		} else if (*Value == '{' || *Value == '[') {
+			depth++;
+		} else if (*Value == '}' || *Value == ']') {
+			if (depth == 0) {
+				return Value;
+			}
+			depth--;
+		}
+		Value++;
+	}
+	return RegionEnd;
+}
+
+/*
+ * This function gives the first empty byte of the slack before ObjectEnd which is the closing brace of object.
+ */
+uint8_t* SlackStartOf(uint8_t *ObjectEnd) {
+	while (*(ObjectEnd - 1) == (uint8_t) FL_EMPTY_BYTE)
+		ObjectEnd--;
+	return ObjectEnd;
+}
+
+/*
+ * This function rewrites the bytes from Start till Limit(exclusive) with the Length bytes of value, or Length empty bytes if value is 0,
+ * followed by the bytes from OldEnd till SlackStart(exclusive) and the empty bytes after them. Only the pages having these bytes are
+ * erased and written. The pages are
+ * written from the last if the bytes move right and from the first if they move left, so every byte is read before its page is erased.
+ * Returns: true if written or false
+ */
+static bool SlackRewrite(uint8_t *Start, uint8_t *value, size_t Length,
+		uint8_t *OldEnd, uint8_t *SlackStart, uint8_t *Limit) {
+	uint8_t PageData[FLASH_PAGE_SIZE];
+	uint8_t *FirstPage = SlackPageOf(Start), *LastPage = SlackPageOf(Limit - 1);
+	uint8_t *Page, *Address, *Source;
+	int32_t Move = (int32_t) Length - (int32_t) (OldEnd - Start); /*The number of bytes by which the bytes after value move*/
+	uint16_t i;
+
+	Page = (Move > 0) ? LastPage : FirstPage;
+	for (;;) {
+		for (i = 0; i < FLASH_PAGE_SIZE; i++) {
+			Address = Page + i;
+			if (Address < Start || Address >= Limit) {
+				PageData[i] = *Address;
+			} else if (Address < Start + Length) {
+				PageData[i] = (value != 0) ? value[Address - Start] : FL_EMPTY_BYTE;
+			} else {
+				Source = Address - Move;
+				PageData[i] = (Source < SlackStart) ? *Source : FL_EMPTY_BYTE;
+			}
+		}
+		if (ErasePage(Page) != ERASE_SUCCESS
+				|| WritePage((uint32_t*) PageData, (uint32_t*) Page,
+				FLASH_PAGE_SIZE) != FL_STORE_SUCCESS) {
+			return false;
+		}
+		if (Page == ((Move > 0) ? FirstPage : LastPage)) {
+			return true;
+		}
+		Page = (Move > 0) ? Page - FLASH_PAGE_SIZE : Page + FLASH_PAGE_SIZE;
+	}
+}
+
+/*
+ * This function does the update in the slack of the object so the DB is not shifted. The member added to an object is only programmed
+ * in its slack. The value which becomes longer or shorter is written with the bytes after it moved in the slack of the object having it,
+ * so only the pages of that object are erased.
+ * Returns: true if the update was done with its status in Status or false if the slack is not enough
+ */
+static bool SlackUpdate(microcDB_Data *FindResult, uint8_t *value,
+		size_t len, microcDB_Status *Status) {
+	uint8_t *ObjectEnd, *SlackStart, *Start, *OldEnd, *Address, *Limit;
+	uint8_t Separator[2];
+	size_t Needed;
+	bool Empty;
+
+	if (FindResult->JSON_type == JSON_OBJ) {
+		ObjectEnd = FindResult->DBEndptr;
+		SlackStart = SlackStartOf(ObjectEnd);
+		/*The half word having the last byte of object is programmed so start at the next one. The half word having the closing
+		 * brace is programmed too so the written half words end before it or before the bytes kept for forwarding marker*/
+		Address = SlackStart + ((uint32_t) SlackStart & 1);
+		Limit = (uint8_t*) (((uint32_t) ObjectEnd - SLACK_RESERVED)
+				& ~(uint32_t) 1);
+		Empty = SkipSlack(FindResult->DBStartptr + 1, ObjectEnd) == ObjectEnd;
+		Needed = len + (Empty ? 0 : 1);
+		if (Address + Needed + (Needed & 1) > Limit) {
+			return false;
+		}
+		if (Empty) {
+			*Status =
+					WriteBytesToFLASH(value, (uint32_t) Address, len)
+							== FL_STORE_SUCCESS ?
+							UPDATE_SUCCESSFUL : UPDATE_FAILED;
+		} else {
+			/*The comma is written with the first byte of value so the rest is half word aligned*/
+			Separator[0] = ',';
+			Separator[1] = *value;
+			*Status =
+					(WriteBytesToFLASH(Separator, (uint32_t) Address, 2)
+							== FL_STORE_SUCCESS
+							&& (len == 1
+									|| WriteBytesToFLASH(value + 1,
+											(uint32_t) Address + 2, len - 1)
+											== FL_STORE_SUCCESS)) ?
+							UPDATE_SUCCESSFUL : UPDATE_FAILED;
+		}
+		return true;
+	}
+
+	/*The quotes of string are replaced too if the value has them*/
+	Start = FindResult->DBStartptr;
+	if (FindResult->JSON_type == JSON_STRING && *value == '\"') {
+		Start--;
+	}
+	/*The enclosing object is searched from the quote as the string may be given without quotes*/
+	ObjectEnd = EnclosingEnd(
+			FindResult->JSON_type == JSON_STRING ?
+					FindResult->DBStartptr - 1 : Start);
+	if (*ObjectEnd != '}') {
+		return false; /*The array lists have no slack*/
+	}
+	if (FindResult->JSON_type == JSON_STRING && *value != '\"') {
+		OldEnd = FindResult->DBEndptr + 1;
+	} else {
+		OldEnd = SkipJSONValue(Start, ObjectEnd) + 1;
+	}
+	SlackStart = SlackStartOf(ObjectEnd);
+	if (Start + len + (SlackStart - OldEnd) > ObjectEnd - SLACK_RESERVED) {
+		return false;
+	}
+	*Status =
+			SlackRewrite(Start, value, len, OldEnd, SlackStart, ObjectEnd) ?
+					UPDATE_SUCCESSFUL : UPDATE_FAILED;
+	return true;
+}
+
+#if MICROCDB_RELOCATION == 0
+/*
+ * This function grows the slack of the object having the update which doesn't fit in it, by shifting the DB after the closing brace of
+ * the object. The DB is shifted by an even number of bytes so the slack of the objects after it stays on half words, and the object is
+ * given the slack for the update and MICROCDB_OBJECT_SLACK more bytes. The data found is moved with the DB.
+ * Returns: microcDB_Status UPDATE_SUCCESSFUL, UPDATE_FAILED, NO_MEMORY if DB would cross its end or NOT_ENOUGH_SPACE if the value is
+ * in an array list which has no slack
+ */
+static microcDB_Status SlackGrow(microcDB_Data *FindResult, size_t len) {
+	uint8_t *ObjectEnd, *End = (uint8_t*) FlashAddresscntr;
+	uint32_t Grow;
+
+	if (FindResult->JSON_type == JSON_OBJ) {
+		ObjectEnd = FindResult->DBEndptr;
+	} else {
+		ObjectEnd = EnclosingEnd(
+				FindResult->JSON_type == JSON_STRING ?
+						FindResult->DBStartptr - 1 : FindResult->DBStartptr);
+		if (*ObjectEnd != '}') {
+			return NOT_ENOUGH_SPACE;
+		}
+	}
+
+	/*The value with a comma and the half words which can't be programmed in the slack is at most len + 4 bytes*/
+	Grow = len + 4 + MICROCDB_OBJECT_SLACK;
+	Grow = Grow + (Grow & 1);
+	if ((uint32_t) End + Grow >= DB_END_ADDR - 1) {
+		return NO_MEMORY;
+	}
+	if (!SlackRewrite(ObjectEnd, 0, Grow, ObjectEnd, End, End + Grow)) {
+		return UPDATE_FAILED;
+	}
+	FlashAddresscntr = FlashAddresscntr + Grow;
+	KEY_INDEX_SHIFT(ObjectEnd, (int32_t) Grow);
+	HASH_INDEX_SHIFT(ObjectEnd, (int32_t) Grow);
+
+	if (FindResult->JSON_type == JSON_OBJ) {
+		FindResult->DBEndptr = FindResult->DBEndptr + Grow;
+	}
+	return UPDATE_SUCCESSFUL;
+}
+#endif
+
+static MICROCDB_THREAD_LOCAL uint8_t Compacted[MICROCDB_SLACK_FIND_BYTES]; /*The object or array list given by MicrocDB_Find()*/
+
+/*
+ * This function gives the bytes from Start till Stop(exclusive) to the callback in calls of at most 0xFFFF bytes.
+ * Returns: false if the callback returned false
+ */
+static bool CompactRun(uint8_t *Start, uint8_t *Stop, microcDB_FoundWrite Write,
+		void *Context) {
+	uint16_t Length;
+
+	while (Start < Stop) {
+		Length = (Stop - Start > 0xFFFF) ? 0xFFFF : (uint16_t) (Stop - Start);
+		if (!Write(Start, Length, Context)) {
+			return false;
+		}
+		Start = Start + Length;
+	}
+	return true;
+}
+
+/*
+ * This function gives the object or array list from Start till End(both inclusive) to the callback without the empty bytes of slack
+ * and the forwarding markers, and the members which were relocated from their latest copy. None of these bytes is a JSON character
+ * outside the strings. The runs of bytes between them are given as they are in flash so nothing is buffered.
+ * Returns: false if the callback returned false
+ */
+static bool CompactValue(uint8_t *Start, uint8_t *End, microcDB_FoundWrite Write,
+		void *Context) {
+	uint8_t *ptr, *ValueEnd, *Run;
+
+#if MICROCDB_RELOCATION == 1
+	if (*Start == '{')
+		RelocationFollow(&Start, &End);
+#endif
+	Run = Start;
+	for (ptr = Start; ptr <= End; ptr = ValueEnd + 1) {
+		ValueEnd = ptr;
+		if (*ptr == '{' && ptr != Start) {
+			ValueEnd = SkipJSONValue(ptr, End);
+			if (!CompactRun(Run, ptr, Write, Context)
+					|| !CompactValue(ptr, ValueEnd, Write, Context)) {
+				return false;
+			}
+			Run = ValueEnd + 1;
+		} else if (*ptr == '"') {
+			ValueEnd = SkipJSONValue(ptr, End); /*The strings are given as they are*/
+		} else if (*ptr == (uint8_t) FL_EMPTY_BYTE || *ptr == 0x00
+				|| (*ptr & 0x80) != 0) {
+			if (!CompactRun(Run, ptr, Write, Context)) {
+				return false;
+			}
+			Run = ptr + 1;
+		}
+	}
+	return CompactRun(Run, End + 1, Write, Context);
+}
+
+/*
+ * This function copies the bytes given by CompactValue() to Compacted after the number of bytes in Context.
+ * Returns: false if they don't fit
+ */
+static bool CompactToBuffer(uint8_t *Bytes, uint16_t Length, void *Context) {
+	size_t *Copied = Context;
+
+	if (*Copied + Length > MICROCDB_SLACK_FIND_BYTES) {
+		return false;
+	}
+	while (Length--) {
+		Compacted[(*Copied)++] = *Bytes++;
+	}
+	return true;
+}
+
+void SlackCompact(microcDB_Data *Data) {
+	size_t Length = 0;
+
+	if (Data->DBstatus != FOUND_SUCCESS
+			|| (Data->JSON_type != JSON_OBJ && Data->JSON_type != JSON_ARRAY)) {
+		return;
+	}
+	/*The value which doesn't fit is given in flash, it is given without the slack by MicrocDB_StreamFound()*/
+	if (!CompactValue(Data->DBStartptr, Data->DBEndptr, CompactToBuffer,
+			&Length)) {
+		return;
+	}
+	Data->DBStartptr = Compacted;
+	Data->DBEndptr = Compacted + Length - 1;
+}
+#endif
 /*MISC functions*/
 /**************************************************************************************************************************************/
 
@@ -425,48 +924,279 @@ static uint8_t GetIndexofChar(uint8_t* StartPtr, uint8_t* EndPtr,
  * to integer to save space. As for example the 28 in the JSONString will be '2''8' which will acquire two
  * bytes, but instead in integer it will acquire only 1 byte! as 28 is one byte <255!*/
 
-/*MicrocDB high level functions*/
-microcDB_Status MicrocDB_Init() {
-	uint8_t initflag = 0;
+#if MICROCDB_COLLECTIONS > 0
+/*Collections*/
+
+/*The named collection and its region. It has only the fields of the entries of MICROCDB_COLLECTION_TABLE*/
+typedef struct {
+	const char *Name; /*Name terminated with '/'*/
+	uint32_t StartAddr;
+	uint32_t EndAddr;
+} microcDB_Collection;
+
+/*The first collection is the default collection which is at MICROCDB_START_ADDR..MICROCDB_END_ADDR*/
+static const microcDB_Collection Collections[MICROCDB_COLLECTIONS + 1] = { {
+		"/", MICROCDB_START_ADDR, MICROCDB_END_ADDR }, MICROCDB_COLLECTION_TABLE };
+static uint32_t AppendAddrs[MICROCDB_COLLECTIONS + 1]; /*The FlashAddresscntr of every collection when it is not selected*/
+static uint8_t SelectedCollection = 0;
+
+uint32_t DBRegionStart = MICROCDB_START_ADDR, DBRegionEnd = MICROCDB_END_ADDR;
+
+/*
+ * This function makes the region of the collection the region of DB. The FlashAddresscntr of the previously selected collection is
+ * saved and the one of this collection is restored.
+ */
+static void SelectRegion(uint8_t Collection) {
+	AppendAddrs[SelectedCollection] = FlashAddresscntr;
+	SelectedCollection = Collection;
+	DBRegionStart = Collections[Collection].StartAddr;
+	DBRegionEnd = Collections[Collection].EndAddr;
+	FlashAddresscntr = AppendAddrs[Collection];
+	KEY_INDEX_BUILD(); /*The index is of the selected collection*/
+}
+
+/*Collections*/
+#endif
+
+/*
+ * This function sets the FlashAddresscntr to the first empty address of the region of DB(i.e of the selected collection). It is used by
+ * InitRegion and after the DB is written other than by inserting, like by restoring a backup.
+ * Returns: microcDB_Status INIT_CMPLT or FLASH_FULL
+ */
+microcDB_Status FindAppendAddress() {
 	uint8_t *i;
-	i = (uint8_t*) MICROCDB_START_ADDR; // Assign the start address of the database to the pointer
+	i = (uint8_t*) DB_START_ADDR; // Assign the start address of the database to the pointer
+
+#if MICROCDB_COMPRESSION == 1
+	/*The compressed blocks can have empty bytes in them so walk the block headers to get the first empty address*/
+	i = (uint8_t*) CompressedInit();
+#else
+	/*If DB was initialized before, then assign the FlashAddresscntr the address
+	 of first empty memory*/
+
+	/*Get the address of the first occurring Empty memory*/
+#if MICROCDB_OBJECT_SLACK > 0
+	/*The slack in objects is empty too, so the first empty address is after the last byte which is not empty*/
+	i = (uint8_t*) DB_END_ADDR - 1;
+	while (i >= (uint8_t*) DB_START_ADDR && *i == (uint8_t) FL_EMPTY_BYTE)
+		i--;
+	i++;
+	i = i + ((uint32_t) i & 1); /*Objects are written from half word*/
+#else
+	while (i < (uint8_t*) DB_END_ADDR) {
+		if (*i == FL_EMPTY_BYTE)
+			break;
+		i++;
+	}
+#endif
+#endif
+	if (i >= (uint8_t*) DB_END_ADDR - 1) {
+		return FLASH_FULL;
+	} else
+		FlashAddresscntr = (uint32_t) i;/*Assign the address of empty location to FlashAddresscntr
+		 So next time the object will stored to empty location only*/
+
+	return INIT_CMPLT;
+}
+
+/*
+ * This function initializes the region of DB(i.e of the selected collection) and sets the FlashAddresscntr to its first empty address.
+ * Returns: microcDB_Status INIT_CMPLT, INIT_FAILED or FLASH_FULL
+ */
+static microcDB_Status InitRegion() {
+	uint8_t initflag = 0;
 
 	/*Check the 0xDB flag in the last address */
-	initflag = *(uint8_t*) MICROCDB_END_ADDR;
+	initflag = *(uint8_t*) DB_END_ADDR;
 
 	/*Check if the database was initialized before, it means having the flag 0xDB stored at last address*/
 	if (initflag == 0xDB) {
-		if (EraseDB() == ERASE_SUCCESS) {
+		if (EraseDB(DB_START_ADDR, DB_END_ADDR) == ERASE_SUCCESS) {
+#if MICROCDB_HASH_INDEX == 1
+			if (HashIndexErase() != ERASE_SUCCESS) {
+				return INIT_FAILED;
+			}
+#endif
+#if MICROCDB_RELOCATION == 1
+			/*The relocated objects belong to the erased DB too*/
+			if (RelocationErase() != ERASE_SUCCESS) {
+				return INIT_FAILED;
+			}
+#endif
+#if MICROCDB_MEMTABLE_BYTES > 0
+			/*The buffered writes were to the erased DB*/
+			if (MemtableErase() != ERASE_SUCCESS) {
+				return INIT_FAILED;
+			}
+#endif
+#if MICROCDB_TIERING == 1
+			/*The members in the cold tier belong to the erased DB too*/
+			if (TierErase() != ERASE_SUCCESS) {
+				return INIT_FAILED;
+			}
+#endif
+#if MICROCDB_SNAPSHOTS > 0
+			SnapshotsRelease(); /*The snapshots were of the erased DB*/
+#endif
+#if MICROCDB_ARRAY_SEGMENTS == 1
+			/*The appended elements belong to the array lists of erased DB*/
+			if (ArraySegmentsErase() != ERASE_SUCCESS) {
+				return INIT_FAILED;
+			}
+#endif
+#if MICROCDB_COMPRESSION == 1
+			CompressedInit(); /*Drop the cached blocks of the erased DB*/
+#endif
 			return INIT_CMPLT;
 		} else
 			return INIT_FAILED;
 	} else {
-		/*If DB was initialized before, then assign the FlashAddresscntr the address
-		 of first empty memory*/
-
-		/*Get the address of the first occurring Empty memory*/
-		while (i < (uint8_t*) MICROCDB_END_ADDR) {
-			if (*i == FL_EMPTY_BYTE)
-				break;
-			i++;
+		return FindAppendAddress();
+	}
+}
+
+/*MicrocDB high level functions*/
+microcDB_Status MicrocDB_Init() {
+	microcDB_Status status;
+#if MICROCDB_COLLECTIONS > 0
+	microcDB_Status CollectionStatus;
+	uint8_t Collection;
+#endif
+
+	STATS_BEGIN(STATS_OP_INIT);
+	DEVICES_SYNC();
+
+#if MICROCDB_BACKUP == 1
+	/*The log of changed pages is read first as the pages changed by Init are logged too*/
+	if (BackupInit() != INIT_CMPLT) {
+		return INIT_FAILED;
+	}
+#endif
+
+#if MICROCDB_CAPPED_SUPPORT == 1
+	/*The capped collection has its own region so it is initialized separately*/
+	if (CappedInit() != INIT_CMPLT) {
+		return INIT_FAILED;
+	}
+#endif
+
+#if MICROCDB_COUNTERS == 1
+	/*The counters have their own region too*/
+	if (CounterInit() != INIT_CMPLT) {
+		return INIT_FAILED;
+	}
+#endif
+#if MICROCDB_CHANGE_FEED == 1
+	/*The sequence numbers of the change feed too*/
+	if (ChangeInit() != INIT_CMPLT) {
+		return INIT_FAILED;
+	}
+#endif
+#if MICROCDB_ARRAY_SEGMENTS == 1
+	ArraySegmentsInit();
+#endif
+#if MICROCDB_RELOCATION == 1
+	RelocationInit();
+#endif
+#if MICROCDB_TIERING == 1
+	TierInit();
+#endif
+
+#if MICROCDB_COLLECTIONS > 0
+	/*Initialize every named collection and at last the default collection which remains selected*/
+	for (Collection = MICROCDB_COLLECTIONS; Collection > 0; Collection--) {
+		SelectRegion(Collection);
+		CollectionStatus = InitRegion();
+		if (CollectionStatus != INIT_CMPLT) {
+			SelectRegion(0);
+			return CollectionStatus;
 		}
-		if (i >= (uint8_t*) MICROCDB_END_ADDR - 1) {
-			return FLASH_FULL;
-		} else
-			FlashAddresscntr = (uint32_t) i;/*Assign the address of empty location to FlashAddresscntr
-			 So next time the object will stored to empty location only*/
+	}
+	SelectRegion(0);
+#endif
+
+#if MICROCDB_UPDATE_JOBS == 1
+	/*The update job pending when power was lost is completed before the first empty address of DB is found*/
+	if (!UpdateJobResume()) {
+		return INIT_FAILED;
+	}
+#endif
 
-		return INIT_CMPLT;
+#if MICROCDB_MEMTABLE_BYTES > 0
+	/*The pages changed by the writes whose applying was interrupted are restored before the first empty address of DB is found*/
+	if (!MemtableRollback()) {
+		return INIT_FAILED;
 	}
+#endif
+
+	status = InitRegion();
+	KEY_INDEX_BUILD();
+#if MICROCDB_HASH_INDEX == 1 && MICROCDB_COMPRESSION == 0
+	HashIndexInit(); /*The compressed store counts the slots when it is initialized*/
+#endif
+#if MICROCDB_BACKUP == 1
+	/*The restore whose pages were written by BackupInit() is completed on the initialized DB*/
+	if (status == INIT_CMPLT && BackupResume() != INIT_CMPLT) {
+		return INIT_FAILED;
+	}
+#endif
+#if MICROCDB_MEMTABLE_BYTES > 0
+	/*The writes journaled before power was lost are applied to the initialized DB*/
+	if (status == INIT_CMPLT && !MemtableInit()) {
+		return INIT_FAILED;
+	}
+#endif
+	return status;
 }
 
-microcDB_Status MicrocDB_Insert(uint8_t *JSONString,
+#if MICROCDB_COLLECTIONS > 0
+microcDB_Status MicrocDB_SelectCollection(uint8_t *name) {
+	uint8_t Collection;
+	const char *CollectionName;
+	uint8_t *namechar;
+
+	STATS_BEGIN(STATS_OP_OTHER);
+	DEVICES_SYNC();
+
+	if (name == 0) {
+		SelectRegion(0);
+		return FOUND_SUCCESS;
+	}
+
+	for (Collection = 0; Collection <= MICROCDB_COLLECTIONS; Collection++) {
+		CollectionName = Collections[Collection].Name;
+		namechar = name;
+		while (*namechar == (uint8_t) *CollectionName && *namechar != '/') {
+			namechar++;
+			CollectionName++;
+		}
+		if (*namechar == '/' && *CollectionName == '/') {
+			SelectRegion(Collection);
+			return FOUND_SUCCESS;
+		}
+	}
+	return NOT_FOUND;
+}
+#endif
+
+/*
+ * This function stores the JSON objects of the string to the selected collection. It is the body of MicrocDB_Insert()
+ * Returns: microcDB_Status STORE_SUCCESS, STORE_FAILED, INVALID_JSON or FLASH_FULL
+ */
+microcDB_Status InsertObjects(uint8_t *JSONString,
 		unsigned int numberofobjects) {
 
+#if MICROCDB_OBJECT_SLACK == 0
 	uint16_t count = 0;/*This variable is used for general purpose counter*/
+#endif
 	size_t len; /*The variable which holds the length of the string passed*/
 	unsigned int num = 0; /*initialize the number of object counter*/
 
+#if MICROCDB_COMPRESSION == 1
+	/*Objects are packed in blocks and compressed before storing*/
+	return CompressedInsert(JSONString, numberofobjects);
+#endif
+
 	/*Validate JSON first*/
 	len = CalculateStringLength(JSONString);
 	replacesingleTodouble(JSONString, len);/*Replace single to double quotes without which the JSMN Parser parses the strings as JSMN_PRIMITIVE*/
@@ -475,6 +1205,13 @@ microcDB_Status MicrocDB_Insert(uint8_t *JSONString,
 		/*Get the length of first object*/
 		len = len + 1; /*Increment as this '/' should also be written to memory
 		 for future object splitting*/
+#if MICROCDB_OBJECT_SLACK > 0
+		/*The slack is added before the closing braces so the object is written byte by byte*/
+		JSONString = WriteObjectWithSlack(JSONString);
+		if (JSONString == 0) {
+			return STORE_FAILED;
+		}
+#else
 		count = 0;
 		while (count < len) {
 			/*Write to Flash*/
@@ -484,6 +1221,7 @@ microcDB_Status MicrocDB_Insert(uint8_t *JSONString,
 				count = count + 4; /*Increment the JSON string counter*/
 			}
 		};
+#endif
 
 		num = num + 1;/*Increment the object counter to get next object*/
 		JSONString++; /*Increment this to point next object. Because at this stage it will be pointing to '/'!*/
@@ -492,13 +1230,65 @@ microcDB_Status MicrocDB_Insert(uint8_t *JSONString,
 
 }
 
-microcDB_Data MicrocDB_Find(uint8_t *query) {
+microcDB_Status MicrocDB_Insert(uint8_t *JSONString,
+		unsigned int numberofobjects) {
+	microcDB_Status status;
+#if MICROCDB_MEMTABLE_BYTES == 0
+	uint8_t *Appended = (uint8_t*) FlashAddresscntr;
+#endif
+	LATENCY_BEGIN();
+
+	STATS_BEGIN(STATS_OP_INSERT);
+	DEVICES_SYNC();
+	if (UPDATE_JOB_PENDING()) {
+		return UPDATE_PENDING; /*The DB is partly shifted by the job*/
+	}
+	CHANGE_BEGIN();
+	SEQ_WRITE_BEGIN();
+#if MICROCDB_MEMTABLE_BYTES > 0
+	status = MemtableInsert(JSONString, numberofobjects); /*The documents are indexed when applied*/
+#else
+	status = InsertObjects(JSONString, numberofobjects);
+	if (status == STORE_SUCCESS) {
+		KEY_INDEX_APPEND(Appended);
+		HASH_INDEX_APPEND(Appended);
+	}
+#endif
+	SEQ_WRITE_END();
+
+	LATENCY_END(LATENCY_OP_INSERT);
+	if (status == STORE_SUCCESS) {
+		CHANGE_EMIT(CHANGE_INSERT, numberofobjects, 0, JSONString);
+	}
+	return status;
+}
+
+/*
+ * This function searches the query in the JSON document starting at DocumentStart. The document should be terminated with '/'
+ * and can be in flash or RAM. This is used by MicrocDB_Find and by the other sources which keep documents at other locations.
+ * Returns: the microcDB_Data same as MicrocDB_Find
+ * */
+microcDB_Data FindInDocument(uint8_t *query, uint8_t *DocumentStart,
+		uint8_t *DocumentEnd) {
 	microcDB_Data data_out_struct;
 
 	microcDB_json_parser db_parser;
 
-	microcDBStartAddr = (uint8_t*) MICROCDB_START_ADDR;
-	microcDBEndAddr = (uint8_t*) MICROCDB_END_ADDR;
+	microcDBStartAddr = DocumentStart;
+	microcDBEndAddr = DocumentEnd;
+
+	db_parser.parsed_type = JSON_UNDEFINED;
+	db_parser.Start = DocumentStart;
+	db_parser.End = DocumentStart;
+
+	/*The document should be a JSON object. This also avoids parsing empty memory if the DB is empty*/
+	if (*DocumentStart != '{') {
+		data_out_struct.DBstatus = NOT_FOUND;
+		data_out_struct.JSON_type = JSON_UNDEFINED;
+		data_out_struct.DBStartptr = DocumentStart;
+		data_out_struct.DBEndptr = DocumentStart;
+		return data_out_struct;
+	}
 
 	uint16_t dotIndex = 0; /*This will hold the index of the dot in query*/
 
@@ -580,6 +1370,33 @@ microcDB_Data MicrocDB_Find(uint8_t *query) {
 
 						db_parser = json_parse(); /*Get next JSON data*/
 
+#if MICROCDB_RELOCATION == 1
+						/*The relocated object is searched in its latest copy*/
+						if (db_parser.parsed_type == JSON_OBJ
+								&& RelocationFollow(&db_parser.Start,
+										&db_parser.End)) {
+							if (partlooper == queryPartcntr - 1) {
+								data_out_struct.DBstatus = FOUND_SUCCESS;
+								data_out_struct.JSON_type = JSON_OBJ;
+								data_out_struct.DBStartptr = db_parser.Start;
+								data_out_struct.DBEndptr = db_parser.End;
+								return data_out_struct;
+							}
+							data_out_struct = FindInDocument(query + dotIndex + 1,
+									db_parser.Start, db_parser.End + 1);
+							/*The parser finds the end of last number of the copy using the end of last object parsed so get it again*/
+							if (data_out_struct.DBstatus == FOUND_SUCCESS
+									&& (data_out_struct.JSON_type == JSON_PRIMITIVE
+											|| data_out_struct.JSON_type == JSON_BOOL)
+									&& data_out_struct.DBStartptr >= db_parser.Start
+									&& data_out_struct.DBStartptr <= db_parser.End) {
+								data_out_struct.DBEndptr = SkipJSONValue(
+										data_out_struct.DBStartptr, db_parser.End);
+							}
+							return data_out_struct;
+						}
+#endif
+
 						/*If it is Object or Array then assign the end address of it to inptr. By this search will continue only within this limits*/
 						if ((db_parser.parsed_type == JSON_OBJ)
 								|| (db_parser.parsed_type == JSON_ARRAY))
@@ -612,17 +1429,96 @@ microcDB_Data MicrocDB_Find(uint8_t *query) {
 	};
 
 	data_out_struct.DBstatus = NOT_FOUND;
+	data_out_struct.JSON_type = JSON_UNDEFINED;
 	data_out_struct.DBStartptr = db_parser.Start;
 	data_out_struct.DBEndptr = db_parser.End;
 	return data_out_struct;
 
 }
 
-/*TODO: Need to find a way to update the JSON data type. For example if any body updates a field
- * which was JSON_STRING before with JSON_PRIMITIVE then parser won't parse it as JSON_PRMITIVE
- * because, it was JSON_STRING before and has '\"' quotes before and after data pointed by the path. */
-microcDB_Status MicrocDB_Update(uint8_t *path, uint8_t *value) {
-	microcDB_Data FindResult;
+/*
+ * This function searches the query in the selected collection. It is used by the API functions which need to find a path so that the
+ * work is accounted to their type of call in engine statistics.
+ */
+microcDB_Data FindPath(uint8_t *query) {
+#if MICROCDB_COMPRESSION == 1
+	return CompressedFind(query);
+#elif MICROCDB_KEY_INDEX_SIZE > 0
+	return KeyIndexFind(query);
+#else
+	return FindInDocument(query, (uint8_t*) DB_START_ADDR,
+			(uint8_t*) DB_END_ADDR);
+#endif
+}
+
+microcDB_Data MicrocDB_Find(uint8_t *query) {
+	microcDB_Data data_out_struct;
+	LATENCY_BEGIN();
+
+	STATS_BEGIN(STATS_OP_FIND);
+	DEVICES_SYNC();
+	if (UPDATE_JOB_PENDING()) {
+		/*The DB is partly shifted by the job*/
+		data_out_struct.DBstatus = UPDATE_PENDING;
+		data_out_struct.JSON_type = JSON_UNDEFINED;
+		data_out_struct.DBStartptr = 0;
+		data_out_struct.DBEndptr = 0;
+		return data_out_struct;
+	}
+#if MICROCDB_MEMTABLE_BYTES > 0
+	data_out_struct = MemtableFind(query); /*The buffered writes are searched with DB*/
+	SLACK_COMPACT(&data_out_struct);
+	ARRAY_SEGMENTS_JOIN(query, &data_out_struct);
+#else
+	SEQ_READ(data_out_struct = FindPath(query); SLACK_COMPACT(&data_out_struct);
+			ARRAY_SEGMENTS_JOIN(query, &data_out_struct));
+#endif
+#if MICROCDB_COMPRESSION == 1
+	CompressedPin(&data_out_struct); /*The block is kept in cache till the caller releases the data*/
+#endif
+#if MICROCDB_TIERING == 1
+	/*The query not found in DB may be of a member moved to the cold tier*/
+	if (data_out_struct.DBstatus == FOUND_SUCCESS) {
+		TierTouch(query);
+	} else {
+		data_out_struct = TierFind(query);
+	}
+#endif
+
+	LATENCY_END(LATENCY_OP_FIND);
+	return data_out_struct;
+}
+
+#if MICROCDB_OBJECT_SLACK > 0
+microcDB_Status MicrocDB_StreamFound(microcDB_Data *Data,
+		microcDB_FoundWrite Write, void *Context) {
+	bool Written;
+
+	STATS_BEGIN(STATS_OP_FIND);
+	DEVICES_SYNC();
+	if (Data->DBstatus != FOUND_SUCCESS) {
+		return NOT_FOUND;
+	}
+	if (UPDATE_JOB_PENDING()) {
+		return UPDATE_PENDING; /*The data may have been moved by the job since it was found*/
+	}
+	if (Data->JSON_type == JSON_OBJ || Data->JSON_type == JSON_ARRAY) {
+		Written = CompactValue(Data->DBStartptr, Data->DBEndptr, Write, Context);
+	} else {
+		Written = CompactRun(Data->DBStartptr, Data->DBEndptr + 1, Write,
+				Context);
+	}
+	return Written ? FOUND_SUCCESS : STORE_FAILED;
+}
+#endif
+
+/*
+ * This function shifts the DB to make the space for the value found at FindResult and writes it there. It is used by UpdateValue()
+ * when the value doesn't fit in place.
+ * Returns: microcDB_Status same as MicrocDB_Update()
+ */
+static microcDB_Status ShiftValue(microcDB_Data FindResult, uint8_t *value,
+		uint16_t len) {
 	uint16_t pageToErase = 0, bytecntr = 0, diff = 0;
 	uint32_t NumberofPages = 0, PageCntr = 0;
 	uint8_t *addressOfPage, *generalptr, *UpdateEndPtr; /*pointer variables to point to different memory addresses*/
@@ -632,187 +1528,389 @@ microcDB_Status MicrocDB_Update(uint8_t *path, uint8_t *value) {
 	 this is the continuation piece of the edited data */
 	uint8_t UpdateCompleteFlag = 0; //This flag will be used to just indicate the last page of update is done and the while loop to be breaked
 
-	FindResult.DBstatus = NOT_FOUND; /*Initialize the find result for NOT_FOUND*/
+	/*Calculate the address till where the updated data would be filled*/
+	UpdateEndPtr = FindResult.DBEndptr + len + 1;
+
+	/*Calculate the Address of first byte of page where UpdateEndPtr lies*/
+
+	/*Get the page number to be erased*/
+	pageToErase = CalculateFlashPageNum((uint32_t*) UpdateEndPtr);
+
+	/* Now calculate the starting Address of the pageToErase
+	 * For it multiply the pageToErase with page size. This will give the number of bytes to be incremented from the MICROCDB_START_ADDR
+	 * And add the above calculated value to MICROCDB_START_ADDR. This will give the first Address of the page to be erased
+	 * */
+	addressOfPage = (uint8_t*) (DB_START_ADDR
+			+ (pageToErase * FLASH_PAGE_SIZE));
+
+	/*Check if the field to be updated is object if it is, then the data to be updated will be next to the old data by adding
+	 * a comma next to old data*/
+	if (FindResult.JSON_type == JSON_OBJ) {
+		/*This means that the data to be updated will erase the pre stored data in flash which is beyond
+		 FindResult.DBEndptr and hence the data in flash memory needs to be shifted right with that number of
+		 bytes(Bytes from FindResult.DBEndptr), this is the expanding operation of Database.For this operation
+		 these extra bytes will be stored in the PreStoredData buffer*/
+
+		/*Check if this operation would cross the boundaries of MICROCDB_END_ADDR*/
+		if (checkCrossesMem(
+		PAGE_SIZE - (FindResult.DBEndptr - addressOfPage)) == true) {
+			return NO_MEMORY;
+		} else {
+			/*Proceed with update as the data which will be stored won't make database shift right go beyond MICROCDB_END_ADDR*/
+
+			/*Check if database size is less than 1 FLASH_PAGE_SIZE and after update will be less than flash page.
+			 *This is very unlikely but case should be handled!*/
+			if (CalculateStringLength(
+					(uint8_t*) DB_START_ADDR)<PAGE_SIZE && (CalculateStringLength(
+									(uint8_t*) DB_START_ADDR)+1+ len)<PAGE_SIZE) {
+				/*If the database size is less than one flash page size then no need of database shifting, only copy page in RAM and
+				 * update new data and write it again!*/
+
+				/*Copy the data to be updated to Edited data buffer*/
+				diff = 0;
+
+				/*First copy the data at the page till DBEndptr*/
+				while (addressOfPage < FindResult.DBEndptr) {
+					EditedData[diff] = *addressOfPage;
+					diff++;
+					addressOfPage++;
+				};
 
-	FindResult = MicrocDB_Find(path);
-	uint16_t len = CalculateStringLength(value);
+				/*Adding comma only if there is something in the object*/
+				if ((FindResult.DBEndptr - FindResult.DBStartptr) > 1) {
+					EditedData[diff] = ','; /*Adding comma, as till here the data inside the DBStart-Endptr might be copied*/
+					diff++;
+				}
+				len = diff + len; /*get the number of bytes after adding data to be updated*/
 
-	/*if strings are passed then replace ' to \"*/
-	if (*value == '\'') {
-		replacesingleTodouble(value, len);
-	}
+				/*Now copy the the data to be updated*/
+				while (diff < len) {
+					EditedData[diff] = *value;
+					diff++;
+					value++;
+				};
 
-	if (FindResult.DBstatus == FOUND_SUCCESS) {
+				/*Copy the data in PrestoredData to Edited Data*/
 
-		/*Check if the FindResult pointer are not pointing to array if it is then return with error as this is not the function to be used with array*/
-		if (FindResult.JSON_type == JSON_ARRAY) {
-			return DATA_IS_ARRAY; /*This function cannot be used for arrays*/
-		}
+				while (diff < FLASH_PAGE_SIZE) {
+					EditedData[diff] = *addressOfPage;
+					diff++;
+					addressOfPage++;
+				};
 
-		/*Calculate the address till where the updated data would be filled*/
-		UpdateEndPtr = FindResult.DBEndptr + len + 1;
+				/*Copy the Edited data to Flash by erasing the page*/
+				addressOfPage = (uint8_t*) (DB_START_ADDR
+						+ (pageToErase * FLASH_PAGE_SIZE));
 
-		/*Calculate the Address of first byte of page where UpdateEndPtr lies*/
+				/*Erase the page where the addressOfPage points.*/
+				if (ErasePage(addressOfPage) != ERASE_SUCCESS) {
+					return UPDATE_FAILED;
+				} else {
+					if (WritePage((uint32_t*) EditedData,
+							(uint32_t*) addressOfPage, FLASH_PAGE_SIZE)
+							!= FL_STORE_SUCCESS) {
+						return UPDATE_FAILED;
+					} else {
+						return UPDATE_SUCCESSFUL;
+					}
+				}
 
-		/*Get the page number to be erased*/
-		pageToErase = CalculateFlashPageNum((uint32_t*) UpdateEndPtr);
+			} else {
 
-		/* Now calculate the starting Address of the pageToErase
-		 * For it multiply the pageToErase with page size. This will give the number of bytes to be incremented from the MICROCDB_START_ADDR
-		 * And add the above calculated value to MICROCDB_START_ADDR. This will give the first Address of the page to be erased
-		 * */
-		addressOfPage = (uint8_t*) (MICROCDB_START_ADDR
-				+ (pageToErase * FLASH_PAGE_SIZE));
+				/*First copy the extra bytes after the address (till where the data will be filled after update) till page end as beyond that
+				 * the DB shift would have taken care. This will be required during writing last page of EditedData to flash*/
+				generalptr = UpdateEndPtr;
+				while (generalptr < (addressOfPage + PAGE_SIZE)) {
+					PreStoredData[bytecntr] = *generalptr;
+					generalptr++;
+					bytecntr++;
+				}
 
-		/*Check if the field to be updated is object if it is, then the data to be updated will be next to the old data by adding
-		 * a comma next to old data*/
-		if (FindResult.JSON_type == JSON_OBJ) {
-			/*This means that the data to be updated will erase the pre stored data in flash which is beyond
-			 FindResult.DBEndptr and hence the data in flash memory needs to be shifted right with that number of
-			 bytes(Bytes from FindResult.DBEndptr), this is the expanding operation of Database.For this operation
-			 these extra bytes will be stored in the PreStoredData buffer*/
+				/*Calculate the Address of first byte of page where DBEndptr lies*/
 
-			/*Check if this operation would cross the boundaries of MICROCDB_END_ADDR*/
-			if (checkCrossesMem(
-			PAGE_SIZE - (FindResult.DBEndptr - addressOfPage)) == true) {
-				return NO_MEMORY;
-			} else {
-				/*Proceed with update as the data which will be stored won't make database shift right go beyond MICROCDB_END_ADDR*/
+				/*Get the page number to be erased*/
+				pageToErase = CalculateFlashPageNum(
+						(uint32_t*) FindResult.DBEndptr);
 
-				/*Check if database size is less than 1 FLASH_PAGE_SIZE and after update will be less than flash page.
-				 *This is very unlikely but case should be handled!*/
-				if (CalculateStringLength(
-						(uint8_t*) MICROCDB_START_ADDR)<PAGE_SIZE && (CalculateStringLength(
-										(uint8_t*) MICROCDB_START_ADDR)+1+ len)<PAGE_SIZE) {
-					/*If the database size is less than one flash page size then no need of database shifting, only copy page in RAM and
-					 * update new data and write it again!*/
+				/* Now calculate the starting Address of the pageToErase
+				 * For it multiply the pageToErase with page size. This will give the number of bytes to be incremented from the MICROCDB_START_ADDR
+				 * And add the above calculated value to MICROCDB_START_ADDR. This will give the first Address of the page to be erased
+				 * */
+				addressOfPage = (uint8_t*) (DB_START_ADDR
+						+ (pageToErase * FLASH_PAGE_SIZE));
 
-					/*Copy the data to be updated to Edited data buffer*/
-					diff = 0;
+				/*Now copy the data to be updated to this EditedData Buffer*/
+
+				/*Calculate the difference between the addressOfPage and (FindResult.DBEndptr - 1) so that this difference can be added to index of
+				 * EditedData buffer so that new data can be updated after it. */
+				diff = (FindResult.DBEndptr - 1) - addressOfPage;
+				EditedData[diff] = ',';/*Add comma as the new data will be the next object/field in the FindResult boundaries*/
+				diff++;/*increment to point to next byte after comma*/
+
+				/*Now copy the data pointed by the value pointer to EditedData from index calculated as diff above till the length of the value string
+				 *.This will edit the buffer and replace old values with the new ones*/
+				if (len > (PAGE_SIZE - diff))
+					generalptr = value + (PAGE_SIZE - diff); //set general pointer only till the remaining size of EditedData so it will not overflow
+				else
+					generalptr = value + len; //set general pointer to point to last byte of value
+
+				while (value != generalptr) {
+					EditedData[diff] = *value;
+					value++;
+					diff++;
+				}
 
-					/*First copy the data at the page till DBEndptr*/
-					while (addressOfPage < FindResult.DBEndptr) {
-						EditedData[diff] = *addressOfPage;
-						diff++;
-						addressOfPage++;
-					};
+				/*Now copy the bytes in the page before updated data starts*/
+				diff = 0;
+				generalptr = addressOfPage;
+				while (diff < ((FindResult.DBEndptr - 1) - addressOfPage)) {
+					EditedData[diff] = *generalptr;
+					diff++;
+					generalptr++;
+				}
 
-					/*Adding comma only if there is something in the object*/
-					if ((FindResult.DBEndptr - FindResult.DBStartptr) > 1) {
-						EditedData[diff] = ','; /*Adding comma, as till here the data inside the DBStart-Endptr might be copied*/
-						diff++;
+				/*Move the database right to create free space to fit the given data at the location where update needs to be done.
+				 *For it, the database will be copied to next locations by the number of bytes equal to the length of data that needs to be
+				 *updated */
+
+				/*copying the page to be edited to Flash is completed now proceed with shifting whole database right. This can also be called
+				 * database expansion operation. Argument is len. The len is the number of bytes of the value(data to be updated), addressOfPage
+				 * is the address of first byte of the page where update needs to be performed, FinResult is the microcdb_status after finding
+				 * Hence this number of bytes free space is needed*/
+				if (ShiftDatabaseRight(len, addressOfPage, &FindResult)
+						!= SHIFT_SUCCESS) {
+					return UPDATE_FAILED;
+				}
+
+				/*Till here the database might have been expanded and a free space equal to len+1 has been created in Flash. Now proceed with
+				 * Storing the EditedData to that space thereby storing the first chunk of the data to be update at flash page*/
+
+				/*Erase the page where the addressOfPage points. In this case it will be the page where the FindResult.DBStartptr lies*/
+				if (ErasePage(addressOfPage) != ERASE_SUCCESS) {
+					return UPDATE_FAILED;
+				} else {
+					if (WritePage((uint32_t*) EditedData,
+							(uint32_t*) addressOfPage, FLASH_PAGE_SIZE)
+							!= FL_STORE_SUCCESS) {
+						return UPDATE_FAILED;
+					} else {
+						addressOfPage = addressOfPage + FLASH_PAGE_SIZE;
+						diff = 0;/*Making this to zero to point to first index of EditedData buffer*/
 					}
-					len = diff + len; /*get the number of bytes after adding data to be updated*/
+				}
+
+				/*Set the generalptr to point to first byte of the page where UpdateEndPtr lies*/
+				/*Get the page number to be erased*/
+				pageToErase = CalculateFlashPageNum(
+						(uint32_t*) UpdateEndPtr);
+
+				/* Now calculate the starting Address of the pageToErase
+				 * For it multiply the pageToErase with page size. This will give the number of bytes to be incremented from the MICROCDB_START_ADDR
+				 * And add the above calculated value to MICROCDB_START_ADDR. This will give the first Address of the page to be erased
+				 * */
+				generalptr = (uint8_t*) (DB_START_ADDR
+						+ (pageToErase * FLASH_PAGE_SIZE));
 
-					/*Now copy the the data to be updated*/
-					while (diff < len) {
+				while (!UpdateCompleteFlag) {
+
+					diff = 0;
+
+					/*Now copy the data pointed by the value pointer to EditedData until the diff is less than the FLASH_PAGE_SIZE as the the
+					 * updated data can be more than FLASH_PAGE_SIZE or until the diff is less than the len(number of bytes of data to be updated)
+					 * as much of the new data might have stored so this condition was also given to avoid unnecessary pointing*/
+					while ((diff < FLASH_PAGE_SIZE) || (diff < len)) {
+						if (*value == '/') {
+							break; /*Ended the data to be updated hence stop copying*/
+						}
 						EditedData[diff] = *value;
-						diff++;
 						value++;
-					};
+						diff++;
+					}
 
-					/*Copy the data in PrestoredData to Edited Data*/
+					/*Check if this is the last page to be stored.If it is then need to copy the prestored data at this page which was created
+					 * after database shift right operation. Because now that page will be erased as Flash memory allows 32 bit word write operations
+					 * So for it the page needs to be erased and whole page will be written. So this time the EditedData will have the remaining
+					 * value(data to be updated) and after it the PreStoredData buffer values*/
+					if (addressOfPage == generalptr) {
 
-					while (diff < FLASH_PAGE_SIZE) {
-						EditedData[diff] = *addressOfPage;
-						diff++;
-						addressOfPage++;
-					};
+						bytecntr = 0;
+						UpdateCompleteFlag = 1; //setting this because this is the last page to be written so this loop needs to be breaked
+						while (diff < PAGE_SIZE) {
+							EditedData[diff] = PreStoredData[bytecntr]; //Copy the prestored data to next index of EditedData buffer
+							diff++;
+							bytecntr++;
+						}
 
-					/*Copy the Edited data to Flash by erasing the page*/
-					addressOfPage = (uint8_t*) (MICROCDB_START_ADDR
-							+ (pageToErase * FLASH_PAGE_SIZE));
+						if (WritePage((uint32_t*) EditedData,
+								(uint32_t*) addressOfPage,
+								FLASH_PAGE_SIZE) != FL_STORE_SUCCESS) {
+							return UPDATE_FAILED;
+						} else {
+							addressOfPage = addressOfPage + PAGE_SIZE;
+							diff = 0;
+							PageCntr++;
+						}
 
-					/*Erase the page where the addressOfPage points.*/
-					if (ErasePage(addressOfPage) != ERASE_SUCCESS) {
-						return UPDATE_FAILED;
-					} else {
+					} /*If this is the last page ends here*/
+
+					else {
+						/*Now write the EditedData buffer to flash. Here no erase is done, as it will be done by the ShiftDatabaseRight
+						 * function*/
 						if (WritePage((uint32_t*) EditedData,
-								(uint32_t*) addressOfPage, FLASH_PAGE_SIZE)
-								!= FL_STORE_SUCCESS) {
+								(uint32_t*) addressOfPage,
+								PAGE_SIZE) != FL_STORE_SUCCESS) {
 							return UPDATE_FAILED;
 						} else {
-							return UPDATE_SUCCESSFUL;
+							addressOfPage = addressOfPage + PAGE_SIZE;
+							diff = 0;
 						}
 					}
 
-				} else {
+				};
+			}/*Else if database size is less than flash page size*/
 
-					/*First copy the extra bytes after the address (till where the data will be filled after update) till page end as beyond that
-					 * the DB shift would have taken care. This will be required during writing last page of EditedData to flash*/
-					generalptr = UpdateEndPtr;
-					while (generalptr < (addressOfPage + PAGE_SIZE)) {
-						PreStoredData[bytecntr] = *generalptr;
-						generalptr++;
-						bytecntr++;
-					}
+		}/*Else checkcrosses memory ends here*/
+	} else {
+
+		/*Check the length of data and select the appropriate method of update*/
+
+		/*If data to be updated is greater than the (FindResult.DBEndptr - FindResult.DBStartptr) then the database needs to be shifted right
+		 * by the amount of bytes which are more to free up space or if the data to be updated is a object then its natural that the new data
+		 * updated will added along with old data in that object so in this case also the database will be expanded*/
+		if (len > ((FindResult.DBEndptr - FindResult.DBStartptr) + 1)) {
+			/*This means that the data to be updated will erase the pre stored data in flash which is beyond
+			 FindResult.DBEndptr and hence the data in flash memory needs to be shifted right with that number of
+			 bytes(Bytes from FindResult.DBEndptr), this is the expanding operation of Database.For this operation
+			 these extra bytes will be stored in the PreStoredData buffer*/
 
-					/*Calculate the Address of first byte of page where DBEndptr lies*/
+			/*Check if this operation would cross the boundaries of MICROCDB_END_ADDR*/
+			if (checkCrossesMem(
+			FLASH_PAGE_SIZE - (FindResult.DBEndptr - addressOfPage)) == true) {
+				return NO_MEMORY;
+			} else {
+				/*Proceed with update as the data which will be stored won't make database shift right go beyond MICROCDB_END_ADDR*/
 
-					/*Get the page number to be erased*/
-					pageToErase = CalculateFlashPageNum(
-							(uint32_t*) FindResult.DBEndptr);
+				/*First copy the extra bytes from the FindResult.DBEndptr to FLASH_PAGE_SIZE to Pre stored buffer*/
 
-					/* Now calculate the starting Address of the pageToErase
-					 * For it multiply the pageToErase with page size. This will give the number of bytes to be incremented from the MICROCDB_START_ADDR
-					 * And add the above calculated value to MICROCDB_START_ADDR. This will give the first Address of the page to be erased
-					 * */
-					addressOfPage = (uint8_t*) (MICROCDB_START_ADDR
-							+ (pageToErase * FLASH_PAGE_SIZE));
+				generalptr = FindResult.DBEndptr;
 
-					/*Now copy the data to be updated to this EditedData Buffer*/
+				bytecntr = 0;
+
+				/*Fill prestored data with Empty bytes of Flash memory*/
+				while (bytecntr < FLASH_PAGE_SIZE) {
+					PreStoredData[bytecntr] = FL_EMPTY_BYTE;
+					bytecntr++;
+				}
+
+				bytecntr = 0;
+
+				/*Calculate the number of bytes that the PreStoredData will hold*/
+				bytecntr = (addressOfPage + FLASH_PAGE_SIZE)
+						- FindResult.DBEndptr;
+
+				/*Calculate the number of bytes the DBEndptr is from addressOfPage. This will be the index of the of PreStoredData buffer
+				 * below this will be empty FL_EMPTY_BYTE*/
+
+				/*Calculate the number of bytes from which the FindResult.DBEndptr starts including data at DBEndptr*/
+				diff = FindResult.DBEndptr - addressOfPage;
+
+				/*Copy the data pointed by the generalptr to pre stored buffer from the diff*/
+				while (diff < FLASH_PAGE_SIZE) {
+					PreStoredData[diff] = *generalptr;
+					generalptr++;
+					diff++;
+				}
 
+				if (*FindResult.DBEndptr != '}') {
+					/*Now copy the Data pointed from addressOfPage to EditedData till the FindResult.DBStartptr as beyond that would be data that needs to
+					 * be edited. addressOfPage will be the address of the first byte of the page where the FindResult.DBStartptr lies */
+					CopyFlashBytesToRAM(EditedData, addressOfPage,
+							(FindResult.DBStartptr - addressOfPage));
+				} else {
+					/*Now copy the Data pointed from addressOfPage to EditedData till the (FindResult.DBEndptr - 1) as beyond that would be data that needs to
+					 * be edited.This is done because this is object so there can be data in the object of FindResult pointers so the new data needs
+					 * to be copied with the data within it.AddressOfPage will be the address of the first byte of the page where the FindResult.DBEndptr lies */
+					CopyFlashBytesToRAM(EditedData, addressOfPage,
+							((FindResult.DBEndptr - 1) - addressOfPage));
+				}
+				/*Now copy the data to be updated to this EditedData Buffer*/
+
+				if (*FindResult.DBEndptr != '}') {
+					/*If FindResult is not a object then set the diff which is index of EditedData to Number of bytes till DBStartptr*/
+					diff = FindResult.DBStartptr - addressOfPage;
+				} else {
 					/*Calculate the difference between the addressOfPage and (FindResult.DBEndptr - 1) so that this difference can be added to index of
 					 * EditedData buffer so that new data can be updated after it. */
 					diff = (FindResult.DBEndptr - 1) - addressOfPage;
-					EditedData[diff] = ',';/*Add comma as the new data will be the next object/field in the FindResult boundaries*/
-					diff++;/*increment to point to next byte after comma*/
+					EditedData[diff] = ',';/*Add comma as the new data will be the next object in the FindResult boundaries*/
+					diff++;
+				}
 
-					/*Now copy the data pointed by the value pointer to EditedData from index calculated as diff above till the length of the value string
-					 *.This will edit the buffer and replace old values with the new ones*/
-					if (len > (PAGE_SIZE - diff))
-						generalptr = value + (PAGE_SIZE - diff); //set general pointer only till the remaining size of EditedData so it will not overflow
-					else
-						generalptr = value + len; //set general pointer to point to last byte of value
+				/*Now copy the data pointed by the value pointer to EditedData from index calculated as diff above till the length of the value string
+				 *.This will edit the buffer and replace old values with the new ones*/
+				while (*value != '/') {
+					EditedData[diff] = *value;
+					value++;
+					diff++;
+				}
 
-					while (value != generalptr) {
-						EditedData[diff] = *value;
-						value++;
+				/*Check if database size is less than 1 FLASH_PAGE_SIZE. This is very unlikely but case should be handled!*/
+				if (CalculateStringLength(
+						(uint8_t*) DB_START_ADDR)<FLASH_PAGE_SIZE) {
+					/*If the database size is less than one flash page size then no need of database shifting, only copy page in RAM and
+					 * update new data and write it again!*/
+
+					/*First copy the data in PrestoredData to Edited Data*/
+
+					/*Calculate the number of bytes from which the FindResult.DBEndptr starts including data at DBEndptr*/
+					diff = FindResult.DBEndptr - addressOfPage;
+
+					while (diff < FLASH_PAGE_SIZE) {
+						EditedData[diff + 1] = PreStoredData[diff];
 						diff++;
 					}
 
-					/*Now copy the bytes in the page before updated data starts*/
-					diff = 0;
-					generalptr = addressOfPage;
-					while (diff < ((FindResult.DBEndptr - 1) - addressOfPage)) {
-						EditedData[diff] = *generalptr;
-						diff++;
-						generalptr++;
+					/*Erase the page where the addressOfPage points.*/
+					if (ErasePage(addressOfPage) != ERASE_SUCCESS) {
+						return UPDATE_FAILED;
+					} else {
+						if (WritePage((uint32_t*) EditedData,
+								(uint32_t*) addressOfPage,
+								FLASH_PAGE_SIZE) != FL_STORE_SUCCESS) {
+							return UPDATE_FAILED;
+						} else {
+							return UPDATE_SUCCESSFUL;
+						}
 					}
 
+				} else {
+
 					/*Move the database right to create free space to fit the given data at the location where update needs to be done.
 					 *For it, the database will be copied to next locations by the number of bytes equal to the length of data that needs to be
 					 *updated */
 
 					/*copying the page to be edited to Flash is completed now proceed with shifting whole database right. This can also be called
-					 * database expansion operation. Argument is len. The len is the number of bytes of the value(data to be updated), addressOfPage
-					 * is the address of first byte of the page where update needs to be performed, FinResult is the microcdb_status after finding
-					 * Hence this number of bytes free space is needed*/
-					if (ShiftDatabaseRight(len, addressOfPage, &FindResult)
-							!= SHIFT_SUCCESS) {
+					 * database expansion operation. Argument is len+bytecntr. The len is the number of bytes of the value(data to be updated)
+					 * and in this case the bytecntr is the number of extra bytes which are after FindResult.DBEndptr till End of flash page. Hence
+					 * this number of bytes free space is needed*/
+					if (ShiftDatabaseRight(len + bytecntr, generalptr,
+							&FindResult) != SHIFT_SUCCESS) {
 						return UPDATE_FAILED;
 					}
 
-					/*Till here the database might have been expanded and a free space equal to len+1 has been created in Flash. Now proceed with
-					 * Storing the EditedData to that space thereby storing the first chunk of the data to be update at flash page*/
+					/*Till here the database might have been expanded and a free space equal to len has been created in Flash. Now proceed with
+					 * Storing the EditedData to that space*/
 
-					/*Erase the page where the addressOfPage points. In this case it will be the page where the FindResult.DBStartptr lies*/
+					/*set the addressOfPage to FindResult.DBStartptr + 1. So that it will point to flash memory at address next to FindResul.DBStartptr.
+					 * This is because the new data needs to be updated/stored under it.*/
+					addressOfPage = FindResult.DBStartptr + 1;
+					/*Erase the page where the addressOfPage points. In this case it will be the page where the FindResul.DBStartptr lies*/
 					if (ErasePage(addressOfPage) != ERASE_SUCCESS) {
 						return UPDATE_FAILED;
 					} else {
 						if (WritePage((uint32_t*) EditedData,
-								(uint32_t*) addressOfPage, FLASH_PAGE_SIZE)
-								!= FL_STORE_SUCCESS) {
+								(uint32_t*) addressOfPage,
+								FLASH_PAGE_SIZE) != FL_STORE_SUCCESS) {
 							return UPDATE_FAILED;
 						} else {
 							addressOfPage = addressOfPage + FLASH_PAGE_SIZE;
@@ -820,21 +1918,11 @@ microcDB_Status MicrocDB_Update(uint8_t *path, uint8_t *value) {
 						}
 					}
 
-					/*Set the generalptr to point to first byte of the page where UpdateEndPtr lies*/
-					/*Get the page number to be erased*/
-					pageToErase = CalculateFlashPageNum(
-							(uint32_t*) UpdateEndPtr);
-
-					/* Now calculate the starting Address of the pageToErase
-					 * For it multiply the pageToErase with page size. This will give the number of bytes to be incremented from the MICROCDB_START_ADDR
-					 * And add the above calculated value to MICROCDB_START_ADDR. This will give the first Address of the page to be erased
-					 * */
-					generalptr = (uint8_t*) (MICROCDB_START_ADDR
-							+ (pageToErase * FLASH_PAGE_SIZE));
-
-					while (!UpdateCompleteFlag) {
+					NumberofPages = ((uint32_t) (FindResult.DBStartptr
+							+ (len + bytecntr)) - (uint32_t) addressOfPage)
+							/ FLASH_PAGE_SIZE;
 
-						diff = 0;
+					while (PageCntr < NumberofPages) {
 
 						/*Now copy the data pointed by the value pointer to EditedData until the diff is less than the FLASH_PAGE_SIZE as the the
 						 * updated data can be more than FLASH_PAGE_SIZE or until the diff is less than the len(number of bytes of data to be updated)
@@ -846,28 +1934,28 @@ microcDB_Status MicrocDB_Update(uint8_t *path, uint8_t *value) {
 							EditedData[diff] = *value;
 							value++;
 							diff++;
-						}
+						};
 
 						/*Check if this is the last page to be stored.If it is then need to copy the prestored data at this page which was created
 						 * after database shift right operation. Because now that page will be erased as Flash memory allows 32 bit word write operations
 						 * So for it the page needs to be erased and whole page will be written. So this time the EditedData will have the remaining
 						 * value(data to be updated) and after it the PreStoredData buffer values*/
-						if (addressOfPage == generalptr) {
+						if ((NumberofPages - PageCntr) != 1) {
 
 							bytecntr = 0;
-							UpdateCompleteFlag = 1; //setting this because this is the last page to be written so this loop needs to be breaked
-							while (diff < PAGE_SIZE) {
+							while (diff < FLASH_PAGE_SIZE) {
 								EditedData[diff] = PreStoredData[bytecntr]; //Copy the prestored data to next index of EditedData buffer
 								diff++;
 								bytecntr++;
-							}
+							};
 
 							if (WritePage((uint32_t*) EditedData,
 									(uint32_t*) addressOfPage,
 									FLASH_PAGE_SIZE) != FL_STORE_SUCCESS) {
 								return UPDATE_FAILED;
 							} else {
-								addressOfPage = addressOfPage + PAGE_SIZE;
+								addressOfPage = addressOfPage
+										+ FLASH_PAGE_SIZE;
 								diff = 0;
 								PageCntr++;
 							}
@@ -879,11 +1967,13 @@ microcDB_Status MicrocDB_Update(uint8_t *path, uint8_t *value) {
 							 * function*/
 							if (WritePage((uint32_t*) EditedData,
 									(uint32_t*) addressOfPage,
-									PAGE_SIZE) != FL_STORE_SUCCESS) {
+									FLASH_PAGE_SIZE) != FL_STORE_SUCCESS) {
 								return UPDATE_FAILED;
 							} else {
-								addressOfPage = addressOfPage + PAGE_SIZE;
+								addressOfPage = addressOfPage
+										+ FLASH_PAGE_SIZE;
 								diff = 0;
+								PageCntr++;
 							}
 						}
 
@@ -891,274 +1981,195 @@ microcDB_Status MicrocDB_Update(uint8_t *path, uint8_t *value) {
 				}/*Else if database size is less than flash page size*/
 
 			}/*Else checkcrosses memory ends here*/
-		} else {
-
-			/*Check the length of data and select the appropriate method of update*/
-
-			/*If data to be updated is greater than the (FindResult.DBEndptr - FindResult.DBStartptr) then the database needs to be shifted right
-			 * by the amount of bytes which are more to free up space or if the data to be updated is a object then its natural that the new data
-			 * updated will added along with old data in that object so in this case also the database will be expanded*/
-			if (len > ((FindResult.DBEndptr - FindResult.DBStartptr) + 1)) {
-				/*This means that the data to be updated will erase the pre stored data in flash which is beyond
-				 FindResult.DBEndptr and hence the data in flash memory needs to be shifted right with that number of
-				 bytes(Bytes from FindResult.DBEndptr), this is the expanding operation of Database.For this operation
-				 these extra bytes will be stored in the PreStoredData buffer*/
-
-				/*Check if this operation would cross the boundaries of MICROCDB_END_ADDR*/
-				if (checkCrossesMem(
-				FLASH_PAGE_SIZE - (FindResult.DBEndptr - addressOfPage)) == true) {
-					return NO_MEMORY;
-				} else {
-					/*Proceed with update as the data which will be stored won't make database shift right go beyond MICROCDB_END_ADDR*/
-
-					/*First copy the extra bytes from the FindResult.DBEndptr to FLASH_PAGE_SIZE to Pre stored buffer*/
-
-					generalptr = FindResult.DBEndptr;
-
-					bytecntr = 0;
-
-					/*Fill prestored data with Empty bytes of Flash memory*/
-					while (bytecntr < FLASH_PAGE_SIZE) {
-						PreStoredData[bytecntr] = FL_EMPTY_BYTE;
-						bytecntr++;
-					}
-
-					bytecntr = 0;
-
-					/*Calculate the number of bytes that the PreStoredData will hold*/
-					bytecntr = (addressOfPage + FLASH_PAGE_SIZE)
-							- FindResult.DBEndptr;
 
-					/*Calculate the number of bytes the DBEndptr is from addressOfPage. This will be the index of the of PreStoredData buffer
-					 * below this will be empty FL_EMPTY_BYTE*/
-
-					/*Calculate the number of bytes from which the FindResult.DBEndptr starts including data at DBEndptr*/
-					diff = FindResult.DBEndptr - addressOfPage;
-
-					/*Copy the data pointed by the generalptr to pre stored buffer from the diff*/
-					while (diff < FLASH_PAGE_SIZE) {
-						PreStoredData[diff] = *generalptr;
-						generalptr++;
-						diff++;
-					}
-
-					if (*FindResult.DBEndptr != '}') {
-						/*Now copy the Data pointed from addressOfPage to EditedData till the FindResult.DBStartptr as beyond that would be data that needs to
-						 * be edited. addressOfPage will be the address of the first byte of the page where the FindResult.DBStartptr lies */
-						CopyFlashBytesToRAM(EditedData, addressOfPage,
-								(FindResult.DBStartptr - addressOfPage));
-					} else {
-						/*Now copy the Data pointed from addressOfPage to EditedData till the (FindResult.DBEndptr - 1) as beyond that would be data that needs to
-						 * be edited.This is done because this is object so there can be data in the object of FindResult pointers so the new data needs
-						 * to be copied with the data within it.AddressOfPage will be the address of the first byte of the page where the FindResult.DBEndptr lies */
-						CopyFlashBytesToRAM(EditedData, addressOfPage,
-								((FindResult.DBEndptr - 1) - addressOfPage));
-					}
-					/*Now copy the data to be updated to this EditedData Buffer*/
-
-					if (*FindResult.DBEndptr != '}') {
-						/*If FindResult is not a object then set the diff which is index of EditedData to Number of bytes till DBStartptr*/
-						diff = FindResult.DBStartptr - addressOfPage;
-					} else {
-						/*Calculate the difference between the addressOfPage and (FindResult.DBEndptr - 1) so that this difference can be added to index of
-						 * EditedData buffer so that new data can be updated after it. */
-						diff = (FindResult.DBEndptr - 1) - addressOfPage;
-						EditedData[diff] = ',';/*Add comma as the new data will be the next object in the FindResult boundaries*/
-						diff++;
-					}
-
-					/*Now copy the data pointed by the value pointer to EditedData from index calculated as diff above till the length of the value string
-					 *.This will edit the buffer and replace old values with the new ones*/
-					while (*value != '/') {
-						EditedData[diff] = *value;
-						value++;
-						diff++;
+		} /*If len is greater ends here*/
+		/*Else data to be updated is equal to the FindResult.DBEndptr - FindResult.DBStartptr and The FindResult pointers are pointing
+		 * non JSON object hence can be updated directly*/
+		else if (len
+				== ((FindResult.DBEndptr - FindResult.DBStartptr) + 1)) {
+
+			/*Now copy the Data pointed from addressOfPage to EditedData till the FLASH_PAGE_SIZE*/
+			if (CopyFlashToRAM((uint32_t*) EditedData,
+					(uint32_t*) addressOfPage) >= FLASH_PAGE_SIZE) {
+
+				/*Now edit the data pointed by the FindResult.DBStartptr to FindResult.DBEndptr*/
+
+				/*Calculate the difference between the addressOfPage and FindResult.DBStartptr so that this difference can be added to index of
+				 * EditedData buffer to get values same as pointed by the FindResult.DBStartptr*/
+				diff = FindResult.DBStartptr - addressOfPage;
+				bytecntr = 0;
+
+				/*Now copy the data pointed by the value pointer to EditedData from index calculated as diff above till the length of the value string
+				 *.This will edit the buffer and replace old values with the new ones*/
+				while (bytecntr < len) {
+					EditedData[diff] = *value;
+					value++;
+					diff++;
+					bytecntr++;
+				};
+
+				/*Now erase the page which has addressOfPage as starting address*/
+				if (ErasePage(addressOfPage) == ERASE_SUCCESS) {
+
+					/*Now write to page whose start address is addressOfPage of the Flash the EditedBuffer*/
+					if (WritePage((uint32_t*) EditedData,
+							(uint32_t*) addressOfPage, FLASH_PAGE_SIZE)
+							!= FL_STORE_SUCCESS) {
+						return UPDATE_FAILED;
 					}
 
-					/*Check if database size is less than 1 FLASH_PAGE_SIZE. This is very unlikely but case should be handled!*/
-					if (CalculateStringLength(
-							(uint8_t*) MICROCDB_START_ADDR)<FLASH_PAGE_SIZE) {
-						/*If the database size is less than one flash page size then no need of database shifting, only copy page in RAM and
-						 * update new data and write it again!*/
-
-						/*First copy the data in PrestoredData to Edited Data*/
-
-						/*Calculate the number of bytes from which the FindResult.DBEndptr starts including data at DBEndptr*/
-						diff = FindResult.DBEndptr - addressOfPage;
-
-						while (diff < FLASH_PAGE_SIZE) {
-							EditedData[diff + 1] = PreStoredData[diff];
-							diff++;
-						}
-
-						/*Erase the page where the addressOfPage points.*/
-						if (ErasePage(addressOfPage) != ERASE_SUCCESS) {
-							return UPDATE_FAILED;
-						} else {
-							if (WritePage((uint32_t*) EditedData,
-									(uint32_t*) addressOfPage,
-									FLASH_PAGE_SIZE) != FL_STORE_SUCCESS) {
-								return UPDATE_FAILED;
-							} else {
-								return UPDATE_SUCCESSFUL;
-							}
-						}
-
-					} else {
-
-						/*Move the database right to create free space to fit the given data at the location where update needs to be done.
-						 *For it, the database will be copied to next locations by the number of bytes equal to the length of data that needs to be
-						 *updated */
-
-						/*copying the page to be edited to Flash is completed now proceed with shifting whole database right. This can also be called
-						 * database expansion operation. Argument is len+bytecntr. The len is the number of bytes of the value(data to be updated)
-						 * and in this case the bytecntr is the number of extra bytes which are after FindResult.DBEndptr till End of flash page. Hence
-						 * this number of bytes free space is needed*/
-						if (ShiftDatabaseRight(len + bytecntr, generalptr,
-								&FindResult) != SHIFT_SUCCESS) {
-							return UPDATE_FAILED;
-						}
-
-						/*Till here the database might have been expanded and a free space equal to len has been created in Flash. Now proceed with
-						 * Storing the EditedData to that space*/
-
-						/*set the addressOfPage to FindResult.DBStartptr + 1. So that it will point to flash memory at address next to FindResul.DBStartptr.
-						 * This is because the new data needs to be updated/stored under it.*/
-						addressOfPage = FindResult.DBStartptr + 1;
-						/*Erase the page where the addressOfPage points. In this case it will be the page where the FindResul.DBStartptr lies*/
-						if (ErasePage(addressOfPage) != ERASE_SUCCESS) {
-							return UPDATE_FAILED;
-						} else {
-							if (WritePage((uint32_t*) EditedData,
-									(uint32_t*) addressOfPage,
-									FLASH_PAGE_SIZE) != FL_STORE_SUCCESS) {
-								return UPDATE_FAILED;
-							} else {
-								addressOfPage = addressOfPage + FLASH_PAGE_SIZE;
-								diff = 0;/*Making this to zero to point to first index of EditedData buffer*/
-							}
-						}
-
-						NumberofPages = ((uint32_t) (FindResult.DBStartptr
-								+ (len + bytecntr)) - (uint32_t) addressOfPage)
-								/ FLASH_PAGE_SIZE;
-
-						while (PageCntr < NumberofPages) {
-
-							/*Now copy the data pointed by the value pointer to EditedData until the diff is less than the FLASH_PAGE_SIZE as the the
-							 * updated data can be more than FLASH_PAGE_SIZE or until the diff is less than the len(number of bytes of data to be updated)
-							 * as much of the new data might have stored so this condition was also given to avoid unnecessary pointing*/
-							while ((diff < FLASH_PAGE_SIZE) || (diff < len)) {
-								if (*value == '/') {
-									break; /*Ended the data to be updated hence stop copying*/
-								}
-								EditedData[diff] = *value;
-								value++;
-								diff++;
-							};
-
-							/*Check if this is the last page to be stored.If it is then need to copy the prestored data at this page which was created
-							 * after database shift right operation. Because now that page will be erased as Flash memory allows 32 bit word write operations
-							 * So for it the page needs to be erased and whole page will be written. So this time the EditedData will have the remaining
-							 * value(data to be updated) and after it the PreStoredData buffer values*/
-							if ((NumberofPages - PageCntr) != 1) {
-
-								bytecntr = 0;
-								while (diff < FLASH_PAGE_SIZE) {
-									EditedData[diff] = PreStoredData[bytecntr]; //Copy the prestored data to next index of EditedData buffer
-									diff++;
-									bytecntr++;
-								};
-
-								if (WritePage((uint32_t*) EditedData,
-										(uint32_t*) addressOfPage,
-										FLASH_PAGE_SIZE) != FL_STORE_SUCCESS) {
-									return UPDATE_FAILED;
-								} else {
-									addressOfPage = addressOfPage
-											+ FLASH_PAGE_SIZE;
-									diff = 0;
-									PageCntr++;
-								}
-
-							} /*If this is the last page ends here*/
-
-							else {
-								/*Now write the EditedData buffer to flash. Here no erase is done, as it will be done by the ShiftDatabaseRight
-								 * function*/
-								if (WritePage((uint32_t*) EditedData,
-										(uint32_t*) addressOfPage,
-										FLASH_PAGE_SIZE) != FL_STORE_SUCCESS) {
-									return UPDATE_FAILED;
-								} else {
-									addressOfPage = addressOfPage
-											+ FLASH_PAGE_SIZE;
-									diff = 0;
-									PageCntr++;
-								}
-							}
-
-						};
-					}/*Else if database size is less than flash page size*/
-
-				}/*Else checkcrosses memory ends here*/
+				} else {
+					return UPDATE_FAILED;
+				}
 
-			} /*If len is greater ends here*/
-			/*Else data to be updated is equal to the FindResult.DBEndptr - FindResult.DBStartptr and The FindResult pointers are pointing
-			 * non JSON object hence can be updated directly*/
-			else if (len
-					== ((FindResult.DBEndptr - FindResult.DBStartptr) + 1)) {
+			} else {
+				return UPDATE_FAILED;
+			}
 
-				/*Now copy the Data pointed from addressOfPage to EditedData till the FLASH_PAGE_SIZE*/
-				if (CopyFlashToRAM((uint32_t*) EditedData,
-						(uint32_t*) addressOfPage) >= FLASH_PAGE_SIZE) {
+		}
+		/*Else if the data to be updated is less than the (FindResult.DBEndptr - FindResult.DBStartptr) then the database needs to be
+		 * shifted left by amount of bytes by which the data is less.This is the shrinking operation of the database*/
+		else if (len < (FindResult.DBEndptr - FindResult.DBStartptr)) {
 
-					/*Now edit the data pointed by the FindResult.DBStartptr to FindResult.DBEndptr*/
+		}
+	}/*If a object check else ends here*/
+	return UPDATE_SUCCESSFUL;
+}
 
-					/*Calculate the difference between the addressOfPage and FindResult.DBStartptr so that this difference can be added to index of
-					 * EditedData buffer to get values same as pointed by the FindResult.DBStartptr*/
-					diff = FindResult.DBStartptr - addressOfPage;
-					bytecntr = 0;
+/*TODO: Need to find a way to update the JSON data type. For example if any body updates a field
+ * which was JSON_STRING before with JSON_PRIMITIVE then parser won't parse it as JSON_PRMITIVE
+ * because, it was JSON_STRING before and has '\"' quotes before and after data pointed by the path. */
+/*
+ * This function updates the value at the path in the selected collection. It is the body of MicrocDB_Update()
+ * Returns: microcDB_Status same as MicrocDB_Update()
+ */
+microcDB_Status UpdateValue(uint8_t *path, uint8_t *value) {
+	microcDB_Data FindResult;
+	uint8_t *ValueStart, *OldEnd;
+	microcDB_Status status;
+#if MICROCDB_OBJECT_SLACK > 0
+	microcDB_Status SlackStatus;
+#endif
 
-					/*Now copy the data pointed by the value pointer to EditedData from index calculated as diff above till the length of the value string
-					 *.This will edit the buffer and replace old values with the new ones*/
-					while (bytecntr < len) {
-						EditedData[diff] = *value;
-						value++;
-						diff++;
-						bytecntr++;
-					};
+#if MICROCDB_COMPRESSION == 1
+	return UPDATE_FAILED; /*Compressed blocks can't be edited in place*/
+#endif
 
-					/*Now erase the page which has addressOfPage as starting address*/
-					if (ErasePage(addressOfPage) == ERASE_SUCCESS) {
+	FindResult.DBstatus = NOT_FOUND; /*Initialize the find result for NOT_FOUND*/
 
-						/*Now write to page whose start address is addressOfPage of the Flash the EditedBuffer*/
-						if (WritePage((uint32_t*) EditedData,
-								(uint32_t*) addressOfPage, FLASH_PAGE_SIZE)
-								!= FL_STORE_SUCCESS) {
-							return UPDATE_FAILED;
-						}
+	FindResult = FindPath(path);
+	uint16_t len = CalculateStringLength(value);
 
-					} else {
-						return UPDATE_FAILED;
-					}
+	/*if strings are passed then replace ' to \"*/
+	if (*value == '\'') {
+		replacesingleTodouble(value, len);
+	}
 
-				} else {
-					return UPDATE_FAILED;
-				}
+	if (FindResult.DBstatus == FOUND_SUCCESS) {
 
-			}
-			/*Else if the data to be updated is less than the (FindResult.DBEndptr - FindResult.DBStartptr) then the database needs to be
-			 * shifted left by amount of bytes by which the data is less.This is the shrinking operation of the database*/
-			else if (len < (FindResult.DBEndptr - FindResult.DBStartptr)) {
+		/*Check if the FindResult pointer are not pointing to array if it is then return with error as this is not the function to be used with array*/
+		if (FindResult.JSON_type == JSON_ARRAY) {
+			return DATA_IS_ARRAY; /*This function cannot be used for arrays*/
+		}
 
+#if MICROCDB_OBJECT_SLACK > 0
+		/*If the update fits in the slack of object then DB is not shifted. The pinned snapshots see the objects so they are not
+		 * changed in place while any is pinned*/
+		if (!SNAPSHOT_PINNED()
+				&& SlackUpdate(&FindResult, value, len, &SlackStatus)) {
+			return SlackStatus;
+		}
+#endif
+#if MICROCDB_RELOCATION == 1
+		/*Otherwise the grown object is relocated*/
+		SlackStatus = UPDATE_FAILED;
+		if (RelocateUpdate(&FindResult, value, len, &SlackStatus)) {
+			return SlackStatus;
+		}
+		/*The superseded copies are reclaimed when the relocation region is full and no snapshot sees them, which moves the copies*/
+		if (SlackStatus == NO_MEMORY && !SNAPSHOT_PINNED()
+				&& RelocationReclaim()) {
+			FindResult = FindPath(path);
+			if (FindResult.DBstatus == FOUND_SUCCESS
+					&& RelocateUpdate(&FindResult, value, len, &SlackStatus)) {
+				return SlackStatus;
 			}
-		}/*If a object check else ends here*/
+		}
+		if (SNAPSHOT_PINNED()) {
+			return SNAPSHOT_CONFLICT;
+		}
+		/*The relocated objects are not in the region of DB so they can't be shifted*/
+		if (RELOCATED(FindResult.DBStartptr)) {
+			return NO_MEMORY;
+		}
+#endif
+#if MICROCDB_OBJECT_SLACK > 0
+#if MICROCDB_RELOCATION == 0
+		/*The object which can't be relocated is given more slack by shifting the DB after it*/
+		if (SNAPSHOT_PINNED()) {
+			return SNAPSHOT_CONFLICT;
+		}
+		SlackStatus = SlackGrow(&FindResult, len);
+		if (SlackStatus != UPDATE_SUCCESSFUL) {
+			return SlackStatus;
+		}
+		if (SlackUpdate(&FindResult, value, len, &SlackStatus)) {
+			return SlackStatus;
+		}
+#endif
+		/*The DB is not shifted otherwise as the slack of objects after the update would be moved off the half words. The relocated
+		 * copies keep the address of the objects they were relocated from*/
+		return NOT_ENOUGH_SPACE;
+#endif
+
+		/*The string is found without its quotes*/
+		ValueStart = FindResult.DBStartptr
+				- (FindResult.JSON_type == JSON_STRING ? 1 : 0);
+		OldEnd = SkipJSONValue(ValueStart, (uint8_t*) DB_END_ADDR);
+		status = ShiftValue(FindResult, value, len);
+		if (status == UPDATE_SUCCESSFUL) {
+			/*The documents after the value were shifted by the change of its length*/
+			HASH_INDEX_SHIFT(OldEnd,
+					SkipJSONValue(ValueStart, (uint8_t*) DB_END_ADDR) - OldEnd);
+		}
+		return status;
 	} else {
 		return PATH_NOT_FOUND;
 	}
 	return UPDATE_SUCCESSFUL;
 }
 
+microcDB_Status MicrocDB_Update(uint8_t *path, uint8_t *value) {
+	microcDB_Status status;
+	LATENCY_BEGIN();
+
+	STATS_BEGIN(STATS_OP_UPDATE);
+	DEVICES_SYNC();
+	if (UPDATE_JOB_PENDING()) {
+		return UPDATE_PENDING; /*The DB is partly shifted by the job*/
+	}
+	CHANGE_BEGIN();
+	SEQ_WRITE_BEGIN();
+#if MICROCDB_MEMTABLE_BYTES > 0
+	status = MemtableUpdate(path, value);
+#else
+	status = UpdateValue(path, value);
+	if (status == UPDATE_SUCCESSFUL) {
+		KEY_INDEX_UPDATED(path); /*The values after the updated one may have been shifted*/
+		HASH_INDEX_UPDATED(path);
+	}
+#endif
+	if (status == PATH_NOT_FOUND && TIER_COLD(path)) {
+		status = DATA_IS_COLD; /*It is updated after MicrocDB_TierStep() moves it back to DB*/
+	}
+	SEQ_WRITE_END();
+
+	LATENCY_END(LATENCY_OP_UPDATE);
+	if (status == UPDATE_SUCCESSFUL) {
+		CHANGE_EMIT(CHANGE_UPDATE, 0, path, value);
+	}
+	return status;
+}
+
 /*MicrocDB high level functions*/
 /**********************************************************************************************************************************/
@@ -0,0 +1,251 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The aggregate queries of microcDB. The array list or object is scanned once from flash and every number of it is
+ *      converted in place and added to the result, so no element is copied or parsed again.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_AGGREGATES == 1
+
+/*MISC functions*/
+
+/*
+ * This function initializes the aggregate result for no numbers.
+ */
+static inline void AggregateInit(microcDB_Aggregate *Result) {
+	Result->Count = 0;
+	Result->Sum = 0;
+	Result->Min = 0;
+	Result->Max = 0;
+	Result->Mean = 0;
+}
+
+/*
+ * This function adds the number between Start and End(both inclusive) to the result. Non numeric values are skipped.
+ */
+static void AggregateAdd(uint8_t *Start, uint8_t *End,
+		microcDB_Aggregate *Result) {
+	float value;
+
+	if (!AsciiToFloat(Start, End, &value)) {
+		return;
+	}
+	if (Result->Count == 0 || value < Result->Min)
+		Result->Min = value;
+	if (Result->Count == 0 || value > Result->Max)
+		Result->Max = value;
+	Result->Sum = Result->Sum + value;
+	Result->Count++;
+}
+
+/*
+ * This function calculates the mean of the aggregated numbers.
+ */
+static inline void AggregateFinish(microcDB_Aggregate *Result) {
+	if (Result->Count != 0)
+		Result->Mean = Result->Sum / (float) Result->Count;
+}
+
+/*
+ * This function compares the Length chars of the string with the key.
+ * Returns: true if same
+ */
+static inline bool KeyEquals(uint8_t *String, uint8_t *Key, size_t Length) {
+	while (Length != 0) {
+		if (*String != *Key)
+			return false;
+		String++;
+		Key++;
+		Length--;
+	}
+	return true;
+}
+
+/*
+ * This function scans the array list or object from its starting bracket/brace Start till its ending bracket/brace End and adds its
+ * numbers to result.
+ * Logic:
+ * The depth is 0 inside the array list or object. If no key is given then the numbers at depth 0 are the elements of array list or
+ * values of object. If key is given then every element is an object whose members are at depth 1, so the number at depth 1 which is
+ * value of the key is added. An element object which was relocated is scanned in its latest copy with the depth of its members, and
+ * its old copy is skipped. Strings are skipped as a whole so the braces or digits in them are not counted, and the slack is skipped
+ * like in Find.
+ */
+static void AggregateRange(uint8_t *Start, uint8_t *End, uint8_t *Key,
+		size_t KeyLength, int16_t depth, microcDB_Aggregate *Result) {
+	uint8_t *ptr = SkipSlack(Start + 1, End), *string, *number;
+	bool KeyMatched = false;
+#if MICROCDB_RELOCATION == 1
+	uint8_t *ObjectEnd, *CopyStart, *CopyEnd;
+#endif
+
+	STATS_ADD(ParserBytes, End - Start + 1);
+
+	while (ptr < End) {
+		switch (*ptr) {
+
+		case '\"':
+			string = ++ptr;
+			while (*ptr != '\"' && ptr < End)
+				ptr++;
+			/*If a key at the depth of members of the elements then check if it is the required one*/
+			if (Key != 0 && depth == 1 && *(ptr + 1) == ':') {
+				KeyMatched = ((size_t) (ptr - string) == KeyLength)
+						&& KeyEquals(string, Key, KeyLength);
+			}
+			ptr++;
+			break;
+
+		case '{':
+#if MICROCDB_RELOCATION == 1
+			if (Key != 0 && depth == 0) {
+				ObjectEnd = SkipJSONValue(ptr, End);
+				CopyStart = ptr;
+				CopyEnd = ObjectEnd;
+				if (RelocationFollow(&CopyStart, &CopyEnd)) {
+					AggregateRange(CopyStart, CopyEnd, Key, KeyLength, 1,
+							Result);
+					ptr = ObjectEnd + 1;
+					break;
+				}
+			}
+#endif
+			depth++;
+			ptr = SkipSlack(ptr + 1, End);
+			break;
+
+		case '[':
+			depth++;
+			ptr++;
+			break;
+
+		case '}':
+		case ']':
+			depth--;
+			KeyMatched = false;
+			ptr++;
+			break;
+
+		case ',':
+			KeyMatched = false;
+			ptr = SkipSlack(ptr + 1, End);
+			break;
+
+		case '-':
+		case '0':
+		case '1':
+		case '2':
+		case '3':
+		case '4':
+		case '5':
+		case '6':
+		case '7':
+		case '8':
+		case '9':
+			number = ptr;
+			while (ptr < End
+					&& ((*ptr >= '0' && *ptr <= '9') || *ptr == '.'
+							|| *ptr == '-'))
+				ptr++;
+			if ((Key == 0 && depth == 0) || (KeyMatched && depth == 1))
+				AggregateAdd(number, ptr - 1, Result);
+			KeyMatched = false;
+			break;
+
+		default:
+			ptr++; /*true, false and the ':' are not needed*/
+		}
+	}
+}
+
+/*
+ * This function aggregates the array list or object at path. It is called again by MicrocDB_Aggregate() if the writer task wrote the
+ * DB while it was read, so the result is initialized here.
+ */
+static microcDB_Status AggregatePath(uint8_t *path, uint8_t *field,
+		microcDB_Aggregate *Result) {
+	microcDB_Data FindResult;
+	size_t KeyLength = 0;
+#if MICROCDB_ARRAY_SEGMENTS == 1
+	uint8_t *Segment, *SegmentList, *SegmentEnd;
+#endif
+
+	AggregateInit(Result);
+
+	FindResult = FindPath(path);
+	if (FindResult.DBstatus != FOUND_SUCCESS) {
+		return PATH_NOT_FOUND;
+	}
+	if (FindResult.JSON_type != JSON_ARRAY
+			&& FindResult.JSON_type != JSON_OBJ) {
+		return PATH_NOT_ARRAYLIST;
+	}
+
+	if (field != 0) {
+		/*The key is till the dot*/
+		while (field[KeyLength] != '.' && field[KeyLength] != '/')
+			KeyLength++;
+	}
+
+	AggregateRange(FindResult.DBStartptr, FindResult.DBEndptr, field,
+			KeyLength, 0, Result);
+#if MICROCDB_ARRAY_SEGMENTS == 1
+	/*The elements appended by MicrocDB_UpdateArrayList() are in the overflow segments*/
+	if (FindResult.JSON_type == JSON_ARRAY) {
+		for (Segment = ArraySegmentFirst(path); Segment != 0; Segment =
+				ArraySegmentNext(Segment)) {
+			SegmentList = ArraySegmentList(Segment, &SegmentEnd);
+			AggregateRange(SegmentList, SegmentEnd, field, KeyLength, 0,
+					Result);
+		}
+	}
+#endif
+	AggregateFinish(Result);
+	return FOUND_SUCCESS;
+}
+
+/*MISC functions*/
+
+/**************************************************************************************************************************************/
+/*MicrocDB aggregate functions*/
+
+microcDB_Status MicrocDB_Aggregate(uint8_t *path, uint8_t *field,
+		microcDB_Aggregate *Result) {
+	microcDB_Status status;
+
+	STATS_BEGIN(STATS_OP_FIND);
+	DEVICES_SYNC();
+	if (UPDATE_JOB_PENDING()) {
+		return UPDATE_PENDING; /*The DB is partly shifted by the job*/
+	}
+	SEQ_READ(status = AggregatePath(path, field, Result));
+	return status;
+}
+
+#if MICROCDB_CAPPED_SUPPORT == 1
+microcDB_Status MicrocDB_CappedAggregate(microcDB_CappedIterator *Iterator,
+		uint8_t *field, microcDB_Aggregate *Result) {
+	microcDB_CappedIterator Begin;
+	microcDB_Aggregate Partial;
+	microcDB_Data Value;
+
+	AggregateInit(Result);
+
+	do {
+		/*The number is added only if the writer task didn't reuse its page while it was read, otherwise it is read again*/
+		Begin = *Iterator;
+		Partial = *Result;
+		SEQ_READ(*Iterator = Begin; *Result = Partial;
+				Value = MicrocDB_CappedNext(Iterator, field);
+				if (Value.DBstatus == FOUND_SUCCESS && Value.JSON_type == JSON_PRIMITIVE)
+					AggregateAdd(Value.DBStartptr, Value.DBEndptr, Result));
+	} while (Value.DBstatus == FOUND_SUCCESS);
+
+	AggregateFinish(Result);
+	return (Value.DBstatus == READ_CONFLICT) ? READ_CONFLICT : FOUND_SUCCESS;
+}
+#endif
+
+/*MicrocDB aggregate functions*/
+#endif
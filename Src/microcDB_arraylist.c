@@ -0,0 +1,463 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The array list appends of microcDB. The appended elements are not inserted in the array list stored in DB as that
+ *      			 needs the DB after it to be shifted. Instead they are written as an overflow segment at the end of the log of
+ *      			 segments in their own flash region and the link of the last segment of the array list is programmed with its address.
+ *      			 So an append writes only the segment and one link. The first segment of an array list is found by its path.
+ *
+ *      			 Layout of a segment:
+ *      			 |Size(2 bytes)|Next(4 bytes)|Path with '/'|Appended elements with '[' and ']' padded to half word|Size(2 bytes)|
+ *      			 The Next is the address of the next segment of the same array list and is empty till it is appended. The size after
+ *      			 the elements is used to check that the segment was completely written. A segment which was not, due to a failed
+ *      			 write or power loss, is skipped by its first size and never linked.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_ARRAY_SEGMENTS == 1
+
+#define SEGMENT_NEXT_OFFSET 2
+#define SEGMENT_PATH_OFFSET 6
+#define SEGMENT_OVERHEAD 8
+#define EMPTY_HALFWORD ((uint16_t)(((uint8_t)FL_EMPTY_BYTE << 8) | (uint8_t)FL_EMPTY_BYTE))
+#define EMPTY_WORD (((uint32_t)EMPTY_HALFWORD << 16) | EMPTY_HALFWORD)
+
+static uint8_t *AppendAddr = (uint8_t*) MICROCDB_ARRAY_START_ADDR; /*The address where next segment will be written*/
+static uint8_t *LastWritten = 0; /*The last written segment. It is the last segment of its array list so the next append to the same
+ array list doesn't need to walk the segments*/
+static MICROCDB_THREAD_LOCAL uint8_t Joined[MICROCDB_ARRAY_FIND_BYTES]; /*The array list given by MicrocDB_Find()*/
+
+/*The bytes of a segment are given in parts of any length, so the odd byte is kept till the next part to write half words*/
+typedef struct {
+	uint32_t Address;
+	uint8_t Pending;
+	bool HasPending;
+} segment_Writer;
+
+/*MISC functions*/
+
+/*
+ * This function reads the link to next segment. It is read as half words as it is not aligned to word.
+ */
+static inline uint32_t SegmentLink(uint8_t *Segment) {
+	return (uint32_t) *(uint16_t*) (Segment + SEGMENT_NEXT_OFFSET)
+			| ((uint32_t) *(uint16_t*) (Segment + SEGMENT_NEXT_OFFSET + 2)
+					<< 16);
+}
+
+/*
+ * This function checks if the segment was completely written.
+ */
+static inline bool SegmentComplete(uint8_t *Segment) {
+	uint16_t Size = *(uint16_t*) Segment;
+
+	return Size != EMPTY_HALFWORD && Size >= SEGMENT_OVERHEAD
+			&& Segment + Size <= (uint8_t*) MICROCDB_ARRAY_END_ADDR + 1
+			&& *(uint16_t*) (Segment + Size - 2) == Size;
+}
+
+/*
+ * This function gives the address after the segments written from Segment, complete or not. The first size of a segment is written
+ * before anything else so a segment having it can be skipped. If the size is not valid then the rest of region is taken as used as it
+ * can't be known which bytes were written.
+ */
+static uint8_t* SegmentsEnd(uint8_t *Segment) {
+	uint16_t Size;
+
+	while (Segment + SEGMENT_OVERHEAD <= (uint8_t*) MICROCDB_ARRAY_END_ADDR + 1) {
+		Size = *(uint16_t*) Segment;
+		if (Size == EMPTY_HALFWORD) {
+			return Segment;
+		}
+		if (Size < SEGMENT_OVERHEAD || (Size & 1) != 0
+				|| Segment + Size > (uint8_t*) MICROCDB_ARRAY_END_ADDR + 1) {
+			break;
+		}
+		Segment = Segment + Size;
+	}
+	return (uint8_t*) MICROCDB_ARRAY_END_ADDR + 1;
+}
+
+/*
+ * This function copies the elements of the array list from Start till End(its brackets) after the Length bytes joined before.
+ * Returns: the length joined or MICROCDB_ARRAY_FIND_BYTES + 1 if the elements don't fit
+ */
+static size_t JoinElements(uint8_t *Start, uint8_t *End, size_t Length) {
+	uint8_t *ptr;
+	bool First = true;
+
+	for (ptr = Start + 1; ptr < End; ptr++) {
+		if (Length + 2 > MICROCDB_ARRAY_FIND_BYTES) {
+			return MICROCDB_ARRAY_FIND_BYTES + 1; /*One byte is kept for the ending bracket*/
+		}
+		if (First && Length > 1) {
+			Joined[Length++] = ',';
+		}
+		First = false;
+		Joined[Length++] = *ptr;
+	}
+	return Length;
+}
+
+/*
+ * This function checks if the path of segment is same as the given path. Both are terminated with '/'.
+ */
+static bool PathEquals(uint8_t *Segment, uint8_t *path) {
+	uint8_t *SegmentPath = Segment + SEGMENT_PATH_OFFSET;
+
+	while (*path != '/') {
+		if (*SegmentPath != *path) {
+			return false;
+		}
+		SegmentPath++;
+		path++;
+	}
+	return *SegmentPath == '/';
+}
+
+/*
+ * This function writes the Count bytes after the bytes written before by the writer.
+ * Returns: true if written
+ */
+static bool WriterPut(segment_Writer *Writer, uint8_t *Bytes, size_t Count) {
+	uint8_t Pair[2];
+	size_t Even;
+
+	if (Writer->HasPending && Count != 0) {
+		Pair[0] = Writer->Pending;
+		Pair[1] = *Bytes;
+		if (WriteBytesToFLASH(Pair, Writer->Address, 2) != FL_STORE_SUCCESS) {
+			return false;
+		}
+		Writer->Address = Writer->Address + 2;
+		Writer->HasPending = false;
+		Bytes++;
+		Count--;
+	}
+
+	Even = Count & ~((size_t) 1);
+	if (Even != 0
+			&& WriteBytesToFLASH(Bytes, Writer->Address, Even)
+					!= FL_STORE_SUCCESS) {
+		return false;
+	}
+	Writer->Address = Writer->Address + Even;
+
+	if (Count & 1) {
+		Writer->Pending = Bytes[Even];
+		Writer->HasPending = true;
+	}
+	return true;
+}
+
+/*
+ * This function writes the odd byte kept by the writer padded with the empty byte.
+ * Returns: true if written
+ */
+static bool WriterFlush(segment_Writer *Writer) {
+	if (Writer->HasPending) {
+		if (WriteBytesToFLASH(&Writer->Pending, Writer->Address, 1)
+				!= FL_STORE_SUCCESS) {
+			return false;
+		}
+		Writer->Address = Writer->Address + 2;
+		Writer->HasPending = false;
+	}
+	return true;
+}
+
+/*
+ * This function writes the segment of the path having the elements of data at AppendAddr and moves the AppendAddr after it once it is
+ * completely written. If writing failed after the size was written then the segment is skipped like after a power loss.
+ * Returns: microcDB_Status UPDATE_SUCCESSFUL, UPDATE_FAILED or NO_MEMORY
+ */
+static microcDB_Status WriteSegment(uint8_t *path, uint8_t *data, size_t len) {
+	segment_Writer Writer;
+	size_t PathLength = CalculateStringLength(path) + 1;
+	uint32_t Size = SEGMENT_OVERHEAD + PathLength + len + 2;
+	uint8_t SizeBytes[2], Bracket;
+
+	Size = Size + (Size & 1);
+	if (Size > EMPTY_HALFWORD - 1
+			|| AppendAddr + Size > (uint8_t*) MICROCDB_ARRAY_END_ADDR + 1) {
+		return NO_MEMORY;
+	}
+	SizeBytes[0] = (uint8_t) Size;
+	SizeBytes[1] = (uint8_t) (Size >> 8);
+	Writer.Address = (uint32_t) AppendAddr + SEGMENT_PATH_OFFSET;
+	Writer.HasPending = false;
+
+	/*The Next is left empty to be programmed by the next append*/
+	Bracket = '[';
+	if (WriteBytesToFLASH(SizeBytes, (uint32_t) AppendAddr, 2)
+			!= FL_STORE_SUCCESS || !WriterPut(&Writer, path, PathLength)
+			|| !WriterPut(&Writer, &Bracket, 1)
+			|| !WriterPut(&Writer, data, len)) {
+		AppendAddr = SegmentsEnd(AppendAddr);
+		return UPDATE_FAILED;
+	}
+	Bracket = ']';
+	if (!WriterPut(&Writer, &Bracket, 1) || !WriterFlush(&Writer)
+			|| WriteBytesToFLASH(SizeBytes, Writer.Address, 2)
+					!= FL_STORE_SUCCESS) {
+		AppendAddr = SegmentsEnd(AppendAddr);
+		return UPDATE_FAILED;
+	}
+	AppendAddr = AppendAddr + Size;
+	return UPDATE_SUCCESSFUL;
+}
+
+/*
+ * This function appends the data to the array list at path. It is the body of MicrocDB_UpdateArrayList()
+ * Returns: microcDB_Status same as MicrocDB_UpdateArrayList()
+ */
+static microcDB_Status AppendToArrayList(uint8_t *path, uint8_t *data) {
+	microcDB_Data FindResult;
+	microcDB_Status status;
+	uint8_t *Segment, *Last = 0, *NewSegment = AppendAddr;
+	uint8_t LinkBytes[4];
+	size_t len = CalculateStringLength(data);
+
+	if (len == 0) {
+		return UPDATE_FAILED;
+	}
+
+	/*Find the last segment of the array list. If nothing was appended yet then the path is checked in DB*/
+	if (LastWritten != 0 && SegmentLink(LastWritten) == EMPTY_WORD
+			&& PathEquals(LastWritten, path)) {
+		Last = LastWritten;
+	} else {
+		for (Segment = ArraySegmentFirst(path); Segment != 0; Segment =
+				ArraySegmentNext(Segment))
+			Last = Segment;
+	}
+	if (Last == 0) {
+		FindResult = FindPath(path);
+		if (FindResult.DBstatus != FOUND_SUCCESS) {
+			return PATH_NOT_FOUND;
+		}
+		if (FindResult.JSON_type != JSON_ARRAY) {
+			return PATH_NOT_ARRAYLIST;
+		}
+	}
+
+	/*if strings are passed then replace ' to \"*/
+	replacesingleTodouble(data, len);
+
+	status = WriteSegment(path, data, len);
+	if (status != UPDATE_SUCCESSFUL) {
+		return status;
+	}
+
+	/*Link the new segment after the last one. Until this the new segment is not a part of the array list*/
+	if (Last != 0) {
+		LinkBytes[0] = (uint8_t) (uint32_t) NewSegment;
+		LinkBytes[1] = (uint8_t) ((uint32_t) NewSegment >> 8);
+		LinkBytes[2] = (uint8_t) ((uint32_t) NewSegment >> 16);
+		LinkBytes[3] = (uint8_t) ((uint32_t) NewSegment >> 24);
+		if (WriteBytesToFLASH(LinkBytes,
+				(uint32_t) (Last + SEGMENT_NEXT_OFFSET), 4)
+				!= FL_STORE_SUCCESS) {
+			return UPDATE_FAILED;
+		}
+	}
+	LastWritten = NewSegment;
+	return UPDATE_SUCCESSFUL;
+}
+
+/*MISC functions*/
+
+/**************************************************************************************************************************************/
+/*MicrocDB array list functions*/
+
+void ArraySegmentsInit() {
+	AppendAddr = SegmentsEnd((uint8_t*) MICROCDB_ARRAY_START_ADDR);
+	LastWritten = 0;
+}
+
+flash_mem_Stat ArraySegmentsErase() {
+	uint32_t Page;
+
+	AppendAddr = (uint8_t*) MICROCDB_ARRAY_START_ADDR;
+	LastWritten = 0;
+	/*The pages are erased one by one as EraseDB() moves the FlashAddresscntr of DB*/
+	for (Page = MICROCDB_ARRAY_START_ADDR; Page < MICROCDB_ARRAY_END_ADDR;
+			Page = Page + FLASH_PAGE_SIZE) {
+		if (ErasePage((uint8_t*) Page) != ERASE_SUCCESS) {
+			return ERASE_FAILED;
+		}
+	}
+	return ERASE_SUCCESS;
+}
+
+uint8_t* ArraySegmentFirst(uint8_t *path) {
+	uint8_t *Segment = (uint8_t*) MICROCDB_ARRAY_START_ADDR;
+
+	/*Only the first segment of an array list is searched, the others are linked to it. A segment which is linked to another one
+	 * is never the first as the first segment of path is found before it*/
+	while (Segment < AppendAddr) {
+		if (SegmentComplete(Segment) && PathEquals(Segment, path)) {
+			return Segment;
+		}
+		Segment = Segment + *(uint16_t*) Segment;
+	}
+	return 0;
+}
+
+uint8_t* ArraySegmentNext(uint8_t *Segment) {
+	uint32_t Next = SegmentLink(Segment);
+
+	/*The link is checked as it may be partly written by a failed append*/
+	if (Next <= (uint32_t) Segment || Next >= (uint32_t) AppendAddr
+			|| !SegmentComplete((uint8_t*) Next)) {
+		return 0;
+	}
+	return (uint8_t*) Next;
+}
+
+uint8_t* ArraySegmentList(uint8_t *Segment, uint8_t **End) {
+	uint8_t *List = Segment + SEGMENT_PATH_OFFSET;
+
+	while (*List != '/')
+		List++;
+	/*The ending bracket is before the size or before the padding byte*/
+	*End = Segment + *(uint16_t*) Segment - 3;
+	if (**End != ']')
+		(*End)--;
+	return List + 1;
+}
+
+void ArraySegmentsJoin(uint8_t *path, microcDB_Data *Data) {
+	uint8_t *Segment, *List, *End;
+	size_t Length = 1;
+
+	if (Data->DBstatus != FOUND_SUCCESS || Data->JSON_type != JSON_ARRAY) {
+		return;
+	}
+	Segment = ArraySegmentFirst(path);
+	if (Segment == 0) {
+		return; /*The array list stored in DB is given as it is*/
+	}
+
+	Joined[0] = '[';
+	Length = JoinElements(Data->DBStartptr, Data->DBEndptr, Length);
+	for (; Segment != 0 && Length <= MICROCDB_ARRAY_FIND_BYTES; Segment =
+			ArraySegmentNext(Segment)) {
+		List = ArraySegmentList(Segment, &End);
+		Length = JoinElements(List, End, Length);
+	}
+	if (Length > MICROCDB_ARRAY_FIND_BYTES) {
+		Data->DBstatus = NO_MEMORY;
+		Data->DBStartptr = 0;
+		Data->DBEndptr = 0;
+		return;
+	}
+	Joined[Length] = ']';
+	Data->DBStartptr = Joined;
+	Data->DBEndptr = Joined + Length;
+}
+
+microcDB_Status MicrocDB_UpdateArrayList(uint8_t *path, uint8_t *data) {
+	microcDB_Status status;
+	LATENCY_BEGIN();
+
+	STATS_BEGIN(STATS_OP_UPDATE);
+	DEVICES_SYNC();
+	if (UPDATE_JOB_PENDING()) {
+		return UPDATE_PENDING; /*The array list can't be found in the partly shifted DB*/
+	}
+	CHANGE_BEGIN();
+	SEQ_WRITE_BEGIN();
+	status = AppendToArrayList(path, data);
+	SEQ_WRITE_END();
+
+	LATENCY_END(LATENCY_OP_UPDATE);
+	if (status == UPDATE_SUCCESSFUL) {
+		CHANGE_EMIT(CHANGE_APPEND, 0, path, data);
+	}
+	return status;
+}
+
+microcDB_Status MicrocDB_ArrayIterBegin(uint8_t *path,
+		microcDB_ArrayIterator *Iterator) {
+	microcDB_Data FindResult;
+
+	STATS_BEGIN(STATS_OP_FIND);
+	DEVICES_SYNC();
+	if (UPDATE_JOB_PENDING()) {
+		return UPDATE_PENDING; /*The DB is partly shifted by the job*/
+	}
+
+#if MICROCDB_SEQLOCK == 1
+	/*The iterator keeps the sequence so that ArrayNext finds if the DB was written since then*/
+	do {
+		Iterator->Sequence = SeqReadBegin();
+		FindResult = FindPath(path);
+		Iterator->Segment = ArraySegmentFirst(path);
+	} while (SeqReadRetry(Iterator->Sequence));
+#else
+	FindResult = FindPath(path);
+	Iterator->Segment = ArraySegmentFirst(path);
+#endif
+	if (FindResult.DBstatus != FOUND_SUCCESS) {
+		return PATH_NOT_FOUND;
+	}
+	if (FindResult.JSON_type != JSON_ARRAY) {
+		return PATH_NOT_ARRAYLIST;
+	}
+	Iterator->Element = FindResult.DBStartptr + 1;
+	Iterator->End = FindResult.DBEndptr;
+	return FOUND_SUCCESS;
+}
+
+microcDB_Data MicrocDB_ArrayNext(microcDB_ArrayIterator *Iterator) {
+	microcDB_Data data_out_struct;
+	uint8_t *ElementEnd;
+
+	DEVICES_SYNC(); /*The DB may be written since the last element was given*/
+	if (UPDATE_JOB_PENDING()) {
+		/*The elements after the one given may have been moved by the job begun since then*/
+		data_out_struct.DBstatus = UPDATE_PENDING;
+		data_out_struct.JSON_type = JSON_UNDEFINED;
+		data_out_struct.DBStartptr = 0;
+		data_out_struct.DBEndptr = 0;
+		return data_out_struct;
+	}
+
+	/*Continue with the next segment when the elements of array list or segment are completed*/
+	while (Iterator->Element >= Iterator->End) {
+		if (Iterator->Segment == 0) {
+#if MICROCDB_SEQLOCK == 1
+			data_out_struct.DBstatus =
+					SeqReadRetry(Iterator->Sequence) ? READ_CONFLICT : NOT_FOUND;
+#else
+			data_out_struct.DBstatus = NOT_FOUND;
+#endif
+			data_out_struct.JSON_type = JSON_UNDEFINED;
+			data_out_struct.DBStartptr = 0;
+			data_out_struct.DBEndptr = 0;
+			return data_out_struct;
+		}
+		Iterator->Element = ArraySegmentList(Iterator->Segment,
+				&Iterator->End) + 1;
+		Iterator->Segment = ArraySegmentNext(Iterator->Segment);
+	}
+
+	ElementEnd = SkipJSONValue(Iterator->Element, Iterator->End);
+	ValueToData(Iterator->Element, ElementEnd, &data_out_struct);
+
+	Iterator->Element = ElementEnd + 1;
+	if (*Iterator->Element == ',')
+		Iterator->Element++;
+#if MICROCDB_SEQLOCK == 1
+	/*The element may have been moved or changed by the writer task while it was read or since the iteration began*/
+	if (SeqReadRetry(Iterator->Sequence)) {
+		data_out_struct.DBstatus = READ_CONFLICT;
+		data_out_struct.JSON_type = JSON_UNDEFINED;
+	}
+#endif
+	return data_out_struct;
+}
+
+/*MicrocDB array list functions*/
+#endif
@@ -0,0 +1,602 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The incremental backup of microcDB. The flash drivers give every change of the region of DB before it is done and
+ *      			 the page having it is logged, once for every checkpoint. A checkpoint is logged as a marker so the generation of a
+ *      			 checkpoint is the number of markers before it added to the base generation of log. The pages changed since a checkpoint
+ *      			 are the ones logged after its marker. When the log is full it is erased and begun again from the current generation,
+ *      			 so the older checkpoints are lost and a backup since them has all the pages.
+ *      			 The generation of the stream restored last is logged after the checkpoint taken by the restore, so an incremental
+ *      			 stream is restored only on the DB which has the pages of the generation it is since. A page logged after it means
+ *      			 the DB was changed locally so it doesn't have them anymore.
+ *
+ *      			 Layout of the log:
+ *      			 |Base generation(4 bytes)|Entry(2 bytes)|Entry(2 bytes)|...|Empty|
+ *      			 An entry is the number of the page from MICROCDB_START_ADDR or CHECKPOINT_ENTRY or RESTORED_ENTRY. RESTORED_ENTRY is
+ *      			 followed by the restored generation in two entries of 15 bits each, low bits first, so they are never empty.
+ *
+ *      			 The pages of a stream are checked and written to the stage before any page of DB is erased, so a corrupt stream
+ *      			 doesn't change the DB. The header of stage is written last and its magic marks that the pages are to be written to
+ *      			 DB, so if the power is lost while they are written MicrocDB_Init() writes them again.
+ *      			 Layout of the stage:
+ *      			 |Magic(2 bytes)|Count(2 bytes)|Generation(4 bytes)|Page number(2 bytes)|...|Empty| Page | Page |...
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_BACKUP == 1
+
+#define DB_PAGES ((MICROCDB_END_ADDR + 1 - MICROCDB_START_ADDR) / PAGE_SIZE)
+#define LOG_HEADER_SIZE 4
+#define CHECKPOINT_ENTRY 0x8000
+#define RESTORED_ENTRY 0x8001
+#define RESTORED_ENTRY_SIZE 6
+#define STREAM_HEADER_SIZE 16
+#define CHUNK_HEADER_SIZE 4
+#define EMPTY_HALFWORD ((uint16_t)(((uint8_t)FL_EMPTY_BYTE << 8) | (uint8_t)FL_EMPTY_BYTE))
+#define EMPTY_WORD (((uint32_t)EMPTY_HALFWORD << 16) | EMPTY_HALFWORD)
+
+#define LOG_START ((uint8_t*) MICROCDB_BACKUP_START_ADDR)
+#define LOG_END ((uint8_t*) MICROCDB_BACKUP_END_ADDR + 1)
+#define STAGE_START ((uint8_t*) MICROCDB_BACKUP_STAGE_START_ADDR)
+#define STAGE_HEADER_SIZE 8
+#define STAGE_MAGIC ((uint16_t)('m' | ('S' << 8)))
+
+static uint8_t *LogAppendAddr = (uint8_t*) MICROCDB_BACKUP_START_ADDR + LOG_HEADER_SIZE; /*The address where next entry will be written*/
+static uint32_t CheckpointGeneration = 1; /*The generation of the last checkpoint*/
+static uint8_t ChangedPages[(DB_PAGES + 7) / 8]; /*The pages logged since the last checkpoint*/
+static bool LogFailed = false; /*Set if a change couldn't be logged, then the backups have all the pages till the log is begun again*/
+static uint32_t RestoredGeneration = 0; /*The generation of the stream restored last, 0 if the DB was changed after it or never restored*/
+static bool StageResumed = false; /*Set if BackupInit() wrote the stage to DB, then BackupResume() completes the restore*/
+
+/*MISC functions*/
+
+/*
+ * This function adds the bytes to the FNV-1a hash.
+ */
+static uint32_t HashBytes(uint32_t hash, uint8_t *Bytes, uint16_t Length) {
+	while (Length != 0) {
+		hash ^= *Bytes;
+		hash *= 16777619u; /*FNV-1a prime*/
+		Bytes++;
+		Length--;
+	}
+	return hash;
+}
+
+/*
+ * This function stores the number little endian in the bytes.
+ */
+static inline void PutLittleEndian(uint8_t *Bytes, uint32_t Number,
+		uint8_t Count) {
+	while (Count != 0) {
+		*Bytes = (uint8_t) Number;
+		Number = Number >> 8;
+		Bytes++;
+		Count--;
+	}
+}
+
+/*
+ * This function reads the little endian number of the bytes.
+ */
+static inline uint32_t GetLittleEndian(uint8_t *Bytes, uint8_t Count) {
+	uint32_t Number = 0;
+
+	while (Count != 0) {
+		Count--;
+		Number = (Number << 8) | Bytes[Count];
+	}
+	return Number;
+}
+
+/*
+ * This function writes the entry at the end of log.
+ * Returns: true if written
+ */
+static inline bool WriteEntry(uint16_t Entry) {
+	uint8_t EntryBytes[2] = { (uint8_t) Entry, (uint8_t) (Entry >> 8) };
+
+	if (WriteBytesToFLASH(EntryBytes, (uint32_t) LogAppendAddr, 2)
+			!= FL_STORE_SUCCESS) {
+		return false;
+	}
+	LogAppendAddr = LogAppendAddr + 2;
+	return true;
+}
+
+/*
+ * This function writes RESTORED_ENTRY with RestoredGeneration at the end of log.
+ * Returns: true if written
+ */
+static bool WriteRestored() {
+	return WriteEntry(RESTORED_ENTRY)
+			&& WriteEntry((uint16_t) (RestoredGeneration & 0x7FFF))
+			&& WriteEntry((uint16_t) ((RestoredGeneration >> 15) & 0x7FFF));
+}
+
+/*
+ * This function erases the log and begins it again from the current generation. The pages changed since the last checkpoint and the
+ * restored generation are logged again so the next checkpoint still has them.
+ * Returns: true if the log was begun again
+ */
+static bool BeginLog() {
+	uint8_t *Page;
+	uint8_t Base[LOG_HEADER_SIZE];
+	uint16_t PageNumber;
+
+	for (Page = LOG_START; Page < LOG_END; Page = Page + PAGE_SIZE) {
+		if (ErasePage(Page) != ERASE_SUCCESS) {
+			return false;
+		}
+	}
+	PutLittleEndian(Base, CheckpointGeneration, LOG_HEADER_SIZE);
+	if (WriteBytesToFLASH(Base, (uint32_t) LOG_START, LOG_HEADER_SIZE)
+			!= FL_STORE_SUCCESS) {
+		return false;
+	}
+	LogAppendAddr = LOG_START + LOG_HEADER_SIZE;
+	if (RestoredGeneration != 0 && !WriteRestored()) {
+		return false;
+	}
+	for (PageNumber = 0; PageNumber < DB_PAGES; PageNumber++) {
+		if ((ChangedPages[PageNumber / 8] & (1 << (PageNumber % 8)))
+				&& !WriteEntry(PageNumber)) {
+			return false;
+		}
+	}
+	LogFailed = false;
+	return true;
+}
+
+/*
+ * This function finds the pages changed since the checkpoint of given generation.
+ * Returns: false if the log doesn't have that checkpoint so all the pages should be taken as changed
+ */
+static bool PagesChangedSince(uint32_t Since, uint8_t *Pages) {
+	uint32_t EntryGeneration = GetLittleEndian(LOG_START, LOG_HEADER_SIZE);
+	uint8_t *Entry;
+	uint16_t i;
+
+	if (LogFailed || Since < EntryGeneration) {
+		return false;
+	}
+	for (i = 0; i < sizeof(ChangedPages); i++) {
+		Pages[i] = 0;
+	}
+	for (Entry = LOG_START + LOG_HEADER_SIZE; Entry < LogAppendAddr; Entry =
+			Entry + 2) {
+		if (*(uint16_t*) Entry == CHECKPOINT_ENTRY) {
+			EntryGeneration++;
+		} else if (*(uint16_t*) Entry == RESTORED_ENTRY) {
+			Entry = Entry + RESTORED_ENTRY_SIZE - 2;
+		} else if (EntryGeneration >= Since
+				&& *(uint16_t*) Entry < DB_PAGES) {
+			Pages[*(uint16_t*) Entry / 8] |= 1 << (*(uint16_t*) Entry % 8);
+		}
+	}
+	return true;
+}
+
+/*
+ * This function logs a checkpoint, the pages changed after it are logged again.
+ * Returns: true if logged
+ */
+static bool Checkpoint() {
+	uint16_t i;
+
+	for (i = 0; i < sizeof(ChangedPages); i++) {
+		ChangedPages[i] = 0;
+	}
+	if (LogFailed || LogAppendAddr + 2 > LOG_END) {
+		/*The log is begun again from the new checkpoint which doesn't have any changed page yet*/
+		CheckpointGeneration++;
+		if (!BeginLog()) {
+			CheckpointGeneration--;
+			LogFailed = true;
+			return false;
+		}
+	} else {
+		if (!WriteEntry(CHECKPOINT_ENTRY)) {
+			LogFailed = true;
+			return false;
+		}
+		CheckpointGeneration++;
+	}
+	return true;
+}
+
+/*
+ * This function logs the restored generation. RestoredGeneration should be set before it.
+ * Returns: true if logged
+ */
+static bool LogRestored() {
+	if (LogFailed || LogAppendAddr + RESTORED_ENTRY_SIZE > LOG_END) {
+		/*The log is begun again with the restored generation*/
+		if (!BeginLog()) {
+			LogFailed = true;
+			return false;
+		}
+	} else if (!WriteRestored()) {
+		LogFailed = true;
+		return false;
+	}
+	return true;
+}
+
+/*
+ * This function copies the page of DB to RAM.
+ */
+static void CopyPage(uint32_t *PageData, uint16_t PageNumber) {
+	uint32_t *Word = (uint32_t*) (MICROCDB_START_ADDR
+			+ ((uint32_t) PageNumber * PAGE_SIZE));
+	uint16_t i;
+
+	for (i = 0; i < PAGE_SIZE / 4; i++) {
+		PageData[i] = Word[i];
+	}
+}
+
+/*
+ * This function gives the bytes of a chunk to the callback and adds them to the hash of chunk.
+ * Returns: true if the callback wrote them
+ */
+static inline bool WriteChunkBytes(microcDB_BackupWrite Write, void *Context,
+		uint8_t *Bytes, uint16_t Length, uint32_t *Hash) {
+	*Hash = HashBytes(*Hash, Bytes, Length);
+	return Write(Bytes, Length, Context);
+}
+
+/*
+ * This function gives the hash of chunk to the callback.
+ * Returns: true if the callback wrote it
+ */
+static inline bool WriteChecksum(microcDB_BackupWrite Write, void *Context,
+		uint32_t Hash) {
+	uint8_t Checksum[4];
+
+	PutLittleEndian(Checksum, Hash, 4);
+	return Write(Checksum, 4, Context);
+}
+
+/*
+ * This function reads the bytes of a chunk using the callback and adds them to the hash of chunk.
+ * Returns: true if the callback read them
+ */
+static inline bool ReadChunkBytes(microcDB_BackupRead Read, void *Context,
+		uint8_t *Bytes, uint16_t Length, uint32_t *Hash) {
+	if (!Read(Bytes, Length, Context)) {
+		return false;
+	}
+	*Hash = HashBytes(*Hash, Bytes, Length);
+	return true;
+}
+
+/*
+ * This function reads the checksum of chunk using the callback and compares it with the hash of chunk.
+ * Returns: true if they are same
+ */
+static inline bool ChecksumMatches(microcDB_BackupRead Read, void *Context,
+		uint32_t Hash) {
+	uint8_t Checksum[4];
+
+	return Read(Checksum, 4, Context)
+			&& GetLittleEndian(Checksum, 4) == Hash;
+}
+
+/*
+ * This function gives the address where the page of given index of stage is.
+ */
+static inline uint8_t* StagedPage(uint16_t Index) {
+	return STAGE_START + ((uint32_t) (Index + 1) * PAGE_SIZE);
+}
+
+/*
+ * This function writes the pages of stage to DB. The stage is not changed so it is done again if the power is lost in the middle.
+ * Returns: true if written
+ */
+static bool ApplyStage() {
+	uint16_t Count = GetLittleEndian(STAGE_START + 2, 2);
+	uint16_t Index, PageNumber;
+	uint8_t *Page;
+
+	for (Index = 0; Index < Count; Index++) {
+		PageNumber = GetLittleEndian(STAGE_START + STAGE_HEADER_SIZE + 2 * Index,
+				2);
+		Page = (uint8_t*) MICROCDB_START_ADDR
+				+ ((uint32_t) PageNumber * PAGE_SIZE);
+		if (ErasePage(Page) != ERASE_SUCCESS
+				|| WritePage((uint32_t*) StagedPage(Index), (uint32_t*) Page,
+				PAGE_SIZE) != FL_STORE_SUCCESS) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * This function rebuilds the index of the documents after the stage was written to DB and logs the generation of stream. The stage
+ * is erased at last so it is not written again.
+ * Returns: true if completed
+ */
+static bool FinishStage() {
+#if MICROCDB_HASH_INDEX == 1
+	/*The slots of the documents which aren't restored would be stale*/
+#if MICROCDB_COMPRESSION == 1
+	if (CompressedReindex() != STORE_SUCCESS) {
+#else
+	if (HashIndexRebuild() != STORE_SUCCESS) {
+#endif
+		return false;
+	}
+#endif
+	/*The pages changed locally after the checkpoint are logged after the restored generation*/
+	RestoredGeneration = GetLittleEndian(STAGE_START + 4, 4);
+	if (!Checkpoint() || !LogRestored()) {
+		RestoredGeneration = 0;
+		return false;
+	}
+	return ErasePage(STAGE_START) == ERASE_SUCCESS;
+}
+
+/*
+ * This function reads the log of changed pages.
+ */
+static void ReadLog() {
+	uint8_t *Entry = LOG_START + LOG_HEADER_SIZE;
+	uint16_t i;
+
+	for (i = 0; i < sizeof(ChangedPages); i++) {
+		ChangedPages[i] = 0;
+	}
+	if (*(uint32_t*) LOG_START == EMPTY_WORD) {
+		/*The log was never written so it is begun from the first generation*/
+		CheckpointGeneration = 1;
+		if (!BeginLog()) {
+			LogFailed = true;
+		}
+		return;
+	}
+
+	CheckpointGeneration = GetLittleEndian(LOG_START, LOG_HEADER_SIZE);
+	RestoredGeneration = 0;
+	while (Entry < LOG_END && *(uint16_t*) Entry != EMPTY_HALFWORD) {
+		if (*(uint16_t*) Entry == CHECKPOINT_ENTRY) {
+			CheckpointGeneration++;
+			for (i = 0; i < sizeof(ChangedPages); i++) {
+				ChangedPages[i] = 0;
+			}
+		} else if (*(uint16_t*) Entry == RESTORED_ENTRY) {
+			if (Entry + RESTORED_ENTRY_SIZE > LOG_END
+					|| *(uint16_t*) (Entry + 2) == EMPTY_HALFWORD
+					|| *(uint16_t*) (Entry + 4) == EMPTY_HALFWORD) {
+				/*The power was lost while it was written, so the log is begun again without it*/
+				RestoredGeneration = 0;
+				if (!BeginLog()) {
+					LogFailed = true;
+				}
+				return;
+			}
+			RestoredGeneration = *(uint16_t*) (Entry + 2)
+					| ((uint32_t) *(uint16_t*) (Entry + 4) << 15);
+			Entry = Entry + RESTORED_ENTRY_SIZE - 2;
+		} else if (*(uint16_t*) Entry < DB_PAGES) {
+			RestoredGeneration = 0; /*The DB was changed after the restore*/
+			ChangedPages[*(uint16_t*) Entry / 8] |= 1
+					<< (*(uint16_t*) Entry % 8);
+		}
+		Entry = Entry + 2;
+	}
+	LogAppendAddr = Entry;
+}
+
+/*MISC functions*/
+
+microcDB_Status BackupInit() {
+	ReadLog();
+	StageResumed = false;
+	if (*(uint16_t*) STAGE_START == STAGE_MAGIC) {
+		/*The power was lost while the stage was written to DB so it is written again before the DB is initialized*/
+		if (!ApplyStage()) {
+			return INIT_FAILED;
+		}
+		StageResumed = true;
+	}
+	return INIT_CMPLT;
+}
+
+microcDB_Status BackupResume() {
+	if (!StageResumed) {
+		return INIT_CMPLT;
+	}
+	StageResumed = false;
+	return FinishStage() ? INIT_CMPLT : INIT_FAILED;
+}
+
+void BackupTrack(uint32_t Address, uint32_t NumberOfBytes) {
+	uint32_t End = Address + NumberOfBytes;
+	uint16_t PageNumber;
+
+	if (NumberOfBytes == 0 || End <= MICROCDB_START_ADDR
+			|| Address > MICROCDB_END_ADDR) {
+		return; /*The log and the other regions are not tracked*/
+	}
+	if (Address < MICROCDB_START_ADDR) {
+		Address = MICROCDB_START_ADDR;
+	}
+	if (End > MICROCDB_END_ADDR + 1) {
+		End = MICROCDB_END_ADDR + 1;
+	}
+	RestoredGeneration = 0; /*The page logged next tells it after a reset, as the restore logs a checkpoint before its generation*/
+
+	for (PageNumber = (Address - MICROCDB_START_ADDR) / PAGE_SIZE;
+			PageNumber <= (End - 1 - MICROCDB_START_ADDR) / PAGE_SIZE;
+			PageNumber++) {
+		if (ChangedPages[PageNumber / 8] & (1 << (PageNumber % 8))) {
+			continue; /*Already logged since the last checkpoint*/
+		}
+		ChangedPages[PageNumber / 8] |= 1 << (PageNumber % 8);
+		if (LogAppendAddr + 2 > LOG_END) {
+			/*The page is logged again with the others changed since the last checkpoint*/
+			if (!BeginLog()) {
+				LogFailed = true;
+			}
+		} else if (!WriteEntry(PageNumber)) {
+			LogFailed = true;
+		}
+	}
+}
+
+microcDB_Status MicrocDB_BackupCheckpoint(uint32_t *Generation) {
+	STATS_BEGIN(STATS_OP_OTHER);
+	DEVICES_SYNC();
+
+	if (!Checkpoint()) {
+		return STORE_FAILED;
+	}
+	*Generation = CheckpointGeneration;
+	return STORE_SUCCESS;
+}
+
+microcDB_Status MicrocDB_Backup(uint32_t Since, microcDB_BackupWrite Write,
+		void *Context) {
+	uint8_t Pages[sizeof(ChangedPages)];
+	uint8_t Header[STREAM_HEADER_SIZE];
+	uint32_t PageData[PAGE_SIZE / 4]; /*The page is copied so its checksum is of the same bytes which are written*/
+	uint32_t Hash;
+	uint16_t PageNumber, Count = 0;
+	bool AllPages;
+
+	STATS_BEGIN(STATS_OP_OTHER);
+	DEVICES_SYNC();
+
+	if (UPDATE_JOB_PENDING()) {
+		return UPDATE_PENDING;
+	}
+
+	AllPages = Since == 0 || !PagesChangedSince(Since, Pages);
+	for (PageNumber = 0; PageNumber < DB_PAGES; PageNumber++) {
+		if (AllPages || (Pages[PageNumber / 8] & (1 << (PageNumber % 8)))) {
+			Count++;
+		}
+	}
+
+	Header[0] = 'm';
+	Header[1] = 'B';
+	PutLittleEndian(Header + 2, PAGE_SIZE, 2);
+	PutLittleEndian(Header + 4, AllPages ? 0 : Since, 4);
+	PutLittleEndian(Header + 8, CheckpointGeneration, 4);
+	PutLittleEndian(Header + 12, Count, 2);
+	PutLittleEndian(Header + 14, 0, 2);
+	Hash = 2166136261u; /*FNV-1a offset basis*/
+	if (!WriteChunkBytes(Write, Context, Header, STREAM_HEADER_SIZE, &Hash)
+			|| !WriteChecksum(Write, Context, Hash)) {
+		return STORE_FAILED;
+	}
+
+	for (PageNumber = 0; PageNumber < DB_PAGES; PageNumber++) {
+		if (!AllPages && !(Pages[PageNumber / 8] & (1 << (PageNumber % 8)))) {
+			continue;
+		}
+		SEQ_READ(CopyPage(PageData, PageNumber));
+		PutLittleEndian(Header, PageNumber, 2);
+		PutLittleEndian(Header + 2, 0, 2);
+		Hash = 2166136261u;
+		if (!WriteChunkBytes(Write, Context, Header, CHUNK_HEADER_SIZE, &Hash)
+				|| !WriteChunkBytes(Write, Context, (uint8_t*) PageData,
+				PAGE_SIZE, &Hash) || !WriteChecksum(Write, Context, Hash)) {
+			return STORE_FAILED;
+		}
+	}
+	return STORE_SUCCESS;
+}
+
+microcDB_Status MicrocDB_Restore(microcDB_BackupRead Read, void *Context) {
+	uint8_t Header[STREAM_HEADER_SIZE];
+	uint8_t Stage[STAGE_HEADER_SIZE + 2 * DB_PAGES];
+	uint32_t PageData[PAGE_SIZE / 4]; /*Words as it is written by WritePage()*/
+	uint32_t Hash;
+	uint16_t Index, Count;
+	uint32_t Since, Generation;
+	microcDB_Status status = STORE_SUCCESS;
+
+	STATS_BEGIN(STATS_OP_OTHER);
+	DEVICES_SYNC();
+
+	if (UPDATE_JOB_PENDING()) {
+		return UPDATE_PENDING;
+	}
+
+	Hash = 2166136261u; /*FNV-1a offset basis*/
+	if (!ReadChunkBytes(Read, Context, Header, STREAM_HEADER_SIZE, &Hash)
+			|| !ChecksumMatches(Read, Context, Hash) || Header[0] != 'm'
+			|| Header[1] != 'B'
+			|| GetLittleEndian(Header + 2, 2) != PAGE_SIZE) {
+		return BACKUP_CORRUPT;
+	}
+	Since = GetLittleEndian(Header + 4, 4);
+	Generation = GetLittleEndian(Header + 8, 4);
+	Count = GetLittleEndian(Header + 12, 2);
+	if (Since != 0
+			&& (RestoredGeneration == 0 || Since > RestoredGeneration
+					|| Generation < RestoredGeneration)) {
+		/*The DB doesn't have the pages changed before Since, or the stream is older than the DB*/
+		return BACKUP_MISMATCH;
+	}
+	if (Generation == 0 || Generation > 0x3FFFFFFF || Count > DB_PAGES) {
+		return BACKUP_CORRUPT; /*It doesn't fit in the entries of RESTORED_ENTRY or in DB*/
+	}
+
+	/*Every page is checked and staged so the DB is not changed if the stream is corrupt or ends early*/
+	if (ErasePage(STAGE_START) != ERASE_SUCCESS) {
+		return STORE_FAILED;
+	}
+	for (Index = 0; Index < Count; Index++) {
+		Hash = 2166136261u;
+		if (!ReadChunkBytes(Read, Context, Header, CHUNK_HEADER_SIZE, &Hash)
+				|| !ReadChunkBytes(Read, Context, (uint8_t*) PageData,
+				PAGE_SIZE, &Hash) || !ChecksumMatches(Read, Context, Hash)
+				|| GetLittleEndian(Header, 2) >= DB_PAGES) {
+			return BACKUP_CORRUPT;
+		}
+		Stage[STAGE_HEADER_SIZE + 2 * Index] = Header[0];
+		Stage[STAGE_HEADER_SIZE + 2 * Index + 1] = Header[1];
+		if (ErasePage(StagedPage(Index)) != ERASE_SUCCESS
+				|| WritePage(PageData, (uint32_t*) StagedPage(Index), PAGE_SIZE)
+						!= FL_STORE_SUCCESS) {
+			return STORE_FAILED;
+		}
+	}
+	/*The magic is written after the rest of header so the stage is written to DB only if it is complete*/
+	PutLittleEndian(Stage, STAGE_MAGIC, 2);
+	PutLittleEndian(Stage + 2, Count, 2);
+	PutLittleEndian(Stage + 4, Generation, 4);
+	if (WriteBytesToFLASH(Stage + 2, (uint32_t) STAGE_START + 2,
+	STAGE_HEADER_SIZE - 2 + 2 * Count) != FL_STORE_SUCCESS
+			|| WriteBytesToFLASH(Stage, (uint32_t) STAGE_START, 2)
+					!= FL_STORE_SUCCESS) {
+		return STORE_FAILED;
+	}
+
+	SEQ_WRITE_BEGIN();
+	if (RestoredGeneration != 0) {
+		/*The pages restored may not be logged again if they were changed since the last checkpoint*/
+		RestoredGeneration = 0;
+		if (!LogRestored()) {
+			SEQ_WRITE_END();
+			return STORE_FAILED;
+		}
+	}
+	/*If writing fails then the stage is written again by MicrocDB_Init()*/
+	if (!ApplyStage()) {
+		status = STORE_FAILED;
+	}
+	FindAppendAddress(); /*The DB may end at other address now*/
+	KEY_INDEX_BUILD();
+	if (status == STORE_SUCCESS && !FinishStage()) {
+		status = STORE_FAILED;
+	}
+	SEQ_WRITE_END();
+	return status;
+}
+
+#endif
@@ -0,0 +1,440 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The source code for the capped collection of MicrocDB. It is a ring buffer of pages in its own flash region.
+ *      			 Documents are appended to the newest page and when it is full the next page which has the oldest documents is
+ *      			 erased and used as the newest page. So the append is O(1) and the database is never shifted.
+ *
+ *      			 Layout of a page:
+ *      			 |Sequence number(4 bytes)|Entry|Entry|...|Empty|
+ *      			 If MICROCDB_CAPPED_TS_INDEX is enabled then the sequence number is followed by the minimum and maximum
+ *      			 timestamp(4 bytes each) of the documents of the page. These are written once when the page gets full, for the
+ *      			 newest page they are kept in RAM.
+ *      			 Layout of an entry:
+ *      			 |Length(2 bytes)|Document with '/' padded to half word|Length(2 bytes)|
+ *      			 The length after document is used to go to previous entry while iterating from newest to oldest.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_CAPPED_SUPPORT == 1
+
+#define CAPPED_PAGES ((MICROCDB_CAPPED_END_ADDR + 1 - MICROCDB_CAPPED_START_ADDR) / FLASH_PAGE_SIZE)
+#if MICROCDB_CAPPED_TS_INDEX == 1
+#define PAGE_HEADER_SIZE 12
+#define PAGE_MIN_TS_OFFSET 4
+#define PAGE_MAX_TS_OFFSET 8
+#else
+#define PAGE_HEADER_SIZE 4
+#endif
+#define ENTRY_OVERHEAD 4
+#define EMPTY_HALFWORD ((uint16_t)(((uint8_t)FL_EMPTY_BYTE << 8) | (uint8_t)FL_EMPTY_BYTE))
+#define EMPTY_WORD (((uint32_t)EMPTY_HALFWORD << 16) | EMPTY_HALFWORD)
+
+static uint32_t HeadPage = 0; /*The index of the newest page*/
+static uint32_t HeadSequence = 0; /*The sequence number of the newest page*/
+static uint8_t *AppendAddr = 0; /*The address in newest page where next entry will be appended*/
+#if MICROCDB_CAPPED_TS_INDEX == 1
+static uint32_t HeadMinTimestamp = 0xFFFFFFFF; /*The minimum and maximum timestamp of the documents in newest page*/
+static uint32_t HeadMaxTimestamp = 0;
+#endif
+
+/*MISC functions*/
+
+/*
+ * This function returns the address of first byte of the page of capped collection
+ */
+static inline uint8_t* CappedPageAddress(uint32_t Page) {
+	return (uint8_t*) MICROCDB_CAPPED_START_ADDR + (Page * FLASH_PAGE_SIZE);
+}
+
+/*
+ * This function returns the number of bytes the entry of document of given length takes
+ */
+static inline uint16_t EntrySize(uint16_t Length) {
+	return Length + (Length & 1) + ENTRY_OVERHEAD;
+}
+
+/*
+ * This function walks the entries of the page and returns the address after the last complete entry. An entry whose length
+ * after document doesn't match the length before it was not completely written and so the walk stops there.
+ */
+static uint8_t* PageEnd(uint32_t Page) {
+	uint8_t *entry = CappedPageAddress(Page) + PAGE_HEADER_SIZE;
+	uint8_t *pageEnd = CappedPageAddress(Page) + FLASH_PAGE_SIZE;
+	uint16_t Length;
+
+	while (entry + ENTRY_OVERHEAD <= pageEnd) {
+		Length = *(uint16_t*) entry;
+		if (Length == EMPTY_HALFWORD || entry + EntrySize(Length) > pageEnd
+				|| *(uint16_t*) (entry + EntrySize(Length) - 2) != Length) {
+			break;
+		}
+		entry = entry + EntrySize(Length);
+	}
+	return entry;
+}
+
+#if MICROCDB_CAPPED_TS_INDEX == 1
+/*
+ * This function gets the timestamp of the document at MICROCDB_CAPPED_TS_PATH.
+ * Returns: true if the document has a unsigned integer timestamp
+ */
+static bool DocumentTimestamp(uint8_t *document, uint32_t *Timestamp) {
+	microcDB_Data TimestampData;
+	uint8_t *digit;
+	uint32_t value = 0;
+
+	TimestampData = FindInDocument((uint8_t*) MICROCDB_CAPPED_TS_PATH, document,
+			document + CalculateStringLength(document));
+	if (TimestampData.DBstatus != FOUND_SUCCESS
+			|| TimestampData.JSON_type != JSON_PRIMITIVE) {
+		return false;
+	}
+	for (digit = TimestampData.DBStartptr; digit <= TimestampData.DBEndptr;
+			digit++) {
+		if (*digit < '0' || *digit > '9') {
+			return false;
+		}
+		value = (value * 10) + (*digit - '0');
+	}
+	*Timestamp = value;
+	return true;
+}
+
+/*
+ * This function checks if the page can have documents with timestamp between From and To. The page whose timestamps were not written
+ * (power was lost before it) is always considered.
+ * Returns: true if the page needs to be read
+ */
+static bool PageInRange(uint32_t Page, uint32_t From, uint32_t To) {
+	uint32_t Min, Max;
+
+	if (Page == HeadPage) {
+		Min = HeadMinTimestamp;
+		Max = HeadMaxTimestamp;
+	} else {
+		Min = *(uint32_t*) (CappedPageAddress(Page) + PAGE_MIN_TS_OFFSET);
+		Max = *(uint32_t*) (CappedPageAddress(Page) + PAGE_MAX_TS_OFFSET);
+		if (Min == EMPTY_WORD && Max == EMPTY_WORD) {
+			return true;
+		}
+	}
+	return (Min <= To && Max >= From);
+}
+
+/*
+ * This function writes the minimum and maximum timestamp of the newest page to its header. This is done when the page is full
+ * as after that its documents won't change.
+ * Returns: true if successful
+ */
+static bool CloseHeadPage() {
+	uint8_t Timestamps[8];
+	uint8_t i;
+
+	for (i = 0; i < 4; i++) {
+		Timestamps[i] = (uint8_t) (HeadMinTimestamp >> (8 * i));
+		Timestamps[i + 4] = (uint8_t) (HeadMaxTimestamp >> (8 * i));
+	}
+	return WriteBytesToFLASH(Timestamps,
+			(uint32_t) CappedPageAddress(HeadPage) + PAGE_MIN_TS_OFFSET, 8)
+			== FL_STORE_SUCCESS;
+}
+#endif
+
+/*
+ * This function erases the page and writes its sequence number so it becomes the newest page.
+ * Returns: true if successful
+ */
+static bool StartPage(uint32_t Page, uint32_t Sequence) {
+	uint8_t header[4];
+
+	if (ErasePage(CappedPageAddress(Page)) != ERASE_SUCCESS) {
+		return false;
+	}
+	header[0] = (uint8_t) Sequence;
+	header[1] = (uint8_t) (Sequence >> 8);
+	header[2] = (uint8_t) (Sequence >> 16);
+	header[3] = (uint8_t) (Sequence >> 24);
+	if (WriteBytesToFLASH(header, (uint32_t) CappedPageAddress(Page), 4)
+			!= FL_STORE_SUCCESS) {
+		return false;
+	}
+	HeadPage = Page;
+	HeadSequence = Sequence;
+	AppendAddr = CappedPageAddress(Page) + PAGE_HEADER_SIZE;
+#if MICROCDB_CAPPED_TS_INDEX == 1
+	HeadMinTimestamp = 0xFFFFFFFF;
+	HeadMaxTimestamp = 0;
+#endif
+	return true;
+}
+
+/*
+ * This function appends the entry of the document having Length bytes with '/'. The page having oldest documents is erased and used if
+ * the entry doesn't fit in the newest page.
+ * Returns: microcDB_Status STORE_SUCCESS or STORE_FAILED
+ */
+static microcDB_Status AppendEntry(uint8_t *JSONString, uint16_t Length) {
+	uint8_t LengthBytes[2];
+
+	if (AppendAddr + EntrySize(Length)
+			> CappedPageAddress(HeadPage) + FLASH_PAGE_SIZE) {
+#if MICROCDB_CAPPED_TS_INDEX == 1
+		if (!CloseHeadPage()) {
+			return STORE_FAILED;
+		}
+#endif
+		if (!StartPage((HeadPage + 1) % CAPPED_PAGES, HeadSequence + 1)) {
+			return STORE_FAILED;
+		}
+	}
+
+	LengthBytes[0] = (uint8_t) Length;
+	LengthBytes[1] = (uint8_t) (Length >> 8);
+
+	/*The length after document is written last so the entry is complete only when it is written*/
+	if (WriteBytesToFLASH(LengthBytes, (uint32_t) AppendAddr, 2)
+			!= FL_STORE_SUCCESS
+			|| WriteBytesToFLASH(JSONString, (uint32_t) AppendAddr + 2, Length)
+					!= FL_STORE_SUCCESS
+			|| WriteBytesToFLASH(LengthBytes,
+					(uint32_t) AppendAddr + EntrySize(Length) - 2, 2)
+					!= FL_STORE_SUCCESS) {
+		/*Don't append after the partially written entry*/
+		AppendAddr = CappedPageAddress(HeadPage) + FLASH_PAGE_SIZE;
+		return STORE_FAILED;
+	}
+
+	AppendAddr = AppendAddr + EntrySize(Length);
+	return STORE_SUCCESS;
+}
+
+/*
+ * This function moves the iterator to the next document having the query. It is done again from the same iterator by
+ * MicrocDB_CappedNext() if the writer task appended while the entries were read.
+ */
+static microcDB_Data CappedStep(microcDB_CappedIterator *Iterator,
+		uint8_t *query) {
+	microcDB_Data data_out_struct;
+	uint32_t Page;
+	uint16_t Length;
+	uint8_t *document;
+#if MICROCDB_CAPPED_TS_INDEX == 1
+	uint32_t Timestamp;
+	bool RangeGiven = (Iterator->From != 0 || Iterator->To != 0xFFFFFFFF);
+#endif
+
+	data_out_struct.DBstatus = NOT_FOUND;
+	data_out_struct.JSON_type = JSON_UNDEFINED;
+	data_out_struct.DBStartptr = 0;
+	data_out_struct.DBEndptr = 0;
+
+#if MICROCDB_SEQLOCK == 1
+	/*The page of iterator was erased and reused by the writer task since the last document was given*/
+	if (Iterator->Sequence != 0
+			&& *(uint32_t*) CappedPageAddress(Iterator->Page)
+					!= Iterator->Sequence) {
+		data_out_struct.DBstatus = READ_CONFLICT;
+		return data_out_struct;
+	}
+#endif
+
+	while (1) {
+		/*If all entries of this page are given then go to previous page*/
+		while (Iterator->Entry
+				<= CappedPageAddress(Iterator->Page) + PAGE_HEADER_SIZE) {
+			if (Iterator->Sequence == 0
+					|| HeadSequence - (Iterator->Sequence - 1)
+							>= CAPPED_PAGES) {
+				return data_out_struct; /*Oldest page is done*/
+			}
+			Page = (Iterator->Page + CAPPED_PAGES - 1) % CAPPED_PAGES;
+			if (*(uint32_t*) CappedPageAddress(Page)
+					!= Iterator->Sequence - 1) {
+				return data_out_struct; /*The previous page was never written*/
+			}
+			Iterator->Page = Page;
+			Iterator->Sequence--;
+#if MICROCDB_CAPPED_TS_INDEX == 1
+			/*Skip the page without reading its documents if its timestamps are out of range*/
+			if (RangeGiven
+					&& !PageInRange(Page, Iterator->From, Iterator->To)) {
+				Iterator->Entry = CappedPageAddress(Page) + PAGE_HEADER_SIZE;
+				continue;
+			}
+#endif
+			Iterator->Entry = PageEnd(Page);
+		}
+
+		/*Go to previous entry using the length stored after the document*/
+		Length = *(uint16_t*) (Iterator->Entry - 2);
+		Iterator->Entry = Iterator->Entry - EntrySize(Length);
+		document = Iterator->Entry + 2;
+
+#if MICROCDB_CAPPED_TS_INDEX == 1
+		if (RangeGiven
+				&& (!DocumentTimestamp(document, &Timestamp)
+						|| Timestamp < Iterator->From
+						|| Timestamp > Iterator->To)) {
+			continue;
+		}
+#endif
+
+		if (query == 0) {
+			data_out_struct.DBstatus = FOUND_SUCCESS;
+			data_out_struct.JSON_type = JSON_OBJ;
+			data_out_struct.DBStartptr = document;
+			data_out_struct.DBEndptr = document + Length - 2; /*Point to the ending brace and not to '/'*/
+			return data_out_struct;
+		}
+
+		data_out_struct = FindInDocument(query, document,
+				document + Length - 1);
+		if (data_out_struct.DBstatus == FOUND_SUCCESS) {
+			return data_out_struct;
+		}
+	}
+}
+/*MISC functions*/
+/**************************************************************************************************************************************/
+
+/*MicrocDB capped collection functions*/
+microcDB_Status CappedInit() {
+	uint32_t Page, Sequence;
+	bool found = false;
+#if MICROCDB_CAPPED_TS_INDEX == 1
+	uint32_t Timestamp;
+	uint8_t *entry;
+#endif
+
+	/*The newest page is the page having the highest sequence number*/
+	for (Page = 0; Page < CAPPED_PAGES; Page++) {
+		Sequence = *(uint32_t*) CappedPageAddress(Page);
+		if (Sequence != EMPTY_WORD && (!found || Sequence > HeadSequence)) {
+			HeadPage = Page;
+			HeadSequence = Sequence;
+			found = true;
+		}
+	}
+
+	if (!found) {
+		/*Capped collection is used first time*/
+		return StartPage(0, 0) ? INIT_CMPLT : INIT_FAILED;
+	}
+
+	AppendAddr = PageEnd(HeadPage);
+
+#if MICROCDB_CAPPED_TS_INDEX == 1
+	/*The timestamps of newest page are not in its header so get them from its documents*/
+	HeadMinTimestamp = 0xFFFFFFFF;
+	HeadMaxTimestamp = 0;
+	entry = CappedPageAddress(HeadPage) + PAGE_HEADER_SIZE;
+	while (entry < AppendAddr) {
+		if (DocumentTimestamp(entry + 2, &Timestamp)) {
+			if (Timestamp < HeadMinTimestamp)
+				HeadMinTimestamp = Timestamp;
+			if (Timestamp > HeadMaxTimestamp)
+				HeadMaxTimestamp = Timestamp;
+		}
+		entry = entry + EntrySize(*(uint16_t*) entry);
+	}
+#endif
+	return INIT_CMPLT;
+}
+
+microcDB_Status MicrocDB_CappedAppend(uint8_t *JSONString) {
+	microcDB_Status status;
+	uint16_t Length;
+#if MICROCDB_CAPPED_TS_INDEX == 1
+	uint32_t Timestamp;
+#endif
+
+	STATS_BEGIN(STATS_OP_INSERT);
+	DEVICES_SYNC();
+
+	Length = CalculateStringLength(JSONString);
+	replacesingleTodouble(JSONString, Length);
+	Length++; /*Store the '/' also so the document can be parsed directly from flash*/
+
+	if (EntrySize(Length) > FLASH_PAGE_SIZE - PAGE_HEADER_SIZE) {
+		return STORE_FAILED;
+	}
+
+#if MICROCDB_CAPPED_TS_INDEX == 1
+	if (!DocumentTimestamp(JSONString, &Timestamp)) {
+		return QUERY_INVALID;
+	}
+#endif
+
+	/*The readers don't see the page of oldest documents being erased for the entry or the entry being written*/
+	CHANGE_BEGIN();
+	SEQ_WRITE_BEGIN();
+	status = AppendEntry(JSONString, Length);
+#if MICROCDB_CAPPED_TS_INDEX == 1
+	if (status == STORE_SUCCESS) {
+		if (Timestamp < HeadMinTimestamp)
+			HeadMinTimestamp = Timestamp;
+		if (Timestamp > HeadMaxTimestamp)
+			HeadMaxTimestamp = Timestamp;
+	}
+#endif
+	SEQ_WRITE_END();
+
+	if (status == STORE_SUCCESS) {
+		CHANGE_EMIT(CHANGE_CAPPED_APPEND, 1, 0, JSONString);
+	}
+	return status;
+}
+
+void MicrocDB_CappedIterNewest(microcDB_CappedIterator *Iterator) {
+	SEQ_READ(Iterator->Page = HeadPage; Iterator->Sequence = HeadSequence;
+			Iterator->Entry = AppendAddr);
+#if MICROCDB_CAPPED_TS_INDEX == 1
+	Iterator->From = 0;
+	Iterator->To = 0xFFFFFFFF;
+#endif
+}
+
+#if MICROCDB_CAPPED_TS_INDEX == 1
+void MicrocDB_CappedIterRange(microcDB_CappedIterator *Iterator, uint32_t From,
+		uint32_t To) {
+	bool InRange;
+
+	SEQ_READ(Iterator->Page = HeadPage; Iterator->Sequence = HeadSequence;
+			Iterator->Entry = AppendAddr;
+			InRange = PageInRange(HeadPage, From, To));
+	Iterator->From = From;
+	Iterator->To = To;
+	/*Skip the newest page if it has no document of the range*/
+	if (!InRange) {
+		Iterator->Entry = CappedPageAddress(Iterator->Page) + PAGE_HEADER_SIZE;
+	}
+}
+#endif
+
+microcDB_Data MicrocDB_CappedNext(microcDB_CappedIterator *Iterator,
+		uint8_t *query) {
+	microcDB_Data data_out_struct;
+#if MICROCDB_SEQLOCK == 1
+	microcDB_CappedIterator Begin = *Iterator;
+	uint32_t Sequence;
+#endif
+
+	STATS_BEGIN(STATS_OP_FIND);
+	DEVICES_SYNC();
+
+#if MICROCDB_SEQLOCK == 1
+	/*The iterator is moved again from where it was if the writer task appended while the entries were read*/
+	do {
+		*Iterator = Begin;
+		Sequence = SeqReadBegin();
+		data_out_struct = CappedStep(Iterator, query);
+	} while (SeqReadRetry(Sequence));
+#else
+	data_out_struct = CappedStep(Iterator, query);
+#endif
+	return data_out_struct;
+}
+/*MicrocDB capped collection functions*/
+
+#endif
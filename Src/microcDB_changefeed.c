@@ -0,0 +1,446 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The change feed of microcDB. Every change of DB is given as a record of the API call which did it, i.e its path and
+ *      			 value, with a sequence number, so a replica having the same data does the same calls and stays same. The records
+ *      			 are as small as the changes, which is less than the pages rewritten by them. The replica checks that the sequence
+ *      			 numbers have no gap, so a lost record is found.
+ *      			 The sequence numbers are kept in their own flash region so they continue after a reset. The number of a change is
+ *      			 logged before the change is done, and reused by the next change if it failed. After a reset the feed continues
+ *      			 from the last number logged, so the numbers given before the reset are not given again and a gap is left only if
+ *      			 the power was lost while a change was done, whose record may not have been given, or its change failed. So the
+ *      			 replica synchronizes again only when a record may be lost. The replica logs every sequence number applied so it
+ *      			 checks the next record also after its reset. The region is used as two banks like the counters, when a bank is full the last limit and applied number
+ *      			 are copied to the other bank.
+ *
+ *      			 Layout of a record:
+ *      			 |Sequence number(4 bytes)|Type(1 byte)|0(1 byte)|Count(2 bytes)|Path length(2 bytes)|Value length(2 bytes)|Path|Value|
+ *      			 Layout of a bank:
+ *      			 |Sequence number of bank(4 bytes)|Entry(4 bytes)|Entry(4 bytes)|...|Empty|
+ *      			 An entry is the number logged for a change or an applied sequence number with APPLIED_ENTRY set. The numbers are less than
+ *      			 MAX_SEQUENCE so the high half word of an entry is never empty, and an entry whose writing was interrupted is skipped.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_CHANGE_FEED == 1
+
+#define RECORD_HEADER_SIZE 12
+#define RECORD_TYPE_OFFSET 4
+#define RECORD_COUNT_OFFSET 6
+#define RECORD_PATH_LENGTH_OFFSET 8
+#define RECORD_VALUE_LENGTH_OFFSET 10
+#define BANK_SIZE ((MICROCDB_CHANGE_FEED_END_ADDR + 1 - MICROCDB_CHANGE_FEED_START_ADDR) / 2)
+#define BANK_HEADER_SIZE 4
+#define ENTRY_SIZE 4
+#define APPLIED_ENTRY 0x80000000u
+#define MAX_SEQUENCE 0x7FFF0000u
+#define EMPTY_HALFWORD ((uint16_t)(((uint8_t)FL_EMPTY_BYTE << 8) | (uint8_t)FL_EMPTY_BYTE))
+#define EMPTY_WORD (((uint32_t)EMPTY_HALFWORD << 16) | EMPTY_HALFWORD)
+
+static microcDB_ChangeWrite FeedCallback = 0; /*The callback of change feed*/
+static void *FeedContext = 0; /*The context given to the callback*/
+static uint32_t FeedSequence = 0; /*The sequence number of the last record given*/
+static uint32_t FeedLogged = 0; /*The last number logged for a change, it may have been given*/
+static uint32_t AppliedSequence = 0; /*The sequence number of the last record applied or 0 if the next record can have any number*/
+static uint8_t ActiveBank = 0; /*The bank which has the entries*/
+static uint32_t ActiveSequence = 0; /*The sequence number of active bank*/
+static uint8_t *FreeEntry = 0; /*The address of first empty entry of active bank*/
+
+/*MISC functions*/
+
+/*
+ * This function stores the number little endian in the bytes.
+ */
+static inline void PutLittleEndian(uint8_t *Bytes, uint32_t Number,
+		uint8_t Count) {
+	while (Count != 0) {
+		*Bytes = (uint8_t) Number;
+		Number = Number >> 8;
+		Bytes++;
+		Count--;
+	}
+}
+
+/*
+ * This function reads the little endian number of the bytes.
+ */
+static inline uint32_t GetLittleEndian(uint8_t *Bytes, uint8_t Count) {
+	uint32_t Number = 0;
+
+	while (Count != 0) {
+		Count--;
+		Number = (Number << 8) | Bytes[Count];
+	}
+	return Number;
+}
+
+/*
+ * This function calculates the length of the given number of strings each terminated with '/' including the slashes.
+ */
+static size_t TerminatedLength(uint8_t *String, uint16_t Count) {
+	size_t Length = 0;
+
+	while (Count != 0) {
+		Length = Length + CalculateStringLength(String + Length) + 1;
+		Count--;
+	}
+	return Length;
+}
+
+/*
+ * This function returns the address of the bank
+ */
+static inline uint8_t* BankAddress(uint8_t Bank) {
+	return (uint8_t*) MICROCDB_CHANGE_FEED_START_ADDR + (Bank * BANK_SIZE);
+}
+
+/*
+ * This function erases the pages of the bank
+ * Returns: flash_mem_Stat ERASE_SUCCESS or ERASE_FAILED
+ */
+static flash_mem_Stat EraseBank(uint8_t Bank) {
+	uint32_t Page;
+
+	for (Page = 0; Page < BANK_SIZE / FLASH_PAGE_SIZE; Page++) {
+		if (ErasePage(BankAddress(Bank) + (Page * FLASH_PAGE_SIZE))
+				!= ERASE_SUCCESS) {
+			return ERASE_FAILED;
+		}
+	}
+	return ERASE_SUCCESS;
+}
+
+/*
+ * This function writes the word little endian at the address
+ * Returns: true if written
+ */
+static bool WriteWord(uint8_t *Address, uint32_t Word) {
+	uint8_t WordBytes[4];
+
+	PutLittleEndian(WordBytes, Word, 4);
+	return WriteBytesToFLASH(WordBytes, (uint32_t) Address, 4)
+			== FL_STORE_SUCCESS;
+}
+
+/*
+ * This function copies the logged and the applied number to the other bank, whose sequence number is written after them so if power
+ * is lost while copying then the active bank remains same. Then the old bank is erased.
+ * Returns: true if copied
+ */
+static bool CompactBank() {
+	uint8_t NewBank = ActiveBank ^ 1;
+	uint8_t *Entry = BankAddress(NewBank) + BANK_HEADER_SIZE;
+
+	if (EraseBank(NewBank) != ERASE_SUCCESS) {
+		return false;
+	}
+	if (FeedLogged != 0) {
+		if (!WriteWord(Entry, FeedLogged)) {
+			return false;
+		}
+		Entry = Entry + ENTRY_SIZE;
+	}
+	if (!WriteWord(Entry, AppliedSequence | APPLIED_ENTRY)
+			|| !WriteWord(BankAddress(NewBank), ActiveSequence + 1)
+			|| EraseBank(ActiveBank) != ERASE_SUCCESS) {
+		return false;
+	}
+	ActiveBank = NewBank;
+	ActiveSequence++;
+	FreeEntry = Entry + ENTRY_SIZE;
+	return true;
+}
+
+/*
+ * This function writes the entry at the end of active bank. The entry is used even if its writing failed.
+ * Returns: true if written
+ */
+static bool LogEntry(uint32_t Entry) {
+	if (FreeEntry + ENTRY_SIZE > BankAddress(ActiveBank) + BANK_SIZE
+			&& !CompactBank()) {
+		return false;
+	}
+	FreeEntry = FreeEntry + ENTRY_SIZE;
+	return WriteWord(FreeEntry - ENTRY_SIZE, Entry);
+}
+
+/*
+ * This function reads the signed decimal number terminated with '/' of the value of CHANGE_INCREMENT record.
+ * Returns: true if it is a number which fits in int32_t
+ */
+static bool ReadDelta(uint8_t *value, int32_t *Delta) {
+	bool Negative = (*value == '-');
+	int64_t Number = 0;
+
+	if (Negative) {
+		value++;
+	}
+	if (*value == '/') {
+		return false;
+	}
+	while (*value != '/') {
+		if (*value < '0' || *value > '9'
+				|| Number > (int64_t) INT32_MAX + 1) {
+			return false;
+		}
+		Number = (Number * 10) + (*value - '0');
+		value++;
+	}
+	if (Negative) {
+		Number = -Number;
+	}
+	if (Number > INT32_MAX || Number < INT32_MIN) {
+		return false;
+	}
+	*Delta = (int32_t) Number;
+	return true;
+}
+
+/*MISC functions*/
+
+microcDB_Status ChangeInit() {
+	uint32_t Sequence0 = *(uint32_t*) BankAddress(0);
+	uint32_t Sequence1 = *(uint32_t*) BankAddress(1);
+	uint8_t *Entry;
+
+	FeedLogged = 0;
+	AppliedSequence = 0;
+	if (Sequence0 == EMPTY_WORD && Sequence1 == EMPTY_WORD) {
+		/*First use of the region, a bank without sequence number may have the entries of an interrupted copy*/
+		if ((*(uint32_t*) (BankAddress(0) + BANK_HEADER_SIZE) != EMPTY_WORD
+				&& EraseBank(0) != ERASE_SUCCESS)
+				|| (*(uint32_t*) (BankAddress(1) + BANK_HEADER_SIZE)
+						!= EMPTY_WORD && EraseBank(1) != ERASE_SUCCESS)
+				|| !WriteWord(BankAddress(0), 1)) {
+			return INIT_FAILED;
+		}
+		ActiveBank = 0;
+		ActiveSequence = 1;
+	} else {
+		if (Sequence1 != EMPTY_WORD
+				&& (Sequence0 == EMPTY_WORD || Sequence1 > Sequence0)) {
+			ActiveBank = 1;
+			ActiveSequence = Sequence1;
+		} else {
+			ActiveBank = 0;
+			ActiveSequence = Sequence0;
+		}
+		/*The other bank is not empty if power was lost while copying or before erasing the old bank*/
+		if ((*(uint32_t*) BankAddress(ActiveBank ^ 1) != EMPTY_WORD
+				|| *(uint32_t*) (BankAddress(ActiveBank ^ 1) + BANK_HEADER_SIZE)
+						!= EMPTY_WORD)
+				&& EraseBank(ActiveBank ^ 1) != ERASE_SUCCESS) {
+			return INIT_FAILED;
+		}
+	}
+
+	Entry = BankAddress(ActiveBank) + BANK_HEADER_SIZE;
+	while (Entry + ENTRY_SIZE <= BankAddress(ActiveBank) + BANK_SIZE
+			&& *(uint32_t*) Entry != EMPTY_WORD) {
+		if (*(uint16_t*) (Entry + 2) == EMPTY_HALFWORD) {
+			/*The power was lost while it was written*/
+		} else if (*(uint32_t*) Entry & APPLIED_ENTRY) {
+			AppliedSequence = *(uint32_t*) Entry & ~APPLIED_ENTRY;
+		} else {
+			FeedLogged = *(uint32_t*) Entry;
+		}
+		Entry = Entry + ENTRY_SIZE;
+	}
+	FreeEntry = Entry;
+
+	/*The record of the last number logged may have been given so the feed continues after it. If it wasn't given the replica finds
+	 the gap*/
+	FeedSequence = FeedLogged;
+	return INIT_CMPLT;
+}
+
+void ChangeBegin() {
+	/*The number is logged once, as the change which failed leaves it for the next change*/
+	if (FeedCallback == 0 || FeedLogged == FeedSequence + 1
+			|| FeedSequence + 1 >= MAX_SEQUENCE) {
+		return;
+	}
+	if (LogEntry(FeedSequence + 1)) {
+		FeedLogged = FeedSequence + 1;
+	}
+}
+
+void ChangeEmit(microcDB_ChangeType Type, uint16_t Count, uint8_t *path,
+		uint8_t *value) {
+	uint8_t Header[RECORD_HEADER_SIZE];
+	size_t PathLength, ValueLength;
+
+	if (FeedCallback == 0) {
+		return;
+	}
+	PathLength = path != 0 ? TerminatedLength(path, 1) : 0;
+	ValueLength = TerminatedLength(value, Type == CHANGE_INSERT ? Count : 1);
+
+	FeedSequence++; /*The sequence is used even if the record can't be given so the replica finds the gap*/
+	if (FeedSequence >= MAX_SEQUENCE || FeedSequence != FeedLogged) {
+		return; /*The number which isn't logged could be given again after a reset*/
+	}
+	PutLittleEndian(Header, FeedSequence, 4);
+	Header[RECORD_TYPE_OFFSET] = (uint8_t) Type;
+	Header[RECORD_TYPE_OFFSET + 1] = 0;
+	PutLittleEndian(Header + RECORD_COUNT_OFFSET, Count, 2);
+	PutLittleEndian(Header + RECORD_PATH_LENGTH_OFFSET, PathLength, 2);
+	PutLittleEndian(Header + RECORD_VALUE_LENGTH_OFFSET, ValueLength, 2);
+
+	if (RECORD_HEADER_SIZE + PathLength + ValueLength > 0xFFFF
+			|| !FeedCallback(Header, RECORD_HEADER_SIZE, FeedContext)) {
+		return;
+	}
+	if (PathLength != 0 && !FeedCallback(path, PathLength, FeedContext)) {
+		return;
+	}
+	FeedCallback(value, ValueLength, FeedContext);
+}
+
+void ChangeEmitIncrement(uint8_t *path, int32_t delta) {
+	uint8_t Digits[13]; /*Sign, 10 digits of int32_t and '/'*/
+	uint8_t *Digit = Digits + sizeof(Digits) - 1;
+	uint32_t Magnitude = (delta < 0) ? -(uint32_t) delta : (uint32_t) delta;
+
+	if (FeedCallback == 0) {
+		return;
+	}
+	*Digit = '/';
+	do {
+		Digit--;
+		*Digit = (uint8_t) ('0' + (Magnitude % 10));
+		Magnitude = Magnitude / 10;
+	} while (Magnitude != 0);
+	if (delta < 0) {
+		Digit--;
+		*Digit = '-';
+	}
+	ChangeEmit(CHANGE_INCREMENT, 0, path, Digit);
+}
+
+void MicrocDB_ChangeFeed(microcDB_ChangeWrite Callback, void *Context) {
+	STATS_BEGIN(STATS_OP_OTHER);
+	DEVICES_SYNC();
+
+	FeedCallback = Callback;
+	FeedContext = Context;
+}
+
+uint32_t MicrocDB_ChangeSequence() {
+	return FeedSequence;
+}
+
+microcDB_Status MicrocDB_ChangeSynced(uint32_t Sequence) {
+	STATS_BEGIN(STATS_OP_OTHER);
+	DEVICES_SYNC();
+
+	if (Sequence >= MAX_SEQUENCE) {
+		return CHANGE_INVALID;
+	}
+	AppliedSequence = Sequence;
+	return LogEntry(Sequence | APPLIED_ENTRY) ? STORE_SUCCESS : STORE_FAILED;
+}
+
+microcDB_Status MicrocDB_ApplyChange(uint8_t *Record, uint16_t Length) {
+	uint32_t Sequence;
+	uint16_t Count, PathLength, ValueLength;
+	uint8_t *path, *value;
+	microcDB_Status status;
+#if MICROCDB_COUNTERS == 1
+	int32_t Delta;
+#endif
+
+	STATS_BEGIN(STATS_OP_OTHER);
+	DEVICES_SYNC();
+
+	if (Length < RECORD_HEADER_SIZE) {
+		return CHANGE_INVALID;
+	}
+	Sequence = GetLittleEndian(Record, 4);
+	Count = GetLittleEndian(Record + RECORD_COUNT_OFFSET, 2);
+	PathLength = GetLittleEndian(Record + RECORD_PATH_LENGTH_OFFSET, 2);
+	ValueLength = GetLittleEndian(Record + RECORD_VALUE_LENGTH_OFFSET, 2);
+	path = Record + RECORD_HEADER_SIZE;
+	value = path + PathLength;
+
+	/*The path and value should fill the record and end with '/' so they are not read beyond it*/
+	if ((uint32_t) RECORD_HEADER_SIZE + PathLength + ValueLength != Length
+			|| ValueLength == 0 || value[ValueLength - 1] != '/'
+			|| (PathLength != 0 && path[PathLength - 1] != '/')) {
+		return CHANGE_INVALID;
+	}
+	if (Sequence == 0 || Sequence >= MAX_SEQUENCE) {
+		return CHANGE_INVALID;
+	}
+	if (AppliedSequence != 0 && Sequence != AppliedSequence + 1) {
+		return CHANGE_OUT_OF_ORDER;
+	}
+
+	switch (Record[RECORD_TYPE_OFFSET]) {
+	case CHANGE_INSERT:
+		if (Count == 0 || TerminatedLength(value, Count) != ValueLength) {
+			return CHANGE_INVALID;
+		}
+		status = MicrocDB_Insert(value, Count);
+		if (status != STORE_SUCCESS) {
+			return status;
+		}
+		break;
+	case CHANGE_UPDATE:
+		if (PathLength == 0) {
+			return CHANGE_INVALID;
+		}
+		status = MicrocDB_Update(path, value);
+		if (status != UPDATE_SUCCESSFUL) {
+			return status;
+		}
+		break;
+#if MICROCDB_ARRAY_SEGMENTS == 1
+	case CHANGE_APPEND:
+		if (PathLength == 0) {
+			return CHANGE_INVALID;
+		}
+		status = MicrocDB_UpdateArrayList(path, value);
+		if (status != UPDATE_SUCCESSFUL) {
+			return status;
+		}
+		break;
+#endif
+#if MICROCDB_COUNTERS == 1
+	case CHANGE_INCREMENT:
+		if (PathLength == 0 || !ReadDelta(value, &Delta)) {
+			return CHANGE_INVALID;
+		}
+		status = MicrocDB_Increment(path, Delta);
+		if (status != UPDATE_SUCCESSFUL) {
+			return status;
+		}
+		break;
+#endif
+#if MICROCDB_CAPPED_SUPPORT == 1
+	case CHANGE_CAPPED_APPEND:
+		status = MicrocDB_CappedAppend(value);
+		if (status != STORE_SUCCESS) {
+			return status;
+		}
+		break;
+#endif
+#if MICROCDB_SCHEMA_SUPPORT == 1
+	case CHANGE_INSERT_RECORD:
+		status = MicrocDB_InsertRecord(value);
+		if (status != STORE_SUCCESS) {
+			return status;
+		}
+		break;
+#endif
+	default:
+		return CHANGE_INVALID;
+	}
+
+	/*If it isn't logged the replica finds a gap after a reset and is synchronized again*/
+	AppliedSequence = Sequence;
+	LogEntry(Sequence | APPLIED_ENTRY);
+	return status;
+}
+
+#endif
@@ -0,0 +1,705 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The source code for the compression of documents stored by MicrocDB. The documents are packed in blocks of
+ *      			 MICROCDB_COMP_BLOCK_SIZE bytes and every block is compressed with a small LZ77 compressor(LZF format) before
+ *      			 writing to flash. Blocks are decompressed on read to a small RAM cache so MicrocDB_Find works transparently. The block
+ *      			 of the data given by MicrocDB_Find is pinned in the cache till MicrocDB_Release, so the next lookups don't overwrite it.
+ *
+ *      			 Layout of a block in flash:
+ *      			 |Size(2 bytes)|Uncompressed length(2 bytes)|Filter length(2 bytes)|Bloom filter|Stored bytes padded to half word|
+ *      			 The size is the number of bytes after the uncompressed length, and the filter length and filter are there only if
+ *      			 MICROCDB_COMP_BLOOM_BYTES is not 0. If the number of stored bytes is same as uncompressed length then the block is
+ *      			 stored uncompressed. The size is written first and the uncompressed length last, so a block which was not
+ *      			 completely written as the power was lost has the empty uncompressed length and is skipped.
+ *      			 The Bloom filter has the keys of the documents of block so Find skips the blocks which can't have the query. It has
+ *      			 about 14 bits for every key of the block and not more than MICROCDB_COMP_BLOOM_BYTES, so a block of few documents
+ *      			 has a small filter.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_COMPRESSION == 1
+
+#define BLOCK_HEADER_SIZE 4
+#if MICROCDB_COMP_BLOOM_BYTES > 0
+#define FILTER_LENGTH_SIZE 2
+#else
+#define FILTER_LENGTH_SIZE 0
+#endif
+#define BLOOM_BITS_PER_KEY 14
+#define BLOOM_HASHES 7 /*Number of bits set for every key, near the best for 10 to 14 bits of filter per key*/
+#define EMPTY_HALFWORD ((uint16_t)(((uint8_t)FL_EMPTY_BYTE << 8) | (uint8_t)FL_EMPTY_BYTE))
+
+#define LZ_HASH_LOG 8 /*Number of bits of hash. The hash table takes 2^LZ_HASH_LOG half words of RAM*/
+#define LZ_MAX_OFFSET 8192
+#define LZ_MAX_LITERALS 32
+#define LZ_MAX_MATCH (264) /*7 + 255 + 2*/
+
+/*The cached decompressed block*/
+typedef struct {
+	uint32_t BlockAddress; /*Flash address of the block, 0 if this cache entry is empty*/
+	uint16_t Length; /*Number of decompressed bytes*/
+	uint32_t LastUsed; /*Value of the UseCounter when last used, least recently used entry is replaced*/
+	uint8_t Pins; /*The number of found data not released which point to this entry, a pinned entry is not replaced*/
+	uint8_t Data[MICROCDB_COMP_BLOCK_SIZE];
+} comp_CacheEntry;
+
+static comp_CacheEntry BlockCache[MICROCDB_COMP_CACHE_BLOCKS];
+static uint32_t UseCounter = 0;
+static uint8_t CompressedData[MICROCDB_COMP_BLOCK_SIZE];
+static uint16_t HashTable[1 << LZ_HASH_LOG];
+
+/*MISC functions*/
+
+/*
+ * This function compresses the InLength bytes pointed by *in to the *out buffer of size OutSize.
+ * Returns: the number of compressed bytes or 0 if the compressed data won't fit in OutSize
+ */
+static uint16_t LZ_Compress(uint8_t *in, uint16_t InLength, uint8_t *out,
+		uint16_t OutSize) {
+	uint8_t *ip = in, *in_end = in + InLength, *ref;
+	uint8_t *op = out, *out_end = out + OutSize;
+	uint16_t hash, offset, len, maxlen;
+	uint8_t lit = 0;
+
+	for (hash = 0; hash < (1 << LZ_HASH_LOG); hash++) {
+		HashTable[hash] = 0;
+	}
+
+	if (OutSize == 0) {
+		return 0;
+	}
+	op++; /*Keep space for the control byte of the first literal run*/
+
+	while (ip + 2 < in_end) {
+		hash = ((ip[0] << 5) ^ (ip[1] << 2) ^ ip[2] ^ (ip[0] >> 3))
+				& ((1 << LZ_HASH_LOG) - 1);
+		/*Hash table holds index + 1 of the last occurrence so 0 means empty*/
+		ref = HashTable[hash] ? (in + HashTable[hash] - 1) : 0;
+		HashTable[hash] = (ip - in) + 1;
+
+		if (ref != 0 && (offset = (ip - ref) - 1) < LZ_MAX_OFFSET
+				&& ref[0] == ip[0] && ref[1] == ip[1] && ref[2] == ip[2]) {
+
+			/*Find the length of match*/
+			maxlen = in_end - ip;
+			if (maxlen > LZ_MAX_MATCH)
+				maxlen = LZ_MAX_MATCH;
+			len = 3;
+			while (len < maxlen && ref[len] == ip[len]) {
+				len++;
+			}
+
+			if (op + 3 >= out_end) {
+				return 0;
+			}
+
+			/*Close the literal run by writing its control byte or drop the unused control byte*/
+			if (lit)
+				op[-lit - 1] = lit - 1;
+			else
+				op--;
+
+			len = len - 2;
+			if (len < 7) {
+				*op++ = (offset >> 8) + (len << 5);
+			} else {
+				*op++ = (offset >> 8) + (7 << 5);
+				*op++ = len - 7;
+			}
+			*op++ = offset;
+
+			lit = 0;
+			op++; /*Keep space for the control byte of next literal run*/
+			ip = ip + len + 2;
+		} else {
+			if (op >= out_end) {
+				return 0;
+			}
+			lit++;
+			*op++ = *ip++;
+			if (lit == LZ_MAX_LITERALS) {
+				op[-lit - 1] = lit - 1;
+				lit = 0;
+				op++;
+			}
+		}
+	}
+
+	/*Copy the remaining bytes as literals*/
+	while (ip < in_end) {
+		if (op >= out_end) {
+			return 0;
+		}
+		lit++;
+		*op++ = *ip++;
+		if (lit == LZ_MAX_LITERALS) {
+			op[-lit - 1] = lit - 1;
+			lit = 0;
+			op++;
+		}
+	}
+
+	if (lit)
+		op[-lit - 1] = lit - 1;
+	else
+		op--;
+
+	return op - out;
+}
+
+/*
+ * This function decompresses the InLength bytes pointed by *in to the *out buffer of size OutSize.
+ * Returns: the number of decompressed bytes or 0 if the compressed data is corrupt
+ */
+static uint16_t LZ_Decompress(uint8_t *in, uint16_t InLength, uint8_t *out,
+		uint16_t OutSize) {
+	uint8_t *ip = in, *in_end = in + InLength, *ref;
+	uint8_t *op = out, *out_end = out + OutSize;
+	uint16_t ctrl, len;
+
+	while (ip < in_end) {
+		ctrl = *ip++;
+
+		if (ctrl < LZ_MAX_LITERALS) {
+			/*Literal run of ctrl + 1 bytes*/
+			ctrl++;
+			if (op + ctrl > out_end || ip + ctrl > in_end) {
+				return 0;
+			}
+			while (ctrl--) {
+				*op++ = *ip++;
+			}
+		} else {
+			/*Back reference*/
+			len = ctrl >> 5;
+			ref = op - ((ctrl & 0x1F) << 8) - 1;
+			if (len == 7) {
+				if (ip >= in_end) {
+					return 0;
+				}
+				len = len + *ip++;
+			}
+			if (ip >= in_end) {
+				return 0;
+			}
+			ref = ref - *ip++;
+			len = len + 2;
+
+			if (op + len > out_end || ref < out) {
+				return 0;
+			}
+			while (len--) {
+				*op++ = *ref++;
+			}
+		}
+	}
+	return op - out;
+}
+
+#if MICROCDB_COMP_BLOOM_BYTES > 0
+/*
+ * This function calculates the FNV-1a hash of the Length chars of string.
+ */
+static uint32_t BloomHash(uint8_t *string, uint16_t Length) {
+	uint32_t hash = 2166136261UL;
+	while (Length--) {
+		hash = (hash ^ *string) * 16777619UL;
+		string++;
+	}
+	return hash;
+}
+
+/*
+ * This function checks or sets the BLOOM_HASHES bits of the hash in the Bloom filter of Bits bits. The bits are derived from the hash by
+ * double hashing.
+ * Returns: true if all the bits are set(after setting them if Set is true)
+ */
+static bool BloomBits(uint8_t *Bloom, uint16_t Bits, uint32_t hash, bool Set) {
+	uint32_t step = (hash >> 16) | 1;
+	uint16_t bit;
+	uint8_t i;
+
+	for (i = 0; i < BLOOM_HASHES; i++) {
+		bit = (hash + i * step) % Bits;
+		if (Set)
+			Bloom[bit >> 3] |= (uint8_t) (1 << (bit & 7));
+		else if (!(Bloom[bit >> 3] & (1 << (bit & 7))))
+			return false;
+	}
+	return true;
+}
+
+/*
+ * This function adds the keys of the Length bytes of the block to the Bloom filter of Bits bits, or only counts them if Bits is 0. The
+ * string values are not added as the query has only keys, so they would only fill the filter.
+ * Returns: the number of keys
+ */
+static uint16_t BloomKeys(uint8_t *Data, uint16_t Length, uint8_t *Bloom,
+		uint16_t Bits) {
+	uint8_t *end = Data + Length, *string;
+	uint16_t Keys = 0;
+
+	while (Data < end) {
+		if (*Data == '\"') {
+			string = ++Data;
+			while (Data < end && *Data != '\"')
+				Data++;
+			if (Data + 1 < end && Data[1] == ':') {
+				if (Bits != 0)
+					BloomBits(Bloom, Bits, BloomHash(string, Data - string),
+							true);
+				Keys++;
+			}
+		}
+		Data++;
+	}
+	return Keys;
+}
+
+/*
+ * This function builds the Bloom filter of all the keys of the Length bytes of the block. It has BLOOM_BITS_PER_KEY bits for every key
+ * rounded up to half words and not more than MICROCDB_COMP_BLOOM_BYTES.
+ * Returns: the number of bytes of filter
+ */
+static uint16_t BloomBuild(uint8_t *Data, uint16_t Length, uint8_t *Bloom) {
+	uint32_t Bytes = ((uint32_t) BloomKeys(Data, Length, Bloom, 0)
+			* BLOOM_BITS_PER_KEY + 15) / 16 * 2;
+	uint16_t i;
+
+	if (Bytes > MICROCDB_COMP_BLOOM_BYTES) {
+		Bytes = MICROCDB_COMP_BLOOM_BYTES;
+	}
+	for (i = 0; i < Bytes; i++) {
+		Bloom[i] = 0;
+	}
+	if (Bytes != 0) {
+		BloomKeys(Data, Length, Bloom, Bytes * 8);
+	}
+	return Bytes;
+}
+
+/*
+ * This function checks if every part of the query separated by '.' may be a key of the block using its Bloom filter of Bytes bytes.
+ * Returns: false if the block surely doesn't have the query
+ */
+static bool BloomMayHaveQuery(uint8_t *Bloom, uint16_t Bytes, uint8_t *query) {
+	uint8_t *part;
+
+	if (Bytes == 0) {
+		return true; /*The block had no keys*/
+	}
+	while (*query != '/') {
+		part = query;
+		while (*query != '.' && *query != '/')
+			query++;
+		if (query != part
+				&& !BloomBits(Bloom, Bytes * 8, BloomHash(part, query - part),
+						false))
+			return false;
+		if (*query == '.')
+			query++;
+	}
+	return true;
+}
+#endif
+
+/*
+ * This function checks if the block was completely written, its uncompressed length is written after all its other bytes.
+ */
+static inline bool BlockCommitted(uint32_t BlockAddress) {
+	return *(uint16_t*) (BlockAddress + 2) != EMPTY_HALFWORD;
+}
+
+/*
+ * This function gives the number of bytes of the Bloom filter of block.
+ */
+static inline uint16_t FilterLength(uint32_t BlockAddress) {
+#if MICROCDB_COMP_BLOOM_BYTES > 0
+	return *(uint16_t*) (BlockAddress + BLOCK_HEADER_SIZE);
+#else
+	(void) BlockAddress;
+	return 0;
+#endif
+}
+
+/*
+ * This function gives the stored bytes of block after its filter and their number in StoredLength.
+ */
+static inline uint8_t* StoredBytes(uint32_t BlockAddress,
+		uint16_t *StoredLength) {
+	uint16_t Skipped = FILTER_LENGTH_SIZE + FilterLength(BlockAddress);
+
+	*StoredLength = *(uint16_t*) BlockAddress - Skipped;
+	return (uint8_t*) BlockAddress + BLOCK_HEADER_SIZE + Skipped;
+}
+
+/*
+ * This function returns the least recently used entry of the block cache which is not pinned
+ * Returns: the entry or 0 if all the entries are pinned
+ */
+static comp_CacheEntry* GetLRUEntry() {
+	comp_CacheEntry *entry = 0;
+	uint8_t i;
+
+	for (i = 0; i < MICROCDB_COMP_CACHE_BLOCKS; i++) {
+		if (BlockCache[i].Pins == 0
+				&& (entry == 0 || BlockCache[i].LastUsed < entry->LastUsed)) {
+			entry = &BlockCache[i];
+		}
+	}
+	return entry;
+}
+
+/*
+ * This function returns the entry of the block cache having the byte or 0 if it is not in the cache
+ */
+static comp_CacheEntry* EntryOf(uint8_t *Byte) {
+	uint8_t i;
+
+	for (i = 0; i < MICROCDB_COMP_CACHE_BLOCKS; i++) {
+		if (Byte >= BlockCache[i].Data
+				&& Byte < BlockCache[i].Data + MICROCDB_COMP_BLOCK_SIZE) {
+			return &BlockCache[i];
+		}
+	}
+	return 0;
+}
+
+/*
+ * This function returns the decompressed block stored at BlockAddress. The block is decompressed only if it is not already in cache.
+ * Returns: the cache entry or 0 if the block is corrupt or all the entries are pinned
+ */
+static comp_CacheEntry* GetBlock(uint32_t BlockAddress) {
+	comp_CacheEntry *entry;
+	uint16_t StoredLength;
+	uint16_t Length = *(uint16_t*) (BlockAddress + 2);
+	uint8_t *stored = StoredBytes(BlockAddress, &StoredLength);
+	uint16_t i;
+
+	UseCounter++;
+
+	for (i = 0; i < MICROCDB_COMP_CACHE_BLOCKS; i++) {
+		if (BlockCache[i].BlockAddress == BlockAddress) {
+			BlockCache[i].LastUsed = UseCounter;
+			return &BlockCache[i];
+		}
+	}
+
+	if (Length > MICROCDB_COMP_BLOCK_SIZE) {
+		return 0;
+	}
+
+	entry = GetLRUEntry();
+	if (entry == 0) {
+		return 0;
+	}
+	entry->BlockAddress = 0;
+
+	if (StoredLength == Length) {
+		/*Block is stored uncompressed*/
+		for (i = 0; i < Length; i++) {
+			entry->Data[i] = stored[i];
+		}
+	} else if (LZ_Decompress(stored, StoredLength, entry->Data,
+	MICROCDB_COMP_BLOCK_SIZE) != Length) {
+		return 0;
+	}
+
+	entry->BlockAddress = BlockAddress;
+	entry->Length = Length;
+	entry->LastUsed = UseCounter;
+	return entry;
+}
+
+/*
+ * This function compresses the Length bytes of the block and stores it at FlashAddresscntr. If the block can't be compressed then
+ * it is stored uncompressed. The block remains in cache as it is just written.
+ * Returns: microcDB_Status STORE_SUCCESS or STORE_FAILED or FLASH_FULL
+ */
+static microcDB_Status StoreBlock(comp_CacheEntry *entry, uint16_t Length) {
+	uint16_t StoredLength, Size, Filter = 0;
+	uint8_t header[BLOCK_HEADER_SIZE + FILTER_LENGTH_SIZE
+			+ MICROCDB_COMP_BLOOM_BYTES];
+	uint8_t *stored = CompressedData;
+
+	/*Store uncompressed if compression doesn't save anything*/
+	StoredLength = LZ_Compress(entry->Data, Length, CompressedData, Length - 1);
+	if (StoredLength == 0) {
+		StoredLength = Length;
+		stored = entry->Data;
+	}
+
+#if MICROCDB_COMP_BLOOM_BYTES > 0
+	Filter = BloomBuild(entry->Data, Length,
+			&header[BLOCK_HEADER_SIZE + FILTER_LENGTH_SIZE]);
+	header[BLOCK_HEADER_SIZE] = (uint8_t) Filter;
+	header[BLOCK_HEADER_SIZE + 1] = (uint8_t) (Filter >> 8);
+#endif
+	Size = FILTER_LENGTH_SIZE + Filter + StoredLength;
+
+	/*Keep the last address free as it has the 0xDB flag*/
+	if (FlashAddresscntr + BLOCK_HEADER_SIZE + Size >= DB_END_ADDR) {
+		return FLASH_FULL;
+	}
+#if MICROCDB_HASH_INDEX == 1
+	/*Don't store the documents which can't be indexed*/
+	if (!HashIndexHasRoom(entry->Data, Length)) {
+		return FLASH_FULL;
+	}
+#endif
+
+	header[0] = (uint8_t) Size;
+	header[1] = (uint8_t) (Size >> 8);
+	header[2] = (uint8_t) Length;
+	header[3] = (uint8_t) (Length >> 8);
+
+	/*The size takes the space of block so it is skipped if the next writes fail, the uncompressed length commits it*/
+	if (WriteBytesToFLASH(header, FlashAddresscntr, 2) != FL_STORE_SUCCESS) {
+		if (*(uint16_t*) FlashAddresscntr != EMPTY_HALFWORD) {
+			FlashAddresscntr = CompressedNextBlock(FlashAddresscntr);
+		}
+		return STORE_FAILED;
+	}
+	if (WriteBytesToFLASH(&header[BLOCK_HEADER_SIZE],
+			FlashAddresscntr + BLOCK_HEADER_SIZE, FILTER_LENGTH_SIZE + Filter)
+			!= FL_STORE_SUCCESS
+			|| WriteBytesToFLASH(stored,
+					FlashAddresscntr + BLOCK_HEADER_SIZE + FILTER_LENGTH_SIZE
+							+ Filter, StoredLength) != FL_STORE_SUCCESS
+			|| WriteBytesToFLASH(&header[2], FlashAddresscntr + 2, 2)
+					!= FL_STORE_SUCCESS) {
+		FlashAddresscntr = CompressedNextBlock(FlashAddresscntr);
+		return STORE_FAILED;
+	}
+
+	UseCounter++;
+	entry->BlockAddress = FlashAddresscntr;
+	entry->Length = Length;
+	entry->LastUsed = UseCounter;
+
+	FlashAddresscntr = CompressedNextBlock(FlashAddresscntr);
+#if MICROCDB_HASH_INDEX == 1
+	return HashIndexAddBlock(entry->Data, Length, entry->BlockAddress);
+#else
+	return STORE_SUCCESS;
+#endif
+}
+/*MISC functions*/
+/**************************************************************************************************************************************/
+
+/*MicrocDB compression functions*/
+uint32_t CompressedInit() {
+	uint32_t BlockAddress = DB_START_ADDR;
+	uint8_t i;
+
+	for (i = 0; i < MICROCDB_COMP_CACHE_BLOCKS; i++) {
+		BlockCache[i].BlockAddress = 0;
+		BlockCache[i].LastUsed = 0;
+		BlockCache[i].Pins = 0;
+	}
+	UseCounter = 0;
+#if MICROCDB_HASH_INDEX == 1
+	HashIndexInit();
+#endif
+
+	/*Walk over the block headers till the empty header*/
+	while (BlockAddress + BLOCK_HEADER_SIZE < DB_END_ADDR) {
+		if (*(uint16_t*) BlockAddress == EMPTY_HALFWORD) {
+			break;
+		}
+		BlockAddress = CompressedNextBlock(BlockAddress);
+	}
+	return BlockAddress;
+}
+
+microcDB_Status CompressedInsert(uint8_t *JSONString,
+		unsigned int numberofobjects) {
+	comp_CacheEntry *entry = GetLRUEntry();
+	uint16_t Length = 0;
+	microcDB_Status status;
+	size_t len;
+	unsigned int num = 0;
+
+	if (entry == 0) {
+		return CACHE_FULL;
+	}
+	entry->BlockAddress = 0; /*This entry is used to prepare the block to be stored*/
+
+	while (num < numberofobjects) {
+		len = CalculateStringLength(JSONString);
+		replacesingleTodouble(JSONString, len);
+		len = len + 1; /*Include the '/' as it splits the documents in a block*/
+
+		if (len > MICROCDB_COMP_BLOCK_SIZE) {
+			return STORE_FAILED; /*Document doesn't fit in a block*/
+		}
+
+		/*Store the prepared block if this document won't fit in it*/
+		if (Length + len > MICROCDB_COMP_BLOCK_SIZE) {
+			status = StoreBlock(entry, Length);
+			if (status != STORE_SUCCESS) {
+				return status;
+			}
+			entry = GetLRUEntry();
+			if (entry == 0) {
+				return CACHE_FULL;
+			}
+			entry->BlockAddress = 0;
+			Length = 0;
+		}
+
+		while (len) {
+			entry->Data[Length] = *JSONString;
+			Length++;
+			JSONString++;
+			len--;
+		}
+		num++;
+	}
+
+	if (Length) {
+		return StoreBlock(entry, Length);
+	}
+	return STORE_SUCCESS;
+}
+
+microcDB_Data CompressedFind(uint8_t *query) {
+	microcDB_Data data_out_struct;
+	comp_CacheEntry *entry;
+	uint32_t BlockAddress = DB_START_ADDR;
+	uint8_t *document, *blockEnd;
+
+	data_out_struct.DBstatus = NOT_FOUND;
+	data_out_struct.JSON_type = JSON_UNDEFINED;
+	data_out_struct.DBStartptr = 0;
+	data_out_struct.DBEndptr = 0;
+
+	for (; BlockAddress < FlashAddresscntr;
+			BlockAddress = CompressedNextBlock(BlockAddress)) {
+		if (!BlockCommitted(BlockAddress)) {
+			continue;
+		}
+#if MICROCDB_COMP_BLOOM_BYTES > 0
+		/*Skip the block without decompressing if its filter rules out the query*/
+		if (!BloomMayHaveQuery(
+				(uint8_t*) BlockAddress + BLOCK_HEADER_SIZE + FILTER_LENGTH_SIZE,
+				FilterLength(BlockAddress), query)) {
+			continue;
+		}
+#endif
+
+		entry = GetBlock(BlockAddress);
+		if (entry == 0) {
+			if (GetLRUEntry() == 0) {
+				data_out_struct.DBstatus = CACHE_FULL;
+			}
+			return data_out_struct; /*Corrupt block, nothing after it can be trusted*/
+		}
+
+		/*Search every document of the block*/
+		document = entry->Data;
+		blockEnd = entry->Data + entry->Length;
+		while (document < blockEnd && *document == '{') {
+			data_out_struct = FindInDocument(query, document, blockEnd);
+			if (data_out_struct.DBstatus == FOUND_SUCCESS) {
+				return data_out_struct;
+			}
+			/*Go to next document which is after '/'*/
+			while (document < blockEnd && *document != '/') {
+				document++;
+			}
+			document++;
+		}
+	}
+
+	data_out_struct.DBstatus = NOT_FOUND;
+	data_out_struct.JSON_type = JSON_UNDEFINED;
+	return data_out_struct;
+}
+
+uint8_t* CompressedDocument(uint32_t BlockAddress, uint16_t Ordinal,
+		uint8_t **BlockEnd, microcDB_Status *Status) {
+	comp_CacheEntry *entry;
+	uint8_t *document;
+
+	*Status = NOT_FOUND;
+	if (BlockAddress >= FlashAddresscntr || !BlockCommitted(BlockAddress)) {
+		return 0;
+	}
+	entry = GetBlock(BlockAddress);
+	if (entry == 0) {
+		if (GetLRUEntry() == 0) {
+			*Status = CACHE_FULL;
+		}
+		return 0;
+	}
+
+	document = entry->Data;
+	*BlockEnd = entry->Data + entry->Length;
+	while (Ordinal != 0 && document < *BlockEnd) {
+		if (*document == '/')
+			Ordinal--;
+		document++;
+	}
+	return (document < *BlockEnd && *document == '{') ? document : 0;
+}
+
+uint32_t CompressedNextBlock(uint32_t BlockAddress) {
+	uint16_t Size = *(uint16_t*) BlockAddress;
+
+	return BlockAddress + BLOCK_HEADER_SIZE + Size + (Size & 1);
+}
+
+#if MICROCDB_HASH_INDEX == 1
+microcDB_Status CompressedReindex() {
+	comp_CacheEntry *entry;
+	uint32_t BlockAddress;
+	microcDB_Status status;
+
+	if (HashIndexErase() != ERASE_SUCCESS) {
+		return STORE_FAILED;
+	}
+	for (BlockAddress = DB_START_ADDR; BlockAddress < FlashAddresscntr;
+			BlockAddress = CompressedNextBlock(BlockAddress)) {
+		if (!BlockCommitted(BlockAddress)) {
+			continue;
+		}
+		entry = GetBlock(BlockAddress);
+		if (entry == 0) {
+			return (GetLRUEntry() == 0) ? CACHE_FULL : STORE_SUCCESS; /*Nothing after a corrupt block can be trusted*/
+		}
+		status = HashIndexAddBlock(entry->Data, entry->Length, BlockAddress);
+		if (status != STORE_SUCCESS) {
+			return status;
+		}
+	}
+	return STORE_SUCCESS;
+}
+#endif
+
+void CompressedPin(microcDB_Data *Data) {
+	comp_CacheEntry *entry;
+
+	if (Data->DBstatus == FOUND_SUCCESS) {
+		entry = EntryOf(Data->DBStartptr);
+		if (entry != 0 && entry->Pins != 0xFF) {
+			entry->Pins++;
+		}
+	}
+}
+
+void MicrocDB_Release(microcDB_Data *Data) {
+	comp_CacheEntry *entry;
+
+	if (Data->DBstatus == FOUND_SUCCESS) {
+		entry = EntryOf(Data->DBStartptr);
+		if (entry != 0 && entry->Pins != 0) {
+			entry->Pins--;
+		}
+		Data->DBstatus = NOT_FOUND; /*So it is not released twice*/
+	}
+}
+/*MicrocDB compression functions*/
+
+#endif
@@ -0,0 +1,381 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The counters of microcDB. The counters are stored in their own flash region which is used as two banks. Every
+ *      			 counter has a slot in the active bank and every change of counter is programmed once in the next empty half word
+ *      			 of its slot. So a change doesn't erase the flash. When the slot is full a new slot with the current value as base is
+ *      			 written and when the bank is full the newest slot of every counter is copied to the other bank which becomes active
+ *      			 and the old bank is erased.
+ *
+ *      			 Layout of a bank:
+ *      			 |Sequence number(4 bytes)|Slot|Slot|...|Empty|
+ *      			 Layout of a slot:
+ *      			 |Path padded to MICROCDB_COUNTER_KEY_SIZE|Base(4 bytes)|Complete flag(2 bytes)|Delta(2 bytes)|...|
+ *      			 The complete flag is written after the path and base so a slot whose writing was interrupted is ignored. The deltas
+ *      			 are stored XORed with the empty half word so that a delta of -1 is not same as empty flash.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_COUNTERS == 1
+
+#define BANK_SIZE ((MICROCDB_COUNTER_END_ADDR + 1 - MICROCDB_COUNTER_START_ADDR) / 2)
+#define BANK_HEADER_SIZE 4
+#define SLOT_BASE_OFFSET MICROCDB_COUNTER_KEY_SIZE
+#define SLOT_FLAG_OFFSET (MICROCDB_COUNTER_KEY_SIZE + 4)
+#define SLOT_DELTAS_OFFSET (MICROCDB_COUNTER_KEY_SIZE + 6)
+#define SLOT_SIZE (SLOT_DELTAS_OFFSET + (2 * MICROCDB_COUNTER_DELTAS))
+#define SLOTS_PER_BANK ((BANK_SIZE - BANK_HEADER_SIZE) / SLOT_SIZE)
+#define MAX_DELTA 32767
+#define EMPTY_HALFWORD ((uint16_t)(((uint8_t)FL_EMPTY_BYTE << 8) | (uint8_t)FL_EMPTY_BYTE))
+#define EMPTY_WORD (((uint32_t)EMPTY_HALFWORD << 16) | EMPTY_HALFWORD)
+
+static uint8_t ActiveBank = 0; /*The bank which has the counters*/
+static uint32_t ActiveSequence = 0; /*The sequence number of active bank*/
+static uint8_t *FreeSlot = 0; /*The address of first empty slot of active bank*/
+
+/*MISC functions*/
+
+/*
+ * This function returns the address of the slot of the bank
+ */
+static inline uint8_t* SlotAddress(uint8_t Bank, uint16_t Slot) {
+	return (uint8_t*) MICROCDB_COUNTER_START_ADDR + (Bank * BANK_SIZE)
+			+ BANK_HEADER_SIZE + (Slot * SLOT_SIZE);
+}
+
+/*
+ * This function checks if the path stored in slot is same as given path. Both are terminated with '/'.
+ */
+static bool KeyEquals(uint8_t *Slot, uint8_t *path) {
+	while (*path != '/') {
+		if (*Slot != *path) {
+			return false;
+		}
+		Slot++;
+		path++;
+	}
+	return *Slot == '/';
+}
+
+/*
+ * This function searches the newest complete slot of the path in the bank.
+ * Returns: The address of slot or 0 if the counter has no slot
+ */
+static uint8_t* FindSlot(uint8_t Bank, uint8_t *path) {
+	uint8_t *Slot, *Found = 0;
+
+	for (Slot = SlotAddress(Bank, 0);
+			Slot < SlotAddress(Bank, SLOTS_PER_BANK) && *Slot != FL_EMPTY_BYTE;
+			Slot = Slot + SLOT_SIZE) {
+		if (*(uint16_t*) (Slot + SLOT_FLAG_OFFSET) != EMPTY_HALFWORD
+				&& KeyEquals(Slot, path)) {
+			Found = Slot;
+		}
+	}
+	return Found;
+}
+
+/*
+ * This function calculates the value of counter from the base and deltas of its slot. The base is read byte by byte as it may not be
+ * aligned to word.
+ * Returns: The value and the address of first empty delta in FreeDelta or 0 if all deltas are used
+ */
+static int32_t SlotValue(uint8_t *Slot, uint8_t **FreeDelta) {
+	uint8_t *Delta;
+	uint32_t Base = (uint32_t) Slot[SLOT_BASE_OFFSET]
+			| ((uint32_t) Slot[SLOT_BASE_OFFSET + 1] << 8)
+			| ((uint32_t) Slot[SLOT_BASE_OFFSET + 2] << 16)
+			| ((uint32_t) Slot[SLOT_BASE_OFFSET + 3] << 24);
+	int32_t Value = (int32_t) Base;
+
+	*FreeDelta = 0;
+	for (Delta = Slot + SLOT_DELTAS_OFFSET; Delta < Slot + SLOT_SIZE; Delta =
+			Delta + 2) {
+		if (*(uint16_t*) Delta == EMPTY_HALFWORD) {
+			*FreeDelta = Delta;
+			break;
+		}
+		/*The stored deltas never overflow the counter but a corrupt slot may, so the sum wraps instead*/
+		Value = (int32_t) ((uint32_t) Value
+				+ (uint32_t) (int16_t) (*(uint16_t*) Delta ^ EMPTY_HALFWORD));
+	}
+	return Value;
+}
+
+/*
+ * This function writes the slot of the path with given base at the address of Slot which should be empty.
+ * Returns: microcDB_Status STORE_SUCCESS or STORE_FAILED
+ */
+static microcDB_Status WriteSlot(uint8_t *Slot, uint8_t *path, int32_t Base) {
+	uint8_t SlotBytes[SLOT_FLAG_OFFSET];
+	uint8_t Flag[2] = { (uint8_t) ~FL_EMPTY_BYTE, (uint8_t) ~FL_EMPTY_BYTE };
+	uint8_t i = 0;
+
+	while (i < MICROCDB_COUNTER_KEY_SIZE) {
+		SlotBytes[i] = *path;
+		if (*path != '/')
+			path++;
+		else
+			break;
+		i++;
+	}
+	for (i++; i < MICROCDB_COUNTER_KEY_SIZE; i++)
+		SlotBytes[i] = FL_EMPTY_BYTE;
+	SlotBytes[SLOT_BASE_OFFSET] = (uint8_t) Base;
+	SlotBytes[SLOT_BASE_OFFSET + 1] = (uint8_t) ((uint32_t) Base >> 8);
+	SlotBytes[SLOT_BASE_OFFSET + 2] = (uint8_t) ((uint32_t) Base >> 16);
+	SlotBytes[SLOT_BASE_OFFSET + 3] = (uint8_t) ((uint32_t) Base >> 24);
+
+	if (WriteBytesToFLASH(SlotBytes, (uint32_t) Slot, SLOT_FLAG_OFFSET)
+			!= FL_STORE_SUCCESS
+			|| WriteBytesToFLASH(Flag, (uint32_t) (Slot + SLOT_FLAG_OFFSET), 2)
+					!= FL_STORE_SUCCESS) {
+		return STORE_FAILED;
+	}
+	return STORE_SUCCESS;
+}
+
+/*
+ * This function erases all the pages of the bank
+ * Returns: flash_mem_Stat ERASE_SUCCESS or ERASE_FAILED
+ */
+static flash_mem_Stat EraseBank(uint8_t Bank) {
+	uint32_t Page;
+
+	for (Page = 0; Page < BANK_SIZE / FLASH_PAGE_SIZE; Page++) {
+		if (ErasePage(
+				(uint8_t*) MICROCDB_COUNTER_START_ADDR + (Bank * BANK_SIZE)
+						+ (Page * FLASH_PAGE_SIZE)) != ERASE_SUCCESS) {
+			return ERASE_FAILED;
+		}
+	}
+	return ERASE_SUCCESS;
+}
+
+/*
+ * This function writes the sequence number to the header of the bank
+ * Returns: microcDB_Status STORE_SUCCESS or STORE_FAILED
+ */
+static microcDB_Status WriteSequence(uint8_t Bank, uint32_t Sequence) {
+	uint8_t SequenceBytes[BANK_HEADER_SIZE] = { (uint8_t) Sequence,
+			(uint8_t) (Sequence >> 8), (uint8_t) (Sequence >> 16),
+			(uint8_t) (Sequence >> 24) };
+
+	if (WriteBytesToFLASH(SequenceBytes,
+	MICROCDB_COUNTER_START_ADDR + (Bank * BANK_SIZE), BANK_HEADER_SIZE)
+			!= FL_STORE_SUCCESS) {
+		return STORE_FAILED;
+	}
+	return STORE_SUCCESS;
+}
+
+/*
+ * This function copies the newest slot of every counter of the active bank to the other bank with its value as base. The sequence
+ * number of the other bank is written after the slots so if power is lost while copying then the active bank remains same. Then the
+ * old bank is erased.
+ * Returns: microcDB_Status STORE_SUCCESS, STORE_FAILED
+ */
+static microcDB_Status CompactBank() {
+	uint8_t NewBank = ActiveBank ^ 1;
+	uint8_t *Slot, *NewSlot = SlotAddress(NewBank, 0), *FreeDelta;
+
+	if (EraseBank(NewBank) != ERASE_SUCCESS) {
+		return STORE_FAILED;
+	}
+
+	for (Slot = SlotAddress(ActiveBank, 0);
+			Slot < FreeSlot; Slot = Slot + SLOT_SIZE) {
+		/*Copy only the newest slot of counter. The slot starts with its path so it is used as path*/
+		if (*(uint16_t*) (Slot + SLOT_FLAG_OFFSET) == EMPTY_HALFWORD
+				|| FindSlot(ActiveBank, Slot) != Slot) {
+			continue;
+		}
+		if (WriteSlot(NewSlot, Slot, SlotValue(Slot, &FreeDelta))
+				!= STORE_SUCCESS) {
+			return STORE_FAILED;
+		}
+		NewSlot = NewSlot + SLOT_SIZE;
+	}
+
+	if (WriteSequence(NewBank, ActiveSequence + 1) != STORE_SUCCESS
+			|| EraseBank(ActiveBank) != ERASE_SUCCESS) {
+		return STORE_FAILED;
+	}
+	ActiveBank = NewBank;
+	ActiveSequence++;
+	FreeSlot = NewSlot;
+	return STORE_SUCCESS;
+}
+
+/*
+ * This function gets the integer value at the path in DB which is the initial value of counter.
+ * Returns: microcDB_Status FOUND_SUCCESS, NOT_FOUND or QUERY_INVALID if the value is not an integer
+ */
+static microcDB_Status DBValue(uint8_t *path, int32_t *Value) {
+	microcDB_Data Data = FindPath(path);
+
+	if (Data.DBstatus != FOUND_SUCCESS) {
+		return NOT_FOUND;
+	}
+	/*The integer has at most 11 chars, the parser can give the end after it so get the end again*/
+	if (Data.JSON_type != JSON_PRIMITIVE
+			|| !AsciiToInteger(Data.DBStartptr,
+					SkipJSONValue(Data.DBStartptr, Data.DBStartptr + 11), Value)) {
+		return QUERY_INVALID;
+	}
+	return FOUND_SUCCESS;
+}
+
+/*
+ * This function adds delta to the counter. The delta is programmed in the slot of counter if it has an empty delta and delta fits in
+ * half word, otherwise a new slot with the new value as base is written.
+ * Returns: microcDB_Status same as MicrocDB_Increment()
+ */
+static microcDB_Status CounterAdd(uint8_t *path, int32_t delta) {
+	uint8_t *Slot, *FreeDelta = 0;
+	uint8_t DeltaBytes[2];
+	uint16_t Stored;
+	int32_t Value = 0;
+	microcDB_Status status;
+
+	if (CalculateStringLength(path) >= MICROCDB_COUNTER_KEY_SIZE) {
+		return QUERY_INVALID;
+	}
+
+	Slot = FindSlot(ActiveBank, path);
+	if (Slot != 0) {
+		Value = SlotValue(Slot, &FreeDelta);
+	} else {
+		status = DBValue(path, &Value);
+		if (status == QUERY_INVALID) {
+			return UPDATE_FAILED;
+		} else if (status == NOT_FOUND) {
+			Value = 0;
+		}
+	}
+	if (delta == 0) {
+		return UPDATE_SUCCESSFUL;
+	}
+	if ((delta > 0 && Value > INT32_MAX - delta)
+			|| (delta < 0 && Value < INT32_MIN - delta)) {
+		return COUNTER_OVERFLOW;
+	}
+
+	if (FreeDelta == 0 || delta > MAX_DELTA || delta < -MAX_DELTA) {
+		/*A new slot is needed so make space for it if the bank is full*/
+		if (FreeSlot + SLOT_SIZE > SlotAddress(ActiveBank, SLOTS_PER_BANK)) {
+			if (CompactBank() != STORE_SUCCESS) {
+				return STORE_FAILED;
+			}
+			/*The copied slot has all its deltas empty*/
+			Slot = FindSlot(ActiveBank, path);
+			if (Slot != 0) {
+				Value = SlotValue(Slot, &FreeDelta);
+			}
+		}
+	}
+
+	if (FreeDelta != 0 && delta <= MAX_DELTA && delta >= -MAX_DELTA) {
+		Stored = (uint16_t) (int16_t) delta ^ EMPTY_HALFWORD;
+		DeltaBytes[0] = (uint8_t) Stored;
+		DeltaBytes[1] = (uint8_t) (Stored >> 8);
+		if (WriteBytesToFLASH(DeltaBytes, (uint32_t) FreeDelta, 2)
+				!= FL_STORE_SUCCESS) {
+			return STORE_FAILED;
+		}
+		return UPDATE_SUCCESSFUL;
+	}
+
+	if (FreeSlot + SLOT_SIZE > SlotAddress(ActiveBank, SLOTS_PER_BANK)) {
+		return FLASH_FULL;
+	}
+	status = WriteSlot(FreeSlot, path, Value + delta);
+	FreeSlot = FreeSlot + SLOT_SIZE; /*The slot is used even if writing failed*/
+	return (status == STORE_SUCCESS) ? UPDATE_SUCCESSFUL : STORE_FAILED;
+}
+
+/*MISC functions*/
+
+/**************************************************************************************************************************************/
+/*MicrocDB counter functions*/
+
+microcDB_Status CounterInit() {
+	uint32_t Sequence0 = *(uint32_t*) MICROCDB_COUNTER_START_ADDR;
+	uint32_t Sequence1 = *(uint32_t*) (MICROCDB_COUNTER_START_ADDR + BANK_SIZE);
+	uint8_t OtherBank;
+
+	if (Sequence0 == EMPTY_WORD && Sequence1 == EMPTY_WORD) {
+		/*First use of the region, a bank without sequence number may have the slots of an interrupted copy*/
+		if ((*SlotAddress(0, 0) != FL_EMPTY_BYTE && EraseBank(0) != ERASE_SUCCESS)
+				|| (*SlotAddress(1, 0) != FL_EMPTY_BYTE
+						&& EraseBank(1) != ERASE_SUCCESS)
+				|| WriteSequence(0, 1) != STORE_SUCCESS) {
+			return INIT_FAILED;
+		}
+		ActiveBank = 0;
+		ActiveSequence = 1;
+	} else {
+		if (Sequence1 != EMPTY_WORD
+				&& (Sequence0 == EMPTY_WORD || Sequence1 > Sequence0)) {
+			ActiveBank = 1;
+			ActiveSequence = Sequence1;
+		} else {
+			ActiveBank = 0;
+			ActiveSequence = Sequence0;
+		}
+		/*The other bank is not empty if power was lost while copying or before erasing the old bank*/
+		OtherBank = ActiveBank ^ 1;
+		if ((*(uint32_t*) (MICROCDB_COUNTER_START_ADDR + (OtherBank * BANK_SIZE))
+				!= EMPTY_WORD || *SlotAddress(OtherBank, 0) != FL_EMPTY_BYTE)
+				&& EraseBank(OtherBank) != ERASE_SUCCESS) {
+			return INIT_FAILED;
+		}
+	}
+
+	FreeSlot = SlotAddress(ActiveBank, 0);
+	while (FreeSlot < SlotAddress(ActiveBank, SLOTS_PER_BANK)
+			&& *FreeSlot != FL_EMPTY_BYTE) {
+		FreeSlot = FreeSlot + SLOT_SIZE;
+	}
+	return INIT_CMPLT;
+}
+
+microcDB_Status MicrocDB_Increment(uint8_t *path, int32_t delta) {
+	microcDB_Status status;
+	LATENCY_BEGIN();
+
+	STATS_BEGIN(STATS_OP_UPDATE);
+	DEVICES_SYNC();
+	CHANGE_BEGIN();
+	status = CounterAdd(path, delta);
+
+	LATENCY_END(LATENCY_OP_UPDATE);
+	if (status == UPDATE_SUCCESSFUL) {
+		CHANGE_EMIT_INCREMENT(path, delta);
+	}
+	return status;
+}
+
+microcDB_Status MicrocDB_Decrement(uint8_t *path, int32_t delta) {
+	if (delta == INT32_MIN) {
+		return COUNTER_OVERFLOW; /*-delta is not an int32_t*/
+	}
+	return MicrocDB_Increment(path, -delta);
+}
+
+microcDB_Status MicrocDB_GetCounter(uint8_t *path, int32_t *Value) {
+	uint8_t *Slot, *FreeDelta;
+
+	STATS_BEGIN(STATS_OP_FIND);
+	DEVICES_SYNC();
+
+	Slot = FindSlot(ActiveBank, path);
+	if (Slot != 0) {
+		*Value = SlotValue(Slot, &FreeDelta);
+		return FOUND_SUCCESS;
+	}
+	return (DBValue(path, Value) == FOUND_SUCCESS) ? FOUND_SUCCESS : NOT_FOUND;
+}
+
+/*MicrocDB counter functions*/
+#endif
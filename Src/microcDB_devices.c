@@ -0,0 +1,93 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The flash devices of microcDB. The pages in the window of a memory mapped device (e.g external NOR flash in the
+ *      			 memory mapped mode of QSPI) are erased and programmed by its functions in MICROCDB_DEVICE_TABLE and read through the
+ *      			 window like the internal flash. An erase is only begun and the device is waited for before its next erase or
+ *      			 program, or by DevicesSync at the next call of microcDB. So the CPU parses and programs the other devices while a
+ *      			 device erases, and the erases of different devices overlap only when a call erases both. The pages of one device,
+ *      			 like the ones erased by EraseDB, are erased one after another.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_DEVICES > 0
+
+#include MICROCDB_DEVICE_HEADER
+
+typedef struct {
+	uint32_t Start; /*The first address of window*/
+	uint32_t End; /*The last address of window*/
+	bool (*EraseBegin)(uint32_t PageAddress);
+	bool (*Busy)(void);
+	bool (*Program)(uint32_t Address, uint8_t *Data, size_t NumberOfBytes);
+} microcDB_Device;
+
+static const microcDB_Device Devices[MICROCDB_DEVICES] = {
+MICROCDB_DEVICE_TABLE };
+static bool Pending[MICROCDB_DEVICES]; /*true if the device may still be erasing or programming*/
+
+/*MISC functions*/
+
+/*
+ * This function waits till the device is not busy.
+ */
+static inline void DeviceWait(int8_t Device) {
+	if (Pending[Device]) {
+		while (Devices[Device].Busy()) {
+		}
+		Pending[Device] = false;
+	}
+}
+
+/*MISC functions*/
+
+int8_t DeviceOf(uint32_t Address) {
+	int8_t Device;
+
+	for (Device = 0; Device < MICROCDB_DEVICES; Device++) {
+		if (Address >= Devices[Device].Start && Address <= Devices[Device].End) {
+			return Device;
+		}
+	}
+	return -1;
+}
+
+flash_mem_Stat DeviceErasePage(int8_t Device, uint32_t PageAddress) {
+	DeviceWait(Device);
+	if (!Devices[Device].EraseBegin(PageAddress)) {
+		return ERASE_FAILED;
+	}
+	Pending[Device] = true; /*The page is read only after DevicesSync or the next program of device*/
+	return ERASE_SUCCESS;
+}
+
+flash_mem_Stat DeviceProgram(int8_t Device, uint32_t Address, uint8_t *Data,
+		size_t NumberOfBytes) {
+	uint8_t *Window = (uint8_t*) Address;
+	size_t bytecntr;
+
+	DeviceWait(Device);
+	if (!Devices[Device].Program(Address, Data, NumberOfBytes)) {
+		return FL_STORE_FAILED;
+	}
+	Pending[Device] = true;
+	DeviceWait(Device);
+
+	/*Verify the programmed bytes through the window*/
+	for (bytecntr = 0; bytecntr < NumberOfBytes; bytecntr++) {
+		if (Window[bytecntr] != Data[bytecntr]) {
+			return FL_STORE_FAILED;
+		}
+	}
+	return FL_STORE_SUCCESS;
+}
+
+void DevicesSync() {
+	int8_t Device;
+
+	for (Device = 0; Device < MICROCDB_DEVICES; Device++) {
+		DeviceWait(Device);
+	}
+}
+
+#endif
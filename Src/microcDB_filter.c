@@ -0,0 +1,240 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The filter scans of microcDB. The elements of an array list or object are walked once, the members of every
+ *      element are compared and the values inside them are skipped without parsing. An element object which was relocated is
+ *      compared and given in its latest copy.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_FILTER == 1
+
+/*MISC functions*/
+
+/*
+ * This function compares the chars of Value of given length with the compare value terminated with '/'.
+ * Returns: less than 0, 0 or greater than 0 if the Value is less, same or greater. If Prefix is true then 0 is returned if the Value
+ * starts with the compare value.
+ */
+static int8_t CompareChars(uint8_t *Value, size_t Length, uint8_t *Compare,
+		bool Prefix) {
+	while (*Compare != '/') {
+		if (Length == 0)
+			return -1;
+		if (*Value != *Compare)
+			return (*Value < *Compare) ? -1 : 1;
+		Value++;
+		Compare++;
+		Length--;
+	}
+	return (Length == 0 || Prefix) ? 0 : 1;
+}
+
+/*
+ * This function compares the Length chars of the string with the key.
+ * Returns: true if same
+ */
+static inline bool KeyEquals(uint8_t *String, uint8_t *Key, size_t Length) {
+	while (Length != 0) {
+		if (*String != *Key)
+			return false;
+		String++;
+		Key++;
+		Length--;
+	}
+	return true;
+}
+
+/*
+ * This function checks the condition between the value of a member from Start till End(both inclusive) and the compare value. For
+ * strings the Start and End should point to first and last char without quotes.
+ * Returns: true if condition is satisfied
+ */
+static bool FilterMatches(uint8_t *Start, uint8_t *End, bool IsString,
+		microcDB_FilterOp Op, uint8_t *Compare, size_t CompareLength) {
+	float number, CompareNumber;
+	int8_t result;
+	size_t Length = (End >= Start) ? (size_t) (End - Start + 1) : 0; /*The empty string has End before Start*/
+
+	if (Op == FILTER_PREFIX) {
+		return CompareChars(Start, Length, Compare, true) == 0;
+	}
+
+	/*Numbers are compared by value*/
+	if (!IsString && Length != 0 && CompareLength != 0
+			&& AsciiToFloat(Start, End, &number)
+			&& AsciiToFloat(Compare, Compare + CompareLength - 1,
+					&CompareNumber)) {
+		result = (number < CompareNumber) ? -1 :
+					(number > CompareNumber) ? 1 : 0;
+	} else
+		result = CompareChars(Start, Length, Compare, false);
+
+	switch (Op) {
+	case FILTER_EQ:
+		return result == 0;
+	case FILTER_NE:
+		return result != 0;
+	case FILTER_LT:
+		return result < 0;
+	case FILTER_GT:
+		return result > 0;
+	default:
+		return false;
+	}
+}
+
+/*
+ * This function finds the member of the object from its '{' ObjectStart till its '}' ObjectEnd having the given key and checks the
+ * condition on its value. The values of the other members are skipped without parsing.
+ * Returns: true if member is present and condition is satisfied
+ */
+static bool ObjectMatches(uint8_t *ObjectStart, uint8_t *ObjectEnd,
+		uint8_t *Key, size_t KeyLength, microcDB_FilterOp Op, uint8_t *Compare,
+		size_t CompareLength) {
+	uint8_t *ptr = SkipSlack(ObjectStart + 1, ObjectEnd), *MemberKey, *ValueEnd;
+	size_t MemberKeyLength;
+
+	while (ptr < ObjectEnd && *ptr == '\"') {
+		/*The key of member*/
+		MemberKey = ptr + 1;
+		ptr = SkipJSONValue(ptr, ObjectEnd);
+		MemberKeyLength = ptr - MemberKey;
+		ptr = ptr + 2; /*Skip the ending quote and ':'*/
+
+		ValueEnd = SkipJSONValue(ptr, ObjectEnd);
+		if (MemberKeyLength == KeyLength
+				&& KeyEquals(MemberKey, Key, KeyLength)) {
+			if (*ptr == '\"')
+				return FilterMatches(ptr + 1, ValueEnd - 1, true, Op, Compare,
+						CompareLength);
+			else
+				return FilterMatches(ptr, ValueEnd, false, Op, Compare,
+						CompareLength);
+		}
+		ptr = SkipSlack(ValueEnd + 1, ObjectEnd);
+		if (*ptr == ',')
+			ptr = SkipSlack(ptr + 1, ObjectEnd);
+	}
+	return false;
+}
+
+/*MISC functions*/
+
+/**************************************************************************************************************************************/
+/*MicrocDB filter functions*/
+
+microcDB_Status MicrocDB_Filter(uint8_t *path, uint8_t *field,
+		microcDB_FilterOp Op, uint8_t *value, microcDB_FilterCallback Callback,
+		void *Context) {
+	microcDB_Data FindResult, Match, Key;
+	uint8_t *ptr, *End, *KeyEnd, *ValueEnd;
+	microcDB_Status status = NOT_FOUND;
+	size_t KeyLength = 0, CompareLength;
+#if MICROCDB_ARRAY_SEGMENTS == 1
+	uint8_t *Segment;
+#endif
+#if MICROCDB_SEQLOCK == 1
+	uint32_t Sequence;
+#endif
+
+	STATS_BEGIN(STATS_OP_FIND);
+	DEVICES_SYNC();
+	if (UPDATE_JOB_PENDING()) {
+		return UPDATE_PENDING; /*The DB is partly shifted by the job*/
+	}
+
+#if MICROCDB_SEQLOCK == 1
+	/*The callback can't be called again for the matches given so the scan gives READ_CONFLICT if the DB is written during it*/
+	do {
+		Sequence = SeqReadBegin();
+		FindResult = FindPath(path);
+	} while (SeqReadRetry(Sequence));
+#else
+	FindResult = FindPath(path);
+#endif
+	if (FindResult.DBstatus != FOUND_SUCCESS) {
+		return PATH_NOT_FOUND;
+	}
+	if (FindResult.JSON_type != JSON_ARRAY
+			&& FindResult.JSON_type != JSON_OBJ) {
+		return PATH_NOT_ARRAYLIST;
+	}
+	STATS_ADD(ParserBytes,
+			FindResult.DBEndptr - FindResult.DBStartptr + 1);
+
+	/*The key is till the dot*/
+	while (field[KeyLength] != '.' && field[KeyLength] != '/')
+		KeyLength++;
+	CompareLength = CalculateStringLength(value);
+
+	Match.DBstatus = FOUND_SUCCESS;
+	Match.JSON_type = JSON_OBJ;
+	Key.DBstatus = NOT_FOUND;
+	Key.JSON_type = JSON_UNDEFINED;
+	Key.DBStartptr = 0;
+	Key.DBEndptr = 0;
+
+	ptr = SkipSlack(FindResult.DBStartptr + 1, FindResult.DBEndptr);
+	End = FindResult.DBEndptr;
+#if MICROCDB_ARRAY_SEGMENTS == 1
+	/*The elements appended by MicrocDB_UpdateArrayList() are in the overflow segments*/
+	Segment = (FindResult.JSON_type == JSON_ARRAY) ? ArraySegmentFirst(path) : 0;
+#endif
+	for (;;) {
+#if MICROCDB_ARRAY_SEGMENTS == 1
+		if (ptr >= End && Segment != 0) {
+			ptr = ArraySegmentList(Segment, &End) + 1;
+			Segment = ArraySegmentNext(Segment);
+		}
+#endif
+		if (ptr >= End)
+			break;
+
+		if (FindResult.JSON_type == JSON_OBJ) {
+			/*Skip the key of the value*/
+			KeyEnd = SkipJSONValue(ptr, End);
+			Key.DBstatus = FOUND_SUCCESS;
+			Key.JSON_type = JSON_STRING;
+			Key.DBStartptr = ptr + 1;
+			Key.DBEndptr = KeyEnd - 1;
+			ptr = KeyEnd + 2;
+		}
+
+		ValueEnd = SkipJSONValue(ptr, End);
+		Match.DBStartptr = ptr;
+		Match.DBEndptr = ValueEnd;
+#if MICROCDB_RELOCATION == 1
+		if (*ptr == '{') {
+			RelocationFollow(&Match.DBStartptr, &Match.DBEndptr); /*The latest copy of the relocated object is compared*/
+		}
+#endif
+
+		/*Only the objects are compared, other elements are skipped*/
+		if (*ptr == '{'
+				&& ObjectMatches(Match.DBStartptr, Match.DBEndptr, field,
+						KeyLength, Op, value, CompareLength)) {
+#if MICROCDB_SEQLOCK == 1
+			if (SeqReadRetry(Sequence)) {
+				return READ_CONFLICT; /*The match may have been read while it was written*/
+			}
+#endif
+			status = FOUND_SUCCESS;
+			if (!Callback(&Match, &Key, Context))
+				break;
+		}
+
+		ptr = SkipSlack(ValueEnd + 1, End);
+		if (*ptr == ',')
+			ptr = SkipSlack(ptr + 1, End);
+	}
+#if MICROCDB_SEQLOCK == 1
+	if (SeqReadRetry(Sequence)) {
+		return READ_CONFLICT; /*The objects skipped may have been read while they were written*/
+	}
+#endif
+	return status;
+}
+
+/*MicrocDB filter functions*/
+#endif
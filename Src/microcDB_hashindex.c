@@ -0,0 +1,533 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The persistent hash index of microcDB on the value at MICROCDB_HASH_INDEX_PATH of the stored documents.
+ *      Every page of the index region is a bucket. The slot of a document is added to the bucket page of the hash of its value, or to
+ *      the next page having a free slot in the probe sequence of the hash if that is full. The step of the sequence is derived from the
+ *      hash(double hashing by pages) so the full pages don't make long runs probed by every value. Slots are only programmed once in
+ *      the erased flash so the index never needs erasing except when DB is erased or restored.
+ *      The slot whose document doesn't have its value anymore is stale, it is dropped by programming it to 0 and the lookup which met it
+ *      falls back to a scan of the documents, which adds the slot of the document found.
+ *      The uncompressed documents are changed in place. An update adds the slot of the new value of its document, and when the DB is
+ *      shifted the slots of the documents after the shift are added again at their new offsets before the old ones are dropped.
+ *
+ *      Layout of a slot:
+ *      |Hash of value(4 bytes)|Location of document(4 bytes)|
+ *      The location is the offset of block from MICROCDB_START_ADDR(20 bits) and ordinal of document in block(12 bits) in the compressed
+ *      store, or the offset of document from MICROCDB_START_ADDR in the uncompressed store.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_HASH_INDEX == 1
+
+#define SLOT_SIZE 8
+#define SLOTS_PER_PAGE (FLASH_PAGE_SIZE / SLOT_SIZE)
+#define INDEX_PAGES ((MICROCDB_HASH_INDEX_END_ADDR + 1 - MICROCDB_HASH_INDEX_START_ADDR) / FLASH_PAGE_SIZE)
+#define ORDINAL_BITS 12
+#define EMPTY_HALFWORD ((uint16_t)(((uint8_t)FL_EMPTY_BYTE << 8) | (uint8_t)FL_EMPTY_BYTE))
+#define EMPTY_WORD (((uint32_t)EMPTY_HALFWORD << 16) | EMPTY_HALFWORD)
+#define DROPPED_WORD 0x00000000UL /*Both words of the dropped slot*/
+
+static uint32_t UsedSlots = 0; /*The number of slots used in the index region*/
+static bool IndexComplete = true; /*false if the slot of some document didn't fit in the index, then the lookups which miss scan DB*/
+
+/*MISC functions*/
+
+/*
+ * This function returns the address of the slot of the page.
+ */
+static inline uint8_t* SlotAddress(uint32_t Page, uint16_t Slot) {
+	return (uint8_t*) MICROCDB_HASH_INDEX_START_ADDR + (Page * FLASH_PAGE_SIZE)
+			+ (Slot * SLOT_SIZE);
+}
+
+/*
+ * This function calculates the FNV-1a hash of the bytes from Start till End(both inclusive).
+ */
+static uint32_t ValueHash(uint8_t *Start, uint8_t *End) {
+	uint32_t hash = 2166136261UL;
+	while (Start <= End) {
+		hash = (hash ^ *Start) * 16777619UL;
+		Start++;
+	}
+	return hash;
+}
+
+/*
+ * This function gets the indexed value of the document. The value of a string is without quotes.
+ * Returns: true if the document has the value
+ */
+static bool DocumentValue(uint8_t *Document, uint8_t *DocumentEnd,
+		microcDB_Data *Value) {
+	*Value = FindInDocument((uint8_t*) MICROCDB_HASH_INDEX_PATH, Document,
+			DocumentEnd);
+	if (Value->DBstatus != FOUND_SUCCESS) {
+		return false;
+	}
+	/*The parser can give the end of number after the number so get it again to hash the same bytes as the given value*/
+	if (Value->JSON_type == JSON_PRIMITIVE || Value->JSON_type == JSON_BOOL)
+		Value->DBEndptr = SkipJSONValue(Value->DBStartptr, DocumentEnd);
+	return true;
+}
+
+#if MICROCDB_COMPRESSION == 1
+/*
+ * This function returns the next document of the block or 0 if there are no more documents.
+ */
+static inline uint8_t* NextDocument(uint8_t *Document, uint8_t *BlockEnd) {
+	while (Document < BlockEnd && *Document != '/')
+		Document++;
+	Document++;
+	return (Document < BlockEnd && *Document == '{') ? Document : 0;
+}
+#else
+/*
+ * This function returns the stored document from Document or 0 if there are no more documents. The end of document is given in
+ * DocumentEnd which is after its '}' as the parser searches till it.
+ */
+static uint8_t* StoredDocument(uint8_t *Document, uint8_t **DocumentEnd) {
+	uint8_t *End = (uint8_t*) FlashAddresscntr;
+
+	if (Document >= End || *Document != '{') {
+		return 0;
+	}
+	*DocumentEnd = SkipJSONValue(Document, End) + 1;
+	return Document;
+}
+
+/*
+ * This function returns the stored document after the one ending at DocumentEnd or 0 if there are no more documents.
+ */
+static uint8_t* NextStoredDocument(uint8_t **DocumentEnd) {
+	uint8_t *Document = *DocumentEnd, *End = (uint8_t*) FlashAddresscntr;
+
+	/*The next document is after the '/' and the padding to a word*/
+	while (Document < End && *Document != '{')
+		Document++;
+	return StoredDocument(Document, DocumentEnd);
+}
+#endif
+
+/*
+ * This function gives the document at the location of a slot. Returns 0 if there is no such document, then Status is CACHE_FULL if its
+ * block couldn't be decompressed as all the blocks of cache are pinned or NOT_FOUND.
+ */
+static uint8_t* SlotDocument(uint32_t location, uint8_t **DocumentEnd,
+		microcDB_Status *Status) {
+#if MICROCDB_COMPRESSION == 1
+	return CompressedDocument(MICROCDB_START_ADDR + (location >> ORDINAL_BITS),
+			location & ((1 << ORDINAL_BITS) - 1), DocumentEnd, Status);
+#else
+	*Status = NOT_FOUND;
+	return StoredDocument((uint8_t*) DB_START_ADDR + location, DocumentEnd);
+#endif
+}
+
+/*
+ * This function compares the value found in a document with the given value.
+ * Returns: true if same
+ */
+static bool ValueEquals(microcDB_Data *Value, uint8_t *value, uint8_t *ValueEnd) {
+	uint8_t *a = Value->DBStartptr;
+
+	while (a <= Value->DBEndptr && value <= ValueEnd && *a == *value) {
+		a++;
+		value++;
+	}
+	return a > Value->DBEndptr && value > ValueEnd;
+}
+
+/*
+ * This function calculates the step between the pages probed for the hash. It is coprime to the number of pages so all of them are
+ * probed.
+ */
+static uint32_t ProbeStep(uint32_t hash) {
+	uint32_t step = (hash >> 16) % INDEX_PAGES, a, b, r;
+
+	do {
+		step++;
+		a = step;
+		b = INDEX_PAGES;
+		while (b != 0) {
+			r = a % b;
+			a = b;
+			b = r;
+		}
+	} while (a != 1);
+	return step;
+}
+
+/*
+ * This function programs the slot of the document in the first free slot of the pages probed for the hash.
+ * Returns: microcDB_Status STORE_SUCCESS, STORE_FAILED or FLASH_FULL
+ */
+static microcDB_Status AddSlot(uint32_t hash, uint32_t location) {
+	uint8_t SlotBytes[SLOT_SIZE];
+	uint32_t Page = hash % INDEX_PAGES, step = ProbeStep(hash), probes;
+	uint16_t Slot = SLOTS_PER_PAGE;
+
+	for (probes = 0; probes < INDEX_PAGES; probes++) {
+		for (Slot = 0; Slot < SLOTS_PER_PAGE; Slot++) {
+			if (*(uint32_t*) (SlotAddress(Page, Slot) + 4) == EMPTY_WORD)
+				break;
+		}
+		if (Slot < SLOTS_PER_PAGE)
+			break;
+		Page = (Page + step) % INDEX_PAGES;
+	}
+	if (Slot == SLOTS_PER_PAGE) {
+		IndexComplete = false;
+		return FLASH_FULL;
+	}
+
+	SlotBytes[0] = (uint8_t) hash;
+	SlotBytes[1] = (uint8_t) (hash >> 8);
+	SlotBytes[2] = (uint8_t) (hash >> 16);
+	SlotBytes[3] = (uint8_t) (hash >> 24);
+	SlotBytes[4] = (uint8_t) location;
+	SlotBytes[5] = (uint8_t) (location >> 8);
+	SlotBytes[6] = (uint8_t) (location >> 16);
+	SlotBytes[7] = (uint8_t) (location >> 24);
+	if (WriteBytesToFLASH(SlotBytes, (uint32_t) SlotAddress(Page, Slot),
+	SLOT_SIZE) != FL_STORE_SUCCESS) {
+		return STORE_FAILED;
+	}
+	UsedSlots++;
+	return STORE_SUCCESS;
+}
+
+/*
+ * This function gives the result of the lookup from the found document. A compressed block is pinned in the cache till the result is
+ * given to MicrocDB_Release().
+ */
+static microcDB_Data FoundDocument(uint8_t *Document, uint8_t *BlockEnd,
+		uint8_t *query) {
+	microcDB_Data data_out_struct;
+
+	if (query == 0) {
+		data_out_struct.DBstatus = FOUND_SUCCESS;
+		data_out_struct.JSON_type = JSON_OBJ;
+		data_out_struct.DBStartptr = Document;
+		data_out_struct.DBEndptr = SkipJSONValue(Document, BlockEnd);
+	} else {
+		data_out_struct = FindInDocument(query, Document, BlockEnd);
+	}
+#if MICROCDB_COMPRESSION == 1
+	CompressedPin(&data_out_struct);
+#else
+	SLACK_COMPACT(&data_out_struct); /*Same as MicrocDB_Find()*/
+#endif
+	return data_out_struct;
+}
+
+/*
+ * This function searches the value in all the documents. It is used when the index had a stale slot or is not complete so the document
+ * may not be in the index. The slot of found document is added so the next lookup finds it using the index.
+ * Returns: microcDB_Data same as MicrocDB_IndexFind()
+ */
+static microcDB_Data ScanDocuments(uint8_t *value, uint8_t *ValueEnd,
+		uint32_t hash, uint8_t *query) {
+	microcDB_Data data_out_struct, Value;
+	uint8_t *Document, *BlockEnd;
+#if MICROCDB_COMPRESSION == 1
+	microcDB_Status status;
+	uint32_t BlockAddress;
+	uint16_t Ordinal;
+#endif
+
+	data_out_struct.DBstatus = NOT_FOUND;
+	data_out_struct.JSON_type = JSON_UNDEFINED;
+	data_out_struct.DBStartptr = 0;
+	data_out_struct.DBEndptr = 0;
+
+#if MICROCDB_COMPRESSION == 1
+	for (BlockAddress = MICROCDB_START_ADDR; BlockAddress < FlashAddresscntr;
+			BlockAddress = CompressedNextBlock(BlockAddress)) {
+		Ordinal = 0;
+		Document = CompressedDocument(BlockAddress, 0, &BlockEnd, &status);
+		if (status == CACHE_FULL) {
+			data_out_struct.DBstatus = CACHE_FULL;
+			return data_out_struct;
+		}
+		while (Document != 0) {
+			if (DocumentValue(Document, BlockEnd, &Value)
+					&& ValueEquals(&Value, value, ValueEnd)) {
+				AddSlot(hash,
+						((BlockAddress - MICROCDB_START_ADDR) << ORDINAL_BITS)
+								| Ordinal);
+				return FoundDocument(Document, BlockEnd, query);
+			}
+			Ordinal++;
+			Document = NextDocument(Document, BlockEnd);
+		}
+	}
+#else
+	for (Document = StoredDocument((uint8_t*) DB_START_ADDR, &BlockEnd);
+			Document != 0; Document = NextStoredDocument(&BlockEnd)) {
+		if (DocumentValue(Document, BlockEnd, &Value)
+				&& ValueEquals(&Value, value, ValueEnd)) {
+			AddSlot(hash, Document - (uint8_t*) DB_START_ADDR);
+			return FoundDocument(Document, BlockEnd, query);
+		}
+	}
+#endif
+	return data_out_struct;
+}
+
+#if MICROCDB_COMPRESSION == 0
+/*
+ * This function checks if the probe sequence of the hash has the slot of the location.
+ * Returns: true if it has
+ */
+static bool HasSlot(uint32_t hash, uint32_t location) {
+	uint8_t *SlotBytes;
+	uint32_t Page = hash % INDEX_PAGES, step = ProbeStep(hash), probes;
+	uint16_t Slot;
+
+	for (probes = 0; probes < INDEX_PAGES; probes++) {
+		for (Slot = 0; Slot < SLOTS_PER_PAGE; Slot++) {
+			SlotBytes = SlotAddress(Page, Slot);
+			if (*(uint32_t*) (SlotBytes + 4) == EMPTY_WORD) {
+				return false; /*The probing ends at a free slot*/
+			}
+			if (*(uint32_t*) SlotBytes == hash
+					&& *(uint32_t*) (SlotBytes + 4) == location) {
+				return true;
+			}
+		}
+		Page = (Page + step) % INDEX_PAGES;
+	}
+	return false;
+}
+#endif
+
+/*MISC functions*/
+
+/**************************************************************************************************************************************/
+/*MicrocDB hash index functions*/
+
+void HashIndexInit() {
+	uint32_t Page;
+	uint16_t Slot;
+
+	UsedSlots = 0;
+	for (Page = 0; Page < INDEX_PAGES; Page++) {
+		for (Slot = 0; Slot < SLOTS_PER_PAGE; Slot++) {
+			if (*(uint32_t*) (SlotAddress(Page, Slot) + 4) == EMPTY_WORD)
+				break; /*Slots of a page are used in order*/
+			UsedSlots++;
+		}
+	}
+	/*A document may have been left out when all the slots were used*/
+	IndexComplete = UsedSlots < (uint32_t) INDEX_PAGES * SLOTS_PER_PAGE;
+}
+
+flash_mem_Stat HashIndexErase() {
+	uint32_t Page;
+
+	for (Page = 0; Page < INDEX_PAGES; Page++) {
+		if (ErasePage(SlotAddress(Page, 0)) != ERASE_SUCCESS) {
+			return ERASE_FAILED;
+		}
+	}
+	UsedSlots = 0;
+	IndexComplete = true;
+	return ERASE_SUCCESS;
+}
+
+#if MICROCDB_COMPRESSION == 1
+bool HashIndexHasRoom(uint8_t *Data, uint16_t Length) {
+	uint8_t *Document = (*Data == '{') ? Data : 0;
+	microcDB_Data Value;
+	uint32_t needed = 0;
+
+	while (Document != 0) {
+		if (DocumentValue(Document, Data + Length, &Value))
+			needed++;
+		Document = NextDocument(Document, Data + Length);
+	}
+	return UsedSlots + needed <= (uint32_t) INDEX_PAGES * SLOTS_PER_PAGE;
+}
+
+microcDB_Status HashIndexAddBlock(uint8_t *Data, uint16_t Length,
+		uint32_t BlockAddress) {
+	uint8_t *Document = (*Data == '{') ? Data : 0;
+	microcDB_Data Value;
+	microcDB_Status status;
+	uint16_t Ordinal = 0;
+
+	while (Document != 0) {
+		if (DocumentValue(Document, Data + Length, &Value)) {
+			status = AddSlot(ValueHash(Value.DBStartptr, Value.DBEndptr),
+					((BlockAddress - MICROCDB_START_ADDR) << ORDINAL_BITS)
+							| Ordinal);
+			if (status != STORE_SUCCESS) {
+				return status;
+			}
+		}
+		Ordinal++;
+		Document = NextDocument(Document, Data + Length);
+	}
+	return STORE_SUCCESS;
+}
+#else
+void HashIndexAppend(uint8_t *Start) {
+	microcDB_Data Value;
+	uint8_t *Document, *DocumentEnd;
+
+	for (Document = StoredDocument(Start, &DocumentEnd); Document != 0;
+			Document = NextStoredDocument(&DocumentEnd)) {
+		if (DocumentValue(Document, DocumentEnd, &Value)) {
+			AddSlot(ValueHash(Value.DBStartptr, Value.DBEndptr),
+					Document - (uint8_t*) DB_START_ADDR); /*The lookups scan DB if it didn't fit*/
+		}
+	}
+}
+
+void HashIndexUpdated(uint8_t *path) {
+	microcDB_Data Value;
+	uint8_t *Indexed = (uint8_t*) MICROCDB_HASH_INDEX_PATH, *part = path;
+	uint8_t *Document, *DocumentEnd;
+	uint32_t hash, location;
+
+	/*Only the update of the indexed value, of an object having it or of a value in it changes the indexed value*/
+	while (*part == *Indexed && *part != '/') {
+		part++;
+		Indexed++;
+	}
+	if (*part != '/' && *Indexed != '/') {
+		return;
+	}
+
+	/*The updated document is the first having the path same as found by MicrocDB_Find()*/
+	for (Document = StoredDocument((uint8_t*) DB_START_ADDR, &DocumentEnd);
+			Document != 0; Document = NextStoredDocument(&DocumentEnd)) {
+		if (FindInDocument(path, Document, DocumentEnd).DBstatus
+				== FOUND_SUCCESS) {
+			break;
+		}
+	}
+	if (Document == 0 || !DocumentValue(Document, DocumentEnd, &Value)) {
+		return;
+	}
+
+	/*The slot of its old value is stale now and is dropped by the lookup which meets it*/
+	hash = ValueHash(Value.DBStartptr, Value.DBEndptr);
+	location = Document - (uint8_t*) DB_START_ADDR;
+	if (!HasSlot(hash, location)) {
+		AddSlot(hash, location);
+	}
+}
+
+void HashIndexShift(uint8_t *Cut, int32_t Delta) {
+	uint8_t Dropped[SLOT_SIZE] = { 0 }, *SlotBytes;
+	uint32_t CutOffset = Cut - (uint8_t*) DB_START_ADDR, Page, location;
+	uint16_t Used[INDEX_PAGES], Slot;
+
+	if (Delta == 0) {
+		return;
+	}
+	/*The slots added for the moved documents are after the slots used now, so they are not moved again*/
+	for (Page = 0; Page < INDEX_PAGES; Page++) {
+		for (Slot = 0; Slot < SLOTS_PER_PAGE; Slot++) {
+			if (*(uint32_t*) (SlotAddress(Page, Slot) + 4) == EMPTY_WORD)
+				break;
+		}
+		Used[Page] = Slot;
+	}
+
+	for (Page = 0; Page < INDEX_PAGES; Page++) {
+		for (Slot = 0; Slot < Used[Page]; Slot++) {
+			SlotBytes = SlotAddress(Page, Slot);
+			location = *(uint32_t*) (SlotBytes + 4);
+			if (location <= CutOffset) {
+				continue; /*Not moved, or dropped which has the location 0*/
+			}
+			/*The new slot is added first so the document stays in the index if power is lost before the old one is dropped. The
+			 * old one is stale then and is dropped by the lookup*/
+			AddSlot(*(uint32_t*) SlotBytes, location + Delta);
+			WriteBytesToFLASH(Dropped, (uint32_t) SlotBytes, SLOT_SIZE);
+		}
+	}
+}
+
+microcDB_Status HashIndexRebuild() {
+	if (HashIndexErase() != ERASE_SUCCESS) {
+		return STORE_FAILED;
+	}
+	HashIndexAppend((uint8_t*) DB_START_ADDR);
+	return STORE_SUCCESS;
+}
+#endif
+
+microcDB_Data MicrocDB_IndexFind(uint8_t *value, uint8_t *query) {
+	microcDB_Data data_out_struct, Value;
+	microcDB_Status status;
+	uint8_t *ValueEnd = value + CalculateStringLength(value) - 1;
+	uint8_t *Document, *BlockEnd, *SlotBytes;
+	uint8_t Dropped[SLOT_SIZE] = { 0 };
+	uint32_t hash, location, Page, step, probes;
+	uint16_t Slot;
+	bool Stale = false;
+
+	STATS_BEGIN(STATS_OP_FIND);
+	DEVICES_SYNC();
+
+	data_out_struct.DBstatus = NOT_FOUND;
+	data_out_struct.JSON_type = JSON_UNDEFINED;
+	data_out_struct.DBStartptr = 0;
+	data_out_struct.DBEndptr = 0;
+	if (UPDATE_JOB_PENDING()) {
+		data_out_struct.DBstatus = UPDATE_PENDING; /*The documents and their slots are partly shifted by the job*/
+		return data_out_struct;
+	}
+
+	hash = ValueHash(value, ValueEnd);
+	Page = hash % INDEX_PAGES;
+	step = ProbeStep(hash);
+
+	for (probes = 0; probes < INDEX_PAGES; probes++) {
+		for (Slot = 0; Slot < SLOTS_PER_PAGE; Slot++) {
+			SlotBytes = SlotAddress(Page, Slot);
+			location = *(uint32_t*) (SlotBytes + 4);
+			if (location == EMPTY_WORD) {
+				break;
+			}
+			if (*(uint32_t*) SlotBytes != hash
+					|| (hash == DROPPED_WORD && location == DROPPED_WORD)) {
+				continue;
+			}
+
+			Document = SlotDocument(location, &BlockEnd, &status);
+			if (status == CACHE_FULL) {
+				data_out_struct.DBstatus = CACHE_FULL;
+				return data_out_struct;
+			}
+
+			/*The slot is stale if its document doesn't have a value of its hash anymore, like after the DB was written other than by
+			 * inserting. Different values can have same hash so the value is compared too*/
+			if (Document == 0 || !DocumentValue(Document, BlockEnd, &Value)
+					|| ValueHash(Value.DBStartptr, Value.DBEndptr) != hash) {
+				WriteBytesToFLASH(Dropped, (uint32_t) SlotBytes, SLOT_SIZE);
+				Stale = true;
+				continue;
+			}
+			if (ValueEquals(&Value, value, ValueEnd)) {
+				return FoundDocument(Document, BlockEnd, query);
+			}
+		}
+		if (Slot < SLOTS_PER_PAGE) {
+			break; /*The probing ends at a free slot*/
+		}
+		Page = (Page + step) % INDEX_PAGES;
+	}
+
+	/*The document of the stale slot, or one left out of the full index, may not be in the index*/
+	if (Stale || !IndexComplete) {
+		return ScanDocuments(value, ValueEnd, hash, query);
+	}
+	return data_out_struct;
+}
+
+/*MicrocDB hash index functions*/
+#endif
@@ -3,19 +3,20 @@
  */
 
 #include "microcDB_jsonparser.h"
+#include <microcDB_internal.h>
 
-int levelCounter = 0; /*This will indicate the deepness of the JSON document currently parser is. The 0 will indicate that the parser is at
+MICROCDB_THREAD_LOCAL int levelCounter = 0; /*This will indicate the deepness of the JSON document currently parser is. The 0 will indicate that the parser is at
  at root of the JSON document. It will increment on each occurrence of the JSON object or ArrayList and will decrement
  after detecting the closing brace or bracket of each object or arrayList respectively*/
 
-int inlevelcntr = 0;
+MICROCDB_THREAD_LOCAL int inlevelcntr = 0;
 
-uint8_t firstTime = 0;
+MICROCDB_THREAD_LOCAL uint8_t firstTime = 0;
 
-microcDB_json_parser jsonParser;
-uint8_t *microcDBStartAddr, *inStartAddr;
-uint8_t *microcDBEndAddr,*inEndAddr;
-uint8_t *memptr, *inptr;
+MICROCDB_THREAD_LOCAL microcDB_json_parser jsonParser;
+MICROCDB_THREAD_LOCAL uint8_t *microcDBStartAddr, *inStartAddr;
+MICROCDB_THREAD_LOCAL uint8_t *microcDBEndAddr,*inEndAddr;
+MICROCDB_THREAD_LOCAL uint8_t *memptr, *inptr;
 
 void json_parser_init() {
 	levelCounter = -1; /*while init the levelCounter would indicate the level of parsing below the whole JSON object which is -1*/
@@ -29,6 +30,9 @@ void json_parser_init() {
 
 microcDB_json_parser json_parse() {
 	uint8_t data;
+#if MICROCDB_STATS == 1
+	uint8_t *StatsStart = memptr; /*To count the bytes examined in this step*/
+#endif
 	if (memptr < microcDBEndAddr) {
 		data = *memptr;
 
@@ -42,7 +46,8 @@ microcDB_json_parser json_parse() {
 				jsonParser.Start = memptr;
 				memptr++;
 
-				while (*memptr != '/') {
+				/*The document ends at '/' or at the end address given for it*/
+				while (*memptr != '/' && memptr < microcDBEndAddr) {
 					if (*memptr == '{' || *memptr == '[')
 						levelCounter++; /*increment the levelCounter on occurrence of Object. The more the value of levelCounter the more the deep
 						 in json tree we are. Its 0 value indicates we are at root*/
@@ -51,6 +56,8 @@ microcDB_json_parser json_parse() {
 					memptr++;
 				};
 				microcDBEndAddr = memptr - 1;
+				STATS_ADD(ParserBytes, memptr - jsonParser.Start);
+				STATS_ADD(BracketRescans, 1);
 
 				memptr--;
 
@@ -85,6 +92,8 @@ microcDB_json_parser json_parse() {
 					memptr++;
 				};
 
+				STATS_ADD(ParserBytes, memptr - jsonParser.Start);
+				STATS_ADD(BracketRescans, 1);
 				jsonParser.parsed_type = JSON_OBJ;
 				jsonParser.End = memptr - 1;
 				inStartAddr = jsonParser.Start;
@@ -123,6 +132,8 @@ microcDB_json_parser json_parse() {
 			}
 			;
 
+			STATS_ADD(ParserBytes, memptr - jsonParser.Start);
+			STATS_ADD(BracketRescans, 1);
 			jsonParser.End = memptr - 1;/*Assign the end of array list*/
 			memptr = inptr;/*Reinitialize the memptr to the starting address data in arrayList So that data in that can be seen in next loop*/
 			inStartAddr = jsonParser.Start;
@@ -136,7 +147,7 @@ microcDB_json_parser json_parse() {
 			jsonParser.Start = memptr; /*Assign the address of the first char of string*/
 
 			/*Increment the memptr till next \" . It will indicate till here the string has ended*/
-			while (*memptr != '\"') {
+			while (*memptr != '\"' && memptr < microcDBEndAddr) { /*The string being written by the writer task may not be closed yet*/
 				memptr++;
 			}
 			;
@@ -147,14 +158,14 @@ microcDB_json_parser json_parse() {
 
 			if (*memptr == ':' || *memptr == ',' || *memptr == ']'
 					|| *memptr == '}') {
-				while (*memptr != '\"') {
+				while (*memptr != '\"' && memptr < microcDBEndAddr) { /*Don't skip beyond the end of the JSON being parsed*/
 					if (*memptr != 'f' && *memptr != 't' && *memptr != '1'
 							&& *memptr != '2' && *memptr != '3'
 							&& *memptr != '4' && *memptr != '5'
 							&& *memptr != '6' && *memptr != '7'
 							&& *memptr != '8' && *memptr != '9'
-							&& *memptr != '0' && *memptr != '['
-							&& *memptr != '{') {
+							&& *memptr != '0' && *memptr != '-'
+							&& *memptr != '[' && *memptr != '{') {
 						memptr++;
 					} else
 						break;
@@ -189,7 +200,8 @@ microcDB_json_parser json_parse() {
 
 			break;
 
-			/*If numeric chars*/
+			/*If numeric chars or sign of negative number*/
+		case '-':
 		case '0':
 		case '1':
 		case '2':
@@ -221,6 +233,12 @@ microcDB_json_parser json_parse() {
 				memptr++;
 			} else
 				jsonParser.End = memptr - 1;
+#if MICROCDB_OBJECT_SLACK > 0
+			/*The empty bytes before the comma are the slack of object*/
+			while (*jsonParser.End == (uint8_t) FL_EMPTY_BYTE
+					&& jsonParser.End > jsonParser.Start)
+				jsonParser.End--;
+#endif
 
 			memptr++;
 
@@ -244,12 +262,34 @@ microcDB_json_parser json_parse() {
 
 			break;
 
+#if MICROCDB_OBJECT_SLACK > 0
+		case (uint8_t) FL_EMPTY_BYTE: /*The slack reserved in objects is skipped*/
+			memptr++;
+			jsonParser.parsed_type = JSON_UNDEFINED;
+
+			break;
+#endif
+
+#if MICROCDB_RELOCATION == 1
+		case 0x00: /*The forwarding marker of relocated object is skipped as its new copy is searched instead*/
+			memptr = memptr + RELOCATION_MARKER_SIZE;
+			jsonParser.parsed_type = JSON_UNDEFINED;
+
+			break;
+#endif
+
 		default:
+			/*Any other byte is skipped, so the parser ends even on the bytes being written by the writer task of MICROCDB_SEQLOCK*/
+			memptr++;
 			jsonParser.parsed_type = JSON_UNDEFINED;
 
-			
 		};
 
+#if MICROCDB_STATS == 1
+		/*The bytes walked forward in this step. The scan of object or array list for matching brace or bracket is counted above*/
+		if (memptr > StatsStart)
+			STATS_ADD(ParserBytes, memptr - StatsStart);
+#endif
 	} else {
 		jsonParser.parsed_type = JSON_END;
 		jsonParser.Start = memptr - 1;
@@ -0,0 +1,260 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The RAM hash index of the top level keys of the root object of microcDB. It maps the hash of every top level key to
+ *      its key and value in flash so MicrocDB_Find() starts the search at the subtree of the first part of query instead of the start
+ *      of DB. The table uses open addressing with linear probing. It is built in one pass over the top level members of all the
+ *      documents by MicrocDB_Init(), on selecting a collection and after the DB is restored. The writes only change the entries they
+ *      affect: the inserted documents are added and an update moves the entries of the members after the updated one.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_KEY_INDEX_SIZE > 0
+
+typedef struct {
+	uint32_t Hash;
+	uint8_t *Key; /*First char of the key in flash, 0 if this slot is empty*/
+	uint8_t *Value; /*First byte of the value*/
+	uint8_t *ValueEnd; /*Last byte of the value*/
+	uint8_t *DocumentEnd; /*The '}' of the document having the key*/
+} index_Slot;
+
+static index_Slot KeyIndex[MICROCDB_KEY_INDEX_SIZE];
+static bool KeyIndexComplete = false; /*false if some key didn't fit in the table, then the keys not in table may still be stored*/
+
+/*MISC functions*/
+
+/*
+ * This function calculates the FNV-1a hash of the Length chars of the key.
+ */
+static uint32_t KeyHash(uint8_t *Key, size_t Length) {
+	uint32_t hash = 2166136261UL;
+	while (Length--) {
+		hash = (hash ^ *Key) * 16777619UL;
+		Key++;
+	}
+	return hash;
+}
+
+/*
+ * This function compares the key stored in flash which ends with '"' with the key of given length.
+ * Returns: true if same
+ */
+static bool KeyEquals(uint8_t *StoredKey, uint8_t *Key, size_t Length) {
+	while (Length != 0) {
+		if (*StoredKey != *Key)
+			return false;
+		StoredKey++;
+		Key++;
+		Length--;
+	}
+	return *StoredKey == '\"';
+}
+
+/*
+ * This function returns the slot of the key or the empty slot where it should be added. If the table is full and the key is not
+ * in it then 0 is returned.
+ */
+static index_Slot* KeyIndexSlot(uint8_t *Key, size_t Length, uint32_t hash) {
+	uint16_t slot = hash % MICROCDB_KEY_INDEX_SIZE, probes;
+
+	for (probes = 0; probes < MICROCDB_KEY_INDEX_SIZE; probes++) {
+		if (KeyIndex[slot].Key == 0
+				|| (KeyIndex[slot].Hash == hash
+						&& KeyEquals(KeyIndex[slot].Key, Key, Length)))
+			return &KeyIndex[slot];
+		slot++;
+		if (slot == MICROCDB_KEY_INDEX_SIZE)
+			slot = 0;
+	}
+	return 0;
+}
+
+/*
+ * This function adds the members of the document from its '{' to its '}' at End. If a key is repeated then the first one is kept as
+ * MicrocDB_Find() gives the first one.
+ */
+static void IndexDocument(uint8_t *ptr, uint8_t *End) {
+	uint8_t *Key, *Value;
+	index_Slot *slot;
+	uint32_t hash;
+
+	STATS_ADD(ParserBytes, End - ptr + 1);
+	ptr = SkipSlack(ptr + 1, End);
+	while (ptr < End && *ptr == '\"') {
+		Key = ptr + 1;
+		ptr = SkipJSONValue(ptr, End);
+		Value = ptr + 2; /*Skip the ending quote and ':'*/
+
+		hash = KeyHash(Key, ptr - Key);
+		slot = KeyIndexSlot(Key, ptr - Key, hash);
+
+		ptr = SkipJSONValue(Value, End);
+		if (slot == 0) {
+			KeyIndexComplete = false;
+		} else if (slot->Key == 0) {
+			slot->Hash = hash;
+			slot->Key = Key;
+			slot->Value = Value;
+			slot->ValueEnd = ptr;
+			slot->DocumentEnd = End;
+		}
+
+		ptr = SkipSlack(ptr + 1, End);
+		if (*ptr == ',')
+			ptr++;
+	}
+}
+
+/*
+ * This function moves the entries of the keys after Cut by Delta bytes as the bytes after it were shifted, and the end of the value
+ * having Cut. If DocumentEnd is not 0 then only the bytes till it were shifted, in the slack of the document.
+ */
+static void ShiftEntries(uint8_t *Cut, int32_t Delta, uint8_t *DocumentEnd) {
+	index_Slot *slot;
+	uint16_t i;
+
+	for (i = 0; i < MICROCDB_KEY_INDEX_SIZE; i++) {
+		slot = &KeyIndex[i];
+		if (slot->Key == 0
+				|| (DocumentEnd != 0 && slot->DocumentEnd != DocumentEnd)) {
+			continue;
+		}
+		if (slot->Key > Cut) {
+			slot->Key = slot->Key + Delta;
+			slot->Value = slot->Value + Delta;
+			slot->ValueEnd = slot->ValueEnd + Delta;
+		} else if (slot->ValueEnd >= Cut) {
+			slot->ValueEnd = slot->ValueEnd + Delta;
+		}
+		if (DocumentEnd == 0 && slot->DocumentEnd >= Cut) {
+			slot->DocumentEnd = slot->DocumentEnd + Delta;
+		}
+	}
+}
+
+/*MISC functions*/
+
+/**************************************************************************************************************************************/
+/*MicrocDB key index functions*/
+
+void KeyIndexBuild() {
+	uint16_t i;
+
+	for (i = 0; i < MICROCDB_KEY_INDEX_SIZE; i++) {
+		KeyIndex[i].Key = 0;
+	}
+	KeyIndexComplete = true;
+	KeyIndexAppend((uint8_t*) DB_START_ADDR);
+}
+
+void KeyIndexAppend(uint8_t *Start) {
+	uint8_t *End = (uint8_t*) FlashAddresscntr, *DocumentEnd;
+
+	while (Start < End && *Start == '{') {
+		DocumentEnd = SkipJSONValue(Start, End);
+		IndexDocument(Start, DocumentEnd);
+		Start = DocumentEnd + 1;
+
+		/*The next document is after the '/' and the padding to a word*/
+		while (Start < End && *Start != '{')
+			Start++;
+	}
+}
+
+void KeyIndexUpdated(uint8_t *path) {
+	index_Slot *slot;
+	uint8_t *ValueEnd;
+	size_t Length = 0;
+
+	while (path[Length] != '.' && path[Length] != '/')
+		Length++;
+	slot = KeyIndexSlot(path, Length, KeyHash(path, Length));
+	if (slot == 0 || slot->Key == 0) {
+		/*The updated key didn't fit in the table so the keys after it are not known*/
+		if (!KeyIndexComplete)
+			KeyIndexBuild();
+		return;
+	}
+
+	/*The value begins at the same address after the update so its length tells how much the members after it were shifted. A
+	 * relocated object keeps its old bytes with the forwarding marker so nothing is shifted*/
+	ValueEnd = SkipJSONValue(slot->Value, (uint8_t*) DB_END_ADDR);
+	if (ValueEnd != slot->ValueEnd) {
+#if MICROCDB_OBJECT_SLACK > 0
+		ShiftEntries(slot->Value, ValueEnd - slot->ValueEnd, slot->DocumentEnd);
+#else
+		ShiftEntries(slot->Value, ValueEnd - slot->ValueEnd, 0);
+#endif
+	}
+}
+
+void KeyIndexShift(uint8_t *Cut, int32_t Delta) {
+	ShiftEntries(Cut, Delta, 0);
+}
+
+/*
+ * This function searches the query using the index. The first part of query is looked up in the index and the rest of query is searched
+ * only in its value. If the first part is not in the index and the index has all the keys then nothing is searched.
+ * Returns: microcDB_Data same as MicrocDB_Find()
+ */
+microcDB_Data KeyIndexFind(uint8_t *query) {
+	microcDB_Data data_out_struct;
+	index_Slot *slot;
+	uint8_t *Value, *ValueEnd;
+	size_t Length = 0;
+
+	data_out_struct.DBstatus = NOT_FOUND;
+	data_out_struct.JSON_type = JSON_UNDEFINED;
+	data_out_struct.DBStartptr = 0;
+	data_out_struct.DBEndptr = 0;
+
+	while (query[Length] != '.' && query[Length] != '/')
+		Length++;
+
+	slot = KeyIndexSlot(query, Length, KeyHash(query, Length));
+	if (slot == 0 || slot->Key == 0) {
+		if (KeyIndexComplete)
+			return data_out_struct;
+		/*The key may be one which didn't fit in the table*/
+		return FindInDocument(query, (uint8_t*) DB_START_ADDR,
+				(uint8_t*) DB_END_ADDR);
+	}
+
+	/*Only the top level key is queried*/
+	if (query[Length] == '/' || query[Length + 1] == '/') {
+		ValueToData(slot->Value, slot->ValueEnd, &data_out_struct);
+		return data_out_struct;
+	}
+
+	if (*slot->Value != '{') {
+		return data_out_struct; /*Rest of query can't be in a value which is not object*/
+	}
+	Value = slot->Value;
+	ValueEnd = slot->ValueEnd;
+#if MICROCDB_RELOCATION == 1
+	RelocationFollow(&Value, &ValueEnd); /*The object may have been relocated*/
+#endif
+
+	/*Search the rest of query only in the value*/
+	data_out_struct = FindInDocument(query + Length + 1, Value, ValueEnd + 1);
+	if (data_out_struct.DBstatus == FOUND_SUCCESS) {
+		if (data_out_struct.DBStartptr > ValueEnd) {
+			/*The object relocated inside the value is in its own copy which is found completely*/
+			if (!RELOCATED(data_out_struct.DBStartptr)) {
+				data_out_struct.DBstatus = NOT_FOUND;
+				data_out_struct.JSON_type = JSON_UNDEFINED;
+			}
+		} else if ((data_out_struct.JSON_type == JSON_PRIMITIVE
+				|| data_out_struct.JSON_type == JSON_BOOL)
+				&& data_out_struct.DBStartptr >= Value) {
+			/*The parser finds the end of last number of the object using the end of the whole document so get it again*/
+			data_out_struct.DBEndptr = SkipJSONValue(data_out_struct.DBStartptr,
+					ValueEnd);
+		}
+	}
+	return data_out_struct;
+}
+
+/*MicrocDB key index functions*/
+#endif
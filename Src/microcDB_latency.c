@@ -0,0 +1,100 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The latency histograms of microcDB. Every operation has a histogram of log2 buckets of the ticks of
+ *      MICROCDB_LATENCY_CLOCK() so the memory used is fixed and recording is few instructions.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_LATENCY == 1
+
+static uint32_t LatencyBuckets[LATENCY_OP_COUNT][MICROCDB_LATENCY_BUCKETS];
+static uint32_t LatencyCount[LATENCY_OP_COUNT];
+static uint32_t LatencyMax[LATENCY_OP_COUNT];
+
+/*MISC functions*/
+
+/*
+ * This function gives the bucket of the latency which is the number of bits needed for it.
+ */
+static inline uint8_t LatencyBucket(uint32_t Ticks) {
+	uint8_t bucket = 0;
+	while (Ticks != 0 && bucket < MICROCDB_LATENCY_BUCKETS - 1) {
+		Ticks = Ticks >> 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+/*
+ * This function gives the latency below or at which the given percent of latencies of the operation lie. It is the upper limit of the
+ * bucket where the percentile lies, limited by the maximum latency.
+ */
+static uint32_t LatencyPercentile(microcDB_LatencyOp Op, uint8_t Percent) {
+	uint32_t rank, seen = 0, limit;
+	uint8_t bucket;
+
+	if (LatencyCount[Op] == 0) {
+		return 0;
+	}
+
+	/*The rank of the percentile, rounded up so that p99 of few samples is the largest one*/
+	rank = (uint32_t) (((uint64_t) LatencyCount[Op] * Percent + 99) / 100);
+
+	for (bucket = 0; bucket < MICROCDB_LATENCY_BUCKETS; bucket++) {
+		seen += LatencyBuckets[Op][bucket];
+		if (seen >= rank)
+			break;
+	}
+
+	if (bucket == 0)
+		return 0;
+	if (bucket >= MICROCDB_LATENCY_BUCKETS - 1)
+		return LatencyMax[Op]; /*The last bucket has no upper limit*/
+	limit = (uint32_t) ((1ULL << bucket) - 1);
+	return limit < LatencyMax[Op] ? limit : LatencyMax[Op];
+}
+
+/*MISC functions*/
+
+/*
+ * This function adds the latency to the histogram of the operation. It is used by the LATENCY_END macro.
+ */
+void LatencyRecord(microcDB_LatencyOp Op, uint32_t Ticks) {
+	LatencyBuckets[Op][LatencyBucket(Ticks)]++;
+	LatencyCount[Op]++;
+	if (Ticks > LatencyMax[Op])
+		LatencyMax[Op] = Ticks;
+}
+
+/**************************************************************************************************************************************/
+/*MicrocDB latency functions*/
+
+void MicrocDB_GetLatency(microcDB_LatencyOp Op, microcDB_Latency *Latency) {
+	uint8_t bucket;
+
+	if (Op >= LATENCY_OP_COUNT) {
+		return;
+	}
+
+	Latency->Count = LatencyCount[Op];
+	Latency->P50 = LatencyPercentile(Op, 50);
+	Latency->P99 = LatencyPercentile(Op, 99);
+	Latency->Max = LatencyMax[Op];
+	for (bucket = 0; bucket < MICROCDB_LATENCY_BUCKETS; bucket++)
+		Latency->Buckets[bucket] = LatencyBuckets[Op][bucket];
+}
+
+void MicrocDB_ResetLatency() {
+	uint8_t op, bucket;
+
+	for (op = 0; op < LATENCY_OP_COUNT; op++) {
+		for (bucket = 0; bucket < MICROCDB_LATENCY_BUCKETS; bucket++)
+			LatencyBuckets[op][bucket] = 0;
+		LatencyCount[op] = 0;
+		LatencyMax[op] = 0;
+	}
+}
+
+/*MicrocDB latency functions*/
+#endif
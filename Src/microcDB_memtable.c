@@ -0,0 +1,976 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The memtable of microcDB. The inserts and updates are buffered in RAM and applied to DB together when the buffer or
+ *      			 its journal is full or MicrocDB_Sync() is called. Every buffered write is also appended to the journal in flash, which
+ *      			 is only programmed sequentially, so the writes not applied when power is lost are applied by MicrocDB_Init(). An
+ *      			 update of a value which is buffered replaces the buffered one, so only the last value of a path is written to DB.
+ *
+ *      			 MicrocDB_Find() doesn't apply the buffered writes. The value found in DB is copied to RAM with the buffered values in
+ *      			 it, and the value of a buffered path is given from RAM.
+ *
+ *      			 The buffered writes are sorted by the address of the value they replace and applied as a sorted run. The inserted
+ *      			 documents are written first one after other at the end of DB, then the values whose length is not changed are written
+ *      			 in place with one rewrite of every page having them in the order of pages, and the rest are updated from the highest
+ *      			 address so the values found before at lower addresses are not moved.
+ *
+ *      			 Layout of a record of journal:
+ *      			 |Size(2 bytes)|Applied(2 bytes)|Type(1 byte)|Target(1 byte)|Count(2 bytes)|Path length(2 bytes)|Value length(2 bytes)|
+ *      			 |Path|Value|Padding to half word|Size(2 bytes)|
+ *      			 The Applied is programmed when the write is replaced by a later one. The size after the record is used to check that the
+ *      			 record was completely written, a record which was not is skipped by the size before it.
+ *
+ *      			 Every page of DB is saved to the undo log before it is first changed by applying the writes, so the writes whose applying
+ *      			 was interrupted by a power loss are rolled back by MicrocDB_Init() and applied again once.
+ *      			 Layout of the undo log:
+ *      			 |Header page: Commit(2 bytes)|Number of the page of DB in slot 1(2 bytes)|...|Slot 1(1 page)|Slot 2(1 page)|...|
+ *      			 The number is written after the page is copied to its slot. The Commit is programmed when the writes are applied, then
+ *      			 the journal and the undo log are erased.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_MEMTABLE_BYTES > 0
+
+#define ENTRY_INSERT 1 /*The documents to be inserted*/
+#define ENTRY_REPLACE 2 /*The value which replaces the value at path*/
+#define ENTRY_ADD 3 /*The member added to the object at path*/
+
+#define ENTRY_PENDING 0
+#define ENTRY_IN_PLACE 1 /*The value has the length of the old value so it is written in its page*/
+#define ENTRY_SHIFT 2 /*The value is updated by UpdateValue()*/
+#define ENTRY_DONE 3
+
+#define LOG_APPLIED_OFFSET 2
+#define LOG_TYPE_OFFSET 4
+#define LOG_TARGET_OFFSET 5
+#define LOG_COUNT_OFFSET 6
+#define LOG_PATH_LENGTH_OFFSET 8
+#define LOG_VALUE_LENGTH_OFFSET 10
+#define LOG_HEADER_SIZE 12
+#define EMPTY_HALFWORD ((uint16_t)(((uint8_t)FL_EMPTY_BYTE << 8) | (uint8_t)FL_EMPTY_BYTE))
+
+#define WORD sizeof(uintptr_t) /*The entries are aligned to it as they have pointers*/
+#define MAX_ENTRIES (MICROCDB_MEMTABLE_BYTES / sizeof(memtable_Entry) + 1)
+
+#define LOG_START ((uint8_t*) MICROCDB_MEMTABLE_LOG_START_ADDR)
+#define LOG_END ((uint8_t*) MICROCDB_MEMTABLE_LOG_END_ADDR - 1) /*The last half word is not used*/
+
+#define DB_PAGES ((MICROCDB_END_ADDR + 1 - MICROCDB_START_ADDR) / PAGE_SIZE)
+#define UNDO_HEADER ((uint8_t*) MICROCDB_MEMTABLE_UNDO_START_ADDR)
+#define UNDO_SLOT(Slot) (UNDO_HEADER + ((uint32_t) (Slot) * PAGE_SIZE))
+#define UNDO_NUMBER(Slot) (UNDO_HEADER + (2 * (uint32_t) (Slot))) /*The number of the page of DB saved in the slot*/
+
+/*The buffered write. It is followed by the path and value*/
+typedef struct {
+	uint16_t Size; /*The size of entry with its path and value, multiple of WORD so the next entry is aligned*/
+	uint8_t Type;
+	uint8_t State;
+	uint8_t Target; /*The JSON_Type of the value at path when the update was buffered*/
+	uint16_t Count; /*The number of documents to be inserted*/
+	uint16_t PathLength; /*With the '/'*/
+	uint16_t ValueLength; /*With the '/'*/
+	uint8_t *Cut; /*The first byte of DB replaced by the value*/
+	uint8_t *CutEnd; /*The byte after the last byte replaced*/
+	uint8_t *Record; /*The record of journal*/
+} memtable_Entry;
+
+static uintptr_t Memtable[(MICROCDB_MEMTABLE_BYTES + WORD - 1) / WORD]; /*Words so the entries are aligned*/
+static uint16_t MemtableUsed = 0; /*The number of bytes of the entries*/
+static uint8_t *LogAppendAddr = LOG_START; /*The address where next record of journal will be written*/
+static microcDB_Status FlushStatus = UPDATE_SUCCESSFUL; /*The status of the first buffered write which failed since MicrocDB_Sync()*/
+static uint8_t Found[MICROCDB_MEMTABLE_FIND_BYTES]; /*The value given by MicrocDB_Find() if it has buffered writes*/
+static bool Tracking = false; /*The pages of DB are saved to the undo log before they are changed while the writes are applied*/
+static bool UndoFailed = false; /*A page couldn't be saved since the writes were applied*/
+static uint16_t UndoSlots = 0; /*The number of pages saved to the undo log*/
+static uint8_t SavedPages[(DB_PAGES + 7) / 8]; /*The pages of DB saved to the undo log*/
+
+/*MISC functions*/
+
+/*
+ * This function gives the entry at the offset of memtable.
+ */
+static inline memtable_Entry* EntryAt(uint16_t Offset) {
+	return (memtable_Entry*) ((uint8_t*) Memtable + Offset);
+}
+
+/*
+ * This function gives the path of entry. The value is after it.
+ */
+static inline uint8_t* EntryPath(memtable_Entry *Entry) {
+	return (uint8_t*) (Entry + 1);
+}
+
+/*
+ * This function gives the value of entry.
+ */
+static inline uint8_t* EntryValue(memtable_Entry *Entry) {
+	return EntryPath(Entry) + Entry->PathLength;
+}
+
+/*
+ * This function checks if one of the paths is the other or is in the value of other. Both are terminated with '/'.
+ */
+static bool PathsOverlap(uint8_t *A, uint8_t *B) {
+	while (*A == *B && *A != '/') {
+		A++;
+		B++;
+	}
+	return *A == '/' || *B == '/';
+}
+
+/*
+ * This function checks if the paths are same.
+ */
+static bool PathsEqual(uint8_t *A, uint8_t *B) {
+	while (*A == *B && *A != '/') {
+		A++;
+		B++;
+	}
+	return *A == '/' && *B == '/';
+}
+
+/*
+ * This function checks if the path is the Parent path or a path in its value. Both are terminated with '/'.
+ */
+static bool PathIn(uint8_t *path, uint8_t *Parent) {
+	while (*path == *Parent && *Parent != '/') {
+		path++;
+		Parent++;
+	}
+	return *Parent == '/';
+}
+
+/*
+ * This function marks the record of journal replaced so it is not applied by MemtableInit.
+ * Returns: true if marked
+ */
+static inline bool MarkReplaced(uint8_t *Record) {
+	uint8_t Mark[2] = { (uint8_t) ~FL_EMPTY_BYTE, (uint8_t) ~FL_EMPTY_BYTE };
+
+	return WriteBytesToFLASH(Mark, (uint32_t) (Record + LOG_APPLIED_OFFSET), 2)
+			== FL_STORE_SUCCESS;
+}
+
+/*
+ * This function checks if the page is empty.
+ */
+static bool PageEmpty(uint8_t *Page) {
+	uint16_t i;
+
+	for (i = 0; i < PAGE_SIZE; i = i + 2) {
+		if (*(uint16_t*) (Page + i) != EMPTY_HALFWORD) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * This function copies the page of DB to the next slot of undo log. The slot left by a copy which was interrupted is erased first.
+ * Returns: true if saved
+ */
+static bool SavePage(uint16_t PageNumber) {
+	uint8_t *Slot = UNDO_SLOT(UndoSlots + 1);
+	uint8_t Number[2] = { (uint8_t) PageNumber, (uint8_t) (PageNumber >> 8) };
+
+	if ((!PageEmpty(Slot) && ErasePage(Slot) != ERASE_SUCCESS)
+			|| WritePage(
+					(uint32_t*) ((uint8_t*) DB_START_ADDR
+							+ ((uint32_t) PageNumber * PAGE_SIZE)),
+					(uint32_t*) Slot, PAGE_SIZE) != FL_STORE_SUCCESS
+			|| WriteBytesToFLASH(Number, (uint32_t) UNDO_NUMBER(UndoSlots + 1),
+					2) != FL_STORE_SUCCESS) {
+		return false;
+	}
+	UndoSlots++;
+	return true;
+}
+
+/*
+ * This function removes the entry from memtable by moving the entries after it.
+ */
+static void RemoveEntry(uint16_t Offset) {
+	uint16_t Size = EntryAt(Offset)->Size;
+	uint16_t i;
+
+	for (i = Offset / WORD; i < (MemtableUsed - Size) / WORD; i++) {
+		Memtable[i] = Memtable[i + (Size / WORD)];
+	}
+	MemtableUsed = MemtableUsed - Size;
+}
+
+/*
+ * This function checks if the entry fits in memtable and its record fits in journal.
+ */
+static inline bool EntryFits(uint16_t PathLength, uint16_t ValueLength) {
+	uint32_t Size = sizeof(memtable_Entry) + PathLength + ValueLength;
+	uint32_t RecordSize = LOG_HEADER_SIZE + PathLength + ValueLength + 3;
+
+	return Size + WORD - 1 <= sizeof(Memtable)
+			&& RecordSize <= (uint32_t) (LOG_END - LOG_START);
+}
+
+/*
+ * This function adds the entry at the end of memtable. It should fit in the memtable.
+ */
+static memtable_Entry* AddEntry(uint8_t Type, uint8_t Target, uint16_t Count,
+		uint8_t *path, uint16_t PathLength, uint8_t *value,
+		uint16_t ValueLength, uint8_t *Record) {
+	memtable_Entry *Entry = EntryAt(MemtableUsed);
+	uint8_t *Bytes = EntryPath(Entry);
+	uint16_t i;
+
+	Entry->Size = sizeof(memtable_Entry) + PathLength + ValueLength;
+	Entry->Size = (Entry->Size + WORD - 1) & ~(WORD - 1);
+	Entry->Type = Type;
+	Entry->State = ENTRY_PENDING;
+	Entry->Target = Target;
+	Entry->Count = Count;
+	Entry->PathLength = PathLength;
+	Entry->ValueLength = ValueLength;
+	Entry->Record = Record;
+	for (i = 0; i < PathLength; i++) {
+		*Bytes++ = path[i];
+	}
+	for (i = 0; i < ValueLength; i++) {
+		*Bytes++ = value[i];
+	}
+	MemtableUsed = MemtableUsed + Entry->Size;
+	return Entry;
+}
+
+/*
+ * This function checks if the record of journal was completely written.
+ */
+static inline bool RecordComplete(uint8_t *Record) {
+	uint16_t Size = *(uint16_t*) Record;
+
+	return Size != EMPTY_HALFWORD && Size > LOG_HEADER_SIZE
+			&& Record + Size <= LOG_END
+			&& *(uint16_t*) (Record + Size - 2) == Size;
+}
+
+/*
+ * This function gives the record after the record of journal. A record which was not completely written is skipped by its size, if
+ * the size itself is not valid then the rest of the journal is taken as used.
+ */
+static inline uint8_t* NextRecord(uint8_t *Record) {
+	uint16_t Size = *(uint16_t*) Record;
+
+	if (Size <= LOG_HEADER_SIZE || (Size & 1) != 0 || Record + Size > LOG_END) {
+		return LOG_END;
+	}
+	return Record + Size;
+}
+
+/*
+ * This function walks the records of journal from Record till the first empty half word.
+ * Returns: the address after the last record
+ */
+static uint8_t* RecordsEnd(uint8_t *Record) {
+	while (Record + LOG_HEADER_SIZE <= LOG_END) {
+		if (*(uint16_t*) Record == EMPTY_HALFWORD) {
+			return Record;
+		}
+		Record = NextRecord(Record);
+	}
+	return LOG_END;
+}
+
+/*
+ * This function writes the record of entry at the end of journal. LogAppendAddr is moved after it, or after the bytes written if
+ * writing failed so the record is skipped.
+ * Returns: true if written
+ */
+static bool WriteRecord(memtable_Entry *Entry) {
+	uint8_t Header[LOG_HEADER_SIZE];
+	uint16_t Size = LOG_HEADER_SIZE + Entry->PathLength + Entry->ValueLength;
+	uint8_t *Record = LogAppendAddr;
+
+	Size = Size + (Size & 1) + 2;
+	Header[0] = (uint8_t) Size;
+	Header[1] = (uint8_t) (Size >> 8);
+	Header[LOG_TYPE_OFFSET] = Entry->Type;
+	Header[LOG_TARGET_OFFSET] = Entry->Target;
+	Header[LOG_COUNT_OFFSET] = (uint8_t) Entry->Count;
+	Header[LOG_COUNT_OFFSET + 1] = (uint8_t) (Entry->Count >> 8);
+	Header[LOG_PATH_LENGTH_OFFSET] = (uint8_t) Entry->PathLength;
+	Header[LOG_PATH_LENGTH_OFFSET + 1] = (uint8_t) (Entry->PathLength >> 8);
+	Header[LOG_VALUE_LENGTH_OFFSET] = (uint8_t) Entry->ValueLength;
+	Header[LOG_VALUE_LENGTH_OFFSET + 1] = (uint8_t) (Entry->ValueLength >> 8);
+
+	Entry->Record = Record;
+
+	/*The applied mark is left empty*/
+	if (WriteBytesToFLASH(Header, (uint32_t) Record, 2) != FL_STORE_SUCCESS
+			|| WriteBytesToFLASH(Header + LOG_TYPE_OFFSET,
+					(uint32_t) (Record + LOG_TYPE_OFFSET),
+					LOG_HEADER_SIZE - LOG_TYPE_OFFSET) != FL_STORE_SUCCESS
+			|| WriteBytesToFLASH(EntryPath(Entry),
+					(uint32_t) (Record + LOG_HEADER_SIZE),
+					Entry->PathLength + Entry->ValueLength) != FL_STORE_SUCCESS
+			|| WriteBytesToFLASH(Header, (uint32_t) (Record + Size - 2), 2)
+					!= FL_STORE_SUCCESS) {
+		LogAppendAddr = RecordsEnd(LogAppendAddr);
+		return false;
+	}
+	LogAppendAddr = LogAppendAddr + Size;
+	return true;
+}
+
+/*
+ * This function finds the bytes of DB which are replaced by the value of entry.
+ * Returns: false if the path is not found
+ */
+static bool FindCut(memtable_Entry *Entry) {
+	microcDB_Data FindResult = FindPath(EntryPath(Entry));
+	uint8_t *value = EntryValue(Entry);
+
+	if (FindResult.DBstatus != FOUND_SUCCESS) {
+		return false;
+	}
+	if (FindResult.JSON_type == JSON_OBJ) {
+		Entry->Cut = FindResult.DBEndptr;
+		Entry->CutEnd = FindResult.DBEndptr;
+	} else if (FindResult.JSON_type == JSON_STRING && *value == '\"') {
+		/*The quoted string replaces the old string with its quotes*/
+		Entry->Cut = FindResult.DBStartptr - 1;
+		Entry->CutEnd = FindResult.DBEndptr + 2;
+	} else {
+		Entry->Cut = FindResult.DBStartptr;
+		Entry->CutEnd = FindResult.DBEndptr + 1;
+	}
+	return true;
+}
+
+/*
+ * This function gives the first address of the page having the address.
+ */
+static inline uint8_t* PageOf(uint8_t *Address) {
+	return (uint8_t*) DB_START_ADDR
+			+ (((Address - (uint8_t*) DB_START_ADDR) / PAGE_SIZE) * PAGE_SIZE);
+}
+
+/*
+ * This function writes the values of entries in place which are in the page with one rewrite of the page.
+ * Returns: microcDB_Status UPDATE_SUCCESSFUL or UPDATE_FAILED
+ */
+static microcDB_Status WriteInPlace(uint8_t *Page) {
+	uint32_t PageWords[PAGE_SIZE / 4]; /*Words as it is written by WritePage()*/
+	uint8_t *PageBytes = (uint8_t*) PageWords, *value;
+	memtable_Entry *Entry;
+	uint16_t Offset, i;
+	microcDB_Status status = UPDATE_SUCCESSFUL;
+
+	for (i = 0; i < PAGE_SIZE; i++) {
+		PageBytes[i] = Page[i];
+	}
+	for (Offset = 0; Offset < MemtableUsed; Offset = Offset + Entry->Size) {
+		Entry = EntryAt(Offset);
+		if (Entry->State == ENTRY_IN_PLACE && PageOf(Entry->Cut) == Page) {
+			value = EntryValue(Entry);
+			for (i = 0; i < Entry->CutEnd - Entry->Cut; i++) {
+				PageBytes[(Entry->Cut - Page) + i] = value[i];
+			}
+		}
+	}
+
+	if (ErasePage(Page) != ERASE_SUCCESS
+			|| WritePage(PageWords, (uint32_t*) Page, PAGE_SIZE)
+					!= FL_STORE_SUCCESS) {
+		status = UPDATE_FAILED;
+	}
+	for (Offset = 0; Offset < MemtableUsed; Offset = Offset + Entry->Size) {
+		Entry = EntryAt(Offset);
+		if (Entry->State == ENTRY_IN_PLACE && PageOf(Entry->Cut) == Page) {
+			Entry->State = ENTRY_DONE;
+			if (status == UPDATE_SUCCESSFUL) {
+				HASH_INDEX_UPDATED(EntryPath(Entry));
+			}
+		}
+	}
+	return status;
+}
+
+/*
+ * This function applies the buffered writes to DB and empties the memtable. The journal is not erased, and the pages changed are saved
+ * to the undo log till it is erased with the journal.
+ * Returns: microcDB_Status UPDATE_SUCCESSFUL or the status of the first write which failed
+ */
+static microcDB_Status ApplyEntries() {
+	memtable_Entry *Entry;
+	microcDB_Status status = UPDATE_SUCCESSFUL, EntryStatus;
+	uint16_t Offset, Order[MAX_ENTRIES], Entries = 0, i;
+	uint8_t *Appended;
+	size_t len;
+
+	Tracking = true;
+
+	/*The documents are inserted first so the updates of paths in them are found*/
+	for (Offset = 0; Offset < MemtableUsed; Offset = Offset + Entry->Size) {
+		Entry = EntryAt(Offset);
+		if (Entry->Type == ENTRY_INSERT) {
+			Appended = (uint8_t*) FlashAddresscntr;
+			EntryStatus = InsertObjects(EntryValue(Entry), Entry->Count);
+			if (EntryStatus == STORE_SUCCESS) {
+				KEY_INDEX_APPEND(Appended);
+				HASH_INDEX_APPEND(Appended);
+			} else if (status == UPDATE_SUCCESSFUL) {
+				status = EntryStatus;
+			}
+			Entry->State = ENTRY_DONE;
+		}
+	}
+
+	/*The values are found before any of them is changed and the entries are sorted by their address by insertion*/
+	for (Offset = 0; Offset < MemtableUsed; Offset = Offset + Entry->Size) {
+		Entry = EntryAt(Offset);
+		if (Entry->State != ENTRY_PENDING) {
+			continue;
+		}
+		if (!FindCut(Entry)) {
+			Entry->State = ENTRY_DONE;
+			if (status == UPDATE_SUCCESSFUL)
+				status = PATH_NOT_FOUND;
+			continue;
+		}
+		len = Entry->ValueLength - 1;
+		Entry->State = ENTRY_SHIFT;
+		if (Entry->Type == ENTRY_REPLACE
+				&& (size_t) (Entry->CutEnd - Entry->Cut) == len
+				&& PageOf(Entry->Cut) == PageOf(Entry->CutEnd - 1)) {
+			Entry->State = ENTRY_IN_PLACE;
+		}
+		for (i = Entries; i > 0 && EntryAt(Order[i - 1])->Cut > Entry->Cut; i--) {
+			Order[i] = Order[i - 1];
+		}
+		Order[i] = Offset;
+		Entries++;
+	}
+
+	/*The values of same length are written with one rewrite of every page having them, from the first page*/
+	for (i = 0; i < Entries; i++) {
+		Entry = EntryAt(Order[i]);
+		if (Entry->State == ENTRY_IN_PLACE) {
+			EntryStatus = WriteInPlace(PageOf(Entry->Cut));
+			if (EntryStatus != UPDATE_SUCCESSFUL && status == UPDATE_SUCCESSFUL) {
+				status = EntryStatus;
+			}
+		}
+	}
+
+	/*The rest are updated from the highest address so the values found at lower addresses are not shifted*/
+	for (i = Entries; i > 0; i--) {
+		Entry = EntryAt(Order[i - 1]);
+		if (Entry->State != ENTRY_SHIFT) {
+			continue;
+		}
+		EntryStatus = UpdateValue(EntryPath(Entry), EntryValue(Entry));
+		if (EntryStatus == UPDATE_SUCCESSFUL) {
+			KEY_INDEX_UPDATED(EntryPath(Entry)); /*The values after the updated one may have been shifted*/
+			HASH_INDEX_UPDATED(EntryPath(Entry));
+		} else if (status == UPDATE_SUCCESSFUL) {
+			status = EntryStatus;
+		}
+		Entry->State = ENTRY_DONE;
+	}
+
+	Tracking = false;
+	if (UndoFailed) {
+		UndoFailed = false;
+		if (status == UPDATE_SUCCESSFUL)
+			status = UPDATE_FAILED; /*The writes can't be rolled back if power is lost before the journal is erased*/
+	}
+	MemtableUsed = 0;
+	return status;
+}
+
+/*
+ * This function applies the buffered writes and erases the journal. The status of a write which failed is kept for MicrocDB_Sync().
+ * Returns: microcDB_Status UPDATE_SUCCESSFUL or UPDATE_FAILED if the journal couldn't be erased
+ */
+static microcDB_Status Flush() {
+	microcDB_Status status;
+
+	if (LogAppendAddr == LOG_START) {
+		return UPDATE_SUCCESSFUL;
+	}
+	status = ApplyEntries();
+	if (status != UPDATE_SUCCESSFUL && FlushStatus == UPDATE_SUCCESSFUL) {
+		FlushStatus = status;
+	}
+	return MemtableErase() == ERASE_SUCCESS ? UPDATE_SUCCESSFUL : UPDATE_FAILED;
+}
+
+/*
+ * This function adds the write to memtable and journal. They are flushed first if it doesn't fit in them. The single quotes of value are
+ * replaced first, so the buffered value is found like the one in DB.
+ * Returns: microcDB_Status UPDATE_SUCCESSFUL, NO_MEMORY if it can't fit in the empty memtable or journal, or UPDATE_FAILED if the
+ * journal couldn't be written
+ */
+static microcDB_Status Buffer(uint8_t Type, uint8_t Target, uint16_t Count,
+		uint8_t *path, uint16_t PathLength, uint8_t *value,
+		uint16_t ValueLength) {
+	memtable_Entry *Entry;
+	microcDB_Status status;
+
+	if (!EntryFits(PathLength, ValueLength)) {
+		return NO_MEMORY;
+	}
+	if (MemtableUsed + sizeof(memtable_Entry) + PathLength + ValueLength
+			+ WORD - 1 > sizeof(Memtable)
+			|| LogAppendAddr + LOG_HEADER_SIZE + PathLength + ValueLength + 3
+					> LOG_END) {
+		status = Flush();
+		if (status != UPDATE_SUCCESSFUL) {
+			return status;
+		}
+	}
+
+	replacesingleTodouble(value, ValueLength);
+	Entry = AddEntry(Type, Target, Count, path, PathLength, value, ValueLength,
+			0);
+	if (!WriteRecord(Entry)) {
+		MemtableUsed = MemtableUsed - Entry->Size;
+		return UPDATE_FAILED;
+	}
+	return UPDATE_SUCCESSFUL;
+}
+
+/*
+ * This function sets the status of data which doesn't fit in the RAM buffer of MemtableFind().
+ */
+static inline void FoundTooLong(microcDB_Data *Data) {
+	Data->DBstatus = NO_MEMORY;
+	Data->DBStartptr = 0;
+	Data->DBEndptr = 0;
+}
+
+/*
+ * This function copies the data found in the buffered writes to the RAM buffer of MemtableFind(), as the entries are moved in memtable
+ * by the later writes.
+ */
+static void CopyFound(microcDB_Data *Data) {
+	size_t Length = Data->DBEndptr + 1 - Data->DBStartptr, i;
+
+	if (Length > MICROCDB_MEMTABLE_FIND_BYTES) {
+		FoundTooLong(Data);
+		return;
+	}
+	for (i = 0; i < Length; i++) {
+		Found[i] = Data->DBStartptr[i];
+	}
+	Data->DBStartptr = Found;
+	Data->DBEndptr = Found + Length - 1;
+}
+
+/*
+ * This function finds the query which is the path of a replaced value or a path in it, or a path in a member added to an object. The
+ * value is searched in a copy in the RAM buffer of MemtableFind().
+ */
+static microcDB_Data BufferedFind(memtable_Entry *Entry, uint8_t *query) {
+	microcDB_Data data_out_struct;
+	uint8_t *value = EntryValue(Entry), *Subquery = query + Entry->PathLength
+			- 1;
+	uint16_t Length = Entry->ValueLength - 1, i; /*Without the '/'*/
+
+	data_out_struct.DBstatus = NOT_FOUND;
+	data_out_struct.JSON_type = JSON_UNDEFINED;
+	data_out_struct.DBStartptr = 0;
+	data_out_struct.DBEndptr = 0;
+	if (Length + 3 > MICROCDB_MEMTABLE_FIND_BYTES) {
+		FoundTooLong(&data_out_struct);
+		return data_out_struct;
+	}
+
+	/*The added member is searched as the only member of an object*/
+	if (Entry->Type == ENTRY_ADD) {
+		Found[0] = '{';
+		for (i = 0; i < Length; i++) {
+			Found[i + 1] = value[i];
+		}
+		Found[Length + 1] = '}';
+		Found[Length + 2] = '/';
+		return FindInDocument(Subquery, Found, Found + Length + 2);
+	}
+
+	for (i = 0; i <= Length; i++) {
+		Found[i] = value[i];
+	}
+	if (*Subquery != '/') {
+		/*A path in the value is searched only if it is an object, a string is updated inside its quotes so it stays a string*/
+		return *Found == '{' && Entry->Target != JSON_STRING ?
+				FindInDocument(Subquery, Found, Found + Length) : data_out_struct;
+	}
+	if (Entry->Target == JSON_STRING && *Found != '\"') {
+		data_out_struct.DBstatus = FOUND_SUCCESS;
+		data_out_struct.JSON_type = JSON_STRING;
+		data_out_struct.DBStartptr = Found;
+		data_out_struct.DBEndptr = Found + Length - 1;
+	} else {
+		ValueToData(Found, Found + Length - 1, &data_out_struct);
+	}
+	return data_out_struct;
+}
+
+/*
+ * This function copies the value found in DB to the RAM buffer of MemtableFind() with the buffered values of the paths in it, in the
+ * order of their address. The data is not changed if no buffered value is in it.
+ */
+static void Overlay(uint8_t *query, microcDB_Data *Data) {
+	memtable_Entry *Entry;
+	uint8_t *ptr = Data->DBStartptr, *End = Data->DBEndptr + 1, *value;
+	uint16_t Offset, Order[MAX_ENTRIES], Entries = 0, i, j;
+	size_t Length = 0;
+
+	for (Offset = 0; Offset < MemtableUsed; Offset = Offset + Entry->Size) {
+		Entry = EntryAt(Offset);
+		if (Entry->Type == ENTRY_INSERT || !PathIn(EntryPath(Entry), query)
+				|| !FindCut(Entry) || Entry->Cut < ptr || Entry->CutEnd > End) {
+			continue;
+		}
+		for (i = Entries; i > 0 && EntryAt(Order[i - 1])->Cut > Entry->Cut; i--) {
+			Order[i] = Order[i - 1];
+		}
+		Order[i] = Offset;
+		Entries++;
+	}
+	if (Entries == 0) {
+		return;
+	}
+
+	for (i = 0; i <= Entries; i++) {
+		Entry = i < Entries ? EntryAt(Order[i]) : 0;
+		value = Entry != 0 ? Entry->Cut : End;
+		if (Length + (value - ptr) + (Entry != 0 ? Entry->ValueLength : 0)
+				> MICROCDB_MEMTABLE_FIND_BYTES) {
+			FoundTooLong(Data);
+			return;
+		}
+		while (ptr < value) {
+			Found[Length++] = *ptr++;
+		}
+		if (Entry == 0) {
+			break;
+		}
+		/*The added member is after a comma if the object has any member*/
+		if (Entry->Type == ENTRY_ADD
+				&& SkipSlack(FindPath(EntryPath(Entry)).DBStartptr + 1,
+						Entry->Cut) != Entry->Cut) {
+			Found[Length++] = ',';
+		}
+		value = EntryValue(Entry);
+		for (j = 0; j < Entry->ValueLength - 1; j++) {
+			Found[Length++] = value[j];
+		}
+		ptr = Entry->CutEnd;
+	}
+	ValueToData(Found, Found + Length - 1, Data);
+}
+
+/*MISC functions*/
+
+/**************************************************************************************************************************************/
+/*MicrocDB memtable functions*/
+
+bool MemtableInit() {
+	uint8_t *Record;
+	uint16_t PathLength, ValueLength;
+
+	MemtableUsed = 0;
+	LogAppendAddr = RecordsEnd(LOG_START);
+	if (LogAppendAddr == LOG_START) {
+		return true;
+	}
+	for (Record = LOG_START; Record < LogAppendAddr; Record = NextRecord(Record)) {
+		if (RecordComplete(Record)
+				&& *(uint16_t*) (Record + LOG_APPLIED_OFFSET) == EMPTY_HALFWORD) {
+			PathLength = *(uint16_t*) (Record + LOG_PATH_LENGTH_OFFSET);
+			ValueLength = *(uint16_t*) (Record + LOG_VALUE_LENGTH_OFFSET);
+			if (MemtableUsed + sizeof(memtable_Entry) + PathLength + ValueLength
+					+ WORD - 1 > sizeof(Memtable)) {
+				ApplyEntries();
+			}
+			AddEntry(Record[LOG_TYPE_OFFSET], Record[LOG_TARGET_OFFSET],
+					*(uint16_t*) (Record + LOG_COUNT_OFFSET),
+					Record + LOG_HEADER_SIZE, PathLength,
+					Record + LOG_HEADER_SIZE + PathLength, ValueLength, Record);
+		}
+	}
+	/*The writes which failed are dropped as they would fail again*/
+	ApplyEntries();
+	return MemtableErase() == ERASE_SUCCESS;
+}
+
+bool MemtableRollback() {
+	uint16_t Slot, PageNumber;
+	uint8_t *Page;
+
+	Tracking = false;
+	for (Slot = 0; Slot < sizeof(SavedPages); Slot++) {
+		SavedPages[Slot] = 0;
+	}
+	for (UndoSlots = 0;
+			UndoSlots < DB_PAGES
+					&& *(uint16_t*) UNDO_NUMBER(UndoSlots + 1) != EMPTY_HALFWORD;
+			UndoSlots++) {
+		PageNumber = *(uint16_t*) UNDO_NUMBER(UndoSlots + 1);
+		SavedPages[PageNumber / 8] |= 1 << (PageNumber % 8);
+	}
+
+	/*The writes were applied if the undo log is committed, only the erasing of journal was interrupted*/
+	if (*(uint16_t*) UNDO_HEADER != EMPTY_HALFWORD) {
+		return MemtableErase() == ERASE_SUCCESS;
+	}
+	/*The pages are restored again if power is lost while restoring, and they are not saved again when the writes are applied again*/
+	for (Slot = 1; Slot <= UndoSlots; Slot++) {
+		Page = (uint8_t*) DB_START_ADDR
+				+ ((uint32_t) *(uint16_t*) UNDO_NUMBER(Slot) * PAGE_SIZE);
+		if (ErasePage(Page) != ERASE_SUCCESS
+				|| WritePage((uint32_t*) UNDO_SLOT(Slot), (uint32_t*) Page,
+				PAGE_SIZE) != FL_STORE_SUCCESS) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void MemtableTrack(uint32_t Address, uint32_t NumberOfBytes) {
+	uint32_t End = Address + NumberOfBytes;
+	uint16_t PageNumber;
+
+	if (!Tracking || NumberOfBytes == 0 || End <= DB_START_ADDR
+			|| Address > DB_END_ADDR) {
+		return; /*The journal, the undo log and the other regions are not saved*/
+	}
+	if (Address < DB_START_ADDR) {
+		Address = DB_START_ADDR;
+	}
+	if (End > DB_END_ADDR + 1) {
+		End = DB_END_ADDR + 1;
+	}
+
+	for (PageNumber = (Address - DB_START_ADDR) / PAGE_SIZE;
+			PageNumber <= (End - 1 - DB_START_ADDR) / PAGE_SIZE;
+			PageNumber++) {
+		if (SavedPages[PageNumber / 8] & (1 << (PageNumber % 8))) {
+			continue; /*The page before the writes is already saved*/
+		}
+		SavedPages[PageNumber / 8] |= 1 << (PageNumber % 8);
+		if (!SavePage(PageNumber)) {
+			UndoFailed = true;
+		}
+	}
+}
+
+flash_mem_Stat MemtableErase() {
+	uint8_t Commit[2] = { (uint8_t) ~FL_EMPTY_BYTE, (uint8_t) ~FL_EMPTY_BYTE };
+	uint32_t Page;
+	uint16_t Slot;
+
+	MemtableUsed = 0;
+	LogAppendAddr = LOG_START;
+
+	/*The pages saved are not restored once the undo log is committed, so the writes are not applied again after the journal is
+	 * erased*/
+	if (UndoSlots > 0 && *(uint16_t*) UNDO_HEADER == EMPTY_HALFWORD
+			&& WriteBytesToFLASH(Commit, (uint32_t) UNDO_HEADER, 2)
+					!= FL_STORE_SUCCESS) {
+		return ERASE_FAILED;
+	}
+	/*The pages are erased one by one as EraseDB() moves the FlashAddresscntr of DB*/
+	for (Page = MICROCDB_MEMTABLE_LOG_START_ADDR;
+			Page < MICROCDB_MEMTABLE_LOG_END_ADDR; Page = Page + PAGE_SIZE) {
+		if (ErasePage((uint8_t*) Page) != ERASE_SUCCESS) {
+			return ERASE_FAILED;
+		}
+	}
+	/*The header is erased last so the slots are erased again if power is lost before it*/
+	for (Slot = UndoSlots; Slot > 0; Slot--) {
+		if (ErasePage(UNDO_SLOT(Slot)) != ERASE_SUCCESS) {
+			return ERASE_FAILED;
+		}
+	}
+	if (!PageEmpty(UNDO_HEADER) && ErasePage(UNDO_HEADER) != ERASE_SUCCESS) {
+		return ERASE_FAILED;
+	}
+	for (Slot = 0; Slot < sizeof(SavedPages); Slot++) {
+		SavedPages[Slot] = 0;
+	}
+	UndoSlots = 0;
+	return ERASE_SUCCESS;
+}
+
+microcDB_Status MemtableInsert(uint8_t *JSONString,
+		unsigned int numberofobjects) {
+	size_t Length = 0;
+	unsigned int num;
+	microcDB_Status status;
+
+	for (num = 0; num < numberofobjects; num++) {
+		Length = Length + CalculateStringLength(JSONString + Length) + 1;
+	}
+	if (Length > 0xFFFF) {
+		status = NO_MEMORY;
+	} else {
+		status = Buffer(ENTRY_INSERT, JSON_UNDEFINED, numberofobjects, 0, 0,
+				JSONString, Length);
+	}
+	if (status == NO_MEMORY) {
+		/*The documents larger than memtable are inserted after the buffered writes*/
+		status = Flush();
+		if (status != UPDATE_SUCCESSFUL) {
+			return status;
+		}
+		return InsertObjects(JSONString, numberofobjects);
+	}
+	return status == UPDATE_SUCCESSFUL ? STORE_SUCCESS : status;
+}
+
+microcDB_Status MemtableUpdate(uint8_t *path, uint8_t *value) {
+	microcDB_Data FindResult;
+	memtable_Entry *Entry;
+	uint16_t Offset, PathLength, ValueLength;
+	bool Overlaps = false, HasInserts = false;
+	microcDB_Status status;
+
+	for (Offset = 0; Offset < MemtableUsed; Offset = Offset + Entry->Size) {
+		Entry = EntryAt(Offset);
+		if (Entry->Type == ENTRY_INSERT) {
+			HasInserts = true;
+		} else if (PathsOverlap(EntryPath(Entry), path)) {
+			Overlaps = true;
+		}
+	}
+
+	/*The path can be in the buffered documents*/
+	FindResult = FindPath(path);
+	if (FindResult.DBstatus != FOUND_SUCCESS && HasInserts) {
+		status = Flush();
+		if (status != UPDATE_SUCCESSFUL) {
+			return status;
+		}
+		Overlaps = false;
+		FindResult = FindPath(path);
+	}
+	if (FindResult.DBstatus != FOUND_SUCCESS) {
+		return PATH_NOT_FOUND;
+	}
+	if (FindResult.JSON_type == JSON_ARRAY) {
+		return DATA_IS_ARRAY;
+	}
+
+	if (Overlaps) {
+		/*The buffered value of the same path is replaced, otherwise the buffered writes are applied so this one sees them*/
+		Offset = 0;
+		while (Offset < MemtableUsed) {
+			Entry = EntryAt(Offset);
+			if (Entry->Type == ENTRY_REPLACE
+					&& FindResult.JSON_type != JSON_OBJ
+					&& PathsEqual(EntryPath(Entry), path)) {
+				if (!MarkReplaced(Entry->Record)) {
+					return UPDATE_FAILED;
+				}
+				RemoveEntry(Offset);
+				Overlaps = false;
+				continue;
+			}
+			Offset = Offset + Entry->Size;
+		}
+		for (Offset = 0; Offset < MemtableUsed; Offset = Offset + Entry->Size) {
+			Entry = EntryAt(Offset);
+			if (Entry->Type != ENTRY_INSERT
+					&& PathsOverlap(EntryPath(Entry), path)) {
+				Overlaps = true;
+			}
+		}
+		if (Overlaps) {
+			status = Flush();
+			if (status != UPDATE_SUCCESSFUL) {
+				return status;
+			}
+		}
+	}
+
+	PathLength = CalculateStringLength(path) + 1;
+	ValueLength = CalculateStringLength(value) + 1;
+	status = Buffer(FindResult.JSON_type == JSON_OBJ ? ENTRY_ADD : ENTRY_REPLACE,
+			FindResult.JSON_type, 0, path, PathLength, value, ValueLength);
+	if (status == NO_MEMORY) {
+		/*The value larger than memtable is updated after the buffered writes*/
+		status = Flush();
+		if (status != UPDATE_SUCCESSFUL) {
+			return status;
+		}
+		return UpdateValue(path, value);
+	}
+	return status;
+}
+
+microcDB_Data MemtableFind(uint8_t *query) {
+	microcDB_Data data_out_struct;
+	memtable_Entry *Entry;
+	uint8_t *value, *Document;
+	uint16_t Offset, num;
+
+	/*The query in a buffered value is found in it. A member added to an object may also be in the object in DB*/
+	for (Offset = 0; Offset < MemtableUsed; Offset = Offset + Entry->Size) {
+		Entry = EntryAt(Offset);
+		if (Entry->Type == ENTRY_INSERT || !PathIn(query, EntryPath(Entry))
+				|| (Entry->Type == ENTRY_ADD
+						&& PathsEqual(EntryPath(Entry), query))) {
+			continue;
+		}
+		data_out_struct = BufferedFind(Entry, query);
+		if (data_out_struct.DBstatus != NOT_FOUND
+				|| Entry->Type == ENTRY_REPLACE) {
+			return data_out_struct;
+		}
+		break;
+	}
+
+	/*The value found in DB is given with the buffered values in it*/
+	data_out_struct = FindPath(query);
+	if (data_out_struct.DBstatus == FOUND_SUCCESS) {
+		Overlay(query, &data_out_struct);
+		return data_out_struct;
+	}
+
+	/*The documents not inserted yet are searched after the ones in DB*/
+	for (Offset = 0; Offset < MemtableUsed; Offset = Offset + Entry->Size) {
+		Entry = EntryAt(Offset);
+		if (Entry->Type != ENTRY_INSERT) {
+			continue;
+		}
+		Document = EntryValue(Entry);
+		for (num = 0; num < Entry->Count; num++) {
+			value = Document + CalculateStringLength(Document);
+			data_out_struct = FindInDocument(query, Document, value);
+			if (data_out_struct.DBstatus == FOUND_SUCCESS) {
+				CopyFound(&data_out_struct);
+				return data_out_struct;
+			}
+			Document = value + 1;
+		}
+	}
+	return data_out_struct;
+}
+
+microcDB_Status MicrocDB_Sync() {
+	microcDB_Status status;
+	LATENCY_BEGIN();
+
+	STATS_BEGIN(STATS_OP_UPDATE);
+	DEVICES_SYNC();
+	status = Flush();
+	if (status == UPDATE_SUCCESSFUL) {
+		status = FlushStatus;
+		FlushStatus = UPDATE_SUCCESSFUL;
+	}
+
+	LATENCY_END(LATENCY_OP_UPDATE);
+	return status;
+}
+
+/*MicrocDB memtable functions*/
+#endif
@@ -0,0 +1,100 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The projection queries of microcDB. The path is found once and the members of the object are walked once, every
+ *      member key is compared with the requested keys and the values are skipped without parsing.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_PROJECTION == 1
+
+/*MISC functions*/
+
+/*
+ * This function compares the key of member of given length with the requested key terminated with "./".
+ * Returns: true if same
+ */
+static inline bool MemberKeyEquals(uint8_t *MemberKey, size_t Length,
+		uint8_t *Key) {
+	while (Length != 0) {
+		if (*MemberKey != *Key)
+			return false;
+		MemberKey++;
+		Key++;
+		Length--;
+	}
+	return *Key == '.';
+}
+
+/*
+ * This function gives the values of the keys of the object at path. It is called again by MicrocDB_Project() if the writer task wrote
+ * the DB while it was read, so the results are initialized here.
+ */
+static microcDB_Status ProjectPath(uint8_t *path, uint8_t **keys,
+		uint8_t numberofkeys, microcDB_Data *Results) {
+	microcDB_Data FindResult;
+	uint8_t *ptr, *End, *MemberKey, *ValueEnd;
+	size_t MemberKeyLength;
+	uint8_t key, remaining = numberofkeys;
+
+	for (key = 0; key < numberofkeys; key++) {
+		Results[key].DBstatus = NOT_FOUND;
+		Results[key].JSON_type = JSON_UNDEFINED;
+		Results[key].DBStartptr = 0;
+		Results[key].DBEndptr = 0;
+	}
+
+	FindResult = FindPath(path);
+	if (FindResult.DBstatus != FOUND_SUCCESS) {
+		return PATH_NOT_FOUND;
+	}
+	if (FindResult.JSON_type != JSON_OBJ) {
+		return QUERY_INVALID;
+	}
+
+	End = FindResult.DBEndptr;
+	ptr = SkipSlack(FindResult.DBStartptr + 1, End);
+	/*Walk the members till all the keys are found*/
+	while (ptr < End && *ptr == '\"' && remaining != 0) {
+		MemberKey = ptr + 1;
+		ptr = SkipJSONValue(ptr, End);
+		MemberKeyLength = ptr - MemberKey;
+		ptr = ptr + 2; /*Skip the ending quote and ':'*/
+
+		ValueEnd = SkipJSONValue(ptr, End);
+		for (key = 0; key < numberofkeys; key++) {
+			if (Results[key].DBstatus == NOT_FOUND
+					&& MemberKeyEquals(MemberKey, MemberKeyLength, keys[key])) {
+				ValueToData(ptr, ValueEnd, &Results[key]);
+				remaining--;
+			}
+		}
+		STATS_ADD(ParserBytes, ValueEnd - MemberKey + 2);
+
+		ptr = SkipSlack(ValueEnd + 1, End);
+		if (*ptr == ',')
+			ptr++;
+	}
+	return FOUND_SUCCESS;
+}
+
+/*MISC functions*/
+
+/**************************************************************************************************************************************/
+/*MicrocDB projection functions*/
+
+microcDB_Status MicrocDB_Project(uint8_t *path, uint8_t **keys,
+		uint8_t numberofkeys, microcDB_Data *Results) {
+	microcDB_Status status;
+
+	STATS_BEGIN(STATS_OP_FIND);
+	DEVICES_SYNC();
+	if (UPDATE_JOB_PENDING()) {
+		return UPDATE_PENDING; /*The DB is partly shifted by the job*/
+	}
+	SEQ_READ(status = ProjectPath(path, keys, numberofkeys, Results));
+	return status;
+}
+
+/*MicrocDB projection functions*/
+#endif
@@ -0,0 +1,526 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The object relocation of microcDB. An object which outgrows its slack is not grown in place as that needs the DB
+ *      			 after it to be shifted. Instead its grown copy is written as a record at the end of the relocation region and a
+ *      			 forwarding marker having the id of the record is programmed in the end of the slack of the old object, which is
+ *      			 kept empty for it. The copy has its own slack so it grows in place, and when that is not enough its next copy is
+ *      			 written with the same id, so finding an object follows only one marker to the latest record of its id.
+ *      			 The region is used as two banks. When the active bank is full and no snapshot is pinned, the latest record of every
+ *      			 id is copied to the other bank which becomes active and the old bank with the superseded copies is erased.
+ *
+ *      			 Layout of a bank:
+ *      			 |Generation(4 bytes)|Record|Record|...|Empty|
+ *      			 Layout of a record:
+ *      			 |Size(2 bytes)|Id(4 bytes)|Object with '/' padded to half word|Size(2 bytes)|
+ *      			 The generation is written after the records are copied to the bank, and the size after the object is used to check
+ *      			 that the record was completely written. A record which was not, due to a failed write or power loss, is skipped by
+ *      			 its first size and no marker is programmed to it.
+ *
+ *      			 Layout of a forwarding marker:
+ *      			 |0x00|Id of the record as 7 nibbles each ORed with 0x80|
+ *      			 None of these bytes is a JSON character so the braces of the old object are still matched by the parser.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_RELOCATION == 1
+
+#define BANK_SIZE ((MICROCDB_RELOCATION_END_ADDR + 1 - MICROCDB_RELOCATION_START_ADDR) / 2)
+#define BANK_HEADER_SIZE 4
+#define RECORD_ID_OFFSET 2
+#define RECORD_OBJECT_OFFSET 6
+#define RECORD_OVERHEAD 8
+#define MARKER_NIBBLE 0x80
+#define MAX_ID 0x0FFFFFFF /*The id has 7 nibbles in the marker*/
+#define EMPTY_HALFWORD ((uint16_t)(((uint8_t)FL_EMPTY_BYTE << 8) | (uint8_t)FL_EMPTY_BYTE))
+#define EMPTY_WORD (((uint32_t)EMPTY_HALFWORD << 16) | EMPTY_HALFWORD)
+
+static uint8_t ActiveBank = 0; /*The bank which has the records*/
+static uint32_t ActiveGeneration = 0; /*The generation of active bank or 0 if it was never written*/
+static uint8_t *AppendAddr = (uint8_t*) MICROCDB_RELOCATION_START_ADDR + BANK_HEADER_SIZE; /*The address where next record will be written*/
+static uint32_t NextId = 0; /*The id of next relocated object*/
+
+/*The bytes of a record are given one by one, so they are kept till a half word is complete. The half words having only empty bytes
+ * are not programmed so the slack of the copy can be programmed later*/
+typedef struct {
+	uint32_t Address;
+	uint8_t HalfWord[2];
+	uint8_t Count;
+} record_Writer;
+
+/*MISC functions*/
+
+/*
+ * This function gives the first address of the bank.
+ */
+static inline uint8_t* BankStart(uint8_t Bank) {
+	return (uint8_t*) MICROCDB_RELOCATION_START_ADDR + (Bank * BANK_SIZE);
+}
+
+/*
+ * This function erases the pages of the bank. EraseDB() is not used as it moves the FlashAddresscntr of DB.
+ */
+static flash_mem_Stat EraseBank(uint8_t Bank) {
+	uint32_t Page;
+
+	for (Page = 0; Page < BANK_SIZE / FLASH_PAGE_SIZE; Page++) {
+		if (ErasePage(BankStart(Bank) + (Page * FLASH_PAGE_SIZE))
+				!= ERASE_SUCCESS) {
+			return ERASE_FAILED;
+		}
+	}
+	return ERASE_SUCCESS;
+}
+
+/*
+ * This function reads a word which is aligned to half word.
+ */
+static inline uint32_t ReadWord(uint8_t *Address) {
+	return (uint32_t) *(uint16_t*) Address
+			| ((uint32_t) *(uint16_t*) (Address + 2) << 16);
+}
+
+/*
+ * This function checks if the record was completely written.
+ */
+static inline bool RecordComplete(uint8_t *Record) {
+	uint16_t Size = *(uint16_t*) Record;
+
+	return Size != EMPTY_HALFWORD && Size > RECORD_OVERHEAD
+			&& Record + Size <= BankStart(ActiveBank) + BANK_SIZE
+			&& *(uint16_t*) (Record + Size - 2) == Size;
+}
+
+/*
+ * This function gives the address after the records written from Record in the active bank, complete or not. The first size of a record
+ * is written before anything else so a record having it can be skipped. If the size is not valid then the rest of bank is taken as used
+ * as it can't be known which bytes were written.
+ */
+static uint8_t* RecordsEnd(uint8_t *Record) {
+	uint8_t *BankEnd = BankStart(ActiveBank) + BANK_SIZE;
+	uint16_t Size;
+
+	while (Record + RECORD_OVERHEAD <= BankEnd) {
+		Size = *(uint16_t*) Record;
+		if (Size == EMPTY_HALFWORD) {
+			return Record;
+		}
+		if (Size <= RECORD_OVERHEAD || (Size & 1) != 0
+				|| Record + Size > BankEnd) {
+			break;
+		}
+		Record = Record + Size;
+	}
+	return BankEnd;
+}
+
+/*
+ * This function gives the record having the address or 0 if it is not in a written record.
+ */
+static uint8_t* RecordOf(uint8_t *Address) {
+	uint8_t *Record = BankStart(ActiveBank) + BANK_HEADER_SIZE;
+
+	while (Record < AppendAddr) {
+		if (Address < Record + *(uint16_t*) Record) {
+			return Address >= Record ? Record : 0;
+		}
+		Record = Record + *(uint16_t*) Record;
+	}
+	return 0;
+}
+
+/*
+ * This function gives the latest complete record of the id or 0 if it has none. The snapshot being read doesn't see the records
+ * written after it was pinned.
+ */
+static uint8_t* LatestRecord(uint32_t Id) {
+	uint8_t *Record, *Latest = 0, *Limit = AppendAddr;
+
+#if MICROCDB_SNAPSHOTS > 0
+	if (SnapshotLimit != 0 && SnapshotLimit < Limit) {
+		Limit = SnapshotLimit;
+	}
+#endif
+	for (Record = BankStart(ActiveBank) + BANK_HEADER_SIZE; Record < Limit;
+			Record = Record + *(uint16_t*) Record) {
+		if (RecordComplete(Record)
+				&& ReadWord(Record + RECORD_ID_OFFSET) == Id) {
+			Latest = Record;
+		}
+	}
+	return Latest;
+}
+
+/*
+ * This function gives the address of forwarding marker in the slack of object ending at ObjectEnd. It is half word aligned and ends
+ * before the half word having the closing brace.
+ */
+static inline uint8_t* MarkerOf(uint8_t *ObjectEnd) {
+	return (uint8_t*) (((uint32_t) ObjectEnd - RELOCATION_MARKER_SIZE)
+			& ~(uint32_t) 1);
+}
+
+/*
+ * This function reads the id of the forwarding marker.
+ * Returns: false if the marker is not completely written
+ */
+static bool MarkerId(uint8_t *Marker, uint32_t *Id) {
+	uint8_t i;
+
+	if (*Marker != 0x00) {
+		return false;
+	}
+	*Id = 0;
+	for (i = 1; i < RELOCATION_MARKER_SIZE; i++) {
+		if ((Marker[i] & 0xF0) != MARKER_NIBBLE) {
+			return false;
+		}
+		*Id = (*Id << 4) | (Marker[i] & 0x0F);
+	}
+	return true;
+}
+
+/*
+ * This function gives the opening brace or bracket of the object or array list having the byte at Position. It is searched backwards
+ * so the strings are entered at their ending quote.
+ * Returns: the opening brace or bracket or 0 if not found
+ */
+static uint8_t* EnclosingStart(uint8_t *Position) {
+	uint8_t *Lower =
+			RELOCATED(Position) ?
+					(uint8_t*) MICROCDB_RELOCATION_START_ADDR :
+					(uint8_t*) DB_START_ADDR;
+	int16_t depth = 0;
+
+	while (Position >= Lower) {
+		if (*Position == '\"') {
+			Position--;
+			while (Position >= Lower && *Position != '\"')
+				Position--;
+		} else if (*Position == '}' || *Position == ']') {
+			depth++;
+		} else if (*Position == '{' || *Position == '[') {
+			if (depth == 0) {
+				return Position;
+			}
+			depth--;
+		}
+		Position--;
+	}
+	return 0;
+}
+
+/*
+ * This function checks if the object is a value of a member so it can be forwarded. The objects of array lists and the documents are not
+ * relocated, except the copies which are the values of members of the old objects.
+ */
+static bool Relocatable(uint8_t *ObjectStart) {
+	uint8_t *Record;
+
+	if (RELOCATED(ObjectStart)) {
+		Record = RecordOf(ObjectStart);
+		if (Record != 0 && ObjectStart == Record + RECORD_OBJECT_OFFSET) {
+			return true;
+		}
+	} else if (ObjectStart <= (uint8_t*) DB_START_ADDR) {
+		return false;
+	}
+	return *(ObjectStart - 1) == ':';
+}
+
+/*
+ * This function writes the bytes after the bytes written before by the writer.
+ * Returns: true if written
+ */
+static bool WriterPut(record_Writer *Writer, uint8_t *Bytes, size_t Count) {
+	while (Count != 0) {
+		Writer->HalfWord[Writer->Count++] = *Bytes;
+		if (Writer->Count == 2) {
+			Writer->Count = 0;
+			if ((Writer->HalfWord[0] != (uint8_t) FL_EMPTY_BYTE
+					|| Writer->HalfWord[1] != (uint8_t) FL_EMPTY_BYTE)
+					&& WriteBytesToFLASH(Writer->HalfWord, Writer->Address, 2)
+							!= FL_STORE_SUCCESS) {
+				return false;
+			}
+			Writer->Address = Writer->Address + 2;
+		}
+		Bytes++;
+		Count--;
+	}
+	return true;
+}
+
+/*
+ * This function writes the object of the record, see WriteRecord(), and the padding after it.
+ * Returns: true if written
+ */
+static bool WriteRecordBody(record_Writer *Writer, uint8_t *ObjectStart,
+		uint8_t *Cut, uint8_t *Separator, uint8_t *value, size_t len,
+		uint8_t *Resume, uint8_t *SlackStart) {
+	uint8_t Byte;
+	uint16_t i;
+
+	if (!WriterPut(Writer, ObjectStart, Cut - ObjectStart)
+			|| (Separator != 0 && !WriterPut(Writer, Separator, 1))
+			|| !WriterPut(Writer, value, len)
+			|| !WriterPut(Writer, Resume, SlackStart - Resume)) {
+		return false;
+	}
+	Byte = FL_EMPTY_BYTE;
+	for (i = 0; i < MICROCDB_OBJECT_SLACK; i++) {
+		if (!WriterPut(Writer, &Byte, 1)) {
+			return false;
+		}
+	}
+	Byte = '}';
+	if (!WriterPut(Writer, &Byte, 1)) {
+		return false;
+	}
+	Byte = '/';
+	if (!WriterPut(Writer, &Byte, 1)) {
+		return false;
+	}
+	/*Write the odd byte padded with the empty byte*/
+	if (Writer->Count == 1) {
+		if (WriteBytesToFLASH(Writer->HalfWord, Writer->Address, 1)
+				!= FL_STORE_SUCCESS) {
+			return false;
+		}
+		Writer->Address = Writer->Address + 2;
+	}
+	return true;
+}
+
+/*
+ * This function writes the record of the grown copy of object with the id at AppendAddr. The copy has the bytes of the old object from
+ * ObjectStart till Cut, the separator if given, the value, the bytes from Resume till SlackStart and a new slack. The AppendAddr is
+ * moved once the record is completely written, or after the record if writing failed after its size was written.
+ * Returns: microcDB_Status UPDATE_SUCCESSFUL, UPDATE_FAILED or NO_MEMORY
+ */
+static microcDB_Status WriteRecord(uint32_t Id, uint8_t *ObjectStart,
+		uint8_t *Cut, uint8_t *Separator, uint8_t *value, size_t len,
+		uint8_t *Resume, uint8_t *SlackStart) {
+	record_Writer Writer;
+	uint32_t Size = RECORD_OVERHEAD + (Cut - ObjectStart)
+			+ (Separator != 0 ? 1 : 0) + len + (SlackStart - Resume)
+			+ MICROCDB_OBJECT_SLACK + 2;
+	uint8_t SizeBytes[2], IdBytes[4] = { (uint8_t) Id, (uint8_t) (Id >> 8),
+			(uint8_t) (Id >> 16), (uint8_t) (Id >> 24) };
+
+	Size = Size + (Size & 1);
+	if (Size > EMPTY_HALFWORD - 1
+			|| AppendAddr + Size > BankStart(ActiveBank) + BANK_SIZE) {
+		return NO_MEMORY;
+	}
+	SizeBytes[0] = (uint8_t) Size;
+	SizeBytes[1] = (uint8_t) (Size >> 8);
+	Writer.Address = (uint32_t) AppendAddr + RECORD_OBJECT_OFFSET;
+	Writer.Count = 0;
+
+	if (WriteBytesToFLASH(SizeBytes, (uint32_t) AppendAddr, 2)
+			!= FL_STORE_SUCCESS
+			|| WriteBytesToFLASH(IdBytes,
+					(uint32_t) AppendAddr + RECORD_ID_OFFSET, 4)
+					!= FL_STORE_SUCCESS
+			|| !WriteRecordBody(&Writer, ObjectStart, Cut, Separator, value,
+					len, Resume, SlackStart)
+			|| WriteBytesToFLASH(SizeBytes, Writer.Address, 2)
+					!= FL_STORE_SUCCESS) {
+		AppendAddr = RecordsEnd(AppendAddr);
+		return UPDATE_FAILED;
+	}
+	AppendAddr = AppendAddr + Size;
+	return UPDATE_SUCCESSFUL;
+}
+
+/*MISC functions*/
+
+/**************************************************************************************************************************************/
+/*MicrocDB object relocation functions*/
+
+void RelocationInit() {
+	uint32_t Generation0 = ReadWord(BankStart(0)), Generation1 = ReadWord(
+			BankStart(1)), Id;
+	uint8_t *Record;
+
+	/*The bank written last is active. If power was lost before the old bank was erased then both have a generation*/
+	ActiveBank = (Generation1 != EMPTY_WORD
+			&& (Generation0 == EMPTY_WORD || Generation1 > Generation0)) ?
+			1 : 0;
+	ActiveGeneration = ActiveBank == 1 ? Generation1 :
+						Generation0 == EMPTY_WORD ? 0 : Generation0;
+	AppendAddr = RecordsEnd(BankStart(ActiveBank) + BANK_HEADER_SIZE);
+
+	NextId = 0;
+	for (Record = BankStart(ActiveBank) + BANK_HEADER_SIZE; Record < AppendAddr;
+			Record = Record + *(uint16_t*) Record) {
+		Id = ReadWord(Record + RECORD_ID_OFFSET);
+		if (RecordComplete(Record) && Id >= NextId) {
+			NextId = Id + 1;
+		}
+	}
+}
+
+uint32_t RelocationGeneration() {
+	return (uint32_t) AppendAddr;
+}
+
+flash_mem_Stat RelocationErase() {
+	ActiveBank = 0;
+	ActiveGeneration = 0;
+	AppendAddr = BankStart(0) + BANK_HEADER_SIZE;
+	NextId = 0;
+	if (EraseBank(0) != ERASE_SUCCESS) {
+		return ERASE_FAILED;
+	}
+	return EraseBank(1);
+}
+
+bool RelocationReclaim() {
+	uint8_t NewBank = ActiveBank ^ 1;
+	uint8_t *Record, *NewRecord = BankStart(NewBank) + BANK_HEADER_SIZE;
+	uint8_t GenerationBytes[BANK_HEADER_SIZE];
+	record_Writer Writer;
+	uint32_t Generation = ActiveGeneration + 1;
+
+	if (EraseBank(NewBank) != ERASE_SUCCESS) {
+		return false;
+	}
+
+	/*Only the latest record of every id is copied, the others are superseded by it*/
+	for (Record = BankStart(ActiveBank) + BANK_HEADER_SIZE; Record < AppendAddr;
+			Record = Record + *(uint16_t*) Record) {
+		if (!RecordComplete(Record)
+				|| LatestRecord(ReadWord(Record + RECORD_ID_OFFSET)) != Record) {
+			continue;
+		}
+		Writer.Address = (uint32_t) NewRecord;
+		Writer.Count = 0;
+		if (!WriterPut(&Writer, Record, *(uint16_t*) Record)) {
+			return false;
+		}
+		NewRecord = NewRecord + *(uint16_t*) Record;
+	}
+
+	GenerationBytes[0] = (uint8_t) Generation;
+	GenerationBytes[1] = (uint8_t) (Generation >> 8);
+	GenerationBytes[2] = (uint8_t) (Generation >> 16);
+	GenerationBytes[3] = (uint8_t) (Generation >> 24);
+	if (WriteBytesToFLASH(GenerationBytes, (uint32_t) BankStart(NewBank),
+	BANK_HEADER_SIZE) != FL_STORE_SUCCESS) {
+		return false;
+	}
+	ActiveBank = NewBank;
+	ActiveGeneration = Generation;
+	AppendAddr = NewRecord;
+	/*The new bank is used even if the old one is not erased, as it is erased again before it is used*/
+	EraseBank(NewBank ^ 1);
+	return true;
+}
+
+bool RelocationFollow(uint8_t **Start, uint8_t **End) {
+	uint8_t *Record, *Last;
+	uint32_t Id;
+
+	if (MarkerOf(*End) <= *Start || !MarkerId(MarkerOf(*End), &Id)) {
+		return false;
+	}
+	Record = LatestRecord(Id);
+	if (Record == 0) {
+		return false;
+	}
+	/*The object ends before the '/' which is before the size or before the padding byte*/
+	Last = Record + *(uint16_t*) Record - 3;
+	if (*Last != '/')
+		Last--;
+	*Start = Record + RECORD_OBJECT_OFFSET;
+	*End = Last - 1;
+	return true;
+}
+
+bool RelocateUpdate(microcDB_Data *FindResult, uint8_t *value, size_t len,
+		microcDB_Status *Status) {
+	uint8_t *ObjectStart, *ObjectEnd, *ValueStart, *Cut, *Resume, *SlackStart,
+			*Marker = 0, *Record;
+	uint8_t Comma = ',', MarkerBytes[RELOCATION_MARKER_SIZE];
+	uint8_t *Separator = 0;
+	uint32_t Id;
+	uint8_t i;
+
+	if (FindResult->JSON_type == JSON_OBJ) {
+		/*The member is added after the last one*/
+		ObjectStart = FindResult->DBStartptr;
+		ObjectEnd = FindResult->DBEndptr;
+		SlackStart = SlackStartOf(ObjectEnd);
+		Cut = SlackStart;
+		Resume = SlackStart;
+		if (SkipSlack(ObjectStart + 1, ObjectEnd) != ObjectEnd) {
+			Separator = &Comma;
+		}
+	} else {
+		/*The value is replaced in the object having it*/
+		ValueStart =
+				FindResult->JSON_type == JSON_STRING ?
+						FindResult->DBStartptr - 1 : FindResult->DBStartptr;
+		ObjectEnd = EnclosingEnd(ValueStart);
+		ObjectStart = EnclosingStart(ValueStart - 1);
+		if (ObjectStart == 0 || *ObjectStart != '{' || *ObjectEnd != '}') {
+			return false;
+		}
+		SlackStart = SlackStartOf(ObjectEnd);
+		if (FindResult->JSON_type == JSON_STRING && *value != '\"') {
+			Cut = FindResult->DBStartptr;
+			Resume = FindResult->DBEndptr + 1;
+		} else {
+			Cut = ValueStart;
+			Resume = SkipJSONValue(ValueStart, ObjectEnd) + 1;
+		}
+	}
+
+	if (!Relocatable(ObjectStart)) {
+		return false;
+	}
+	/*The copy of a relocated object is superseded by the next copy with its id, the other objects are forwarded by a marker*/
+	Record = RELOCATED(ObjectStart) ? RecordOf(ObjectStart) : 0;
+	if (Record != 0 && ObjectStart == Record + RECORD_OBJECT_OFFSET) {
+		Id = ReadWord(Record + RECORD_ID_OFFSET);
+	} else {
+		/*The bytes kept for the marker should be empty*/
+		Marker = MarkerOf(ObjectEnd);
+		if (Marker <= ObjectStart || Marker < SlackStart || NextId > MAX_ID) {
+			return false;
+		}
+		for (i = 0; i < RELOCATION_MARKER_SIZE; i++) {
+			if (Marker[i] != (uint8_t) FL_EMPTY_BYTE) {
+				return false;
+			}
+		}
+		Id = NextId;
+	}
+
+	*Status = WriteRecord(Id, ObjectStart, Cut, Separator, value, len, Resume,
+			SlackStart);
+	if (*Status != UPDATE_SUCCESSFUL) {
+		return *Status != NO_MEMORY; /*The caller reclaims the superseded records if the bank is full*/
+	}
+	if (Marker == 0) {
+		return true;
+	}
+
+	/*Till the marker is programmed the old object is used*/
+	NextId++;
+	MarkerBytes[0] = 0x00;
+	for (i = RELOCATION_MARKER_SIZE - 1; i > 0; i--) {
+		MarkerBytes[i] = MARKER_NIBBLE | (uint8_t) (Id & 0x0F);
+		Id = Id >> 4;
+	}
+	if (WriteBytesToFLASH(MarkerBytes, (uint32_t) Marker,
+	RELOCATION_MARKER_SIZE) != FL_STORE_SUCCESS) {
+		*Status = UPDATE_FAILED;
+	}
+	return true;
+}
+
+/*MicrocDB object relocation functions*/
+#endif
@@ -0,0 +1,468 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The source code for the schema support of MicrocDB. A schema is compiled to a fixed binary layout where each
+ *      			 field has a constant offset and type. The records are stored compactly in their own flash region so finding a
+ *      			 field of a record is a offset calculation instead of parsing.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_SCHEMA_SUPPORT == 1
+
+#define RECORD_HEADER_SIZE 2 /*Every record starts with the half word signature of the schema it was stored with*/
+#define RECORD_EMPTY_HEADER 0xFFFF
+#define RECORD_MARK_SIZE 2 /*Every record ends with the half word commit mark which is written after all its fields*/
+#define RECORD_COMMITTED 0x0000
+
+/*The types of fields which a schema can have*/
+typedef enum {
+	FIELD_U8, FIELD_I8, FIELD_U16, FIELD_I16, FIELD_U32, FIELD_I32, FIELD_F32, FIELD_BOOL, FIELD_STRING
+} schema_FieldType;
+
+/*The compiled field of the schema*/
+typedef struct {
+	uint8_t Key[MICROCDB_SCHEMA_KEY_SIZE];
+	uint8_t KeyLength;
+	schema_FieldType Type;
+	uint16_t Offset; /*Offset of the field from the start of record*/
+	uint16_t Size; /*Number of bytes of the field in record*/
+} schema_Field;
+
+static schema_Field SchemaFields[MICROCDB_SCHEMA_MAX_FIELDS];
+static uint8_t NumberOfFields = 0;
+static uint16_t RecordSize = 0; /*Size of record including header, 0 indicates no schema is registered*/
+static uint16_t SchemaSignature = RECORD_EMPTY_HEADER;
+static uint32_t RecordCount = 0;
+
+/*MISC functions*/
+
+/*
+ * This function returns the index of the field whose key is same as the chars between Start and End(both inclusive)
+ * Returns: index of field or NumberOfFields if not found
+ */
+static uint8_t GetFieldIndex(uint8_t *Start, uint8_t *End) {
+	uint8_t field, i;
+	uint16_t len = (End - Start) + 1;
+
+	for (field = 0; field < NumberOfFields; field++) {
+		if (SchemaFields[field].KeyLength != len)
+			continue;
+		for (i = 0; i < len; i++) {
+			if (SchemaFields[field].Key[i] != Start[i])
+				break;
+		}
+		if (i == len)
+			return field;
+	}
+	return NumberOfFields;
+}
+
+/*
+ * This function compiles the type string between Start and End(both inclusive) into the field.
+ * Returns: true if the type string is valid
+ */
+static bool CompileFieldType(uint8_t *Start, uint8_t *End, schema_Field *Field) {
+	uint16_t len = (End - Start) + 1;
+	int32_t size;
+
+	if (len == 2 && Start[0] == 'u' && Start[1] == '8') {
+		Field->Type = FIELD_U8;
+		Field->Size = 1;
+	} else if (len == 2 && Start[0] == 'i' && Start[1] == '8') {
+		Field->Type = FIELD_I8;
+		Field->Size = 1;
+	} else if (len == 3 && Start[1] == '1' && Start[2] == '6'
+			&& (Start[0] == 'u' || Start[0] == 'i')) {
+		Field->Type = (Start[0] == 'u') ? FIELD_U16 : FIELD_I16;
+		Field->Size = 2;
+	} else if (len == 3 && Start[1] == '3' && Start[2] == '2'
+			&& (Start[0] == 'u' || Start[0] == 'i' || Start[0] == 'f')) {
+		Field->Type =
+				(Start[0] == 'u') ?
+						FIELD_U32 : ((Start[0] == 'i') ? FIELD_I32 : FIELD_F32);
+		Field->Size = 4;
+	} else if (len == 4 && Start[0] == 'b' && Start[1] == 'o' && Start[2] == 'o'
+			&& Start[3] == 'l') {
+		Field->Type = FIELD_BOOL;
+		Field->Size = 1;
+	} else if (len > 1 && Start[0] == 's'
+			&& AsciiToInteger(Start + 1, End, &size) == true && size > 0) {
+		Field->Type = FIELD_STRING;
+		Field->Size = size;
+	} else
+		return false;
+
+	return true;
+}
+
+/*
+ * This function encodes the parsed value of the JSON into the record buffer at the offset of the field.
+ * Returns: true if the value has the type and range of the field
+ */
+static bool EncodeField(schema_Field *Field, microcDB_json_parser *Value,
+		uint8_t *Record) {
+	int32_t integer;
+	float decimal;
+	uint16_t len, i;
+	uint8_t *dest = Record + Field->Offset;
+
+	switch (Field->Type) {
+	case FIELD_BOOL:
+		if (Value->parsed_type != JSON_BOOL)
+			return false;
+		*dest = (*Value->Start == 't') ? 1 : 0;
+		return true;
+
+	case FIELD_STRING:
+		if (Value->parsed_type != JSON_STRING)
+			return false;
+		len = (Value->End + 1) - Value->Start;
+		if (len > Field->Size)
+			return false;
+		/*Copy the string and fill the remaining bytes with null*/
+		for (i = 0; i < Field->Size; i++) {
+			dest[i] = (i < len) ? Value->Start[i] : 0;
+		}
+		return true;
+
+	case FIELD_F32:
+		if (Value->parsed_type != JSON_PRIMITIVE
+				|| AsciiToFloat(Value->Start, Value->End, &decimal) != true)
+			return false;
+		dest[0] = ((uint8_t*) &decimal)[0];
+		dest[1] = ((uint8_t*) &decimal)[1];
+		dest[2] = ((uint8_t*) &decimal)[2];
+		dest[3] = ((uint8_t*) &decimal)[3];
+		return true;
+
+	default:
+		if (Value->parsed_type != JSON_PRIMITIVE
+				|| AsciiToInteger(Value->Start, Value->End, &integer) != true)
+			return false;
+		/*Check the range of integer according to the type*/
+		if ((Field->Type == FIELD_U8 && (integer < 0 || integer > 255))
+				|| (Field->Type == FIELD_I8 && (integer < -128 || integer > 127))
+				|| (Field->Type == FIELD_U16 && (integer < 0 || integer > 65535))
+				|| (Field->Type == FIELD_I16
+						&& (integer < -32768 || integer > 32767))
+				|| (Field->Type == FIELD_U32 && integer < 0))
+			return false;
+		/*Store little endian*/
+		for (i = 0; i < Field->Size; i++) {
+			dest[i] = (uint8_t) (integer >> (8 * i));
+		}
+		return true;
+	}
+}
+
+/*
+ * This function calculates the signature of the compiled layout. It is stored as header of every record so the records stored
+ * with some other schema can be detected.
+ */
+static uint16_t CalculateSignature() {
+	uint32_t hash = 2166136261u; /*FNV-1a offset basis*/
+	uint8_t field, i;
+
+	for (field = 0; field < NumberOfFields; field++) {
+		for (i = 0; i < SchemaFields[field].KeyLength; i++) {
+			hash = (hash ^ SchemaFields[field].Key[i]) * 16777619u;
+		}
+		hash = (hash ^ SchemaFields[field].Type) * 16777619u;
+		hash = (hash ^ SchemaFields[field].Size) * 16777619u;
+	}
+	hash = (hash >> 16) ^ (hash & 0xFFFF);
+	if (hash == RECORD_EMPTY_HEADER)
+		hash--; /*The header should never look like empty flash*/
+	return (uint16_t) hash;
+}
+
+/*
+ * This function returns the flash address of the record.
+ */
+static inline uint8_t* RecordAddress(uint32_t RecordIndex) {
+	return (uint8_t*) MICROCDB_SCHEMA_START_ADDR + (RecordIndex * RecordSize);
+}
+
+/*
+ * This function checks if the record was stored completely. A record whose commit mark is not written was being stored when the
+ * power was lost, it takes its index but is never found.
+ */
+static inline bool RecordCommitted(uint32_t RecordIndex) {
+	return *(uint16_t*) (RecordAddress(RecordIndex + 1) - RECORD_MARK_SIZE)
+			== RECORD_COMMITTED;
+}
+
+/*
+ * This function gives the field of query in the record. It is called again by MicrocDB_FindRecord() if the writer task wrote the
+ * records while it was read.
+ */
+static microcDB_Data RecordField(uint32_t RecordIndex, uint8_t *query) {
+	microcDB_Data data_out_struct;
+	schema_Field *Field;
+	uint8_t *keyEnd = query;
+	uint8_t field;
+
+	data_out_struct.DBstatus = NOT_FOUND;
+	data_out_struct.JSON_type = JSON_UNDEFINED;
+	data_out_struct.DBStartptr = 0;
+	data_out_struct.DBEndptr = 0;
+
+	/*Get the key from query which is till the dot*/
+	while (*keyEnd != '.') {
+		if (*keyEnd == '/') {
+			data_out_struct.DBstatus = QUERY_INVALID;
+			return data_out_struct;
+		}
+		keyEnd++;
+	}
+
+	if (RecordIndex >= RecordCount || keyEnd == query
+			|| !RecordCommitted(RecordIndex)) {
+		return data_out_struct;
+	}
+
+	field = GetFieldIndex(query, keyEnd - 1);
+	if (field == NumberOfFields) {
+		return data_out_struct;
+	}
+	Field = &SchemaFields[field];
+
+	/*The location of the field is calculated from the layout, no parsing needed*/
+	data_out_struct.DBStartptr = RecordAddress(RecordIndex) + Field->Offset;
+	data_out_struct.DBEndptr = data_out_struct.DBStartptr + Field->Size - 1;
+	data_out_struct.DBstatus = FOUND_SUCCESS;
+
+	if (Field->Type == FIELD_BOOL) {
+		data_out_struct.JSON_type = JSON_BOOL;
+	} else if (Field->Type == FIELD_STRING) {
+		data_out_struct.JSON_type = JSON_STRING;
+		/*Strings shorter than field are padded with null so point to the last char*/
+		while (data_out_struct.DBEndptr > data_out_struct.DBStartptr
+				&& *data_out_struct.DBEndptr == 0) {
+			data_out_struct.DBEndptr--;
+		}
+	} else
+		data_out_struct.JSON_type = JSON_PRIMITIVE;
+
+	return data_out_struct;
+}
+/*MISC functions*/
+/**************************************************************************************************************************************/
+
+/*MicrocDB schema functions*/
+microcDB_Status MicrocDB_RegisterSchema(uint8_t *SchemaString) {
+	microcDB_json_parser schema_parser;
+	uint8_t *key = 0;
+	uint16_t header;
+	uint8_t i;
+	size_t len;
+
+	STATS_BEGIN(STATS_OP_OTHER);
+	DEVICES_SYNC();
+
+	RecordSize = 0;
+	NumberOfFields = 0;
+
+	len = CalculateStringLength(SchemaString);
+	replacesingleTodouble(SchemaString, len);
+
+	/*Parse the schema string using the JSON parser*/
+	microcDBStartAddr = SchemaString;
+	microcDBEndAddr = SchemaString + len;
+	json_parser_init();
+
+	schema_parser = json_parse();
+	if (schema_parser.parsed_type != JSON_OBJ) {
+		return SCHEMA_INVALID;
+	}
+
+	/*The fields are laid out in the order they appear in schema after the record header*/
+	len = RECORD_HEADER_SIZE;
+
+	while (schema_parser.parsed_type != JSON_END) {
+		schema_parser = json_parse();
+
+		if (schema_parser.parsed_type == JSON_STRING) {
+			if (key == 0) {
+				/*This is a key so remember it till its type is parsed*/
+				key = schema_parser.Start;
+				if ((schema_parser.End - key) + 1 > MICROCDB_SCHEMA_KEY_SIZE
+						|| NumberOfFields >= MICROCDB_SCHEMA_MAX_FIELDS
+						|| GetFieldIndex(key, schema_parser.End)
+								!= NumberOfFields) {
+					return SCHEMA_INVALID; /*Key too long, too many fields or duplicate key*/
+				}
+				SchemaFields[NumberOfFields].KeyLength = (schema_parser.End - key)
+						+ 1;
+				for (i = 0; i < SchemaFields[NumberOfFields].KeyLength; i++) {
+					SchemaFields[NumberOfFields].Key[i] = key[i];
+				}
+			} else {
+				/*This is the type of the key*/
+				if (CompileFieldType(schema_parser.Start, schema_parser.End,
+						&SchemaFields[NumberOfFields]) != true) {
+					return SCHEMA_INVALID;
+				}
+				SchemaFields[NumberOfFields].Offset = len;
+				len = len + SchemaFields[NumberOfFields].Size;
+				NumberOfFields++;
+				key = 0;
+			}
+		} else if (schema_parser.parsed_type != JSON_UNDEFINED
+				&& schema_parser.parsed_type != JSON_END) {
+			return SCHEMA_INVALID; /*Only string types are allowed in schema*/
+		}
+	};
+
+	/*Records are written with half word access so keep the size even, the commit mark is after the fields*/
+	len = ((len + 1) & ~((size_t) 1)) + RECORD_MARK_SIZE;
+
+	if (NumberOfFields == 0 || key != 0 || len > MICROCDB_SCHEMA_MAX_RECORD_SIZE) {
+		return SCHEMA_INVALID;
+	}
+
+	RecordSize = len;
+	SchemaSignature = CalculateSignature();
+
+	/*Count the records stored in flash. All the records should have been stored with this schema. The header is written first so the
+	 records which were not completely stored are counted too*/
+	RecordCount = 0;
+	while (RecordAddress(RecordCount + 1) - 1
+			<= (uint8_t*) MICROCDB_SCHEMA_END_ADDR) {
+		header = *(uint16_t*) RecordAddress(RecordCount);
+		if (header == RECORD_EMPTY_HEADER)
+			break;
+		if (header != SchemaSignature) {
+			RecordSize = 0;
+			return SCHEMA_MISMATCH;
+		}
+		RecordCount++;
+	};
+
+	return SCHEMA_REGISTERED;
+}
+
+microcDB_Status MicrocDB_InsertRecord(uint8_t *JSONString) {
+	microcDB_json_parser record_parser;
+	uint8_t Record[MICROCDB_SCHEMA_MAX_RECORD_SIZE];
+	uint32_t FieldsPresent = 0; /*bit per field of schema to check that every field is given exactly once*/
+	uint8_t field = MICROCDB_SCHEMA_MAX_FIELDS;
+	size_t len;
+
+	STATS_BEGIN(STATS_OP_INSERT);
+	DEVICES_SYNC();
+
+	if (RecordSize == 0) {
+		return STORE_FAILED; /*No schema is registered*/
+	}
+
+	if (RecordAddress(RecordCount + 1) - 1
+			> (uint8_t*) MICROCDB_SCHEMA_END_ADDR) {
+		return FLASH_FULL;
+	}
+
+	len = CalculateStringLength(JSONString);
+	replacesingleTodouble(JSONString, len);
+
+	/*Validate and encode the JSON in one pass of the parser*/
+	microcDBStartAddr = JSONString;
+	microcDBEndAddr = JSONString + len;
+	json_parser_init();
+
+	record_parser = json_parse();
+	if (record_parser.parsed_type != JSON_OBJ) {
+		return SCHEMA_VIOLATION;
+	}
+
+	while (record_parser.parsed_type != JSON_END) {
+		record_parser = json_parse();
+
+		if (record_parser.parsed_type == JSON_UNDEFINED
+				|| record_parser.parsed_type == JSON_END)
+			continue;
+
+		if (field == MICROCDB_SCHEMA_MAX_FIELDS) {
+			/*Expecting a key*/
+			if (record_parser.parsed_type != JSON_STRING)
+				return SCHEMA_VIOLATION;
+			field = GetFieldIndex(record_parser.Start, record_parser.End);
+			if (field == NumberOfFields || (FieldsPresent & (1UL << field)))
+				return SCHEMA_VIOLATION; /*Unknown or repeated field*/
+		} else {
+			/*Expecting the value of the key*/
+			if (EncodeField(&SchemaFields[field], &record_parser, Record)
+					!= true)
+				return SCHEMA_VIOLATION;
+			FieldsPresent |= (1UL << field);
+			field = MICROCDB_SCHEMA_MAX_FIELDS;
+		}
+	};
+
+	if (FieldsPresent != ((1UL << NumberOfFields) - 1)) {
+		return SCHEMA_VIOLATION; /*Some field is missing*/
+	}
+
+	/*Pad the record to the even size with empty byte*/
+	if ((SchemaFields[NumberOfFields - 1].Offset
+			+ SchemaFields[NumberOfFields - 1].Size)
+			< RecordSize - RECORD_MARK_SIZE) {
+		Record[RecordSize - RECORD_MARK_SIZE - 1] = FL_EMPTY_BYTE;
+	}
+	Record[0] = (uint8_t) SchemaSignature;
+	Record[1] = (uint8_t) (SchemaSignature >> 8);
+	Record[RecordSize - 2] = (uint8_t) RECORD_COMMITTED;
+	Record[RecordSize - 1] = (uint8_t) (RECORD_COMMITTED >> 8);
+
+	/*The header is written first so the index is taken even if the power is lost, then the fields and the commit mark at last, so a
+	 record is found only once it is fully stored*/
+	CHANGE_BEGIN();
+	SEQ_WRITE_BEGIN();
+	RecordCount++;
+	if (WriteBytesToFLASH(Record, (uint32_t) RecordAddress(RecordCount - 1),
+	RecordSize - RECORD_MARK_SIZE) != FL_STORE_SUCCESS
+			|| WriteBytesToFLASH(Record + RecordSize - RECORD_MARK_SIZE,
+					(uint32_t) RecordAddress(RecordCount) - RECORD_MARK_SIZE,
+					RECORD_MARK_SIZE) != FL_STORE_SUCCESS) {
+		SEQ_WRITE_END();
+		return STORE_FAILED;
+	}
+	SEQ_WRITE_END();
+
+	CHANGE_EMIT(CHANGE_INSERT_RECORD, 1, 0, JSONString);
+	return STORE_SUCCESS;
+}
+
+microcDB_Data MicrocDB_FindRecord(uint32_t RecordIndex, uint8_t *query) {
+	microcDB_Data data_out_struct;
+
+	STATS_BEGIN(STATS_OP_FIND);
+	DEVICES_SYNC();
+	SEQ_READ(data_out_struct = RecordField(RecordIndex, query));
+	return data_out_struct;
+}
+
+uint32_t MicrocDB_RecordCount() {
+	return RecordCount;
+}
+
+microcDB_Status MicrocDB_EraseRecords() {
+	uint8_t *addressOfPage = (uint8_t*) MICROCDB_SCHEMA_START_ADDR;
+
+	STATS_BEGIN(STATS_OP_OTHER);
+	DEVICES_SYNC();
+
+	SEQ_WRITE_BEGIN(); /*The readers don't give the fields of the records being erased*/
+	while (addressOfPage < (uint8_t*) MICROCDB_SCHEMA_END_ADDR) {
+		if (ErasePage(addressOfPage) != ERASE_SUCCESS) {
+			SEQ_WRITE_END();
+			return INIT_FAILED;
+		}
+		addressOfPage = addressOfPage + FLASH_PAGE_SIZE;
+	}
+	RecordCount = 0;
+	SEQ_WRITE_END();
+	return INIT_CMPLT;
+}
+/*MicrocDB schema functions*/
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The single writer mode of microcDB. The writer task makes the sequence of writes odd before writing the DB and even
+ *      			 after it, so a reader which sees the same even sequence before and after its search read the DB when it was not
+ *      			 being written. The readers don't take any lock and the writer never waits for them. The ports give the memory barrier
+ *      			 and the wait of a reader while the DB is being written.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_SEQLOCK == 1
+
+#if MICROCDB_SEQLOCK_PORT == MICROCDB_PORT_FREERTOS
+#include "FreeRTOS.h"
+#include "task.h"
+/*The reader sleeps for a tick so that the writer task is run even if its priority is lower*/
+#define SEQ_WAIT() vTaskDelay(1)
+#define SEQ_BARRIER() __sync_synchronize() /*dmb on Cortex-M*/
+#define SEQ_ENTER() taskENTER_CRITICAL()
+#define SEQ_EXIT() taskEXIT_CRITICAL()
+#else
+#include <sched.h>
+#include <pthread.h>
+#define SEQ_WAIT() sched_yield()
+#define SEQ_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+static pthread_mutex_t SeqMutex = PTHREAD_MUTEX_INITIALIZER;
+#define SEQ_ENTER() pthread_mutex_lock(&SeqMutex)
+#define SEQ_EXIT() pthread_mutex_unlock(&SeqMutex)
+#endif
+
+static volatile uint32_t WriteSequence = 0; /*Odd while the writer task is writing the DB*/
+
+/*
+ * This function makes the sequence odd. Only the writer task calls it so the increment needs no atomic operation.
+ */
+void SeqWriteBegin() {
+	WriteSequence = WriteSequence + 1;
+	SEQ_BARRIER(); /*The sequence is seen odd before any byte of DB is changed*/
+}
+
+/*
+ * This function makes the sequence even again after the DB was written.
+ */
+void SeqWriteEnd() {
+	SEQ_BARRIER(); /*All the bytes of DB are written before the sequence is seen even*/
+	WriteSequence = WriteSequence + 1;
+}
+
+/*
+ * This function waits till the sequence is even and gives it.
+ */
+uint32_t SeqReadBegin() {
+	uint32_t Sequence;
+
+	Sequence = WriteSequence;
+	while (Sequence & 1) {
+		SEQ_WAIT();
+		Sequence = WriteSequence;
+	}
+	SEQ_BARRIER(); /*The DB is read only after the sequence*/
+	return Sequence;
+}
+
+/*
+ * This function checks if the sequence changed since SeqReadBegin().
+ */
+bool SeqReadRetry(uint32_t Sequence) {
+	SEQ_BARRIER(); /*The DB was read before the sequence is read again*/
+	return WriteSequence != Sequence;
+}
+
+/*
+ * This function enters the critical section. It is short so the tasks are not switched in it on FreeRTOS.
+ */
+void SeqCriticalEnter() {
+	SEQ_ENTER();
+}
+
+/*
+ * This function exits the critical section.
+ */
+void SeqCriticalExit() {
+	SEQ_EXIT();
+}
+
+/**************************************************************************************************************************************/
+/*MicrocDB single writer functions*/
+
+uint32_t MicrocDB_ReadBegin() {
+	return SeqReadBegin();
+}
+
+bool MicrocDB_ReadRetry(uint32_t Sequence) {
+	return SeqReadRetry(Sequence);
+}
+
+/*MicrocDB single writer functions*/
+#endif
@@ -0,0 +1,118 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The snapshots of microcDB. The objects which are relocated are written as new copies and the old ones are kept, so
+ *      			 the address where next copy will be written is the generation of DB. A snapshot pins the generation and its finds
+ *      			 don't see the copies written after it. While any snapshot is pinned the updates are done only by relocation so the
+ *      			 data seen by the snapshot is never changed in place, and the superseded copies are not reclaimed. Once no snapshot
+ *      			 is pinned the relocation reclaims them when its region is full.
+ *      			 Every reader task passes its own snapshot to MicrocDB_SnapshotFind() and the generation seen by the task is kept
+ *      			 per task, so in the single writer mode the readers pin and read their snapshots at the same time.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_SNAPSHOTS > 0
+
+#define SNAPSHOT_ENDED 0xFFFFFFFF
+
+static volatile uint8_t SnapshotsPinned = 0; /*The number of pinned snapshots*/
+MICROCDB_THREAD_LOCAL uint8_t *SnapshotLimit = 0;
+
+/*
+ * This function checks if any snapshot is pinned. It is used by the updates which change the objects in place.
+ */
+bool SnapshotPinned() {
+	return SnapshotsPinned != 0;
+}
+
+/*
+ * This function unpins all the snapshots as the DB seen by them was erased.
+ */
+void SnapshotsRelease() {
+	SnapshotsPinned = 0;
+}
+
+/**************************************************************************************************************************************/
+/*MicrocDB snapshot functions*/
+
+microcDB_Status MicrocDB_SnapshotBegin(microcDB_Snapshot *Snapshot) {
+	bool Pinned;
+#if MICROCDB_SEQLOCK == 1
+	uint32_t Sequence;
+#endif
+
+	STATS_BEGIN(STATS_OP_OTHER);
+	DEVICES_SYNC();
+
+#if MICROCDB_SEQLOCK == 1
+	/*The pin is counted before the sequence is checked, so a write which begins after it sees the pin and a write which was being done
+	 * during it makes the snapshot pinned again*/
+	do {
+		Sequence = SeqReadBegin();
+		SEQ_CRITICAL_ENTER();
+		Pinned = SnapshotsPinned < MICROCDB_SNAPSHOTS;
+		if (Pinned)
+			SnapshotsPinned++;
+		SEQ_CRITICAL_EXIT();
+		if (!Pinned) {
+			return NO_MEMORY;
+		}
+		Snapshot->Generation = RelocationGeneration();
+		if (!SeqReadRetry(Sequence)) {
+			break;
+		}
+		SEQ_CRITICAL_ENTER();
+		SnapshotsPinned--;
+		SEQ_CRITICAL_EXIT();
+	} while (true);
+#else
+	Pinned = SnapshotsPinned < MICROCDB_SNAPSHOTS;
+	if (!Pinned) {
+		return NO_MEMORY;
+	}
+	SnapshotsPinned++;
+	Snapshot->Generation = RelocationGeneration();
+#endif
+	return FOUND_SUCCESS;
+}
+
+microcDB_Data MicrocDB_SnapshotFind(microcDB_Snapshot *Snapshot,
+		uint8_t *query) {
+	microcDB_Data data_out_struct;
+	LATENCY_BEGIN();
+
+	STATS_BEGIN(STATS_OP_FIND);
+	DEVICES_SYNC();
+	if (UPDATE_JOB_PENDING()) {
+		/*The DB is partly shifted by the job*/
+		data_out_struct.DBstatus = UPDATE_PENDING;
+		data_out_struct.JSON_type = JSON_UNDEFINED;
+		data_out_struct.DBStartptr = 0;
+		data_out_struct.DBEndptr = 0;
+		return data_out_struct;
+	}
+	/*The snapshot which is not pinned sees the latest data*/
+	if (Snapshot->Generation != SNAPSHOT_ENDED) {
+		SnapshotLimit = (uint8_t*) Snapshot->Generation;
+	}
+	SEQ_READ(data_out_struct = FindPath(query); SLACK_COMPACT(&data_out_struct)); /*The members are copied as seen by the snapshot*/
+	SnapshotLimit = 0;
+
+	LATENCY_END(LATENCY_OP_FIND);
+	return data_out_struct;
+}
+
+void MicrocDB_SnapshotEnd(microcDB_Snapshot *Snapshot) {
+	STATS_BEGIN(STATS_OP_OTHER);
+	DEVICES_SYNC();
+
+	SEQ_CRITICAL_ENTER();
+	if (Snapshot->Generation != SNAPSHOT_ENDED && SnapshotsPinned != 0) {
+		SnapshotsPinned--;
+	}
+	SEQ_CRITICAL_EXIT();
+	Snapshot->Generation = SNAPSHOT_ENDED;
+}
+
+/*MicrocDB snapshot functions*/
+#endif
@@ -0,0 +1,48 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The engine statistics of microcDB. The counters are added by the STATS_ADD hooks in the parser, flash drivers and
+ *      the engine to the type of API call marked by STATS_BEGIN, so the cost of each type of call can be seen on target.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_STATS == 1
+
+microcDB_Stats EngineStats[STATS_OP_COUNT];
+MICROCDB_THREAD_LOCAL microcDB_StatsOp CurrentStatsOp = STATS_OP_OTHER; /*The work done outside the API calls is accounted to other*/
+
+/**************************************************************************************************************************************/
+/*MicrocDB statistics functions*/
+
+void MicrocDB_GetStats(microcDB_StatsOp Op, microcDB_Stats *Stats) {
+	uint8_t type;
+
+	if (Op < STATS_OP_COUNT) {
+		*Stats = EngineStats[Op];
+		return;
+	}
+
+	/*Sum of all the types*/
+	*Stats = EngineStats[0];
+	for (type = 1; type < STATS_OP_COUNT; type++) {
+		Stats->Calls += EngineStats[type].Calls;
+		Stats->ParserBytes += EngineStats[type].ParserBytes;
+		Stats->BracketRescans += EngineStats[type].BracketRescans;
+		Stats->PageErases += EngineStats[type].PageErases;
+		Stats->PageWrites += EngineStats[type].PageWrites;
+		Stats->WordsProgrammed += EngineStats[type].WordsProgrammed;
+		Stats->ShiftPagesMoved += EngineStats[type].ShiftPagesMoved;
+		Stats->StringLengthCalls += EngineStats[type].StringLengthCalls;
+	}
+}
+
+void MicrocDB_ResetStats() {
+	uint8_t *counter = (uint8_t*) EngineStats;
+	size_t i;
+
+	for (i = 0; i < sizeof(EngineStats); i++)
+		counter[i] = 0;
+}
+
+/*MicrocDB statistics functions*/
+#endif
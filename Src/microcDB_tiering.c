@@ -0,0 +1,768 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The tiering of microcDB. The DB is the hot tier and the top level members of its documents which are not accessed
+ *      			 recently are moved to the cold tier, which is a region in a slower and larger memory. The accesses of top level keys
+ *      			 are counted in RAM and the counts are halved periodically. A member is moved by writing it as a record of the cold
+ *      			 tier and then cutting it from DB by an update job, and a member of cold tier accessed frequently is moved back by
+ *      			 an update job which adds it to the document it was moved from. Till the job is completed the member is in both the
+ *      			 tiers and the one in DB is found first. The jobs are stepped by MicrocDB_TierStep() with MICROCDB_TIER_STEP_PAGE_OPS
+ *      			 page operations per call. The latest record of a key is its copy.
+ *      			 The region is used as two banks. When the active bank is full, the latest record of every key which is not in DB
+ *      			 is copied to the other bank which becomes active, and the old bank with the records of the members moved back or
+ *      			 moved again is erased.
+ *
+ *      			 Layout of a bank:
+ *      			 |Generation(4 bytes)|Record|Record|...|Empty|
+ *      			 Layout of a record:
+ *      			 |Size(2 bytes)|Document(2 bytes)|{"key":value}/ padded to half word|Size(2 bytes)|
+ *      			 The document is the number of the document of DB the member was moved from. The generation is written after the
+ *      			 records are copied to the bank, and the size after the document is used to check that the record was completely
+ *      			 written. A record which was not completely written is skipped by the size before it.
+ *
+ *      			 The keys of the records are added to a Bloom filter in RAM, so a query which is not in the DB and whose key was
+ *      			 never moved to the cold tier doesn't read the cold tier.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_TIERING == 1
+
+#define BANK_SIZE ((MICROCDB_COLD_END_ADDR + 1 - MICROCDB_COLD_START_ADDR) / 2)
+#define BANK_HEADER_SIZE 4
+#define RECORD_ORDINAL_OFFSET 2
+#define RECORD_DOCUMENT_OFFSET 4
+#define RECORD_KEY_OFFSET 6 /*After the '{' and the opening quote*/
+#define RECORD_OVERHEAD 6
+#define EMPTY_HALFWORD ((uint16_t)(((uint8_t)FL_EMPTY_BYTE << 8) | (uint8_t)FL_EMPTY_BYTE))
+#define EMPTY_WORD (((uint32_t)EMPTY_HALFWORD << 16) | EMPTY_HALFWORD)
+#define BLOOM_BITS (MICROCDB_TIER_BLOOM_BYTES * 8)
+#define BLOOM_HASHES 7 /*Number of bits set for every key, the best for about 10 bits of filter per key*/
+
+#define COLD_START (BankStart(ActiveBank) + BANK_HEADER_SIZE)
+#define COLD_END (BankStart(ActiveBank) + BANK_SIZE - 2) /*The last half word of the region has the flag of initialization, so it is not used in both the banks*/
+
+/*The count of recent accesses of a top level key*/
+typedef struct {
+	uint32_t Hash;
+	uint8_t *Record; /*The record of the key if it is in the cold tier, otherwise 0*/
+	uint8_t Hits; /*0 if this entry is empty*/
+} tier_Key;
+
+static tier_Key TierKeys[MICROCDB_TIER_KEYS];
+static uint8_t ActiveBank = 0; /*The bank which has the records*/
+static uint32_t ActiveGeneration = 0; /*The generation of active bank or 0 if it was never written*/
+static uint8_t *AppendAddr = (uint8_t*) MICROCDB_COLD_START_ADDR + BANK_HEADER_SIZE; /*The address where next record will be written*/
+static uint16_t Steps = 0; /*The calls of MicrocDB_TierStep() since the counts were halved*/
+static bool Aged = false; /*true once the counts were halved, before that every key looks cold*/
+#if MICROCDB_TIER_BLOOM_BYTES > 0
+static uint8_t ColdKeys[MICROCDB_TIER_BLOOM_BYTES]; /*The Bloom filter of the keys of the records*/
+#endif
+
+/*The bytes of a record are given in pieces, so they are kept till a half word is complete*/
+typedef struct {
+	uint32_t Address;
+	uint8_t HalfWord[2];
+	uint8_t Count;
+} record_Writer;
+
+/*MISC functions*/
+
+/*
+ * This function gives the first address of the bank.
+ */
+static inline uint8_t* BankStart(uint8_t Bank) {
+	return (uint8_t*) MICROCDB_COLD_START_ADDR + (Bank * BANK_SIZE);
+}
+
+/*
+ * This function erases the pages of the bank. EraseDB() is not used as it moves the FlashAddresscntr of DB.
+ * Returns: flash_mem_Stat ERASE_SUCCESS or ERASE_FAILED
+ */
+static flash_mem_Stat EraseBank(uint8_t Bank) {
+	uint32_t Page;
+
+	for (Page = 0; Page < BANK_SIZE / FLASH_PAGE_SIZE; Page++) {
+		if (ErasePage(BankStart(Bank) + (Page * FLASH_PAGE_SIZE))
+				!= ERASE_SUCCESS) {
+			return ERASE_FAILED;
+		}
+	}
+	return ERASE_SUCCESS;
+}
+
+/*
+ * This function reads a word which is aligned to half word.
+ */
+static inline uint32_t ReadWord(uint8_t *Address) {
+	return (uint32_t) *(uint16_t*) Address
+			| ((uint32_t) *(uint16_t*) (Address + 2) << 16);
+}
+
+/*
+ * This function calculates the FNV-1a hash of the Length chars of the key.
+ */
+static uint32_t KeyHash(uint8_t *Key, size_t Length) {
+	uint32_t hash = 2166136261UL;
+	while (Length--) {
+		hash = (hash ^ *Key) * 16777619UL;
+		Key++;
+	}
+	return hash;
+}
+
+#if MICROCDB_TIER_BLOOM_BYTES > 0
+/*
+ * This function checks or sets the BLOOM_HASHES bits of the hash in the Bloom filter of the keys of the records. The bits are derived
+ * from the hash by double hashing.
+ * Returns: true if all the bits are set(after setting them if Set is true)
+ */
+static bool BloomBits(uint32_t hash, bool Set) {
+	uint32_t step = (hash >> 16) | 1;
+	uint16_t bit;
+	uint8_t i;
+
+	for (i = 0; i < BLOOM_HASHES; i++) {
+		bit = (hash + i * step) % BLOOM_BITS;
+		if (Set)
+			ColdKeys[bit >> 3] |= (uint8_t) (1 << (bit & 7));
+		else if (!(ColdKeys[bit >> 3] & (1 << (bit & 7))))
+			return false;
+	}
+	return true;
+}
+#define BLOOM_ADD(hash) BloomBits(hash, true)
+#define BLOOM_HAS(hash) BloomBits(hash, false)
+#else
+#define BLOOM_ADD(hash)
+#define BLOOM_HAS(hash) true
+#endif
+
+/*
+ * This function calculates the length of the first part of query.
+ */
+static inline size_t KeyLength(uint8_t *query) {
+	size_t Length = 0;
+
+	while (query[Length] != '.' && query[Length] != '/')
+		Length++;
+	return Length;
+}
+
+/*
+ * This function checks if the record was completely written.
+ */
+static inline bool RecordComplete(uint8_t *Record) {
+	uint16_t Size = *(uint16_t*) Record;
+
+	return Size != EMPTY_HALFWORD && Size > RECORD_OVERHEAD
+			&& Record + Size <= COLD_END
+			&& *(uint16_t*) (Record + Size - 2) == Size;
+}
+
+/*
+ * This function gives the record after the record. A record which was not completely written is skipped by its size, if the size
+ * itself is not valid then the rest of the region is taken as used.
+ */
+static inline uint8_t* NextRecord(uint8_t *Record) {
+	uint16_t Size = *(uint16_t*) Record;
+
+	if (Size <= RECORD_OVERHEAD || (Size & 1) != 0 || Record + Size > COLD_END) {
+		return COLD_END;
+	}
+	return Record + Size;
+}
+
+/*
+ * This function walks the records from Record till the first empty half word.
+ * Returns: the address after the last record
+ */
+static uint8_t* RecordsEnd(uint8_t *Record) {
+	while (Record + RECORD_OVERHEAD <= COLD_END) {
+		if (*(uint16_t*) Record == EMPTY_HALFWORD) {
+			return Record;
+		}
+		Record = NextRecord(Record);
+	}
+	return COLD_END;
+}
+
+/*
+ * This function gives the '/' which ends the document of the record.
+ */
+static inline uint8_t* RecordDocumentEnd(uint8_t *Record) {
+	uint8_t *Last = Record + *(uint16_t*) Record - 3;
+
+	return *Last == '/' ? Last : Last - 1;
+}
+
+/*
+ * This function gives the key of the complete record and its length.
+ */
+static inline size_t RecordKey(uint8_t *Record, uint8_t **Key) {
+	uint8_t *Member = Record + RECORD_DOCUMENT_OFFSET + 1;
+
+	*Key = Member + 1;
+	return SkipJSONValue(Member, RecordDocumentEnd(Record)) - *Key;
+}
+
+/*
+ * This function compares the key of record with the key of given length.
+ * Returns: true if same
+ */
+static bool RecordKeyEquals(uint8_t *Record, uint8_t *Key, size_t Length) {
+	uint8_t *StoredKey = Record + RECORD_KEY_OFFSET;
+
+	while (Length != 0) {
+		if (*StoredKey != *Key)
+			return false;
+		StoredKey++;
+		Key++;
+		Length--;
+	}
+	return *StoredKey == '\"';
+}
+
+/*
+ * This function gives the latest record of the key in the cold tier.
+ * Returns: the record or 0 if the key is not in the cold tier
+ */
+static uint8_t* ColdRecord(uint8_t *Key, size_t Length) {
+	uint8_t *Record = COLD_START, *Latest = 0;
+
+	if (!BLOOM_HAS(KeyHash(Key, Length))) {
+		return 0;
+	}
+	while (Record < AppendAddr) {
+		if (RecordComplete(Record) && RecordKeyEquals(Record, Key, Length)) {
+			Latest = Record;
+		}
+		STATS_ADD(ParserBytes, Length);
+		Record = NextRecord(Record);
+	}
+	return Latest;
+}
+
+#if MICROCDB_TIER_BLOOM_BYTES > 0
+/*
+ * This function makes the Bloom filter of the keys of the complete records of active bank.
+ */
+static void BloomBuild() {
+	uint8_t *Record, *Key;
+	size_t Length;
+	uint16_t i;
+
+	for (i = 0; i < MICROCDB_TIER_BLOOM_BYTES; i++) {
+		ColdKeys[i] = 0;
+	}
+	for (Record = COLD_START; Record < AppendAddr; Record = NextRecord(Record)) {
+		if (RecordComplete(Record)) {
+			Length = RecordKey(Record, &Key);
+			BLOOM_ADD(KeyHash(Key, Length));
+		}
+	}
+}
+#define BLOOM_BUILD() BloomBuild()
+#else
+#define BLOOM_BUILD()
+#endif
+
+/*
+ * This function gives the document of DB after the one whose '}' is at DocumentEnd, or the first document if DocumentEnd is 0.
+ * Returns: the '{' of document or 0 if there are no more documents
+ */
+static uint8_t* NextDocument(uint8_t *DocumentEnd) {
+	uint8_t *Document = (uint8_t*) DB_START_ADDR, *End =
+			(uint8_t*) FlashAddresscntr;
+
+	if (DocumentEnd != 0) {
+		/*The next document is after the '/' and the padding to a word*/
+		Document = DocumentEnd + 1;
+		while (Document < End && *Document != '{')
+			Document++;
+	}
+	return (Document < End && *Document == '{') ? Document : 0;
+}
+
+/*
+ * This function gives the document of DB having the number, or the last document if DB has less documents. Its '}' is given in
+ * DocumentEnd.
+ * Returns: the '{' of document or 0 if DB is empty
+ */
+static uint8_t* NumberedDocument(uint16_t Ordinal, uint8_t **DocumentEnd) {
+	uint8_t *Document = NextDocument(0), *Next;
+
+	if (Document == 0) {
+		return 0;
+	}
+	*DocumentEnd = SkipJSONValue(Document, (uint8_t*) FlashAddresscntr);
+	while (Ordinal != 0 && (Next = NextDocument(*DocumentEnd)) != 0) {
+		Document = Next;
+		*DocumentEnd = SkipJSONValue(Document, (uint8_t*) FlashAddresscntr);
+		Ordinal--;
+	}
+	return Document;
+}
+
+/*
+ * This function checks if the key of given length is a top level key of a document of DB. The key is given as it is stored, ending
+ * with '"'.
+ */
+static bool HotKey(uint8_t *Key, size_t Length) {
+	uint8_t *Document, *ptr, *End = 0, *StoredKey;
+	size_t i;
+
+	for (Document = NextDocument(0); Document != 0;
+			Document = NextDocument(End)) {
+		End = SkipJSONValue(Document, (uint8_t*) FlashAddresscntr);
+		ptr = SkipSlack(Document + 1, End);
+		while (ptr < End && *ptr == '\"') {
+			StoredKey = ptr + 1;
+			ptr = SkipJSONValue(ptr, End);
+			if ((size_t) (ptr - StoredKey) == Length) {
+				for (i = 0; i < Length && StoredKey[i] == Key[i]; i++) {
+				}
+				if (i == Length) {
+					return true;
+				}
+			}
+			ptr = SkipJSONValue(ptr + 2, End);
+			ptr = SkipSlack(ptr + 1, End);
+			if (*ptr == ',')
+				ptr++;
+		}
+	}
+	return false;
+}
+
+/*
+ * This function gives the entry of the key in the counts. If the key is not counted then the entry with the least count is used for it.
+ */
+static tier_Key* TierEntry(uint32_t Hash) {
+	tier_Key *Coldest = &TierKeys[0];
+	uint16_t i;
+
+	for (i = 0; i < MICROCDB_TIER_KEYS; i++) {
+		if (TierKeys[i].Hits != 0 && TierKeys[i].Hash == Hash) {
+			return &TierKeys[i];
+		}
+		if (TierKeys[i].Hits < Coldest->Hits) {
+			Coldest = &TierKeys[i];
+		}
+	}
+	Coldest->Hash = Hash;
+	Coldest->Record = 0;
+	Coldest->Hits = 0;
+	return Coldest;
+}
+
+/*
+ * This function gives the count of recent accesses of the key in DB.
+ */
+static uint8_t HotHits(uint32_t Hash) {
+	uint16_t i;
+
+	for (i = 0; i < MICROCDB_TIER_KEYS; i++) {
+		if (TierKeys[i].Hits != 0 && TierKeys[i].Hash == Hash
+				&& TierKeys[i].Record == 0) {
+			return TierKeys[i].Hits;
+		}
+	}
+	return 0;
+}
+
+/*
+ * This function counts the access of the key.
+ */
+static inline tier_Key* CountAccess(uint32_t Hash, uint8_t *Record) {
+	tier_Key *Entry = TierEntry(Hash);
+
+	if (Entry->Hits != 0xFF)
+		Entry->Hits++;
+	Entry->Record = Record;
+	return Entry;
+}
+
+/*
+ * This function halves the counts after every MICROCDB_TIER_AGE_STEPS calls of MicrocDB_TierStep().
+ */
+static void Age() {
+	uint16_t i;
+
+	Steps++;
+	if (Steps < MICROCDB_TIER_AGE_STEPS) {
+		return;
+	}
+	Steps = 0;
+	Aged = true;
+	for (i = 0; i < MICROCDB_TIER_KEYS; i++) {
+		TierKeys[i].Hits = TierKeys[i].Hits >> 1;
+	}
+}
+
+/*
+ * This function writes the bytes after the bytes written before by the writer.
+ * Returns: true if written
+ */
+static bool WriterPut(record_Writer *Writer, uint8_t *Bytes, size_t Count) {
+	while (Count != 0) {
+		Writer->HalfWord[Writer->Count++] = *Bytes;
+		if (Writer->Count == 2) {
+			Writer->Count = 0;
+			if (WriteBytesToFLASH(Writer->HalfWord, Writer->Address, 2)
+					!= FL_STORE_SUCCESS) {
+				return false;
+			}
+			Writer->Address = Writer->Address + 2;
+		}
+		Bytes++;
+		Count--;
+	}
+	return true;
+}
+
+/*
+ * This function writes the member from Member till MemberEnd(inclusive) of the document having the number as the document of a record at
+ * AppendAddr and moves the AppendAddr after it. If writing failed then AppendAddr is moved after the bytes written, so the record is
+ * skipped.
+ * Returns: microcDB_Status UPDATE_SUCCESSFUL, UPDATE_FAILED or NO_MEMORY
+ */
+static microcDB_Status WriteRecord(uint8_t *Member, uint8_t *MemberEnd,
+		uint16_t Ordinal) {
+	record_Writer Writer;
+	uint32_t Size = RECORD_OVERHEAD + (MemberEnd + 1 - Member) + 3;
+	uint8_t SizeBytes[2], OrdinalBytes[2] = { (uint8_t) Ordinal,
+			(uint8_t) (Ordinal >> 8) }, Braces[3] = { '{', '}', '/' };
+
+	Size = Size + (Size & 1);
+	if (Size > EMPTY_HALFWORD - 1 || AppendAddr + Size > COLD_END) {
+		return NO_MEMORY;
+	}
+	SizeBytes[0] = (uint8_t) Size;
+	SizeBytes[1] = (uint8_t) (Size >> 8);
+	Writer.Address = (uint32_t) AppendAddr + RECORD_DOCUMENT_OFFSET;
+	Writer.Count = 0;
+
+	if (WriteBytesToFLASH(SizeBytes, (uint32_t) AppendAddr, 2)
+			!= FL_STORE_SUCCESS
+			|| WriteBytesToFLASH(OrdinalBytes,
+					(uint32_t) AppendAddr + RECORD_ORDINAL_OFFSET, 2)
+					!= FL_STORE_SUCCESS
+			|| !WriterPut(&Writer, Braces, 1)
+			|| !WriterPut(&Writer, Member, MemberEnd + 1 - Member)
+			|| !WriterPut(&Writer, Braces + 1, 2)) {
+		AppendAddr = RecordsEnd(AppendAddr);
+		return UPDATE_FAILED;
+	}
+	/*Write the odd byte padded with the empty byte*/
+	if (Writer.Count == 1) {
+		if (WriteBytesToFLASH(Writer.HalfWord, Writer.Address, 1)
+				!= FL_STORE_SUCCESS) {
+			AppendAddr = RecordsEnd(AppendAddr);
+			return UPDATE_FAILED;
+		}
+		Writer.Address = Writer.Address + 2;
+	}
+	if (WriteBytesToFLASH(SizeBytes, Writer.Address, 2) != FL_STORE_SUCCESS) {
+		AppendAddr = RecordsEnd(AppendAddr);
+		return UPDATE_FAILED;
+	}
+	BLOOM_ADD(KeyHash(Member + 1, SkipJSONValue(Member, MemberEnd) - (Member + 1)));
+	AppendAddr = AppendAddr + Size;
+	return UPDATE_SUCCESSFUL;
+}
+
+/*
+ * This function copies the latest record of every key which is not in DB to the other bank, which becomes active, and erases the old
+ * bank. It is called when no job is pending so the keys found in DB are not being moved. The counted records are moved to their copies
+ * or cleared if they were not copied.
+ * Returns: true if reclaimed
+ */
+static bool Reclaim() {
+	uint8_t NewBank = ActiveBank ^ 1;
+	uint8_t *Record, *NewRecord = BankStart(NewBank) + BANK_HEADER_SIZE, *Key;
+	uint8_t GenerationBytes[BANK_HEADER_SIZE];
+	record_Writer Writer;
+	uint32_t Generation = ActiveGeneration + 1;
+	size_t Length;
+	uint16_t i;
+
+	if (EraseBank(NewBank) != ERASE_SUCCESS) {
+		return false;
+	}
+
+	/*The older records of a key are superseded by its latest one, and the records of keys in DB by the members moved back*/
+	for (Record = COLD_START; Record < AppendAddr; Record = NextRecord(Record)) {
+		if (!RecordComplete(Record)) {
+			continue;
+		}
+		Length = RecordKey(Record, &Key);
+		if (ColdRecord(Key, Length) != Record || HotKey(Key, Length)) {
+			continue;
+		}
+		Writer.Address = (uint32_t) NewRecord;
+		Writer.Count = 0;
+		if (!WriterPut(&Writer, Record, *(uint16_t*) Record)) {
+			return false;
+		}
+		NewRecord = NewRecord + *(uint16_t*) Record;
+	}
+
+	GenerationBytes[0] = (uint8_t) Generation;
+	GenerationBytes[1] = (uint8_t) (Generation >> 8);
+	GenerationBytes[2] = (uint8_t) (Generation >> 16);
+	GenerationBytes[3] = (uint8_t) (Generation >> 24);
+	if (WriteBytesToFLASH(GenerationBytes, (uint32_t) BankStart(NewBank),
+	BANK_HEADER_SIZE) != FL_STORE_SUCCESS) {
+		return false;
+	}
+	ActiveBank = NewBank;
+	ActiveGeneration = Generation;
+	AppendAddr = NewRecord;
+	BLOOM_BUILD();
+
+	/*The old records are still readable till the old bank is erased*/
+	for (i = 0; i < MICROCDB_TIER_KEYS; i++) {
+		if (TierKeys[i].Record != 0) {
+			Length = RecordKey(TierKeys[i].Record, &Key);
+			TierKeys[i].Record = ColdRecord(Key, Length);
+		}
+	}
+	/*The new bank is used even if the old one is not erased, as it is erased again before it is used*/
+	EraseBank(NewBank ^ 1);
+	return true;
+}
+
+/*
+ * This function does at most MICROCDB_TIER_STEP_PAGE_OPS page operations of the journaled job, so a call of MicrocDB_TierStep()
+ * takes a bounded time. The key index is built again once the job is completed as it added or removed a top level key.
+ * Returns: microcDB_Status UPDATE_SUCCESSFUL if the job is completed, UPDATE_PENDING or UPDATE_FAILED, then the job is still pending
+ */
+static microcDB_Status StepJob() {
+	microcDB_UpdateJob Job;
+	microcDB_Status status = MicrocDB_UpdateStep(&Job,
+	MICROCDB_TIER_STEP_PAGE_OPS);
+
+	if (status == UPDATE_SUCCESSFUL) {
+		KEY_INDEX_BUILD();
+	}
+	return status;
+}
+
+/*
+ * This function moves the member of cold tier which was accessed MICROCDB_TIER_PROMOTE_HITS times recently back to the document of
+ * DB it was moved from, if it fits in MICROCDB_TIER_HOT_BYTES.
+ * Returns: microcDB_Status UPDATE_SUCCESSFUL, UPDATE_PENDING, UPDATE_FAILED or NOT_FOUND if no member is moved
+ */
+static microcDB_Status Promote() {
+	uint8_t *Document, *DocumentEnd, *Member, *MemberEnd, *Key;
+	uint8_t Comma = ',', *Separator;
+	microcDB_UpdateJob Job;
+	microcDB_Status status;
+	size_t Length;
+	uint16_t i;
+
+	if (NextDocument(0) == 0) {
+		return NOT_FOUND; /*DB is empty*/
+	}
+	for (i = 0; i < MICROCDB_TIER_KEYS; i++) {
+		if (TierKeys[i].Record == 0
+				|| TierKeys[i].Hits < MICROCDB_TIER_PROMOTE_HITS) {
+			continue;
+		}
+		Member = TierKeys[i].Record + RECORD_DOCUMENT_OFFSET + 1;
+		MemberEnd = RecordDocumentEnd(TierKeys[i].Record) - 2;
+		Length = RecordKey(TierKeys[i].Record, &Key);
+
+		/*The counted record may be older than the latest one of key, or the key may still be in DB if the job cutting it was lost*/
+		if (ColdRecord(Key, Length) != TierKeys[i].Record
+				|| HotKey(Key, Length)) {
+			TierKeys[i].Record = 0;
+			continue;
+		}
+		if (FlashAddresscntr - DB_START_ADDR + (MemberEnd + 2 - Member)
+				> MICROCDB_TIER_HOT_BYTES) {
+			continue;
+		}
+
+		/*The member is added as the last member of its document, or of the last document if its document is not in DB*/
+		Document = NumberedDocument(
+				*(uint16_t*) (TierKeys[i].Record + RECORD_ORDINAL_OFFSET),
+				&DocumentEnd);
+		Separator = (SkipSlack(Document + 1, DocumentEnd) != DocumentEnd) ?
+				&Comma : 0;
+		status = UpdateJobBegin(DocumentEnd - (uint8_t*) DB_START_ADDR,
+				DocumentEnd - (uint8_t*) DB_START_ADDR, Separator, Member,
+				MemberEnd + 1 - Member, &Job);
+		if (status == NO_MEMORY) {
+			TierKeys[i].Hits = 0; /*It is kept in the cold tier*/
+			continue;
+		}
+		if (status != UPDATE_PENDING) {
+			return status;
+		}
+		TierKeys[i].Record = 0;
+		return StepJob();
+	}
+	return NOT_FOUND;
+}
+
+/*
+ * This function moves the first top level member of the documents of DB which wasn't accessed recently to the cold tier. If the cold
+ * tier is full then it is reclaimed first.
+ * Returns: microcDB_Status UPDATE_SUCCESSFUL, UPDATE_PENDING, UPDATE_FAILED, NO_MEMORY or NOT_FOUND if no member is moved
+ */
+static microcDB_Status Demote() {
+	uint8_t *Document, *End = 0, *ptr, *Member, *Value, *PreviousEnd;
+	microcDB_UpdateJob Job;
+	microcDB_Status status;
+	uint32_t Cut, CutEnd;
+	uint16_t Ordinal = 0;
+
+	for (Document = NextDocument(0); Document != 0;
+			Document = NextDocument(End), Ordinal++) {
+		End = SkipJSONValue(Document, (uint8_t*) FlashAddresscntr);
+		STATS_ADD(ParserBytes, End - Document + 1);
+
+		PreviousEnd = 0;
+		ptr = SkipSlack(Document + 1, End);
+		while (ptr < End && *ptr == '\"') {
+			Member = ptr;
+			ptr = SkipJSONValue(ptr, End);
+			Value = ptr + 2; /*Skip the ending quote and ':'*/
+			if (HotHits(KeyHash(Member + 1, ptr - (Member + 1))) != 0) {
+				PreviousEnd = SkipJSONValue(Value, End);
+				ptr = SkipSlack(PreviousEnd + 1, End);
+				if (*ptr == ',')
+					ptr++;
+				continue;
+			}
+
+			/*The member is cut with the comma after it, or before it if it is the last one*/
+			ptr = SkipJSONValue(Value, End);
+			Cut = Member - (uint8_t*) DB_START_ADDR;
+			CutEnd = (ptr + 1) - (uint8_t*) DB_START_ADDR;
+			if (*SkipSlack(ptr + 1, End) == ',') {
+				CutEnd = (SkipSlack(ptr + 1, End) + 1)
+						- (uint8_t*) DB_START_ADDR;
+			} else if (PreviousEnd != 0) {
+				Cut = (PreviousEnd + 1) - (uint8_t*) DB_START_ADDR;
+			}
+
+			status = WriteRecord(Member, ptr, Ordinal);
+			if (status == NO_MEMORY && Reclaim()) {
+				status = WriteRecord(Member, ptr, Ordinal);
+			}
+			if (status != UPDATE_SUCCESSFUL) {
+				return status;
+			}
+			status = UpdateJobBegin(Cut, CutEnd, 0, 0, 0, &Job);
+			if (status != UPDATE_PENDING) {
+				return status;
+			}
+			return StepJob();
+		}
+	}
+	return NOT_FOUND;
+}
+
+/*MISC functions*/
+
+/**************************************************************************************************************************************/
+/*MicrocDB tiering functions*/
+
+void TierInit() {
+	uint32_t Generation0 = ReadWord(BankStart(0)), Generation1 = ReadWord(
+			BankStart(1));
+
+	/*The bank written last is active. If power was lost before the old bank was erased then both have a generation*/
+	ActiveBank = (Generation1 != EMPTY_WORD
+			&& (Generation0 == EMPTY_WORD || Generation1 > Generation0)) ?
+			1 : 0;
+	ActiveGeneration = ActiveBank == 1 ? Generation1 :
+						Generation0 == EMPTY_WORD ? 0 : Generation0;
+	AppendAddr = RecordsEnd(COLD_START);
+	BLOOM_BUILD();
+}
+
+flash_mem_Stat TierErase() {
+	uint16_t i;
+
+	for (i = 0; i < MICROCDB_TIER_KEYS; i++) {
+		TierKeys[i].Hits = 0;
+	}
+	ActiveBank = 0;
+	ActiveGeneration = 0;
+	AppendAddr = COLD_START;
+#if MICROCDB_TIER_BLOOM_BYTES > 0
+	for (i = 0; i < MICROCDB_TIER_BLOOM_BYTES; i++) {
+		ColdKeys[i] = 0;
+	}
+#endif
+	if (EraseBank(0) != ERASE_SUCCESS) {
+		return ERASE_FAILED;
+	}
+	return EraseBank(1);
+}
+
+void TierTouch(uint8_t *query) {
+	CountAccess(KeyHash(query, KeyLength(query)), 0);
+}
+
+microcDB_Data TierFind(uint8_t *query) {
+	microcDB_Data data_out_struct;
+	size_t Length = KeyLength(query);
+	uint8_t *Record = ColdRecord(query, Length);
+
+	if (Record == 0) {
+		data_out_struct.DBstatus = NOT_FOUND;
+		data_out_struct.JSON_type = JSON_UNDEFINED;
+		data_out_struct.DBStartptr = 0;
+		data_out_struct.DBEndptr = 0;
+		return data_out_struct;
+	}
+	data_out_struct = FindInDocument(query, Record + RECORD_DOCUMENT_OFFSET,
+			RecordDocumentEnd(Record));
+	if (data_out_struct.DBstatus == FOUND_SUCCESS) {
+		CountAccess(KeyHash(query, Length), Record);
+	}
+	return data_out_struct;
+}
+
+bool TierCold(uint8_t *path) {
+	size_t Length = KeyLength(path);
+	uint8_t *Record = ColdRecord(path, Length);
+	tier_Key *Entry;
+
+	if (Record == 0) {
+		return false;
+	}
+	Entry = CountAccess(KeyHash(path, Length), Record);
+	if (Entry->Hits < MICROCDB_TIER_PROMOTE_HITS)
+		Entry->Hits = MICROCDB_TIER_PROMOTE_HITS;
+	return true;
+}
+
+microcDB_Status MicrocDB_TierStep() {
+	microcDB_Status status;
+
+	STATS_BEGIN(STATS_OP_OTHER);
+	DEVICES_SYNC();
+
+	/*The job whose page operations were not completed is continued first*/
+	if (UpdateJobPending()) {
+		return StepJob();
+	}
+
+	Age();
+	status = Promote();
+	if (status != NOT_FOUND) {
+		return status;
+	}
+	if (Aged && FlashAddresscntr - DB_START_ADDR > MICROCDB_TIER_HOT_BYTES) {
+		return Demote();
+	}
+	return NOT_FOUND;
+}
+
+/*MicrocDB tiering functions*/
+#endif
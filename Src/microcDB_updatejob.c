@@ -0,0 +1,391 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The update jobs of microcDB. An update which shifts the DB is done as a job of page operations so that a call
+ *      			 takes a bounded time. The bytes which are inserted in DB and the offsets where they replace the old bytes are
+ *      			 journaled first, then every page from the one having the update till the end of DB is rewritten in an order in
+ *      			 which the old bytes needed by the remaining pages are not yet overwritten. That is from the last page when DB grows
+ *      			 and from the first page when it shrinks. A page is rewritten by two operations, its new bytes are written to the
+ *      			 backup page and then the page is erased and written from the backup. Both are marked in the journal, so the job
+ *      			 pending when power was lost is continued from the marks by MicrocDB_Init().
+ *
+ *      			 Layout of the journal page:
+ *      			 |Magic(2 bytes)|Length(2 bytes)|Cut(4 bytes)|CutEnd(4 bytes)|OldEnd(4 bytes)|Inserted bytes padded to half word|
+ *      			 |Backup mark(2 bytes)|Page mark(2 bytes)|...|
+ *      			 The offsets are from MICROCDB_START_ADDR. The inserted bytes replace the old bytes from Cut till CutEnd(exclusive) and
+ *      			 OldEnd is the end of DB before the update. The magic is written after all the other bytes so a journal whose writing
+ *      			 was interrupted is not a job.
+ * */
+
+#include <microcDB_internal.h>
+
+#if MICROCDB_UPDATE_JOBS == 1
+
+#define JOB_MAGIC 0x4A0B
+#define JOB_LENGTH_OFFSET 2
+#define JOB_CUT_OFFSET 4
+#define JOB_CUTEND_OFFSET 8
+#define JOB_OLDEND_OFFSET 12
+#define JOB_HEADER_SIZE 16
+#define JOB_MARKS_PER_PAGE 2
+#define EMPTY_HALFWORD ((uint16_t)(((uint8_t)FL_EMPTY_BYTE << 8) | (uint8_t)FL_EMPTY_BYTE))
+
+#define JOURNAL_PAGE ((uint8_t*) MICROCDB_JOB_START_ADDR)
+#define BACKUP_PAGE ((uint8_t*) MICROCDB_JOB_START_ADDR + PAGE_SIZE)
+
+/*The job read from the journal*/
+typedef struct {
+	uint32_t Cut; /*The offset of first replaced old byte*/
+	uint32_t CutEnd; /*The offset after the last replaced old byte*/
+	uint32_t OldEnd; /*The end of DB before the update*/
+	uint32_t NewEnd; /*The end of DB after the update*/
+	uint16_t Length; /*The number of inserted bytes*/
+	uint16_t FirstPage; /*The first page which is rewritten*/
+	uint16_t Pages; /*The number of pages rewritten*/
+	uint8_t *Inserted; /*The inserted bytes in journal*/
+	uint8_t *Marks; /*The marks of the page operations in journal*/
+} job_Journal;
+
+/*MISC functions*/
+
+/*
+ * This function calculates the pages rewritten by the job from its offsets.
+ */
+static void JobPages(job_Journal *Job) {
+	uint32_t End = Job->NewEnd > Job->OldEnd ? Job->NewEnd : Job->OldEnd;
+
+	/*If the size of DB is not changed then only the pages having the inserted bytes are changed*/
+	if (Job->NewEnd == Job->OldEnd) {
+		End = Job->Cut + (Job->Length != 0 ? Job->Length : 1);
+	}
+
+	Job->FirstPage = Job->Cut / PAGE_SIZE;
+	Job->Pages = ((End - 1) / PAGE_SIZE) + 1 - Job->FirstPage;
+	Job->Marks = JOURNAL_PAGE + JOB_HEADER_SIZE + Job->Length
+			+ (Job->Length & 1);
+}
+
+/*
+ * This function reads the job from the journal.
+ * Returns: false if no job is journaled
+ */
+static bool ReadJournal(job_Journal *Job) {
+	if (*(uint16_t*) JOURNAL_PAGE != JOB_MAGIC) {
+		return false;
+	}
+	Job->Length = *(uint16_t*) (JOURNAL_PAGE + JOB_LENGTH_OFFSET);
+	Job->Cut = *(uint32_t*) (JOURNAL_PAGE + JOB_CUT_OFFSET);
+	Job->CutEnd = *(uint32_t*) (JOURNAL_PAGE + JOB_CUTEND_OFFSET);
+	Job->OldEnd = *(uint32_t*) (JOURNAL_PAGE + JOB_OLDEND_OFFSET);
+	Job->NewEnd = Job->OldEnd + Job->Length - (Job->CutEnd - Job->Cut);
+	Job->Inserted = JOURNAL_PAGE + JOB_HEADER_SIZE;
+	JobPages(Job);
+	return true;
+}
+
+/*
+ * This function counts the page operations of the job which are marked done.
+ */
+static uint32_t OperationsDone(job_Journal *Job) {
+	uint32_t Done = 0;
+
+	while (Done < (uint32_t) Job->Pages * JOB_MARKS_PER_PAGE
+			&& *(uint16_t*) (Job->Marks + (2 * Done)) != EMPTY_HALFWORD)
+		Done++;
+	return Done;
+}
+
+/*
+ * This function gives the address of the page which is rewritten by the job at given number. The pages are rewritten from the last
+ * when DB grows and from the first when it shrinks.
+ */
+static uint8_t* JobPageAddress(job_Journal *Job, uint16_t Number) {
+	uint16_t Page;
+
+	if (Job->NewEnd >= Job->OldEnd) {
+		Page = Job->FirstPage + Job->Pages - 1 - Number;
+	} else {
+		Page = Job->FirstPage + Number;
+	}
+	return (uint8_t*) DB_START_ADDR + ((uint32_t) Page * PAGE_SIZE);
+}
+
+/*
+ * This function gives the byte at the offset of DB after the update. The old bytes are read from DB which still has them as the
+ * pages having them are not rewritten yet.
+ */
+static uint8_t NewByte(job_Journal *Job, uint32_t Offset) {
+	if (Offset < Job->Cut) {
+		return *((uint8_t*) DB_START_ADDR + Offset);
+	} else if (Offset < Job->Cut + Job->Length) {
+		return Job->Inserted[Offset - Job->Cut];
+	} else if (Offset < Job->NewEnd) {
+		return *((uint8_t*) DB_START_ADDR + Offset - Job->Cut - Job->Length
+				+ Job->CutEnd);
+	} else if (Offset < Job->OldEnd) {
+		return FL_EMPTY_BYTE; /*The DB has shrunk*/
+	}
+	return *((uint8_t*) DB_START_ADDR + Offset); /*Keep the bytes after DB like the flag of initialization*/
+}
+
+/*
+ * This function marks the page operation done in journal.
+ * Returns: true if marked
+ */
+static inline bool MarkDone(job_Journal *Job, uint32_t Operation) {
+	uint8_t Mark[2] = { (uint8_t) ~FL_EMPTY_BYTE, (uint8_t) ~FL_EMPTY_BYTE };
+
+	return WriteBytesToFLASH(Mark, (uint32_t) (Job->Marks + (2 * Operation)),
+			2) == FL_STORE_SUCCESS;
+}
+
+/*
+ * This function does the next page operation of the job. It writes the new bytes of the page to the backup page or it writes the
+ * page from the backup page.
+ * Returns: true if done
+ */
+static bool DoOperation(job_Journal *Job, uint32_t Operation) {
+	uint32_t NewPage[PAGE_SIZE / 4]; /*Words as it is written by WritePage()*/
+	uint8_t *NewBytes = (uint8_t*) NewPage;
+	uint8_t *Page = JobPageAddress(Job, Operation / JOB_MARKS_PER_PAGE);
+	uint32_t Offset = Page - (uint8_t*) DB_START_ADDR;
+	uint16_t i;
+
+	if ((Operation % JOB_MARKS_PER_PAGE) == 0) {
+		for (i = 0; i < PAGE_SIZE; i++) {
+			NewBytes[i] = NewByte(Job, Offset + i);
+		}
+		if (ErasePage(BACKUP_PAGE) != ERASE_SUCCESS
+				|| WritePage(NewPage, (uint32_t*) BACKUP_PAGE,
+				PAGE_SIZE) != FL_STORE_SUCCESS) {
+			return false;
+		}
+	} else {
+		if (ErasePage(Page) != ERASE_SUCCESS
+				|| WritePage((uint32_t*) BACKUP_PAGE, (uint32_t*) Page,
+				PAGE_SIZE) != FL_STORE_SUCCESS) {
+			return false;
+		}
+		STATS_ADD(ShiftPagesMoved, 1);
+	}
+	return MarkDone(Job, Operation);
+}
+
+/*
+ * This function completes the job whose pages are all rewritten by erasing the journal.
+ * Returns: true if completed
+ */
+static bool CompleteJob(job_Journal *Job) {
+	if (ErasePage(JOURNAL_PAGE) != ERASE_SUCCESS) {
+		return false;
+	}
+	/*Objects are inserted from a word*/
+	FlashAddresscntr = DB_START_ADDR + Job->NewEnd
+			+ ((4 - (Job->NewEnd & 3)) & 3);
+	/*The values after the updated one were shifted*/
+	KEY_INDEX_SHIFT((uint8_t*) DB_START_ADDR + Job->Cut,
+			(int32_t) (Job->NewEnd - Job->OldEnd));
+	HASH_INDEX_SHIFT((uint8_t*) DB_START_ADDR + Job->Cut,
+			(int32_t) (Job->NewEnd - Job->OldEnd));
+	return true;
+}
+
+/*
+ * This function checks if the journal page is empty. A journal whose writing was interrupted has no magic but has other bytes written.
+ */
+static bool JournalEmpty() {
+	uint16_t i;
+
+	for (i = 0; i < PAGE_SIZE; i = i + 2) {
+		if (*(uint16_t*) (JOURNAL_PAGE + i) != EMPTY_HALFWORD) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * This function writes the journal of job. The magic is written last so the job is pending only when the journal is complete.
+ * Returns: true if written
+ */
+static bool WriteJournal(job_Journal *Job, uint8_t *Separator, uint8_t *value) {
+	uint32_t JournalWords[PAGE_SIZE / 4]; /*Words so the offsets in it are aligned*/
+	uint8_t *Journal = (uint8_t*) JournalWords;
+	uint16_t i = JOB_HEADER_SIZE;
+
+	*(uint16_t*) (Journal + JOB_LENGTH_OFFSET) = Job->Length;
+	*(uint32_t*) (Journal + JOB_CUT_OFFSET) = Job->Cut;
+	*(uint32_t*) (Journal + JOB_CUTEND_OFFSET) = Job->CutEnd;
+	*(uint32_t*) (Journal + JOB_OLDEND_OFFSET) = Job->OldEnd;
+	if (Separator != 0) {
+		Journal[i++] = *Separator;
+	}
+	while (i < JOB_HEADER_SIZE + Job->Length) {
+		Journal[i++] = *value;
+		value++;
+	}
+	*(uint16_t*) Journal = JOB_MAGIC;
+
+	if (!JournalEmpty() && ErasePage(JOURNAL_PAGE) != ERASE_SUCCESS) {
+		return false;
+	}
+	return WriteBytesToFLASH(Journal + JOB_LENGTH_OFFSET,
+			(uint32_t) JOURNAL_PAGE + JOB_LENGTH_OFFSET,
+			i - JOB_LENGTH_OFFSET) == FL_STORE_SUCCESS
+			&& WriteBytesToFLASH(Journal, (uint32_t) JOURNAL_PAGE, 2)
+					== FL_STORE_SUCCESS;
+}
+
+/*MISC functions*/
+
+bool UpdateJobPending() {
+	return *(uint16_t*) JOURNAL_PAGE == JOB_MAGIC;
+}
+
+bool UpdateJobResume() {
+	job_Journal Job;
+	uint32_t Operation;
+
+	if (!ReadJournal(&Job)) {
+		return true;
+	}
+	for (Operation = OperationsDone(&Job);
+			Operation < (uint32_t) Job.Pages * JOB_MARKS_PER_PAGE;
+			Operation++) {
+		if (!DoOperation(&Job, Operation)) {
+			return false;
+		}
+	}
+	if (ErasePage(JOURNAL_PAGE) != ERASE_SUCCESS) {
+		return false;
+	}
+	/*The FlashAddresscntr and key index are set by Init after this. The slots of the hash index moved before power was lost are
+	 * moved again, they are stale then and are dropped by the lookups*/
+	HASH_INDEX_SHIFT((uint8_t*) DB_START_ADDR + Job.Cut,
+			(int32_t) (Job.NewEnd - Job.OldEnd));
+	return true;
+}
+
+microcDB_Status UpdateJobBegin(uint32_t Cut, uint32_t CutEnd,
+		uint8_t *Separator, uint8_t *value, uint16_t len,
+		microcDB_UpdateJob *Job) {
+	job_Journal Journal;
+
+	Journal.Cut = Cut;
+	Journal.CutEnd = CutEnd;
+	Journal.Length = len + (Separator != 0 ? 1 : 0);
+	Journal.OldEnd = FlashAddresscntr - DB_START_ADDR;
+	Journal.NewEnd = Journal.OldEnd + Journal.Length
+			- (Journal.CutEnd - Journal.Cut);
+	JobPages(&Journal);
+
+	if (DB_START_ADDR + Journal.NewEnd + 3 > DB_END_ADDR
+			|| Journal.Marks + (Journal.Pages * JOB_MARKS_PER_PAGE * 2)
+					> JOURNAL_PAGE + PAGE_SIZE) {
+		return NO_MEMORY;
+	}
+	if (!WriteJournal(&Journal, Separator, value)) {
+		return UPDATE_FAILED;
+	}
+
+	Job->PagesDone = 0;
+	Job->Pages = Journal.Pages;
+	return UPDATE_PENDING;
+}
+
+microcDB_Status MicrocDB_UpdateBegin(uint8_t *path, uint8_t *value,
+		microcDB_UpdateJob *Job) {
+	microcDB_Data FindResult;
+	uint8_t Comma = ',', *Separator = 0, *Inside;
+	uint32_t Cut, CutEnd;
+	microcDB_Status status;
+
+	STATS_BEGIN(STATS_OP_UPDATE);
+	DEVICES_SYNC();
+
+	if (UpdateJobPending()) {
+		return UPDATE_FAILED;
+	}
+	if (SNAPSHOT_PINNED()) {
+		return SNAPSHOT_CONFLICT;
+	}
+
+	FindResult = FindPath(path);
+	if (FindResult.DBstatus != FOUND_SUCCESS) {
+		return TIER_COLD(path) ? DATA_IS_COLD : PATH_NOT_FOUND;
+	}
+	if (FindResult.JSON_type == JSON_ARRAY) {
+		return DATA_IS_ARRAY;
+	}
+	/*The relocated objects are not in the region of DB so they can't be shifted*/
+	if (RELOCATED(FindResult.DBStartptr)) {
+		return NO_MEMORY;
+	}
+
+	/*if strings are passed then replace ' to \"*/
+	if (*value == '\'') {
+		replacesingleTodouble(value, CalculateStringLength(value));
+	}
+
+	if (FindResult.JSON_type == JSON_OBJ) {
+		/*The value is added as the last member of object so the comma is needed only if there is something in the object*/
+		Cut = FindResult.DBEndptr - (uint8_t*) DB_START_ADDR;
+		CutEnd = Cut;
+		Inside = SkipSlack(FindResult.DBStartptr + 1, FindResult.DBEndptr);
+		if (Inside != FindResult.DBEndptr) {
+			Separator = &Comma;
+		}
+	} else if (FindResult.JSON_type == JSON_STRING && *value == '\"') {
+		/*The quoted string replaces the old string with its quotes*/
+		Cut = (FindResult.DBStartptr - 1) - (uint8_t*) DB_START_ADDR;
+		CutEnd = (FindResult.DBEndptr + 2) - (uint8_t*) DB_START_ADDR;
+	} else {
+		Cut = FindResult.DBStartptr - (uint8_t*) DB_START_ADDR;
+		CutEnd = (FindResult.DBEndptr + 1) - (uint8_t*) DB_START_ADDR;
+	}
+
+	CHANGE_BEGIN();
+	status = UpdateJobBegin(Cut, CutEnd, Separator, value,
+			CalculateStringLength(value), Job);
+	if (status == UPDATE_PENDING) {
+		/*The replica does the update at once as the later changes are not done till the job is completed*/
+		CHANGE_EMIT(CHANGE_UPDATE, 0, path, value);
+	}
+	return status;
+}
+
+microcDB_Status MicrocDB_UpdateStep(microcDB_UpdateJob *Job, uint16_t PageOps) {
+	job_Journal Journal;
+	microcDB_Status status = UPDATE_PENDING;
+	uint32_t Operation;
+	LATENCY_BEGIN();
+
+	STATS_BEGIN(STATS_OP_UPDATE);
+	DEVICES_SYNC();
+
+	if (!ReadJournal(&Journal)) {
+		return UPDATE_SUCCESSFUL;
+	}
+
+	SEQ_WRITE_BEGIN();
+	Operation = OperationsDone(&Journal);
+	while (PageOps != 0) {
+		if (Operation == (uint32_t) Journal.Pages * JOB_MARKS_PER_PAGE) {
+			status = CompleteJob(&Journal) ? UPDATE_SUCCESSFUL : UPDATE_FAILED;
+			break;
+		}
+		if (!DoOperation(&Journal, Operation)) {
+			status = UPDATE_FAILED;
+			break;
+		}
+		Operation++;
+		PageOps--;
+	}
+	SEQ_WRITE_END();
+
+	Job->PagesDone = Operation / JOB_MARKS_PER_PAGE;
+	Job->Pages = Journal.Pages;
+	LATENCY_END(LATENCY_OP_UPDATE);
+	return status;
+}
+
+#endif
@@ -0,0 +1,41 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The aggregates of the numbers of an array list and of a field of the elements of an object. An element which
+ *      			 outgrew its slack is aggregated from its relocated copy.
+ *
+ * CONFIG MICROCDB_AGGREGATES 1
+ * CONFIG MICROCDB_OBJECT_SLACK 12
+ * CONFIG MICROCDB_RELOCATION 1
+ * CONFIG MICROCDB_RELOCATION_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_RELOCATION_END_ADDR 0x0800C7FF
+ * */
+
+#include "test.h"
+
+int main(void) {
+	microcDB_Aggregate Result;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'temp':[21,22.5,-3],'nodes':{'a':{'t':20},'b':{'t':24},'c':{'u':1},'d':{'t':'x'}},'empty':[],'name':'n'}/"), 1) == STORE_SUCCESS);
+
+	CHECK(MicrocDB_Aggregate(S("temp./"), 0, &Result) == FOUND_SUCCESS);
+	CHECK(Result.Count == 3 && Result.Sum == 40.5f && Result.Min == -3 && Result.Max == 22.5f && Result.Mean == 13.5f);
+
+	/*The elements without the field or with a non numeric value are skipped*/
+	CHECK(MicrocDB_Aggregate(S("nodes./"), S("t./"), &Result) == FOUND_SUCCESS);
+	CHECK(Result.Count == 2 && Result.Sum == 44 && Result.Min == 20 && Result.Max == 24 && Result.Mean == 22);
+
+	CHECK(MicrocDB_Aggregate(S("empty./"), 0, &Result) == FOUND_SUCCESS);
+	CHECK(Result.Count == 0 && Result.Sum == 0 && Result.Mean == 0);
+
+	CHECK(MicrocDB_Aggregate(S("none./"), 0, &Result) == PATH_NOT_FOUND);
+	CHECK(MicrocDB_Aggregate(S("name./"), 0, &Result) == PATH_NOT_ARRAYLIST);
+
+	/*The element a is relocated and its field is updated in the copy*/
+	CHECK(MicrocDB_Update(S("nodes.a./"), S("'pad':'longer than the slack'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Update(S("nodes.a.t./"), S("100/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("nodes.a.t./")), "100");
+	CHECK(MicrocDB_Aggregate(S("nodes./"), S("t./"), &Result) == FOUND_SUCCESS);
+	CHECK(Result.Count == 2 && Result.Sum == 124 && Result.Min == 24 && Result.Max == 100);
+	return 0;
+}
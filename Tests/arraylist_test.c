@@ -0,0 +1,113 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The elements appended to an array list in overflow segments are given by Find, the aggregates, the filters and the
+ *      			 iterator. A segment which was not completely written, by a failed write or a power loss, is skipped. The segments are
+ *      			 erased with DB and the documents are still appended to DB.
+ *
+ * CONFIG MICROCDB_AGGREGATES 1
+ * CONFIG MICROCDB_FILTER 1
+ * CONFIG MICROCDB_ARRAY_SEGMENTS 1
+ * CONFIG MICROCDB_ARRAY_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_ARRAY_END_ADDR 0x0800C7FF
+ * CONFIG MICROCDB_ARRAY_FIND_BYTES 32
+ * */
+
+#include "test.h"
+
+/*
+ * This function gives the address after the last segment written.
+ */
+static uint32_t FreeAddress(void) {
+	uint8_t *Segment = (uint8_t*) MICROCDB_ARRAY_START_ADDR;
+
+	while (*(uint16_t*) Segment != 0xFFFF) {
+		Segment += *(uint16_t*) Segment;
+	}
+	return (uint32_t) Segment;
+}
+
+static bool Count(microcDB_Data *Match, microcDB_Data *Key, void *Context) {
+	(*(int*) Context)++;
+	return true;
+}
+
+static int Append(void) {
+	microcDB_Aggregate Result;
+	microcDB_ArrayIterator Iterator;
+	microcDB_Data Element;
+	int Matches = 0;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'a':{'l':[1,2]},'e':[],'o':[{'t':1}]}/"), 1) == STORE_SUCCESS);
+	CHECK(MicrocDB_UpdateArrayList(S("a.l./"), S("3/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_UpdateArrayList(S("a.l./"), S("4,5/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_UpdateArrayList(S("a.l./"), S("6/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_UpdateArrayList(S("e./"), S("'x'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_UpdateArrayList(S("o./"), S("{'t':5},{'t':9}/")) == UPDATE_SUCCESSFUL);
+
+	CHECK_FOUND(MicrocDB_Find(S("a.l./")), "[1,2,3,4,5,6]");
+	CHECK_FOUND(MicrocDB_Find(S("e./")), "[\"x\"]");
+	CHECK_FOUND(MicrocDB_Find(S("a./")), "{\"l\":[1,2]}");
+	CHECK(MicrocDB_Aggregate(S("a.l./"), 0, &Result) == FOUND_SUCCESS);
+	CHECK(Result.Count == 6 && Result.Sum == 21 && Result.Max == 6);
+	CHECK(MicrocDB_Filter(S("o./"), S("t./"), FILTER_GT, S("2/"), Count, &Matches) == FOUND_SUCCESS);
+	CHECK(Matches == 2);
+	CHECK(MicrocDB_ArrayIterBegin(S("a.l./"), &Iterator) == FOUND_SUCCESS);
+	for (Matches = 1; Matches <= 6; Matches++) {
+		Element = MicrocDB_ArrayNext(&Iterator);
+		CHECK(Element.DBstatus == FOUND_SUCCESS && *Element.DBStartptr == '0' + Matches);
+	}
+	CHECK(MicrocDB_ArrayNext(&Iterator).DBstatus == NOT_FOUND);
+
+	/*The joined array list which doesn't fit in the buffer of Find*/
+	CHECK(MicrocDB_UpdateArrayList(S("e./"), S("'abcdefghijklm','nopqrstuvwxyz'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Find(S("e./")).DBstatus == NO_MEMORY);
+	CHECK(MicrocDB_Aggregate(S("e./"), 0, &Result) == FOUND_SUCCESS);
+
+	/*The append fails after the size of its segment was written*/
+	CHECK(HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, FreeAddress() + 10, 0) == HAL_OK);
+	CHECK(MicrocDB_UpdateArrayList(S("a.l./"), S("7/")) == UPDATE_FAILED);
+	CHECK_FOUND(MicrocDB_Find(S("a.l./")), "[1,2,3,4,5,6]");
+	CHECK(MicrocDB_UpdateArrayList(S("a.l./"), S("8/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("a.l./")), "[1,2,3,4,5,6,8]");
+
+	/*The power is lost while the segment is written*/
+	FlashEmuPowerLossAfter(6);
+	MicrocDB_UpdateArrayList(S("a.l./"), S("9/"));
+	return 1;
+}
+
+static int Reboot(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK_FOUND(MicrocDB_Find(S("a.l./")), "[1,2,3,4,5,6,8]");
+	CHECK(MicrocDB_UpdateArrayList(S("a.l./"), S("0/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("a.l./")), "[1,2,3,4,5,6,8,0]");
+	CHECK(*(uint16_t*) FreeAddress() == 0xFFFF);
+	return 0;
+}
+
+static int Check(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK_FOUND(MicrocDB_Find(S("a.l./")), "[1,2,3,4,5,6,8,0]");
+	return 0;
+}
+
+static int EraseAll(void) {
+	/*The flag of DB asks Init to erase it with the segments*/
+	CHECK(HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, MICROCDB_END_ADDR - 1, 0xDBFF) == HAL_OK);
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(FreeAddress() == MICROCDB_ARRAY_START_ADDR);
+	CHECK(MicrocDB_Insert(S("{'id':2,'l':[1]}/"), 1) == STORE_SUCCESS);
+	CHECK(FlashAddresscntr < MICROCDB_ARRAY_START_ADDR);
+	CHECK_FOUND(MicrocDB_Find(S("id./")), "2");
+	return 0;
+}
+
+int main(void) {
+	CHECK_BOOT(Append);
+	CHECK(*(uint16_t*) FreeAddress() == 0xFFFF);
+	CHECK_BOOT(Reboot);
+	CHECK_BOOT(Check);
+	CHECK_BOOT(EraseAll);
+	return 0;
+}
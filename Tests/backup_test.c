@@ -0,0 +1,197 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The streams of a device are restored on another one. An incremental stream is restored only on the device which was
+ *      			 restored till its Since generation and not changed after it, also after a reset. A corrupt stream doesn't change the
+ *      			 DB, and when the power is lost at any flash operation of a restore the DB has the stream or is as before it.
+ *
+ * CONFIG MICROCDB_OBJECT_SLACK 16
+ * CONFIG MICROCDB_BACKUP 1
+ * CONFIG MICROCDB_BACKUP_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_BACKUP_END_ADDR 0x0800C7FF
+ * CONFIG MICROCDB_BACKUP_STAGE_START_ADDR 0x08010000
+ * CONFIG MICROCDB_BACKUP_STAGE_END_ADDR 0x080143FF
+ * */
+
+#include "test.h"
+#include <sys/mman.h>
+
+#define STREAM_SIZE (32 + 16 * (PAGE_SIZE + 8))
+
+/*The streams are written by the boots of source device and read by the ones of replica so they are shared with them*/
+typedef struct {
+	uint32_t Length;
+	uint32_t Position;
+	uint8_t Bytes[STREAM_SIZE];
+} test_Stream;
+
+enum {
+	FULL, /*All the pages after the first checkpoint*/
+	SINCE_FIRST, /*The pages changed since the first checkpoint*/
+	SINCE_SECOND, /*The pages changed since the second checkpoint*/
+	STREAMS
+};
+
+static test_Stream *Streams;
+static uint8_t Replica[FLASH_EMU_SIZE];
+static uint8_t Image[FLASH_EMU_SIZE];
+
+static bool WriteStream(uint8_t *Bytes, uint16_t Length, void *Context) {
+	test_Stream *Stream = Context;
+
+	CHECK(Stream->Length + Length <= STREAM_SIZE);
+	memcpy(Stream->Bytes + Stream->Length, Bytes, Length);
+	Stream->Length += Length;
+	return true;
+}
+
+static bool ReadStream(uint8_t *Bytes, uint16_t Length, void *Context) {
+	test_Stream *Stream = Context;
+
+	if (Stream->Position + Length > Stream->Length) {
+		return false;
+	}
+	memcpy(Bytes, Stream->Bytes + Stream->Position, Length);
+	Stream->Position += Length;
+	return true;
+}
+
+static microcDB_Status Restore(int Number) {
+	Streams[Number].Position = 0;
+	return MicrocDB_Restore(ReadStream, &Streams[Number]);
+}
+
+static int Source(void) {
+	uint32_t First, Second;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'a':1,'b':'x'}/"), 1) == STORE_SUCCESS);
+	CHECK(MicrocDB_BackupCheckpoint(&First) == STORE_SUCCESS);
+	CHECK(MicrocDB_Backup(0, WriteStream, &Streams[FULL]) == STORE_SUCCESS);
+
+	CHECK(MicrocDB_Update(S("b./"), S("'y'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_BackupCheckpoint(&Second) == STORE_SUCCESS);
+	CHECK(MicrocDB_Backup(First, WriteStream, &Streams[SINCE_FIRST]) == STORE_SUCCESS);
+
+	CHECK(MicrocDB_Update(S("a./"), S("3/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Backup(Second, WriteStream, &Streams[SINCE_SECOND]) == STORE_SUCCESS);
+
+	/*The incremental streams have only the changed page*/
+	CHECK(Streams[SINCE_FIRST].Length < Streams[FULL].Length / 4);
+	CHECK(Streams[SINCE_SECOND].Length < Streams[FULL].Length / 4);
+	return 0;
+}
+
+static int RestoreInOrder(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+
+	/*The incremental streams need the pages of the streams before them*/
+	CHECK(Restore(SINCE_FIRST) == BACKUP_MISMATCH);
+	CHECK(Restore(FULL) == STORE_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("b./")), "x");
+	CHECK(Restore(SINCE_SECOND) == BACKUP_MISMATCH);
+	CHECK_FOUND(MicrocDB_Find(S("b./")), "x");
+	CHECK(Restore(SINCE_FIRST) == STORE_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("b./")), "y");
+	return 0;
+}
+
+static int RestoreAfterReset(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(Restore(SINCE_SECOND) == STORE_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("a./")), "3");
+	CHECK_FOUND(MicrocDB_Find(S("b./")), "y");
+
+	/*The same stream is restored again as the DB has the pages of its Since generation*/
+	CHECK(Restore(SINCE_SECOND) == STORE_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("a./")), "3");
+	return 0;
+}
+
+static int ChangeReplica(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Update(S("a./"), S("2/")) == UPDATE_SUCCESSFUL);
+	CHECK(Restore(SINCE_SECOND) == BACKUP_MISMATCH);
+	CHECK_FOUND(MicrocDB_Find(S("a./")), "2");
+	return 0;
+}
+
+static int RestoreChanged(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(Restore(SINCE_SECOND) == BACKUP_MISMATCH);
+
+	/*A full stream is restored on any DB*/
+	CHECK(Restore(FULL) == STORE_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("a./")), "1");
+	CHECK_FOUND(MicrocDB_Find(S("b./")), "x");
+
+	/*A corrupt or truncated stream is checked before any page of DB is written, so the DB still follows the full one*/
+	Streams[SINCE_FIRST].Bytes[Streams[SINCE_FIRST].Length - 10] ^= 1;
+	CHECK(Restore(SINCE_FIRST) == BACKUP_CORRUPT);
+	Streams[SINCE_FIRST].Bytes[Streams[SINCE_FIRST].Length - 10] ^= 1;
+	CHECK_FOUND(MicrocDB_Find(S("b./")), "x");
+	Streams[FULL].Length -= PAGE_SIZE;
+	CHECK(Restore(FULL) == BACKUP_CORRUPT);
+	Streams[FULL].Length += PAGE_SIZE;
+	CHECK_FOUND(MicrocDB_Find(S("b./")), "x");
+	CHECK(Restore(SINCE_FIRST) == STORE_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("b./")), "y");
+	return 0;
+}
+
+static int RestoreFull(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(Restore(FULL) == STORE_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("b./")), "x");
+	return 0;
+}
+
+/*
+ * This function checks the DB after the power was lost in the restore of full stream. It has the stream or is as before it.
+ */
+static int RestoredOrBefore(void) {
+	microcDB_Data Data;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK_FOUND(MicrocDB_Find(S("a./")), "1");
+	Data = MicrocDB_Find(S("b./"));
+	CHECK(Data.DBstatus == FOUND_SUCCESS && Data.DBStartptr == Data.DBEndptr
+			&& (*Data.DBStartptr == 'x' || *Data.DBStartptr == 'y'));
+
+	/*The incremental stream follows the restored one*/
+	if (*Data.DBStartptr == 'x') {
+		CHECK(Restore(SINCE_FIRST) == STORE_SUCCESS);
+		CHECK_FOUND(MicrocDB_Find(S("b./")), "y");
+	}
+	return 0;
+}
+
+int main(void) {
+	flash_emu_Counts Counts;
+	uint32_t Operations, Loss;
+
+	Streams = mmap(0, STREAMS * sizeof(test_Stream), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	CHECK(Streams != MAP_FAILED);
+	memset(Replica, 0xFF, sizeof(Replica));
+
+	CHECK_BOOT(Source);
+	FlashEmuSwap(Replica);
+	CHECK_BOOT(RestoreInOrder);
+	CHECK_BOOT(RestoreAfterReset);
+	CHECK_BOOT(ChangeReplica);
+	CHECK_BOOT(RestoreChanged);
+
+	/*The power is lost at the operations of a restore, every 97th of them as it stages and writes all the pages*/
+	memcpy(Image, (void*) (uintptr_t) FLASH_EMU_BASE, FLASH_EMU_SIZE);
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed;
+	CHECK_BOOT(RestoreFull);
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed - Operations;
+	for (Loss = 1; Loss < Operations; Loss += 97) {
+		memcpy((void*) (uintptr_t) FLASH_EMU_BASE, Image, FLASH_EMU_SIZE);
+		FlashEmuPowerLossAfter(Loss);
+		CHECK(FlashEmuBoot(RestoreFull) == 0);
+		CHECK_BOOT(RestoredOrBefore);
+	}
+	return 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The Bloom filters of the compressed blocks rule out the blocks without the key, so they aren't decompressed. The
+ *      			 cache has a block which is kept pinned, so a lookup which decompresses another block gives CACHE_FULL. The filter of
+ *      			 a block of one small document is small.
+ *
+ * CONFIG MICROCDB_COMPRESSION 1
+ * CONFIG MICROCDB_COMP_CACHE_BLOCKS 1
+ * */
+
+#include "test.h"
+
+#define DOCUMENTS 300
+#define LOOKUPS 500
+
+int main(void) {
+	static char Documents[DOCUMENTS * 20];
+	microcDB_Data Pinned;
+	uint8_t Query[16];
+	int Index, Length = 0, Decompressed = 0;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	for (Index = 0; Index < DOCUMENTS; Index++) {
+		Length += sprintf(Documents + Length, "{'k%d':'v%d'}/", Index, Index);
+	}
+	CHECK(MicrocDB_Insert((uint8_t*) Documents, DOCUMENTS) == STORE_SUCCESS);
+
+	/*The first block is pinned, the other blocks can't be decompressed*/
+	CHECK_FOUND(Pinned = MicrocDB_Find(S("k0./")), "v0");
+	CHECK(MicrocDB_Find(S("k299./")).DBstatus == CACHE_FULL);
+
+	/*The string values are not in the filters*/
+	CHECK(MicrocDB_Find(S("v299./")).DBstatus == NOT_FOUND);
+
+	/*About 1% of the blocks pass the filter for a key which is not stored*/
+	for (Index = 0; Index < LOOKUPS; Index++) {
+		sprintf((char*) Query, "x%d./", Index);
+		if (MicrocDB_Find(Query).DBstatus == CACHE_FULL) {
+			Decompressed++;
+		}
+	}
+	CHECK(Decompressed <= LOOKUPS / 50);
+
+	MicrocDB_Release(&Pinned);
+	CHECK_FOUND(Pinned = MicrocDB_Find(S("k299./")), "v299");
+	MicrocDB_Release(&Pinned);
+
+	/*The block of a document of 3 keys has a filter of about 6 bytes*/
+	Length = FlashAddresscntr;
+	CHECK(MicrocDB_Insert(S("{'dev':{'name':'sensor','value':12345}}/"), 1) == STORE_SUCCESS);
+	CHECK(FlashAddresscntr - Length <= 56);
+	CHECK_FOUND(MicrocDB_Find(S("dev.value./")), "12345");
+	return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The time range iteration of the capped collection gives only the documents of the range and skips the pages
+ *      			 outside it using their timestamp range, also after a reboot.
+ *
+ * CONFIG MICROCDB_CAPPED_SUPPORT 1
+ * CONFIG MICROCDB_CAPPED_START_ADDR 0x08010000
+ * CONFIG MICROCDB_CAPPED_END_ADDR 0x08011FFF
+ * CONFIG MICROCDB_CAPPED_TS_INDEX 1
+ * CONFIG MICROCDB_STATS 1
+ * */
+
+#include "test.h"
+
+#define DOCUMENTS 300
+
+static int Append(void) {
+	char Document[32];
+	int Index;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	for (Index = 0; Index < DOCUMENTS; Index++) {
+		snprintf(Document, sizeof(Document), "{'t':%d,'v':%d}/",
+				1000 + 10 * Index, Index);
+		CHECK(MicrocDB_CappedAppend((uint8_t*) Document) == STORE_SUCCESS);
+	}
+	CHECK(MicrocDB_CappedAppend(S("{'v':1}/")) == QUERY_INVALID);
+	return 0;
+}
+
+/*
+ * This function counts the documents of the iterator and the bytes parsed to find them.
+ */
+static int Count(microcDB_CappedIterator *Iterator, uint32_t From,
+		uint32_t To, uint32_t *ParserBytes) {
+	microcDB_Data Data;
+	microcDB_Stats Stats;
+	long Timestamp;
+	int Documents = 0;
+
+	MicrocDB_ResetStats();
+	for (;;) {
+		Data = MicrocDB_CappedNext(Iterator, S("t./"));
+		if (Data.DBstatus != FOUND_SUCCESS) {
+			break;
+		}
+		Timestamp = strtol((char*) Data.DBStartptr, 0, 10);
+		CHECK(Timestamp >= From && Timestamp <= To);
+		Documents++;
+	}
+	MicrocDB_GetStats(STATS_OP_FIND, &Stats);
+	*ParserBytes = Stats.ParserBytes;
+	return Documents;
+}
+
+static int Iterate(void) {
+	microcDB_CappedIterator Iterator;
+	uint32_t AllBytes, RangeBytes;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	MicrocDB_CappedIterNewest(&Iterator);
+	CHECK(Count(&Iterator, 0, 0xFFFFFFFF, &AllBytes) == DOCUMENTS);
+
+	/*The ranges of 20 documents in the oldest pages and 2 in the newest page are read without the other pages*/
+	MicrocDB_CappedIterRange(&Iterator, 1100, 1290);
+	CHECK(Count(&Iterator, 1100, 1290, &RangeBytes) == 20);
+	CHECK(RangeBytes < AllBytes / 3);
+	MicrocDB_CappedIterRange(&Iterator, 3980, 3990);
+	CHECK(Count(&Iterator, 3980, 3990, &RangeBytes) == 2);
+	CHECK(RangeBytes < AllBytes / 3);
+	MicrocDB_CappedIterRange(&Iterator, 5000, 6000);
+	CHECK(Count(&Iterator, 5000, 6000, &RangeBytes) == 0);
+	return 0;
+}
+
+int main(void) {
+	CHECK_BOOT(Append);
+	CHECK_BOOT(Iterate);
+	return 0;
+}
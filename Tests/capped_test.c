@@ -0,0 +1,59 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The capped collection keeps the newest documents when it wraps around and finds them again after a reboot.
+ *
+ * CONFIG MICROCDB_CAPPED_SUPPORT 1
+ * CONFIG MICROCDB_CAPPED_START_ADDR 0x08010000
+ * CONFIG MICROCDB_CAPPED_END_ADDR 0x08010FFF
+ * */
+
+#include "test.h"
+
+#define DOCUMENTS 600
+
+static int Append(void) {
+	char Document[32];
+	int Index;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	for (Index = 0; Index < DOCUMENTS; Index++) {
+		snprintf(Document, sizeof(Document), "{'t':%d,'v':%d}/", Index,
+				Index % 7);
+		CHECK(MicrocDB_CappedAppend((uint8_t*) Document) == STORE_SUCCESS);
+	}
+	return 0;
+}
+
+static int Iterate(void) {
+	microcDB_CappedIterator Iterator;
+	microcDB_Data Data;
+	long Previous = DOCUMENTS, Timestamp;
+	int Count = 0;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	MicrocDB_CappedIterNewest(&Iterator);
+	for (;;) {
+		Data = MicrocDB_CappedNext(&Iterator, S("t./"));
+		if (Data.DBstatus != FOUND_SUCCESS) {
+			break;
+		}
+		Timestamp = strtol((char*) Data.DBStartptr, 0, 10);
+		CHECK(Timestamp == Previous - 1); /*Newest to oldest without a gap*/
+		Previous = Timestamp;
+		Count++;
+	}
+	/*The oldest pages were reused but at least 3 of the 4 pages of entries of 20 to 24 bytes are kept*/
+	CHECK(Count > 3 * 1000 / 24 && Count < DOCUMENTS);
+	CHECK(Previous == DOCUMENTS - Count);
+
+	MicrocDB_CappedIterNewest(&Iterator);
+	CHECK_FOUND(MicrocDB_CappedNext(&Iterator, 0), "{\"t\":599,\"v\":4}");
+	return 0;
+}
+
+int main(void) {
+	CHECK_BOOT(Append);
+	CHECK(FlashEmuCounts().PageErases < 16 + DOCUMENTS / 40); /*Only the reused pages are erased*/
+	CHECK_BOOT(Iterate);
+	return 0;
+}
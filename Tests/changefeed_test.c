@@ -0,0 +1,208 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The records of the change feed of a device are applied on another one which then has the same data. The sequence
+ *      			 numbers are kept across the resets of both, so the replica refuses a record applied again after its reset. The primary
+ *      			 continues the numbers after its reset and leaves a gap, which the replica finds, only when the power was lost during
+ *      			 a change.
+ *
+ * CONFIG MICROCDB_OBJECT_SLACK 16
+ * CONFIG MICROCDB_CHANGE_FEED 1
+ * CONFIG MICROCDB_CHANGE_FEED_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_CHANGE_FEED_END_ADDR 0x0800C7FF
+ * CONFIG MICROCDB_COUNTERS 1
+ * CONFIG MICROCDB_COUNTER_START_ADDR 0x0800C800
+ * CONFIG MICROCDB_COUNTER_END_ADDR 0x0800CFFF
+ * CONFIG MICROCDB_CAPPED_SUPPORT 1
+ * CONFIG MICROCDB_CAPPED_START_ADDR 0x0800D000
+ * CONFIG MICROCDB_CAPPED_END_ADDR 0x0800DFFF
+ * CONFIG MICROCDB_SCHEMA_SUPPORT 1
+ * CONFIG MICROCDB_SCHEMA_START_ADDR 0x0800E000
+ * CONFIG MICROCDB_SCHEMA_END_ADDR 0x0800E7FF
+ * */
+
+#include "test.h"
+#include <sys/mman.h>
+
+#define FEED_SIZE 65536
+#define INCREMENTS 300 /*More records than the entries of a bank of the replica*/
+
+/*The feed is written by the boots of primary and read by the ones of replica so it is shared with them*/
+typedef struct {
+	uint32_t Length; /*The bytes given by the primary*/
+	uint32_t Applied; /*The bytes of the records applied by the replica*/
+	uint32_t LastRecord; /*The offset of the last record applied*/
+	uint8_t Bytes[FEED_SIZE];
+} test_Feed;
+
+static test_Feed *Feed;
+static uint8_t Replica[FLASH_EMU_SIZE];
+
+static bool Capture(uint8_t *Bytes, uint16_t Length, void *Context) {
+	CHECK(Feed->Length + Length <= FEED_SIZE);
+	memcpy(Feed->Bytes + Feed->Length, Bytes, Length);
+	Feed->Length += Length;
+	return true;
+}
+
+static uint16_t RecordLength(uint32_t Offset) {
+	uint8_t *Header = Feed->Bytes + Offset;
+
+	return 12 + (Header[8] | (Header[9] << 8)) + (Header[10] | (Header[11] << 8));
+}
+
+static uint32_t RecordSequence(uint32_t Offset) {
+	uint32_t Sequence;
+
+	memcpy(&Sequence, Feed->Bytes + Offset, 4);
+	return Sequence;
+}
+
+/*
+ * This function applies the records given since the last call and checks that all were applied.
+ */
+static void ApplyAll(void) {
+	uint16_t Length;
+	uint8_t Record[256];
+	microcDB_Status Status;
+
+	while (Feed->Applied < Feed->Length) {
+		Length = RecordLength(Feed->Applied);
+		CHECK(Length <= sizeof(Record));
+		memcpy(Record, Feed->Bytes + Feed->Applied, Length); /*The record is changed by the apply*/
+		Status = MicrocDB_ApplyChange(Record, Length);
+		if (Status != STORE_SUCCESS && Status != UPDATE_SUCCESSFUL) {
+			printf("record %u status %d\n", RecordSequence(Feed->Applied), Status);
+			CHECK(0);
+		}
+		Feed->LastRecord = Feed->Applied;
+		Feed->Applied += Length;
+	}
+}
+
+static void CheckData(const char *a, int32_t n) {
+	microcDB_CappedIterator Iterator;
+	int32_t Value;
+
+	CHECK_FOUND(MicrocDB_Find(S("a./")), a);
+	CHECK(MicrocDB_GetCounter(S("n./"), &Value) == FOUND_SUCCESS && Value == n);
+	MicrocDB_CappedIterNewest(&Iterator);
+	CHECK_FOUND(MicrocDB_CappedNext(&Iterator, S("t./")), "1");
+	CHECK(MicrocDB_RecordCount() == 1);
+	CHECK_FOUND(MicrocDB_FindRecord(0, S("name./")), "node1");
+}
+
+static int Primary(void) {
+	int i;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_RegisterSchema(S("{'temp':'i16','name':'s8'}/")) == SCHEMA_REGISTERED);
+	MicrocDB_ChangeFeed(Capture, 0);
+	CHECK(MicrocDB_Insert(S("{'a':'x','n':5}/"), 1) == STORE_SUCCESS);
+	CHECK(MicrocDB_Update(S("a./"), S("'y'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Increment(S("n./"), 100000) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Decrement(S("n./"), 7) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_CappedAppend(S("{'t':1}/")) == STORE_SUCCESS);
+	CHECK(MicrocDB_InsertRecord(S("{'temp':-12,'name':'node1'}/")) == STORE_SUCCESS);
+	for (i = 0; i < INCREMENTS; i++) {
+		CHECK(MicrocDB_Increment(S("n./"), -1) == UPDATE_SUCCESSFUL);
+	}
+	CHECK(MicrocDB_ChangeSequence() == 6 + INCREMENTS);
+	CheckData("y", 5 + 100000 - 7 - INCREMENTS);
+	return 0;
+}
+
+static int ApplyOnReplica(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_RegisterSchema(S("{'temp':'i16','name':'s8'}/")) == SCHEMA_REGISTERED);
+	ApplyAll();
+	CheckData("y", 5 + 100000 - 7 - INCREMENTS);
+	return 0;
+}
+
+static int ResetReplica(void) {
+	uint8_t Record[256];
+	uint16_t Length = RecordLength(Feed->LastRecord);
+
+	/*The last record is refused as its number was already applied before the reset*/
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_RegisterSchema(S("{'temp':'i16','name':'s8'}/")) == SCHEMA_REGISTERED);
+	memcpy(Record, Feed->Bytes + Feed->LastRecord, Length);
+	CHECK(MicrocDB_ApplyChange(Record, Length) == CHANGE_OUT_OF_ORDER);
+	CheckData("y", 5 + 100000 - 7 - INCREMENTS);
+	return 0;
+}
+
+static int ResetPrimary(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	MicrocDB_ChangeFeed(Capture, 0);
+	CHECK(MicrocDB_ChangeSequence() == 6 + INCREMENTS);
+	/*The number of the update which failed is used by the next one*/
+	CHECK(MicrocDB_Update(S("b./"), S("'z'/")) == PATH_NOT_FOUND);
+	CHECK(MicrocDB_Update(S("a./"), S("'z'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_ChangeSequence() == 6 + INCREMENTS + 1);
+	return 0;
+}
+
+static int ApplyAfterReset(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_RegisterSchema(S("{'temp':'i16','name':'s8'}/")) == SCHEMA_REGISTERED);
+	ApplyAll();
+	CheckData("z", 5 + 100000 - 7 - INCREMENTS);
+	return 0;
+}
+
+static int LosePower(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	MicrocDB_ChangeFeed(Capture, 0);
+	/*The power is lost after the number is logged, while the value is written*/
+	FlashEmuPowerLossAfter(3);
+	MicrocDB_Update(S("a./"), S("'w'/"));
+	CHECK(0);
+	return 0;
+}
+
+static int AfterLoss(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	MicrocDB_ChangeFeed(Capture, 0);
+	CHECK(MicrocDB_Update(S("a./"), S("'v'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_ChangeSequence() == 6 + INCREMENTS + 3);
+	return 0;
+}
+
+static int ApplyAfterGap(void) {
+	uint8_t Record[256];
+	uint16_t Length = RecordLength(Feed->Applied);
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_RegisterSchema(S("{'temp':'i16','name':'s8'}/")) == SCHEMA_REGISTERED);
+	memcpy(Record, Feed->Bytes + Feed->Applied, Length);
+	CHECK(MicrocDB_ApplyChange(Record, Length) == CHANGE_OUT_OF_ORDER);
+	CheckData("z", 5 + 100000 - 7 - INCREMENTS);
+
+	/*The update lost on the primary changed the same value so the replica is synchronized with the record after the gap*/
+	CHECK(MicrocDB_ChangeSynced(RecordSequence(Feed->Applied) - 1) == STORE_SUCCESS);
+	ApplyAll();
+	CheckData("v", 5 + 100000 - 7 - INCREMENTS);
+	return 0;
+}
+
+int main(void) {
+	Feed = mmap(0, sizeof(test_Feed), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	CHECK(Feed != MAP_FAILED);
+	memset(Replica, 0xFF, sizeof(Replica));
+
+	CHECK_BOOT(Primary);
+	FlashEmuSwap(Replica);
+	CHECK_BOOT(ApplyOnReplica);
+	CHECK_BOOT(ResetReplica);
+	FlashEmuSwap(Replica);
+	CHECK_BOOT(ResetPrimary);
+	FlashEmuSwap(Replica);
+	CHECK_BOOT(ApplyAfterReset);
+	FlashEmuSwap(Replica);
+	CHECK_BOOT(LosePower);
+	CHECK_BOOT(AfterLoss);
+	FlashEmuSwap(Replica);
+	CHECK_BOOT(ApplyAfterGap);
+	return 0;
+}
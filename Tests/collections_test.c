@@ -0,0 +1,52 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The named collections are separate JSON trees, a key of one collection is not found in the others and every
+ *      			 collection continues appending after a reboot.
+ *
+ * CONFIG MICROCDB_COLLECTIONS 2
+ * CONFIG MICROCDB_COLLECTION_TABLE {"config/", 0x08010000, 0x080107FF}, {"logs/", 0x08010800, 0x08011FFF}
+ * */
+
+#include "test.h"
+
+static int Store(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'name':'default'}/"), 1) == STORE_SUCCESS);
+	CHECK(MicrocDB_SelectCollection(S("config/")) == FOUND_SUCCESS);
+	CHECK(MicrocDB_Insert(S("{'rate':10,'mode':'fast'}/"), 1) == STORE_SUCCESS);
+	CHECK(MicrocDB_SelectCollection(S("logs/")) == FOUND_SUCCESS);
+	CHECK(MicrocDB_Insert(S("{'boot':1}/"), 1) == STORE_SUCCESS);
+	CHECK(MicrocDB_SelectCollection(S("none/")) == NOT_FOUND);
+	CHECK(MicrocDB_Find(S("boot./")).DBstatus == FOUND_SUCCESS); /*Still logs*/
+	return 0;
+}
+
+static int Read(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK_FOUND(MicrocDB_Find(S("name./")), "default");
+	CHECK(MicrocDB_Find(S("rate./")).DBstatus == NOT_FOUND);
+
+	CHECK(MicrocDB_SelectCollection(S("config/")) == FOUND_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("mode./")), "fast");
+	CHECK(MicrocDB_Update(S("rate./"), S("20/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("rate./")), "20");
+	CHECK(MicrocDB_Find(S("name./")).DBstatus == NOT_FOUND);
+
+	/*The second document of logs is appended after the first one of the same region*/
+	CHECK(MicrocDB_SelectCollection(S("logs/")) == FOUND_SUCCESS);
+	CHECK(MicrocDB_Insert(S("{'boot':2}/"), 1) == STORE_SUCCESS);
+	CHECK(*(uint8_t*) 0x08010800 == '{');
+	CHECK(MicrocDB_Find(S("mode./")).DBstatus == NOT_FOUND);
+
+	CHECK(MicrocDB_SelectCollection(0) == FOUND_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("name./")), "default");
+	return 0;
+}
+
+int main(void) {
+	CHECK_BOOT(Store);
+	CHECK_BOOT(Read);
+	CHECK(memcmp((uint8_t*) 0x08010800, "{\"boot\":1}/", 11) == 0);
+	CHECK(memcmp((uint8_t*) 0x0801080C, "{\"boot\":2}/", 11) == 0);
+	return 0;
+}
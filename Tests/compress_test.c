@@ -0,0 +1,90 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The compressed documents are found through the block cache and the found data stays valid while other blocks are
+ *      			 decompressed, till it is released. When the power is lost at any flash operation of storing a block, the block is
+ *      			 not found and the next blocks are stored after it.
+ *
+ * CONFIG MICROCDB_COMPRESSION 1
+ * CONFIG MICROCDB_COMP_BLOCK_SIZE 128
+ * CONFIG MICROCDB_COMP_CACHE_BLOCKS 2
+ * */
+
+#include "test.h"
+
+static uint8_t Image[FLASH_EMU_SIZE];
+
+static int Append(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'dev9':{'name':'sensor-9','value':999}}/"), 1) == STORE_SUCCESS);
+	return 0;
+}
+
+static int AppendAfterLoss(void) {
+	microcDB_Data Data;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK_FOUND(MicrocDB_Find(S("dev7.name./")), "sensor-7");
+	Data = MicrocDB_Find(S("dev9.name./"));
+	CHECK(Data.DBstatus == NOT_FOUND || TestFound(Data, "sensor-9"));
+	CHECK(MicrocDB_Insert(S("{'dev10':{'name':'sensor-10'}}/"), 1) == STORE_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("dev10.name./")), "sensor-10");
+	return 0;
+}
+
+int main(void) {
+	flash_emu_Counts Counts;
+	uint32_t Operations, Loss;
+	microcDB_Data First, Other;
+	char Documents[512];
+	int Index, Length = 0;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	/*Three documents of 40 bytes fit in a block so the 8 documents are in 3 blocks*/
+	for (Index = 0; Index < 8; Index++) {
+		Length += snprintf(Documents + Length, sizeof(Documents) - Length,
+				"{'dev%d':{'name':'sensor-%d','value':%d}}/", Index, Index,
+				Index * 111);
+	}
+	CHECK(MicrocDB_Insert((uint8_t*) Documents, 8) == STORE_SUCCESS);
+	CHECK(FlashAddresscntr - MICROCDB_START_ADDR < (uint32_t) Length);
+
+	First = MicrocDB_Find(S("dev0.name./"));
+	CHECK_FOUND(First, "sensor-0");
+
+	/*The lookups in the other blocks don't replace the pinned block*/
+	CHECK_FOUND(Other = MicrocDB_Find(S("dev3.value./")), "333");
+	MicrocDB_Release(&Other);
+	CHECK_FOUND(Other = MicrocDB_Find(S("dev5.value./")), "555");
+	MicrocDB_Release(&Other);
+	CHECK_FOUND(Other = MicrocDB_Find(S("dev7.name./")), "sensor-7");
+	MicrocDB_Release(&Other);
+	CHECK_FOUND(First, "sensor-0");
+
+	/*All the blocks of cache are pinned so the next block can't be decompressed*/
+	CHECK_FOUND(Other = MicrocDB_Find(S("dev4.name./")), "sensor-4");
+	CHECK(MicrocDB_Find(S("dev6.name./")).DBstatus == CACHE_FULL);
+	CHECK(MicrocDB_Insert(S("{'dev8':1}/"), 1) == CACHE_FULL);
+
+	/*Released data frees the block*/
+	MicrocDB_Release(&First);
+	MicrocDB_Release(&First);
+	CHECK_FOUND(Other = MicrocDB_Find(S("dev6.name./")), "sensor-6");
+	CHECK(MicrocDB_Find(S("dev9./")).DBstatus == NOT_FOUND);
+	memcpy(Image, (void*) (uintptr_t) FLASH_EMU_BASE, FLASH_EMU_SIZE);
+
+	/*The flash operations of storing a block without power loss*/
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed;
+	CHECK_BOOT(Append);
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed - Operations;
+
+	/*The power is lost at every operation of storing*/
+	for (Loss = 1; Loss <= Operations; Loss++) {
+		memcpy((void*) (uintptr_t) FLASH_EMU_BASE, Image, FLASH_EMU_SIZE);
+		FlashEmuPowerLossAfter(Loss);
+		CHECK(FlashEmuBoot(Append) == 0);
+		CHECK_BOOT(AppendAfterLoss);
+	}
+	return 0;
+}
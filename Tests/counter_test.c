@@ -0,0 +1,73 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The counters start at the integer in DB, keep their value across reboots and refuse the changes which would
+ *      			 overflow int32_t.
+ *
+ * CONFIG MICROCDB_COUNTERS 1
+ * CONFIG MICROCDB_COUNTER_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_COUNTER_END_ADDR 0x0800C7FF
+ * CONFIG MICROCDB_COUNTER_DELTAS 4
+ * */
+
+#include "test.h"
+#include <stdint.h>
+
+static int32_t Counter(const char *path) {
+	uint8_t Path[16];
+	int32_t Value;
+
+	strcpy((char*) Path, path);
+	CHECK(MicrocDB_GetCounter(Path, &Value) == FOUND_SUCCESS);
+	return Value;
+}
+
+static int Count(void) {
+	int Index;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'trip':{'km':100},'big':2147483000,'text':'a','long':99999999999}/"), 1) == STORE_SUCCESS);
+
+	/*The deltas of half word are programmed in the slot, the others and the ones after the last delta write a new slot*/
+	for (Index = 0; Index < 10; Index++) {
+		CHECK(MicrocDB_Increment(S("trip.km./"), 5) == UPDATE_SUCCESSFUL);
+	}
+	CHECK(MicrocDB_Increment(S("trip.km./"), 100000) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Decrement(S("trip.km./"), 50) == UPDATE_SUCCESSFUL);
+	CHECK(Counter("trip.km./") == 100100);
+	CHECK_FOUND(MicrocDB_Find(S("trip.km./")), "100");
+
+	CHECK(MicrocDB_Increment(S("new./"), -7) == UPDATE_SUCCESSFUL);
+	CHECK(Counter("new./") == -7);
+	CHECK(MicrocDB_Increment(S("text./"), 1) == UPDATE_FAILED);
+	CHECK(MicrocDB_Increment(S("long./"), 1) == UPDATE_FAILED);
+	CHECK(MicrocDB_Increment(S("trip.odometer.total./"), 1) == QUERY_INVALID);
+
+	/*The changes which overflow are refused and the counter is not changed*/
+	CHECK(MicrocDB_Increment(S("big./"), 647) == UPDATE_SUCCESSFUL);
+	CHECK(Counter("big./") == INT32_MAX);
+	CHECK(MicrocDB_Increment(S("big./"), 1) == COUNTER_OVERFLOW);
+	CHECK(MicrocDB_Increment(S("big./"), INT32_MAX) == COUNTER_OVERFLOW);
+	CHECK(MicrocDB_Decrement(S("new./"), INT32_MIN) == COUNTER_OVERFLOW);
+	CHECK(MicrocDB_Decrement(S("new./"), INT32_MAX - 10) == UPDATE_SUCCESSFUL);
+	CHECK(Counter("new./") == INT32_MIN + 4);
+	CHECK(MicrocDB_Decrement(S("new./"), 5) == COUNTER_OVERFLOW);
+	CHECK(MicrocDB_Decrement(S("new./"), 4) == UPDATE_SUCCESSFUL);
+	CHECK(Counter("new./") == INT32_MIN);
+	CHECK(MicrocDB_Increment(S("new./"), INT32_MIN) == COUNTER_OVERFLOW);
+	CHECK(Counter("big./") == INT32_MAX);
+	return 0;
+}
+
+static int Read(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(Counter("trip.km./") == 100100);
+	CHECK(Counter("big./") == INT32_MAX);
+	CHECK(Counter("new./") == INT32_MIN);
+	return 0;
+}
+
+int main(void) {
+	CHECK_BOOT(Count);
+	CHECK_BOOT(Read);
+	return 0;
+}
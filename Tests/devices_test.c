@@ -0,0 +1,70 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The DB is stored in the window of an emulated NOR flash device and the relocated objects in another one. The
+ *      			 erases are only begun, the window is read only after they are done, and the latency of a page write has the wait
+ *      			 for the erase before it.
+ *
+ * CONFIG MICROCDB_DEVICES 2
+ * CONFIG MICROCDB_DEVICE_TABLE FLASH_DEVICE_TABLE
+ * CONFIG MICROCDB_START_ADDR 0x08038000
+ * CONFIG MICROCDB_END_ADDR 0x0803BFFF
+ * CONFIG MICROCDB_OBJECT_SLACK 16
+ * CONFIG MICROCDB_RELOCATION 1
+ * CONFIG MICROCDB_RELOCATION_START_ADDR 0x0803C000
+ * CONFIG MICROCDB_RELOCATION_END_ADDR 0x0803C7FF
+ * CONFIG MICROCDB_LATENCY 1
+ * */
+
+#include "test.h"
+#include "flash_devices.h"
+
+#define ERASE_TICKS 20 /*The milliseconds of an erase of the emulated devices*/
+
+static void CheckAll(const char *a, const char *d) {
+	CHECK_FOUND(MicrocDB_Find(S("a./")), a);
+	CHECK_FOUND(MicrocDB_Find(S("c.d./")), d);
+	CHECK_FOUND(MicrocDB_Find(S("e./")), "7");
+}
+
+static int Write(void) {
+	microcDB_Latency Latency;
+	uint32_t Erases;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'a':'x','c':{'d':5},'e':7}/"), 1) == STORE_SUCCESS);
+	CheckAll("x", "5");
+
+	/*The page is erased and written again, the write waits for the erase*/
+	MicrocDB_ResetLatency();
+	Erases = FlashDeviceErases(0);
+	CHECK(MicrocDB_Update(S("a./"), S("'xyz'/")) == UPDATE_SUCCESSFUL);
+	CHECK(FlashDeviceErases(0) > Erases);
+	CheckAll("xyz", "5");
+	MicrocDB_GetLatency(LATENCY_OP_WRITE_PAGE, &Latency);
+	CHECK(Latency.Count > 0 && Latency.Max >= ERASE_TICKS);
+	MicrocDB_GetLatency(LATENCY_OP_ERASE_PAGE, &Latency);
+	CHECK(Latency.Count > 0 && Latency.Max < ERASE_TICKS);
+
+	/*The object c is relocated to the other device*/
+	CHECK(MicrocDB_Update(S("c.d./"), S("'a value longer than the slack'/")) == UPDATE_SUCCESSFUL);
+	CHECK(*(uint8_t*) (MICROCDB_RELOCATION_START_ADDR + 4) != 0xFF);
+	CheckAll("xyz", "a value longer than the slack");
+	CHECK(MicrocDB_Update(S("a./"), S("'x'/")) == UPDATE_SUCCESSFUL);
+	CheckAll("x", "a value longer than the slack");
+
+	/*Nothing is stored in the internal flash*/
+	CHECK(FlashEmuCounts().PageErases == 0 && FlashEmuCounts().HalfWordsProgrammed == 0);
+	return 0;
+}
+
+static int Read(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CheckAll("x", "a value longer than the slack");
+	return 0;
+}
+
+int main(void) {
+	CHECK_BOOT(Write);
+	CHECK_BOOT(Read);
+	return 0;
+}
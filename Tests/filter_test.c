@@ -0,0 +1,64 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The filter scan calls the callback for every element matching the condition and stops when it returns false.
+ *      			 An element which outgrew its slack is compared in its relocated copy.
+ *
+ * CONFIG MICROCDB_FILTER 1
+ * CONFIG MICROCDB_OBJECT_SLACK 12
+ * CONFIG MICROCDB_RELOCATION 1
+ * CONFIG MICROCDB_RELOCATION_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_RELOCATION_END_ADDR 0x0800C7FF
+ * */
+
+#include "test.h"
+
+typedef struct {
+	uint8_t Count;
+	uint8_t Limit;
+	char Keys[8];
+} filter_Matches;
+
+static bool Collect(microcDB_Data *Match, microcDB_Data *Key, void *Context) {
+	filter_Matches *Matches = Context;
+
+	CHECK(*Match->DBStartptr == '{' && *Match->DBEndptr == '}');
+	Matches->Keys[Matches->Count++] =
+			Key->DBstatus == FOUND_SUCCESS ? *Key->DBStartptr : '-';
+	return Matches->Count != Matches->Limit;
+}
+
+static filter_Matches Scan(const char *path, microcDB_FilterOp Op,
+		const char *value, microcDB_Status Status, uint8_t Limit) {
+	filter_Matches Matches = { 0, Limit, { 0 } };
+	uint8_t Path[32], Field[] = "status./", Value[16];
+
+	strcpy((char*) Path, path);
+	strcpy((char*) Value, value);
+	CHECK(MicrocDB_Filter(Path, Field, Op, Value, Collect, &Matches) == Status);
+	return Matches;
+}
+
+int main(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'devices':{'a':{'status':'ok','cfg':{'status':'fault'}},'b':{'status':'fault'},'c':{'status':25},'d':{'x':1}},'list':[{'status':30},{'status':'ok'}],'name':'n'}/"), 1) == STORE_SUCCESS);
+
+	/*The members of nested objects are not compared*/
+	CHECK(strcmp(Scan("devices./", FILTER_EQ, "fault/", FOUND_SUCCESS, 0).Keys, "b") == 0);
+	CHECK(strcmp(Scan("devices./", FILTER_NE, "ok/", FOUND_SUCCESS, 0).Keys, "bc") == 0);
+	CHECK(strcmp(Scan("devices./", FILTER_EQ, "25.0/", FOUND_SUCCESS, 0).Keys, "c") == 0);
+	CHECK(strcmp(Scan("devices./", FILTER_PREFIX, "fa/", FOUND_SUCCESS, 0).Keys, "b") == 0);
+	CHECK(strcmp(Scan("devices./", FILTER_NE, "x/", FOUND_SUCCESS, 1).Keys, "a") == 0);
+	CHECK(Scan("devices./", FILTER_EQ, "none/", NOT_FOUND, 0).Count == 0);
+
+	/*"ok" is not a number so it is compared char by char and is greater than "20"*/
+	CHECK(strcmp(Scan("list./", FILTER_GT, "20/", FOUND_SUCCESS, 0).Keys, "--") == 0);
+	CHECK(strcmp(Scan("list./", FILTER_LT, "40/", FOUND_SUCCESS, 0).Keys, "-") == 0);
+
+	Scan("none./", FILTER_EQ, "ok/", PATH_NOT_FOUND, 0);
+	Scan("name./", FILTER_EQ, "ok/", PATH_NOT_ARRAYLIST, 0);
+
+	/*The element d is relocated as its new member doesn't fit in the slack*/
+	CHECK(MicrocDB_Update(S("devices.d./"), S("'status':'fault-with-a-long-description'/")) == UPDATE_SUCCESSFUL);
+	CHECK(strcmp(Scan("devices./", FILTER_PREFIX, "fault/", FOUND_SUCCESS, 0).Keys, "bd") == 0);
+	return 0;
+}
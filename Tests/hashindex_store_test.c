@@ -0,0 +1,67 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The hash index finds the uncompressed documents by their id. An update of the id adds the slot of the new id, and
+ *      			 the slots of the documents shifted by an update job are moved so they are found without a scan.
+ *
+ * CONFIG MICROCDB_OBJECT_SLACK 16
+ * CONFIG MICROCDB_HASH_INDEX 1
+ * CONFIG MICROCDB_HASH_INDEX_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_HASH_INDEX_END_ADDR 0x0800CFFF
+ * CONFIG MICROCDB_UPDATE_JOBS 1
+ * CONFIG MICROCDB_JOB_START_ADDR 0x0800D000
+ * CONFIG MICROCDB_JOB_END_ADDR 0x0800D7FF
+ * */
+
+#include "test.h"
+
+static microcDB_Data Value(const char *Id) {
+	uint8_t Text[16];
+
+	sprintf((char*) Text, "%s/", Id);
+	return MicrocDB_IndexFind(Text, S("v./"));
+}
+
+/*
+ * This function checks that the document of Id is found using its slot, i.e without dropping a stale slot and adding a slot by a scan.
+ */
+static int FoundBySlot(const char *Id, const char *Text) {
+	flash_emu_Counts Before = FlashEmuCounts();
+
+	CHECK_FOUND(Value(Id), Text);
+	CHECK(FlashEmuCounts().HalfWordsProgrammed == Before.HalfWordsProgrammed);
+	return 1;
+}
+
+int main(void) {
+	microcDB_UpdateJob Job;
+	char Document[64];
+	int Index;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	for (Index = 0; Index < 4; Index++) {
+		sprintf(Document, "{'id':'dev%d','v':%d}/", Index, Index * 10);
+		CHECK(MicrocDB_Insert((uint8_t*) Document, 1) == STORE_SUCCESS);
+	}
+	CHECK(FoundBySlot("dev0", "0"));
+	CHECK(FoundBySlot("dev3", "30"));
+	CHECK(Value("dev9").DBstatus == NOT_FOUND);
+
+	/*The id updated in the slack of its document is found by its new slot*/
+	CHECK(MicrocDB_Update(S("id./"), S("'node0'/")) == UPDATE_SUCCESSFUL);
+	CHECK(FoundBySlot("node0", "0"));
+	CHECK(Value("dev0").DBstatus == NOT_FOUND);
+
+	/*The documents after the first one are shifted by the job*/
+	CHECK(MicrocDB_UpdateBegin(S("v./"), S("'a value longer than the slack of the first document'/"), &Job)
+			== UPDATE_PENDING);
+	while (MicrocDB_UpdateStep(&Job, 1) == UPDATE_PENDING)
+		;
+	CHECK(FoundBySlot("dev1", "10"));
+	CHECK(FoundBySlot("dev3", "30"));
+	CHECK(FoundBySlot("node0", "a value longer than the slack of the first document"));
+
+	/*The index is kept after the reset*/
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(FoundBySlot("dev2", "20"));
+	return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The hash index finds the compressed documents by their id and pins the block of the found data till it is released.
+ *      			 A stale slot is dropped and the document is found by a scan which adds it to the index again, and the index is
+ *      			 rebuilt when the DB is restored from a backup.
+ *
+ * CONFIG MICROCDB_COMPRESSION 1
+ * CONFIG MICROCDB_COMP_BLOCK_SIZE 128
+ * CONFIG MICROCDB_COMP_CACHE_BLOCKS 2
+ * CONFIG MICROCDB_HASH_INDEX 1
+ * CONFIG MICROCDB_HASH_INDEX_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_HASH_INDEX_END_ADDR 0x0800CFFF
+ * CONFIG MICROCDB_BACKUP 1
+ * CONFIG MICROCDB_BACKUP_START_ADDR 0x0800D000
+ * CONFIG MICROCDB_BACKUP_END_ADDR 0x0800DFFF
+ * CONFIG MICROCDB_BACKUP_STAGE_START_ADDR 0x08010000
+ * CONFIG MICROCDB_BACKUP_STAGE_END_ADDR 0x080143FF
+ * */
+
+#include "test.h"
+
+#define INDEX_PAGES 4
+
+typedef struct {
+	uint8_t Bytes[32 * 1024];
+	uint32_t Length, Read;
+} backup_Stream;
+
+static bool Write(uint8_t *Bytes, uint16_t Length, void *Context) {
+	backup_Stream *Stream = Context;
+
+	memcpy(Stream->Bytes + Stream->Length, Bytes, Length);
+	Stream->Length += Length;
+	return true;
+}
+
+static bool Read(uint8_t *Bytes, uint16_t Length, void *Context) {
+	backup_Stream *Stream = Context;
+
+	if (Stream->Read + Length > Stream->Length) {
+		return false;
+	}
+	memcpy(Bytes, Stream->Bytes + Stream->Read, Length);
+	Stream->Read += Length;
+	return true;
+}
+
+/*
+ * This function inserts a block of three documents from the id First.
+ */
+static void InsertBlock(int First) {
+	char Documents[128];
+	int Index, Length = 0;
+
+	for (Index = First; Index < First + 3; Index++) {
+		Length += sprintf(Documents + Length, "{'id':'dev%d','v':%d}/", Index, Index * 10);
+	}
+	CHECK(MicrocDB_Insert((uint8_t*) Documents, 3) == STORE_SUCCESS);
+}
+
+static microcDB_Data Value(const char *Id) {
+	uint8_t Text[16];
+
+	sprintf((char*) Text, "%s/", Id);
+	return MicrocDB_IndexFind(Text, S("v./"));
+}
+
+/*
+ * This function programs a slot of the hash of Id which points to the first document of DB, like a slot left by an older DB.
+ */
+static uint8_t* ProgramStaleSlot(const char *Id) {
+	uint32_t Hash = 2166136261UL, Address;
+
+	while (*Id != 0) {
+		Hash = (Hash ^ (uint8_t) *Id++) * 16777619UL;
+	}
+	Address = MICROCDB_HASH_INDEX_START_ADDR + (Hash % INDEX_PAGES) * FLASH_PAGE_SIZE;
+	while (*(uint32_t*) (Address + 4) != 0xFFFFFFFF) {
+		Address += 8;
+	}
+	CHECK(HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, Address, Hash) == HAL_OK);
+	CHECK(HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, Address + 4, 0) == HAL_OK);
+	return (uint8_t*) Address;
+}
+
+int main(void) {
+	static backup_Stream Stream;
+	microcDB_Data First, Second;
+	FLASH_EraseInitTypeDef Erase = { FLASH_TYPEERASE_PAGES, MICROCDB_HASH_INDEX_START_ADDR, INDEX_PAGES };
+	uint32_t PageError;
+	uint8_t *Stale;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	InsertBlock(0);
+	InsertBlock(3);
+	InsertBlock(6);
+	CHECK(MicrocDB_Backup(0, Write, &Stream) == STORE_SUCCESS);
+
+	/*The found data stays valid while the other blocks are used, till it is released*/
+	CHECK_FOUND(First = Value("dev1"), "10");
+	CHECK_FOUND(Second = Value("dev4"), "40");
+	CHECK_FOUND(Value("dev2"), "20");
+	CHECK(Value("dev7").DBstatus == CACHE_FULL);
+	CHECK_FOUND(First, "10");
+	MicrocDB_Release(&First);
+	MicrocDB_Release(&Second);
+	CHECK_FOUND(First = Value("dev7"), "70");
+	MicrocDB_Release(&First);
+	CHECK(Value("dev99").DBstatus == NOT_FOUND);
+
+	/*The lost slot of dev5 is replaced by a stale one*/
+	CHECK(HAL_FLASHEx_Erase(&Erase, &PageError) == HAL_OK);
+	Stale = ProgramStaleSlot("dev5");
+	CHECK_FOUND(First = Value("dev5"), "50");
+	MicrocDB_Release(&First);
+	CHECK(memcmp(Stale, "\0\0\0\0\0\0\0\0", 8) == 0);
+	CHECK(*(uint32_t*) (Stale + 12) != 0xFFFFFFFF); /*The slot added by the scan after the dropped one*/
+	CHECK_FOUND(First = Value("dev5"), "50");
+	MicrocDB_Release(&First);
+
+	/*The restored DB has the blocks which were backed up*/
+	InsertBlock(9);
+	Stream.Read = 0;
+	CHECK(MicrocDB_Restore(Read, &Stream) == STORE_SUCCESS);
+	CHECK_FOUND(First = Value("dev0"), "0");
+	MicrocDB_Release(&First);
+	CHECK_FOUND(First = Value("dev8"), "80");
+	MicrocDB_Release(&First);
+	CHECK(Value("dev10").DBstatus == NOT_FOUND);
+	InsertBlock(20);
+	CHECK_FOUND(First = Value("dev21"), "210");
+	MicrocDB_Release(&First);
+	return 0;
+}
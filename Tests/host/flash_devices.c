@@ -0,0 +1,103 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The NOR flash chips of flash_devices.h emulated in the last pages of the emulated flash. The state of a device
+ *      			 is shared with the boots like the flash, so an erase begun by a boot which lost the power is not done.
+ * */
+
+#include "flash_devices.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define DEVICE_ERASE_MICROS 20000
+#define DEVICE_POLL_MICROS 100
+
+typedef struct {
+	uint32_t ErasePage; /*The page being erased or 0*/
+	uint32_t DoneMicros; /*The emulated time when the erase or program is done*/
+	uint32_t Erases;
+} flash_device_State;
+
+static flash_device_State *State; /*Shared with the boots like the flash*/
+
+__attribute__((constructor)) static void DevicesStart(void) {
+	State = mmap(0, 2 * sizeof(flash_device_State), PROT_READ | PROT_WRITE,
+	MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (State == MAP_FAILED) {
+		fprintf(stderr, "flash_devices: can't map the state\n");
+		exit(2);
+	}
+	memset(State, 0, 2 * sizeof(flash_device_State));
+}
+
+static int InWindow(uint8_t Device, uint32_t Address, size_t Size) {
+	return Address >= FLASH_DEVICE_WINDOW(Device)
+			&& Address + Size <= FLASH_DEVICE_WINDOW(Device + 1);
+}
+
+static bool Busy(uint8_t Device) {
+	if (FlashEmuMicros() < State[Device].DoneMicros) {
+		FlashEmuWait(DEVICE_POLL_MICROS);
+		return true;
+	}
+	if (State[Device].ErasePage != 0) {
+		memset((void*) (uintptr_t) State[Device].ErasePage, 0xFF, FLASH_PAGE_SIZE);
+		State[Device].ErasePage = 0;
+	}
+	return false;
+}
+
+static bool EraseBegin(uint8_t Device, uint32_t PageAddress) {
+	if (Busy(Device) || (PageAddress % FLASH_PAGE_SIZE) != 0
+			|| !InWindow(Device, PageAddress, FLASH_PAGE_SIZE)) {
+		return false;
+	}
+	State[Device].ErasePage = PageAddress;
+	State[Device].DoneMicros = FlashEmuMicros() + DEVICE_ERASE_MICROS;
+	State[Device].Erases++;
+	return true;
+}
+
+static bool Program(uint8_t Device, uint32_t Address, uint8_t *Data,
+		size_t NumberOfBytes) {
+	uint8_t *Window = (uint8_t*) (uintptr_t) Address;
+	size_t Index;
+
+	if (Busy(Device) || !InWindow(Device, Address, NumberOfBytes)) {
+		return false;
+	}
+	for (Index = 0; Index < NumberOfBytes; Index++) {
+		Window[Index] &= Data[Index];
+	}
+	State[Device].DoneMicros = FlashEmuMicros() + NumberOfBytes;
+	return true;
+}
+
+bool FlashDevice0EraseBegin(uint32_t PageAddress) {
+	return EraseBegin(0, PageAddress);
+}
+
+bool FlashDevice0Busy(void) {
+	return Busy(0);
+}
+
+bool FlashDevice0Program(uint32_t Address, uint8_t *Data, size_t NumberOfBytes) {
+	return Program(0, Address, Data, NumberOfBytes);
+}
+
+bool FlashDevice1EraseBegin(uint32_t PageAddress) {
+	return EraseBegin(1, PageAddress);
+}
+
+bool FlashDevice1Busy(void) {
+	return Busy(1);
+}
+
+bool FlashDevice1Program(uint32_t Address, uint8_t *Data, size_t NumberOfBytes) {
+	return Program(1, Address, Data, NumberOfBytes);
+}
+
+uint32_t FlashDeviceErases(uint8_t Device) {
+	return State[Device].Erases;
+}
@@ -0,0 +1,47 @@
+/**
+ * ******************************************************************************
+ * @file            flash_devices.h
+ * @brief           Two NOR flash chips emulated for MICROCDB_DEVICES. Their windows are the last pages of the emulated flash so they
+ *                  are read through pointers like in the memory mapped mode of QSPI. A test uses them with:
+ *                  CONFIG MICROCDB_DEVICES 2
+ *                  CONFIG MICROCDB_DEVICE_TABLE FLASH_DEVICE_TABLE
+ * @author          Mrunal Ahirao
+ ******************************************************************************
+ **/
+
+#ifndef FLASH_DEVICES_H_
+#define FLASH_DEVICES_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "stm32f0xx_hal.h"
+
+#define FLASH_DEVICE_PAGES 16U /*The pages of PAGE_SIZE in the window of every device*/
+
+/*The first address of the window of device 0 or 1*/
+#define FLASH_DEVICE_WINDOW(Device) (FLASH_EMU_BASE + FLASH_EMU_SIZE - ((2U - (Device)) * FLASH_DEVICE_PAGES * FLASH_PAGE_SIZE))
+
+/*The entries of MICROCDB_DEVICE_TABLE for both the devices*/
+#define FLASH_DEVICE_TABLE \
+	{FLASH_DEVICE_WINDOW(0), FLASH_DEVICE_WINDOW(1) - 1, FlashDevice0EraseBegin, FlashDevice0Busy, FlashDevice0Program}, \
+	{FLASH_DEVICE_WINDOW(1), FLASH_DEVICE_WINDOW(2) - 1, FlashDevice1EraseBegin, FlashDevice1Busy, FlashDevice1Program}
+
+/**
+ * @brief The functions of MICROCDB_DEVICE_TABLE. An erase takes 20 ms of the emulated time and its page is erased only when Busy()
+ * finds it done, so the window has the old bytes till the device is waited for. A program clears the bits of the bytes like NOR flash
+ * and keeps the device busy for 1 us per byte. Busy() passes 100 us of the emulated time.
+ */
+bool FlashDevice0EraseBegin(uint32_t PageAddress);
+bool FlashDevice0Busy(void);
+bool FlashDevice0Program(uint32_t Address, uint8_t *Data, size_t NumberOfBytes);
+bool FlashDevice1EraseBegin(uint32_t PageAddress);
+bool FlashDevice1Busy(void);
+bool FlashDevice1Program(uint32_t Address, uint8_t *Data, size_t NumberOfBytes);
+
+/**
+ * @brief This function gives the number of erases begun on the device.
+ */
+uint32_t FlashDeviceErases(uint8_t Device);
+
+#endif /* FLASH_DEVICES_H_ */
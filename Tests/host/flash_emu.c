@@ -0,0 +1,177 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The flash of STM32F0 emulated on Linux. A page is erased to 0xFF and a half word can be programmed only if it is
+ *      			 erased, except to 0x0000, else the program fails like PGERR. The flash is mapped shared so a boot run in a child
+ *      			 process by FlashEmuBoot() changes it, and a power loss is emulated by exiting that process before an operation.
+ *      			 The time is emulated too, it passes only in the flash operations so the latencies are same on every run.
+ * */
+
+#include "stm32f0xx_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define ERASE_MICROS 20000 /*The typical time of the page erase and half word program of STM32F0*/
+#define PROGRAM_MICROS 50
+
+typedef struct {
+	flash_emu_Counts Counts;
+	uint64_t Micros; /*The time passed in the flash operations*/
+	uint32_t PowerLossAfter; /*The operations remaining till the power is lost or 0*/
+} flash_emu_State;
+
+static flash_emu_State *State; /*Shared with the boots like the flash*/
+
+static void EmuMap(void) {
+	void *Flash = mmap((void*) (uintptr_t) FLASH_EMU_BASE, FLASH_EMU_SIZE,
+	PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+	State = mmap(0, sizeof(flash_emu_State), PROT_READ | PROT_WRITE,
+	MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (Flash != (void*) (uintptr_t) FLASH_EMU_BASE || State == MAP_FAILED) {
+		fprintf(stderr, "flash_emu: can't map the flash at 0x%08X\n",
+		FLASH_EMU_BASE);
+		exit(2);
+	}
+	FlashEmuErase();
+}
+
+/*The flash is mapped before main() so the tests begin with an erased MCU*/
+__attribute__((constructor)) static void EmuStart(void) {
+	EmuMap();
+}
+
+/*
+ * This function counts an operation and loses the power if it is the one after the last.
+ */
+static void EmuOperation(void) {
+	if (State->PowerLossAfter != 0) {
+		State->PowerLossAfter--;
+		if (State->PowerLossAfter == 0) {
+			_exit(0);
+		}
+	}
+}
+
+static int EmuInFlash(uint32_t Address, uint32_t Size) {
+	return Address >= FLASH_EMU_BASE
+			&& Address + Size <= FLASH_EMU_BASE + FLASH_EMU_SIZE;
+}
+
+static HAL_StatusTypeDef EmuProgramHalfWord(uint32_t Address, uint16_t Data) {
+	volatile uint16_t *HalfWord = (volatile uint16_t*) (uintptr_t) Address;
+
+	if ((Address & 1) != 0 || !EmuInFlash(Address, 2)) {
+		return HAL_ERROR;
+	}
+	EmuOperation();
+	State->Counts.HalfWordsProgrammed++;
+	State->Micros += PROGRAM_MICROS;
+	if (*HalfWord != 0xFFFF && Data != 0) {
+		State->Counts.ProgramErrors++;
+		return HAL_ERROR;
+	}
+	*HalfWord = Data;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) {
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void) {
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit,
+		uint32_t *PageError) {
+	uint32_t Page;
+
+	*PageError = 0xFFFFFFFF;
+	for (Page = 0; Page < pEraseInit->NbPages; Page++) {
+		uint32_t Address = pEraseInit->PageAddress + Page * FLASH_PAGE_SIZE;
+
+		if ((Address % FLASH_PAGE_SIZE) != 0
+				|| !EmuInFlash(Address, FLASH_PAGE_SIZE)) {
+			*PageError = Address;
+			return HAL_ERROR;
+		}
+		EmuOperation();
+		State->Counts.PageErases++;
+		State->Micros += ERASE_MICROS;
+		memset((void*) (uintptr_t) Address, 0xFF, FLASH_PAGE_SIZE);
+	}
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address,
+		uint64_t Data) {
+	uint32_t HalfWords = TypeProgram == FLASH_TYPEPROGRAM_HALFWORD ? 1 :
+							TypeProgram == FLASH_TYPEPROGRAM_WORD ? 2 : 4;
+	uint32_t Index;
+
+	for (Index = 0; Index < HalfWords; Index++) {
+		if (EmuProgramHalfWord(Address + 2 * Index, (uint16_t) Data) != HAL_OK) {
+			return HAL_ERROR;
+		}
+		Data = Data >> 16;
+	}
+	return HAL_OK;
+}
+
+uint32_t HAL_GetTick(void) {
+	return (uint32_t) (State->Micros / 1000);
+}
+
+uint32_t FlashEmuMicros(void) {
+	return (uint32_t) State->Micros;
+}
+
+void FlashEmuWait(uint32_t Micros) {
+	State->Micros += Micros;
+}
+
+void FlashEmuErase(void) {
+	memset((void*) (uintptr_t) FLASH_EMU_BASE, 0xFF, FLASH_EMU_SIZE);
+	memset(State, 0, sizeof(flash_emu_State));
+}
+
+flash_emu_Counts FlashEmuCounts(void) {
+	return State->Counts;
+}
+
+void FlashEmuPowerLossAfter(uint32_t Operations) {
+	State->PowerLossAfter = Operations;
+}
+
+int FlashEmuBoot(int (*Boot)(void)) {
+	int Status;
+	pid_t Child;
+
+	fflush(stdout);
+	Child = fork();
+	if (Child == 0) {
+		_exit(Boot());
+	}
+	if (Child < 0 || waitpid(Child, &Status, 0) != Child
+			|| !WIFEXITED(Status)) {
+		return -1;
+	}
+	State->PowerLossAfter = 0;
+	return WEXITSTATUS(Status);
+}
+
+void FlashEmuSwap(uint8_t *Image) {
+	uint8_t *Flash = (uint8_t*) (uintptr_t) FLASH_EMU_BASE;
+	uint8_t Byte;
+	uint32_t Index;
+
+	for (Index = 0; Index < FLASH_EMU_SIZE; Index++) {
+		Byte = Flash[Index];
+		Flash[Index] = Image[Index];
+		Image[Index] = Byte;
+	}
+}
@@ -0,0 +1,100 @@
+/**
+ * ******************************************************************************
+ * @file            stm32f0xx_hal.h
+ * @brief           The flash part of STM32F0 HAL emulated on Linux, so microcDB is built and tested on the host. The flash is mapped at
+ *                  FLASH_EMU_BASE like on the MCU so the pointers to it fit in uint32_t.
+ * @author          Mrunal Ahirao
+ ******************************************************************************
+ **/
+
+#ifndef STM32F0XX_HAL_H_
+#define STM32F0XX_HAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FLASH_PAGE_SIZE 1024U
+
+/*The emulated flash, 256 pages from the address of the internal flash of STM32F0*/
+#define FLASH_EMU_BASE 0x08000000U
+#define FLASH_EMU_SIZE (256U * FLASH_PAGE_SIZE)
+
+typedef enum {
+	HAL_OK = 0, HAL_ERROR = 1, HAL_BUSY = 2, HAL_TIMEOUT = 3
+} HAL_StatusTypeDef;
+
+typedef struct {
+	uint32_t TypeErase;
+	uint32_t PageAddress;
+	uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+#define FLASH_TYPEERASE_PAGES 0x00U
+#define FLASH_TYPEERASE_MASSERASE 0x01U
+
+#define FLASH_TYPEPROGRAM_HALFWORD 0x01U
+#define FLASH_TYPEPROGRAM_WORD 0x02U
+#define FLASH_TYPEPROGRAM_DOUBLEWORD 0x03U
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit,
+		uint32_t *PageError);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address,
+		uint64_t Data);
+uint32_t HAL_GetTick(void);
+
+/*Emulator*/
+
+/**
+ * @brief The counts of the operations done on the emulated flash since it was started.
+ */
+typedef struct {
+	uint32_t PageErases;
+	uint32_t HalfWordsProgrammed;
+	uint32_t ProgramErrors; /*Programs of half words which were not erased, PGERR on STM32F0*/
+} flash_emu_Counts;
+
+/**
+ * @brief This function gives the microseconds of the emulated time, HAL_GetTick() gives its milliseconds. The time passes only by the
+ * flash operations, 20 ms for a page erase and 50 us for a half word program, and by FlashEmuWait().
+ */
+uint32_t FlashEmuMicros(void);
+
+/**
+ * @brief This function passes the emulated time, like the time taken by an external device.
+ */
+void FlashEmuWait(uint32_t Micros);
+
+/**
+ * @brief This function fills the emulated flash with 0xFF like a new MCU and resets the counts and the power loss.
+ */
+void FlashEmuErase(void);
+
+/**
+ * @brief This function gives the counts of operations.
+ */
+flash_emu_Counts FlashEmuCounts(void);
+
+/**
+ * @brief This function loses the power after the given number of page erases and half word programs are done, i.e the process of the
+ * boot exits without completing the next one. 0 disables it.
+ */
+void FlashEmuPowerLossAfter(uint32_t Operations);
+
+/**
+ * @brief This function runs the function as a boot of MCU in a child process. The flash is shared with it but the RAM isn't, so the
+ * next boot begins with the RAM of the caller as after a reset.
+ * @returns the exit status of boot, 0 if it returned 0 or the power was lost.
+ */
+int FlashEmuBoot(int (*Boot)(void));
+
+/**
+ * @brief This function exchanges the emulated flash with the image in RAM of FLASH_EMU_SIZE bytes, so several devices are emulated
+ * one after another.
+ */
+void FlashEmuSwap(uint8_t *Image);
+
+/*Emulator*/
+
+#endif /* STM32F0XX_HAL_H_ */
@@ -0,0 +1,64 @@
+/**
+ * ******************************************************************************
+ * @file            test.h
+ * @brief           The checks used by the tests of microcDB on the flash emulator. A test is a main() which returns 0 if it passed.
+ *                  The lines " * CONFIG <macro> <value>" in the comment at the top of a test set the macros of microcDB_config.h it is
+ *                  built with.
+ * @author          Mrunal Ahirao
+ ******************************************************************************
+ **/
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <microDB.h>
+
+/**
+ * @brief Fails the test if the condition is false.
+ */
+#define CHECK(Condition) do { \
+	if (!(Condition)) { \
+		printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #Condition); \
+		exit(1); \
+	} \
+} while (0)
+
+/**
+ * @brief Fails the test if the data found is not the text.
+ */
+#define CHECK_FOUND(Data, Text) CHECK(TestFound((Data), (Text)))
+
+/**
+ * @brief Fails the test if a boot of FlashEmuBoot() failed.
+ */
+#define CHECK_BOOT(Boot) CHECK(FlashEmuBoot(Boot) == 0)
+
+/*
+ * This function checks that the data was found and its bytes from DBStartptr to DBEndptr are the text.
+ */
+static inline int TestFound(microcDB_Data Data, const char *Text) {
+	size_t Length = strlen(Text);
+
+	if (Data.DBstatus != FOUND_SUCCESS
+			|| (size_t) (Data.DBEndptr + 1 - Data.DBStartptr) != Length
+			|| memcmp(Data.DBStartptr, Text, Length) != 0) {
+		if (Data.DBstatus == FOUND_SUCCESS) {
+			printf("found '%.*s' instead of '%s'\n",
+					(int) (Data.DBEndptr + 1 - Data.DBStartptr),
+					(char*) Data.DBStartptr, Text);
+		} else {
+			printf("status %d instead of '%s'\n", Data.DBstatus, Text);
+		}
+		return 0;
+	}
+	return 1;
+}
+
+/*The strings given to microcDB are uint8_t and writable, as the single quotes are replaced in them. MicrocDB_Insert() reads them a
+ word at a time so they are padded with a word of 0*/
+#define S(Text) ((uint8_t[sizeof(Text) + 4]) {Text})
+
+#endif /* TEST_H_ */
@@ -0,0 +1,71 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The key index has the top level keys of all the documents. The writes change only the entries they affect so they
+ *      			 don't parse the whole DB, and the index stays right when an update shifts the members in the slack of document or
+ *      			 relocates a member object.
+ *
+ * CONFIG MICROCDB_KEY_INDEX_SIZE 16
+ * CONFIG MICROCDB_OBJECT_SLACK 32
+ * CONFIG MICROCDB_RELOCATION 1
+ * CONFIG MICROCDB_RELOCATION_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_RELOCATION_END_ADDR 0x0800CFFF
+ * CONFIG MICROCDB_STATS 1
+ * */
+
+#include "test.h"
+
+static void CheckAll(const char *b, const char *d) {
+	CHECK_FOUND(MicrocDB_Find(S("a./")), "1");
+	CHECK_FOUND(MicrocDB_Find(S("b./")), b);
+	CHECK_FOUND(MicrocDB_Find(S("c.d./")), d);
+	CHECK_FOUND(MicrocDB_Find(S("n./")), "0123456789012345678901234567890123456789");
+	CHECK_FOUND(MicrocDB_Find(S("e./")), "7");
+	CHECK_FOUND(MicrocDB_Find(S("f./")), "8");
+}
+
+static int Write(void) {
+	microcDB_Stats Insert, Update;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'a':1,'b':'xy','c':{'d':5},'n':'0123456789012345678901234567890123456789'}/"), 1) == STORE_SUCCESS);
+	CHECK(MicrocDB_Insert(S("{'e':7}/"), 1) == STORE_SUCCESS);
+
+	/*Only the inserted document is parsed*/
+	MicrocDB_ResetStats();
+	CHECK(MicrocDB_Insert(S("{'f':8}/"), 1) == STORE_SUCCESS);
+	MicrocDB_GetStats(STATS_OP_INSERT, &Insert);
+	CHECK(Insert.ParserBytes > 0 && Insert.ParserBytes < 64);
+	CheckAll("xy", "5");
+
+	/*The failed write doesn't parse anything*/
+	MicrocDB_ResetStats();
+	CHECK(MicrocDB_Update(S("none./"), S("1/")) == PATH_NOT_FOUND);
+	MicrocDB_GetStats(STATS_OP_UPDATE, &Update);
+	CHECK(Update.ParserBytes == 0);
+
+	/*The members after b are shifted in the slack of document*/
+	CHECK(MicrocDB_Update(S("b./"), S("'xyz12'/")) == UPDATE_SUCCESSFUL);
+	CheckAll("xyz12", "5");
+	CHECK(MicrocDB_Update(S("b./"), S("'x'/")) == UPDATE_SUCCESSFUL);
+	CheckAll("x", "5");
+
+	/*The object c is relocated as d outgrows its slack*/
+	CHECK(MicrocDB_Update(S("c.d./"), S("'abcdefghijklmnopqrstuvwxyz0123'/")) == UPDATE_SUCCESSFUL);
+	CHECK(*(uint8_t*) (MICROCDB_RELOCATION_START_ADDR + 4) != 0xFF); /*After the generation of first bank*/
+	CheckAll("x", "abcdefghijklmnopqrstuvwxyz0123");
+	CHECK(MicrocDB_Update(S("b./"), S("'xyz'/")) == UPDATE_SUCCESSFUL);
+	CheckAll("xyz", "abcdefghijklmnopqrstuvwxyz0123");
+	return 0;
+}
+
+static int Read(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CheckAll("xyz", "abcdefghijklmnopqrstuvwxyz0123");
+	return 0;
+}
+
+int main(void) {
+	CHECK_BOOT(Write);
+	CHECK_BOOT(Read);
+	return 0;
+}
@@ -0,0 +1,38 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The latency histograms record the latency of the calls and of the flash primitives in the ticks of the clock. The
+ *      			 emulated time passes only in the flash operations so a page erase takes 20 ticks of HAL_GetTick().
+ *
+ * CONFIG MICROCDB_LATENCY 1
+ * */
+
+#include "test.h"
+
+int main(void) {
+	microcDB_Latency Latency;
+	int Index;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	MicrocDB_ResetLatency();
+	CHECK(MicrocDB_Insert(S("{'a':1,'b':'xyz'}/"), 1) == STORE_SUCCESS);
+	for (Index = 0; Index < 10; Index++) {
+		CHECK_FOUND(MicrocDB_Find(S("b./")), "xyz");
+	}
+	CHECK(MicrocDB_Update(S("a./"), S("2/")) == UPDATE_SUCCESSFUL);
+
+	MicrocDB_GetLatency(LATENCY_OP_FIND, &Latency);
+	CHECK(Latency.Count == 10 && Latency.Buckets[0] == 10 && Latency.Max == 0);
+
+	MicrocDB_GetLatency(LATENCY_OP_ERASE_PAGE, &Latency);
+	CHECK(Latency.Count == 1 && Latency.Max == 20);
+	CHECK(Latency.Buckets[5] == 1 && Latency.P50 == 20 && Latency.P99 == 20); /*16..31 limited by Max*/
+
+	/*The update erases and writes a page, 512 half words of 50 us*/
+	MicrocDB_GetLatency(LATENCY_OP_UPDATE, &Latency);
+	CHECK(Latency.Count == 1 && Latency.Max >= 20 + 25 && Latency.Max <= 20 + 26);
+
+	MicrocDB_ResetLatency();
+	MicrocDB_GetLatency(LATENCY_OP_UPDATE, &Latency);
+	CHECK(Latency.Count == 0 && Latency.P99 == 0);
+	return 0;
+}
@@ -0,0 +1,198 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The inserts and updates are buffered and found without being applied, also in the values found in DB, and the values
+ *      			 found stay valid when the buffered writes change. The journal skips a record which failed, and when the power is lost
+ *      			 at any flash operation of journaling the writes journaled completely are applied by MicrocDB_Init(). When the power is
+ *      			 lost while MicrocDB_Sync() applies the writes, every write is applied once by MicrocDB_Init().
+ *
+ * CONFIG MICROCDB_MEMTABLE_BYTES 512
+ * CONFIG MICROCDB_MEMTABLE_LOG_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_MEMTABLE_LOG_END_ADDR 0x0800C7FF
+ * CONFIG MICROCDB_MEMTABLE_UNDO_START_ADDR 0x0800C800
+ * CONFIG MICROCDB_MEMTABLE_UNDO_END_ADDR 0x08010BFF
+ * CONFIG MICROCDB_OBJECT_SLACK 16
+ * */
+
+#include "test.h"
+
+static uint8_t Image[FLASH_EMU_SIZE];
+static uint8_t Synced[MICROCDB_END_ADDR + 1 - MICROCDB_START_ADDR];
+static uint8_t Applied[MICROCDB_END_ADDR + 1 - MICROCDB_START_ADDR]; /*The DB after the writes of SyncWrites() are applied*/
+static int SyncAfter; /*SyncWrites() applies the writes it buffers*/
+
+static void CheckAll(const char *a, const char *b) {
+	CHECK_FOUND(MicrocDB_Find(S("a./")), a);
+	CHECK_FOUND(MicrocDB_Find(S("b./")), b);
+	CHECK_FOUND(MicrocDB_Find(S("c.d./")), "7");
+	CHECK_FOUND(MicrocDB_Find(S("o./")), "{\"p\":1,\"q\":\"w\"}");
+	CHECK_FOUND(MicrocDB_Find(S("s.x./")), "y");
+}
+
+static int Buffer(void) {
+	microcDB_Data Data;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'a':'x','b':'yy','c':{'d':5},'o':{'p':1},'s':0}/"), 1) == STORE_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("a./")), "x");
+	CHECK(MicrocDB_Sync() == UPDATE_SUCCESSFUL);
+	memcpy(Synced, (void*) (uintptr_t) MICROCDB_START_ADDR, sizeof(Synced));
+
+	/*The values in the object found in DB are the buffered ones*/
+	CHECK(MicrocDB_Update(S("a./"), S("'z'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Update(S("c.d./"), S("7/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Update(S("o./"), S("'q':'w'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Update(S("s./"), S("{'x':'y'}/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("c./")), "{\"d\":7}");
+	CHECK_FOUND(MicrocDB_Find(S("o./")), "{\"p\":1,\"q\":\"w\"}");
+	CHECK_FOUND(MicrocDB_Find(S("o.p./")), "1");
+	CHECK_FOUND(MicrocDB_Find(S("o.q./")), "w");
+	CHECK_FOUND(MicrocDB_Find(S("s.x./")), "y");
+
+	/*The value found is not changed by the writes buffered after it*/
+	Data = MicrocDB_Find(S("a./"));
+	CHECK_FOUND(Data, "z");
+	CHECK(MicrocDB_Update(S("b./"), S("'qq'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Update(S("a./"), S("'w'/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(Data, "z");
+	CHECK(memcmp(Synced, (void*) (uintptr_t) MICROCDB_START_ADDR, sizeof(Synced)) == 0); /*The DB is written only by the sync*/
+
+	CheckAll("w", "qq");
+	CHECK(MicrocDB_Sync() == UPDATE_SUCCESSFUL);
+	CheckAll("w", "qq");
+	return 0;
+}
+
+static int FailRecord(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CheckAll("w", "qq");
+
+	/*The bytes of the first record can't be programmed so it is skipped*/
+	*(uint16_t*) (MICROCDB_MEMTABLE_LOG_START_ADDR + 16) = 0;
+	CHECK(MicrocDB_Update(S("b./"), S("'rr'/")) == UPDATE_FAILED);
+	CHECK(MicrocDB_Update(S("a./"), S("'v'/")) == UPDATE_SUCCESSFUL);
+	return 0;
+}
+
+static int Recover(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CheckAll("v", "qq");
+	return 0;
+}
+
+static int Write(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Update(S("a./"), S("'A'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Update(S("b./"), S("'BB'/")) == UPDATE_SUCCESSFUL);
+	CheckAll("A", "BB");
+	return 0;
+}
+
+static int Reboot(void) {
+	microcDB_Data a, b;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	a = MicrocDB_Find(S("a./"));
+	CHECK(TestFound(a, "v") || TestFound(a, "A"));
+	b = MicrocDB_Find(S("b./"));
+	CHECK(TestFound(b, "qq") || (TestFound(b, "BB") && *a.DBStartptr == 'A')); /*b was journaled after a*/
+
+	/*The journal is written again*/
+	CHECK(MicrocDB_Update(S("a./"), S("'C'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Sync() == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("a./")), "C");
+	return 0;
+}
+
+static int Base(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'n':0,'o':{'p':1},'r':'ab','s':'cd','t':{'u':0}}/"), 1) == STORE_SUCCESS);
+	CHECK(MicrocDB_Sync() == UPDATE_SUCCESSFUL);
+	return 0;
+}
+
+/*
+ * The writes are a document inserted, a member added, a value written in place, one which fits in the slack of its object and one which
+ * grows the slack.
+ */
+static int SyncWrites(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'n':1}/"), 1) == STORE_SUCCESS);
+	CHECK(MicrocDB_Update(S("o./"), S("'q':2/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Update(S("s./"), S("'ef'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Update(S("r./"), S("'abcdef'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Update(S("t.u./"), S("'value of u which is longer than the slack'/")) == UPDATE_SUCCESSFUL);
+	if (SyncAfter) {
+		CHECK(MicrocDB_Sync() == UPDATE_SUCCESSFUL);
+	}
+	return 0;
+}
+
+static int AfterSyncLoss(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(memcmp(Applied, (void*) (uintptr_t) MICROCDB_START_ADDR, sizeof(Applied)) == 0);
+	CHECK_FOUND(MicrocDB_Find(S("o./")), "{\"p\":1,\"q\":2}");
+	CHECK_FOUND(MicrocDB_Find(S("r./")), "abcdef");
+	CHECK_FOUND(MicrocDB_Find(S("s./")), "ef");
+	CHECK_FOUND(MicrocDB_Find(S("t.u./")), "value of u which is longer than the slack");
+	CHECK(*(uint16_t*) MICROCDB_MEMTABLE_UNDO_START_ADDR == 0xFFFF);
+
+	/*The documents are still appended to DB after the journal was erased*/
+	CHECK(MicrocDB_Insert(S("{'n':2}/"), 1) == STORE_SUCCESS);
+	CHECK(MicrocDB_Sync() == UPDATE_SUCCESSFUL);
+	CHECK(FlashAddresscntr < MICROCDB_MEMTABLE_LOG_START_ADDR);
+	CHECK(memcmp(Applied, (void*) (uintptr_t) MICROCDB_START_ADDR, FlashAddresscntr - MICROCDB_START_ADDR) != 0);
+	return 0;
+}
+
+int main(void) {
+	flash_emu_Counts Counts;
+	uint32_t Operations, Loss, Buffered;
+
+	CHECK_BOOT(Buffer);
+	CHECK_BOOT(FailRecord);
+	CHECK_BOOT(Recover);
+	memcpy(Image, (void*) (uintptr_t) FLASH_EMU_BASE, FLASH_EMU_SIZE);
+
+	/*The flash operations of journaling the writes without power loss*/
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed;
+	CHECK_BOOT(Write);
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed - Operations;
+
+	/*The power is lost at every operation of journaling, then the writes journaled completely are applied by the reset*/
+	for (Loss = 1; Loss < Operations; Loss++) {
+		memcpy((void*) (uintptr_t) FLASH_EMU_BASE, Image, FLASH_EMU_SIZE);
+		FlashEmuPowerLossAfter(Loss);
+		CHECK(FlashEmuBoot(Write) == 0);
+		CHECK_BOOT(Reboot);
+	}
+
+	/*The flash operations of buffering the writes and of applying them*/
+	FlashEmuErase();
+	CHECK_BOOT(Base);
+	memcpy(Image, (void*) (uintptr_t) FLASH_EMU_BASE, FLASH_EMU_SIZE);
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed;
+	SyncAfter = 0;
+	CHECK_BOOT(SyncWrites);
+	Counts = FlashEmuCounts();
+	Buffered = Counts.PageErases + Counts.HalfWordsProgrammed - Operations;
+	memcpy((void*) (uintptr_t) FLASH_EMU_BASE, Image, FLASH_EMU_SIZE);
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed;
+	SyncAfter = 1;
+	CHECK_BOOT(SyncWrites);
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed - Operations;
+	memcpy(Applied, (void*) (uintptr_t) MICROCDB_START_ADDR, sizeof(Applied));
+
+	/*The power is lost at every 5th operation of MicrocDB_Sync(), then the writes are applied once by the reset*/
+	for (Loss = Buffered + 1; Loss < Operations; Loss += 5) {
+		memcpy((void*) (uintptr_t) FLASH_EMU_BASE, Image, FLASH_EMU_SIZE);
+		FlashEmuPowerLossAfter(Loss);
+		CHECK(FlashEmuBoot(SyncWrites) == 0);
+		CHECK_BOOT(AfterSyncLoss);
+	}
+	return 0;
+}
@@ -0,0 +1,28 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The projection gives the values of several members of an object in one visit, the same as MicrocDB_Find().
+ *
+ * CONFIG MICROCDB_PROJECTION 1
+ * */
+
+#include "test.h"
+
+int main(void) {
+	uint8_t *Keys[] = { S("name./"), S("temp./"), S("none./"), S("cfg./") };
+	microcDB_Data Results[4];
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'status':{'temp':21,'cfg':{'temp':5},'hum':40,'name':'node1'},'list':[1]}/"), 1) == STORE_SUCCESS);
+
+	/*The member of the nested object is not given for the key of status*/
+	CHECK(MicrocDB_Project(S("status./"), Keys, 4, Results) == FOUND_SUCCESS);
+	CHECK_FOUND(Results[0], "node1");
+	CHECK_FOUND(Results[1], "21");
+	CHECK(Results[2].DBstatus == NOT_FOUND);
+	CHECK_FOUND(Results[3], "{\"temp\":5}");
+	CHECK_FOUND(MicrocDB_Find(S("status.name./")), "node1");
+
+	CHECK(MicrocDB_Project(S("none./"), Keys, 4, Results) == PATH_NOT_FOUND);
+	CHECK(MicrocDB_Project(S("list./"), Keys, 4, Results) == QUERY_INVALID);
+	return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The object which outgrows its slack is relocated behind a forwarding marker and found by following the markers,
+ *      			 across reboots. A relocation which was not completely written is skipped and the old object is still used.
+ *
+ * CONFIG MICROCDB_OBJECT_SLACK 12
+ * CONFIG MICROCDB_RELOCATION 1
+ * CONFIG MICROCDB_RELOCATION_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_RELOCATION_END_ADDR 0x0800C7FF
+ * */
+
+#include "test.h"
+
+/*
+ * This function gives the address after the last record written.
+ */
+static uint32_t FreeAddress(void) {
+	uint8_t *Record = (uint8_t*) MICROCDB_RELOCATION_START_ADDR + 4; /*After the generation of first bank*/
+
+	while (*(uint16_t*) Record != 0xFFFF) {
+		Record += *(uint16_t*) Record;
+	}
+	return (uint32_t) Record;
+}
+
+static int Relocate(void) {
+	uint32_t Address;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'id':1,'c':{'d':5,'e':'x'}}/"), 1) == STORE_SUCCESS);
+
+	/*Every update which outgrows the slack of the latest copy relocates it again*/
+	CHECK(MicrocDB_Update(S("c.e./"), S("'abcdefghijklmnop'/")) == UPDATE_SUCCESSFUL);
+	CHECK(FreeAddress() != MICROCDB_RELOCATION_START_ADDR + 4);
+	Address = FreeAddress();
+	CHECK(MicrocDB_Update(S("c./"), S("'f':'0123456789abcdef'/")) == UPDATE_SUCCESSFUL);
+	CHECK(FreeAddress() > Address);
+	CHECK_FOUND(MicrocDB_Find(S("c./")), "{\"d\":5,\"e\":\"abcdefghijklmnop\",\"f\":\"0123456789abcdef\"}");
+	CHECK_FOUND(MicrocDB_Find(S("c.f./")), "0123456789abcdef");
+	CHECK_FOUND(MicrocDB_Find(S("id./")), "1");
+
+	/*The relocation fails after the size of its record was written*/
+	Address = FreeAddress();
+	CHECK(HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, Address + 8, 0) == HAL_OK);
+	CHECK(MicrocDB_Update(S("c.d./"), S("'the value of d is long'/")) == UPDATE_FAILED);
+	CHECK_FOUND(MicrocDB_Find(S("c.d./")), "5");
+	CHECK(MicrocDB_Update(S("c.d./"), S("'the value of d is long'/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("c.d./")), "the value of d is long");
+
+	/*The power is lost while the next one is written*/
+	FlashEmuPowerLossAfter(4);
+	MicrocDB_Update(S("c./"), S("'g':'the value of g is long too'/"));
+	return 1;
+}
+
+static int Reboot(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK_FOUND(MicrocDB_Find(S("c.d./")), "the value of d is long");
+	CHECK(MicrocDB_Find(S("c.g./")).DBstatus == NOT_FOUND);
+	CHECK(MicrocDB_Update(S("c./"), S("'g':'the value of g is long too'/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("c.g./")), "the value of g is long too");
+	CHECK_FOUND(MicrocDB_Find(S("c.f./")), "0123456789abcdef");
+	return 0;
+}
+
+static int Reclaim(void) {
+	char Value[96];
+	uint32_t Updates, Length;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+
+	/*Every update outgrows the slack so the object is relocated until the first bank is full and its latest copy is moved to the
+	 * second one*/
+	for (Updates = 0; *(uint32_t*) (MICROCDB_RELOCATION_START_ADDR + 0x400) == 0xFFFFFFFF; Updates++) {
+		CHECK(Updates < 16);
+		Value[0] = '\'';
+		for (Length = 1; Length <= 16 + (Updates * 16) % 64; Length++) {
+			Value[Length] = 'a' + Updates;
+		}
+		Value[Length] = '\'';
+		Value[Length + 1] = '/';
+		Value[Length + 2] = 0;
+		CHECK(MicrocDB_Update(S("c.e./"), (uint8_t*) Value) == UPDATE_SUCCESSFUL);
+		Value[Length] = 0;
+		CHECK_FOUND(MicrocDB_Find(S("c.e./")), Value + 1);
+	}
+
+	/*The documents are still appended to DB after the banks were erased*/
+	CHECK(MicrocDB_Insert(S("{'id':2}/"), 1) == STORE_SUCCESS);
+	CHECK(FlashAddresscntr < MICROCDB_RELOCATION_START_ADDR);
+	CHECK_FOUND(MicrocDB_Find(S("c.g./")), "the value of g is long too");
+	return 0;
+}
+
+static int AfterReclaim(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Find(S("c.e./")).DBstatus == FOUND_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("c.f./")), "0123456789abcdef");
+	return 0;
+}
+
+int main(void) {
+	CHECK_BOOT(Relocate);
+	CHECK_BOOT(Reboot);
+	CHECK_BOOT(Reclaim);
+	CHECK_BOOT(AfterReclaim);
+	return 0;
+}
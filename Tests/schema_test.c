@@ -0,0 +1,94 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The schema compiled records are validated, stored at constant offsets and found again after a reboot. When the
+ *      			 power is lost at any flash operation of storing a record, it is not found and the next records are stored after it.
+ *
+ * CONFIG MICROCDB_SCHEMA_SUPPORT 1
+ * CONFIG MICROCDB_SCHEMA_START_ADDR 0x08010000
+ * CONFIG MICROCDB_SCHEMA_END_ADDR 0x08010FFF
+ * */
+
+#include "test.h"
+
+static uint8_t Image[FLASH_EMU_SIZE];
+
+static int Store(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_RegisterSchema(S("{'temp':'i16','hum':'u8','name':'s8'}/")) == SCHEMA_REGISTERED);
+	CHECK(MicrocDB_InsertRecord(S("{'temp':-12,'hum':40,'name':'node1'}/")) == STORE_SUCCESS);
+	CHECK(MicrocDB_InsertRecord(S("{'temp':25,'hum':61,'name':'node2'}/")) == STORE_SUCCESS);
+	CHECK(MicrocDB_InsertRecord(S("{'temp':25,'name':'node3'}/")) == SCHEMA_VIOLATION);
+	CHECK(MicrocDB_InsertRecord(S("{'temp':25,'hum':61,'name':'node3','x':1}/")) == SCHEMA_VIOLATION);
+	CHECK(MicrocDB_RecordCount() == 2);
+	return 0;
+}
+
+static int Read(void) {
+	microcDB_Data Data;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_RegisterSchema(S("{'temp':'i16','hum':'u8','name':'s8'}/")) == SCHEMA_REGISTERED);
+	CHECK(MicrocDB_RecordCount() == 2);
+
+	Data = MicrocDB_FindRecord(0, S("temp./"));
+	CHECK(Data.DBstatus == FOUND_SUCCESS && Data.JSON_type == JSON_PRIMITIVE);
+	CHECK(*(int16_t*) Data.DBStartptr == -12);
+	Data = MicrocDB_FindRecord(1, S("hum./"));
+	CHECK(Data.DBstatus == FOUND_SUCCESS && *Data.DBStartptr == 61);
+	CHECK_FOUND(MicrocDB_FindRecord(1, S("name./")), "node2");
+	CHECK(MicrocDB_FindRecord(2, S("temp./")).DBstatus == NOT_FOUND);
+
+	/*The records of a different layout are not read*/
+	CHECK(MicrocDB_RegisterSchema(S("{'temp':'i32'}/")) == SCHEMA_MISMATCH);
+	return 0;
+}
+
+static int Append(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_RegisterSchema(S("{'temp':'i16','hum':'u8','name':'s8'}/")) == SCHEMA_REGISTERED);
+	CHECK(MicrocDB_InsertRecord(S("{'temp':7,'hum':1,'name':'node3'}/")) == STORE_SUCCESS);
+	return 0;
+}
+
+static int AppendAfterLoss(void) {
+	microcDB_Data Data;
+	uint32_t Count;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_RegisterSchema(S("{'temp':'i16','hum':'u8','name':'s8'}/")) == SCHEMA_REGISTERED);
+	Count = MicrocDB_RecordCount();
+	CHECK(Count == 2 || Count == 3);
+	Data = MicrocDB_FindRecord(2, S("name./"));
+	CHECK(Data.DBstatus == NOT_FOUND || TestFound(Data, "node3"));
+	CHECK_FOUND(MicrocDB_FindRecord(1, S("name./")), "node2");
+
+	CHECK(MicrocDB_InsertRecord(S("{'temp':8,'hum':2,'name':'node4'}/")) == STORE_SUCCESS);
+	CHECK(MicrocDB_RecordCount() == Count + 1);
+	CHECK_FOUND(MicrocDB_FindRecord(Count, S("name./")), "node4");
+	return 0;
+}
+
+int main(void) {
+	flash_emu_Counts Counts;
+	uint32_t Operations, Loss;
+
+	CHECK_BOOT(Store);
+	CHECK_BOOT(Read);
+	memcpy(Image, (void*) (uintptr_t) FLASH_EMU_BASE, FLASH_EMU_SIZE);
+
+	/*The flash operations of storing a record without power loss*/
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed;
+	CHECK_BOOT(Append);
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed - Operations;
+
+	/*The power is lost at every operation of storing*/
+	for (Loss = 1; Loss <= Operations; Loss++) {
+		memcpy((void*) (uintptr_t) FLASH_EMU_BASE, Image, FLASH_EMU_SIZE);
+		FlashEmuPowerLossAfter(Loss);
+		CHECK(FlashEmuBoot(Append) == 0);
+		CHECK_BOOT(AppendAfterLoss);
+	}
+	return 0;
+}
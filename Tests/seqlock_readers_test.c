@@ -0,0 +1,134 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The aggregate, filter, projection and capped collection readers run while the writer task rewrites the pages of DB
+ *      			 and reuses the pages of capped collection. They read again, or the filter gives READ_CONFLICT, so no reader gives
+ *      			 a value being written.
+ *
+ * CONFIG MICROCDB_SEQLOCK 1
+ * CONFIG MICROCDB_SEQLOCK_PORT MICROCDB_PORT_PTHREADS
+ * CONFIG MICROCDB_OBJECT_SLACK 16
+ * CONFIG MICROCDB_AGGREGATES 1
+ * CONFIG MICROCDB_FILTER 1
+ * CONFIG MICROCDB_PROJECTION 1
+ * CONFIG MICROCDB_CAPPED_SUPPORT 1
+ * CONFIG MICROCDB_CAPPED_START_ADDR 0x08010000
+ * CONFIG MICROCDB_CAPPED_END_ADDR 0x08010FFF
+ * */
+
+#include "test.h"
+#include <pthread.h>
+#include <unistd.h>
+
+#define WRITES 300
+
+static volatile int WriterDone;
+
+static void* Aggregator(void *Argument) {
+	microcDB_Aggregate Result;
+	long Reads = 0;
+
+	while (!WriterDone) {
+		CHECK(MicrocDB_Aggregate(S("l./"), 0, &Result) == FOUND_SUCCESS);
+		CHECK(Result.Count == 3 && Result.Sum == 6);
+		Reads++;
+	}
+	return (void*) Reads;
+}
+
+static bool Count(microcDB_Data *Match, microcDB_Data *Key, void *Context) {
+	(*(int*) Context)++;
+	return true;
+}
+
+static void* Filterer(void *Argument) {
+	microcDB_Status Status;
+	long Reads = 0;
+	int Matches;
+
+	while (!WriterDone) {
+		Matches = 0;
+		Status = MicrocDB_Filter(S("o./"), S("k./"), FILTER_GT, S("0/"), Count,
+				&Matches);
+		if (Status == READ_CONFLICT) {
+			continue;
+		}
+		CHECK(Status == FOUND_SUCCESS && Matches == 2);
+		Reads++;
+	}
+	return (void*) Reads;
+}
+
+static void* Projector(void *Argument) {
+	uint8_t *Keys[2] = { (uint8_t*) "a./", (uint8_t*) "b./" };
+	microcDB_Data Results[2];
+	uint8_t Values[2];
+	uint32_t Sequence;
+	long Reads = 0;
+
+	while (!WriterDone) {
+		/*The values are read before the writer task moves them*/
+		do {
+			Sequence = MicrocDB_ReadBegin();
+			CHECK(MicrocDB_Project(S("p./"), Keys, 2, Results) == FOUND_SUCCESS);
+			CHECK(Results[0].DBstatus == FOUND_SUCCESS && Results[1].DBstatus == FOUND_SUCCESS);
+			Values[0] = *Results[0].DBStartptr;
+			Values[1] = *Results[1].DBStartptr;
+		} while (MicrocDB_ReadRetry(Sequence));
+		CHECK(Values[0] == '7' && Values[1] == '8');
+		Reads++;
+	}
+	return (void*) Reads;
+}
+
+static void* CappedReader(void *Argument) {
+	microcDB_CappedIterator Iterator;
+	microcDB_Aggregate Result;
+	microcDB_Status Status;
+	long Reads = 0;
+
+	while (!WriterDone) {
+		MicrocDB_CappedIterNewest(&Iterator);
+		Status = MicrocDB_CappedAggregate(&Iterator, S("t./"), &Result);
+		if (Status == READ_CONFLICT) {
+			continue;
+		}
+		CHECK(Status == FOUND_SUCCESS);
+		CHECK(Result.Count > 0 && Result.Min == 5 && Result.Max == 5);
+		Reads++;
+	}
+	return (void*) Reads;
+}
+
+static int Run(void) {
+	void* (*Readers[4])(void*) = { Aggregator, Filterer, Projector, CappedReader };
+	pthread_t Threads[4];
+	void *Result;
+	int i;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'v':'short','l':[1,2,3],'o':[{'k':1},{'k':2}],'p':{'a':7,'b':8}}/"), 1) == STORE_SUCCESS);
+	CHECK(MicrocDB_CappedAppend(S("{'t':5}/")) == STORE_SUCCESS);
+
+	WriterDone = 0;
+	for (i = 0; i < 4; i++) {
+		CHECK(pthread_create(&Threads[i], 0, Readers[i], 0) == 0);
+	}
+
+	/*Every update of v moves the members after it in the slack, and the appends reuse the pages of capped collection*/
+	for (i = 0; i < WRITES; i++) {
+		CHECK(MicrocDB_Update(S("v./"), (i & 1) ? S("'short'/") : S("'a longer value'/")) == UPDATE_SUCCESSFUL);
+		CHECK(MicrocDB_CappedAppend(S("{'t':5,'pad':'0123456789012345678901234567890123456789'}/")) == STORE_SUCCESS);
+		usleep(100); /*The writer task is periodic so the readers also complete reads between the writes*/
+	}
+	WriterDone = 1;
+	for (i = 0; i < 4; i++) {
+		CHECK(pthread_join(Threads[i], &Result) == 0);
+		CHECK(Result != 0);
+	}
+	return 0;
+}
+
+int main(void) {
+	CHECK_BOOT(Run);
+	return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The reader tasks find and iterate the DB while the writer task rewrites its pages. A reader never sees a value
+ *      			 being written, the find is done again and the iteration gives READ_CONFLICT.
+ *
+ * CONFIG MICROCDB_SEQLOCK 1
+ * CONFIG MICROCDB_SEQLOCK_PORT MICROCDB_PORT_PTHREADS
+ * CONFIG MICROCDB_OBJECT_SLACK 16
+ * CONFIG MICROCDB_ARRAY_SEGMENTS 1
+ * CONFIG MICROCDB_ARRAY_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_ARRAY_END_ADDR 0x0800C7FF
+ * */
+
+#include "test.h"
+#include <pthread.h>
+#include <unistd.h>
+
+#define WRITES 300
+
+static volatile int WriterDone;
+
+/*
+ * This function checks that the value is one of the values written by the writer task.
+ */
+static int Written(microcDB_Data Data) {
+	size_t Length = Data.DBEndptr + 1 - Data.DBStartptr;
+
+	return Data.DBstatus == FOUND_SUCCESS
+			&& ((Length == 5 && memcmp(Data.DBStartptr, "short", 5) == 0)
+					|| (Length == 14 && memcmp(Data.DBStartptr, "a longer value", 14) == 0));
+}
+
+static void* Finder(void *Argument) {
+	microcDB_Data Data;
+	uint8_t Copy[32];
+	uint32_t Sequence;
+	uint8_t Seven;
+	long Reads = 0;
+
+	while (!WriterDone) {
+		/*The values found are copied out and used if no write was done meanwhile, as the next write changes the flash they point*/
+		do {
+			Sequence = MicrocDB_ReadBegin();
+			Data = MicrocDB_Find(S("v./"));
+			CHECK(Data.DBstatus == FOUND_SUCCESS);
+			CHECK(Data.DBEndptr - Data.DBStartptr < (int) sizeof(Copy));
+			memcpy(Copy, Data.DBStartptr, Data.DBEndptr + 1 - Data.DBStartptr);
+			Data.DBEndptr = Copy + (Data.DBEndptr - Data.DBStartptr);
+			Data.DBStartptr = Copy;
+			Seven = *MicrocDB_Find(S("n./")).DBStartptr;
+		} while (MicrocDB_ReadRetry(Sequence));
+		CHECK(Written(Data));
+		CHECK(Seven == '7');
+		Reads++;
+	}
+	return (void*) Reads;
+}
+
+static void* Iterator(void *Argument) {
+	microcDB_ArrayIterator Iterator;
+	microcDB_Data Element;
+	uint8_t Elements[4];
+	uint32_t Sequence;
+	long Iterations = 0;
+	int Count;
+
+	while (!WriterDone) {
+		Sequence = MicrocDB_ReadBegin();
+		CHECK(MicrocDB_ArrayIterBegin(S("l./"), &Iterator) == FOUND_SUCCESS);
+		for (Count = 0;; Count++) {
+			Element = MicrocDB_ArrayNext(&Iterator);
+			if (Element.DBstatus != FOUND_SUCCESS) {
+				break;
+			}
+			CHECK(Count < 3);
+			Elements[Count] = *Element.DBStartptr;
+		}
+		/*The iteration is done again if the writer task wrote the DB during it*/
+		if (Element.DBstatus == READ_CONFLICT || MicrocDB_ReadRetry(Sequence)) {
+			continue;
+		}
+		CHECK(Element.DBstatus == NOT_FOUND && Count == 3);
+		CHECK(memcmp(Elements, "123", 3) == 0);
+		Iterations++;
+	}
+	return (void*) Iterations;
+}
+
+static int Run(void) {
+	pthread_t Threads[3];
+	void *Result;
+	int i;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'v':'short','l':[1,2,3],'n':7}/"), 1) == STORE_SUCCESS);
+
+	WriterDone = 0;
+	CHECK(pthread_create(&Threads[0], 0, Finder, 0) == 0);
+	CHECK(pthread_create(&Threads[1], 0, Finder, 0) == 0);
+	CHECK(pthread_create(&Threads[2], 0, Iterator, 0) == 0);
+
+	/*Every update of v moves the members after it in the slack so its page is erased and written again*/
+	for (i = 0; i < WRITES; i++) {
+		CHECK(MicrocDB_Update(S("v./"), (i & 1) ? S("'short'/") : S("'a longer value'/")) == UPDATE_SUCCESSFUL);
+		usleep(100); /*The writer task is periodic so the readers also complete reads between the writes*/
+	}
+	WriterDone = 1;
+	for (i = 0; i < 3; i++) {
+		CHECK(pthread_join(Threads[i], &Result) == 0);
+		CHECK(Result != 0);
+	}
+	CHECK_FOUND(MicrocDB_Find(S("v./")), "short");
+	CHECK(FlashEmuCounts().PageErases >= WRITES);
+	return 0;
+}
+
+int main(void) {
+	CHECK_BOOT(Run);
+	return 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: Without relocation the update which doesn't fit in the slack of its object gives the object more slack by shifting
+ *      			 the DB after it. The slack of the objects after it stays on half words so they are still updated in their slack.
+ *
+ * CONFIG MICROCDB_OBJECT_SLACK 8
+ * CONFIG MICROCDB_SLACK_FIND_BYTES 64
+ * CONFIG MICROCDB_KEY_INDEX_SIZE 8
+ * */
+
+#include "test.h"
+
+int main(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'k':{}}/"), 1) == STORE_SUCCESS);
+	CHECK(MicrocDB_Insert(S("{'n':5,'o':{'a':1}}/"), 1) == STORE_SUCCESS);
+
+	/*The member of 24 bytes doesn't fit in the slack of k*/
+	CHECK(MicrocDB_Update(S("k./"), S("'member':'0123456789ab'/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("k./")), "{\"member\":\"0123456789ab\"}");
+	CHECK_FOUND(MicrocDB_Find(S("k.member./")), "0123456789ab");
+
+	/*The second document was shifted and its slack is programmed by the updates*/
+	CHECK_FOUND(MicrocDB_Find(S("n./")), "5");
+	CHECK(MicrocDB_Update(S("o./"), S("'b':2/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("o./")), "{\"a\":1,\"b\":2}");
+	CHECK(MicrocDB_Update(S("n./"), S("'five'/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("n./")), "five");
+
+	/*A value of the object which outgrows its slack*/
+	CHECK(MicrocDB_Update(S("o.a./"), S("'a longer value of a'/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("o./")), "{\"a\":\"a longer value of a\",\"b\":2}");
+	CHECK_FOUND(MicrocDB_Find(S("k.member./")), "0123456789ab");
+
+	/*The documents are found after the reset*/
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK_FOUND(MicrocDB_Find(S("o.b./")), "2");
+	CHECK(MicrocDB_Insert(S("{'m':1}/"), 1) == STORE_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("m./")), "1");
+	return 0;
+}
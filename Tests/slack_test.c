@@ -0,0 +1,62 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The updates are done in the slack of objects or by relocating the object, and the objects found are given without
+ *      			 the slack and forwarding markers. The update which fits in neither is refused without shifting the DB. The object
+ *      			 found which doesn't fit in the buffer is streamed without the slack.
+ *
+ * CONFIG MICROCDB_OBJECT_SLACK 16
+ * CONFIG MICROCDB_SLACK_FIND_BYTES 64
+ * CONFIG MICROCDB_RELOCATION 1
+ * CONFIG MICROCDB_RELOCATION_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_RELOCATION_END_ADDR 0x0800CFFF
+ * */
+
+#include "test.h"
+
+typedef struct {
+	char Bytes[128];
+	size_t Length;
+} found_Stream;
+
+static bool Write(uint8_t *Bytes, uint16_t Length, void *Context) {
+	found_Stream *Stream = Context;
+
+	memcpy(Stream->Bytes + Stream->Length, Bytes, Length);
+	Stream->Length += Length;
+	return true;
+}
+
+int main(void) {
+	found_Stream Stream = { { 0 }, 0 };
+	microcDB_Data Found;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'a':{'x':1,'y':'ab'},'l':[{'k':1}],'n':5}/"), 1) == STORE_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("a./")), "{\"x\":1,\"y\":\"ab\"}");
+	CHECK_FOUND(MicrocDB_Find(S("l./")), "[{\"k\":1}]");
+
+	/*In the slack of the object*/
+	CHECK(MicrocDB_Update(S("a.x./"), S("22/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Update(S("a./"), S("'z':3/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("a./")), "{\"x\":22,\"y\":\"ab\",\"z\":3}");
+	CHECK_FOUND(MicrocDB_Find(S("a.z./")), "3");
+
+	/*The member which outgrows its slack is relocated and its parent is found with the latest copy*/
+	CHECK(MicrocDB_Update(S("a.y./"), S("'abcdefghijklmnop'/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("a./")), "{\"x\":22,\"y\":\"abcdefghijklmnop\",\"z\":3}");
+
+	/*The document is not relocated so the update which doesn't fit in its slack is refused*/
+	CHECK(MicrocDB_Update(S("n./"), S("'0123456789abcdefghij'/")) == NOT_ENOUGH_SPACE);
+	CHECK_FOUND(MicrocDB_Find(S("n./")), "5");
+	CHECK_FOUND(MicrocDB_Find(S("l./")), "[{\"k\":1}]");
+
+	/*The object found which doesn't fit in the buffer*/
+	CHECK(MicrocDB_Update(S("a./"), S("'w':'0123456789'/")) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_Update(S("a./"), S("'v':'0123456789'/")) == UPDATE_SUCCESSFUL);
+	Found = MicrocDB_Find(S("a./"));
+	CHECK(Found.DBstatus == FOUND_SUCCESS);
+	CHECK(MicrocDB_StreamFound(&Found, Write, &Stream) == FOUND_SUCCESS);
+	CHECK(strcmp(Stream.Bytes, "{\"x\":22,\"y\":\"abcdefghijklmnop\",\"z\":3,\"w\":\"0123456789\",\"v\":\"0123456789\"}") == 0);
+	CHECK_FOUND(MicrocDB_Find(S("a.v./")), "0123456789");
+	return 0;
+}
@@ -0,0 +1,194 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: Every task reads its own snapshot, also while the writer task updates the DB in the single writer mode. The copies
+ *      			 superseded while a snapshot was pinned are reclaimed once it is unpinned, and a power loss while they are reclaimed
+ *      			 keeps the latest values.
+ *
+ * CONFIG MICROCDB_OBJECT_SLACK 12
+ * CONFIG MICROCDB_RELOCATION 1
+ * CONFIG MICROCDB_RELOCATION_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_RELOCATION_END_ADDR 0x0800C7FF
+ * CONFIG MICROCDB_SNAPSHOTS 2
+ * CONFIG MICROCDB_SEQLOCK 1
+ * CONFIG MICROCDB_SEQLOCK_PORT MICROCDB_PORT_PTHREADS
+ * */
+
+#include "test.h"
+#include <pthread.h>
+
+#define SECOND_BANK (MICROCDB_RELOCATION_START_ADDR + FLASH_PAGE_SIZE)
+#define LONG_VALUES 100 /*The values from this are longer so updating a value to them doesn't fit in the slack*/
+
+static uint8_t Image[FLASH_EMU_SIZE];
+static volatile int ReaderPinned, WriterDone;
+static uint32_t Value; /*The number of last value of c.d written*/
+
+/*
+ * This function gives the value number N of c.d. The values are longer than the slack so the updates which are not done in place
+ * relocate c.
+ */
+static void ValueOf(uint32_t N, char *Text) {
+	sprintf(Text, N < LONG_VALUES ? "value-%014u" : "long-value-%018u", N);
+}
+
+static microcDB_Status UpdateTo(uint32_t N) {
+	char Text[32];
+	uint8_t Quoted[40] = { 0 };
+
+	ValueOf(N, Text);
+	sprintf((char*) Quoted, "'%s'/", Text);
+	return MicrocDB_Update(S("c.d./"), Quoted);
+}
+
+static void CheckValue(microcDB_Data Data, uint32_t N) {
+	char Text[32];
+
+	ValueOf(N, Text);
+	CHECK_FOUND(Data, Text);
+}
+
+static uint32_t Generation(uint32_t Bank) {
+	return *(uint32_t*) Bank;
+}
+
+static void* Reader(void *Argument) {
+	microcDB_Snapshot Snapshot;
+	int i;
+
+	CHECK(MicrocDB_SnapshotBegin(&Snapshot) == FOUND_SUCCESS);
+	ReaderPinned = 1;
+	for (i = 0; !WriterDone; i++) {
+		CheckValue(MicrocDB_SnapshotFind(&Snapshot, S("c.d./")), 0);
+		CHECK_FOUND(MicrocDB_SnapshotFind(&Snapshot, S("id./")), "1");
+	}
+	CheckValue(MicrocDB_SnapshotFind(&Snapshot, S("c.d./")), 0);
+	MicrocDB_SnapshotEnd(&Snapshot);
+	return (void*) (intptr_t) i;
+}
+
+static int Pin(void) {
+	microcDB_Snapshot First, Second;
+	microcDB_Status Status;
+	pthread_t Thread;
+	void *Reads;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'id':1,'c':{'d':5,'e':'x'}}/"), 1) == STORE_SUCCESS);
+	CHECK(UpdateTo(0) == UPDATE_SUCCESSFUL);
+
+	/*Every snapshot sees the DB as it was when it was pinned*/
+	CHECK(MicrocDB_SnapshotBegin(&First) == FOUND_SUCCESS);
+	CHECK(UpdateTo(1) == UPDATE_SUCCESSFUL);
+	CHECK(MicrocDB_SnapshotBegin(&Second) == FOUND_SUCCESS);
+	CHECK(UpdateTo(2) == UPDATE_SUCCESSFUL);
+	CheckValue(MicrocDB_Find(S("c.d./")), 2);
+	CheckValue(MicrocDB_SnapshotFind(&First, S("c.d./")), 0);
+	CheckValue(MicrocDB_SnapshotFind(&Second, S("c.d./")), 1);
+	MicrocDB_SnapshotEnd(&Second);
+
+	/*The superseded copies are not reclaimed while a snapshot is pinned, so the updates fail once the relocation region is full*/
+	Value = 2;
+	do {
+		Status = UpdateTo(++Value);
+	} while (Status == UPDATE_SUCCESSFUL);
+	CHECK(Status == SNAPSHOT_CONFLICT);
+	CHECK(Generation(SECOND_BANK) == 0xFFFFFFFF);
+	CheckValue(MicrocDB_Find(S("c.d./")), Value - 1);
+	CheckValue(MicrocDB_SnapshotFind(&First, S("c.d./")), 0);
+	MicrocDB_SnapshotEnd(&First);
+
+	/*Once no snapshot is pinned they are reclaimed*/
+	CHECK(UpdateTo(LONG_VALUES) == UPDATE_SUCCESSFUL);
+	CHECK(Generation(SECOND_BANK) == 1);
+	CHECK(Generation(MICROCDB_RELOCATION_START_ADDR) == 0xFFFFFFFF);
+	CheckValue(MicrocDB_Find(S("c.d./")), LONG_VALUES);
+	CHECK_FOUND(MicrocDB_Find(S("c.e./")), "x");
+
+	/*A reader task reads its snapshot while the writer task updates*/
+	CHECK(UpdateTo(0) == UPDATE_SUCCESSFUL);
+	ReaderPinned = 0;
+	WriterDone = 0;
+	CHECK(pthread_create(&Thread, 0, Reader, 0) == 0);
+	while (!ReaderPinned)
+		;
+	for (Value = 1; Value < 10; Value++) {
+		Status = UpdateTo(Value);
+		if (Status == SNAPSHOT_CONFLICT) {
+			break;
+		}
+		CHECK(Status == UPDATE_SUCCESSFUL);
+		CheckValue(MicrocDB_Find(S("c.d./")), Value);
+	}
+	WriterDone = 1;
+	CHECK(pthread_join(Thread, &Reads) == 0);
+	CHECK(Reads != 0);
+	CHECK(UpdateTo(Value) == UPDATE_SUCCESSFUL);
+	CheckValue(MicrocDB_Find(S("c.d./")), Value);
+	return (int) Value;
+}
+
+static int Reboot(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CheckValue(MicrocDB_Find(S("c.d./")), Value);
+	CHECK_FOUND(MicrocDB_Find(S("c.e./")), "x");
+	return 0;
+}
+
+/*
+ * This function relocates c while a snapshot is pinned till the relocation region is full.
+ */
+static int Fill(void) {
+	microcDB_Snapshot Snapshot;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_SnapshotBegin(&Snapshot) == FOUND_SUCCESS);
+	while (UpdateTo(Value + 1) == UPDATE_SUCCESSFUL) {
+		Value++;
+	}
+	MicrocDB_SnapshotEnd(&Snapshot);
+	return (int) Value;
+}
+
+static int Reclaim(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(UpdateTo(LONG_VALUES + Value) == UPDATE_SUCCESSFUL);
+	return 0;
+}
+
+static int CheckReclaimed(void) {
+	microcDB_Data Data;
+	char Text[32];
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK_FOUND(MicrocDB_Find(S("id./")), "1");
+	CHECK_FOUND(MicrocDB_Find(S("c.e./")), "x");
+	Data = MicrocDB_Find(S("c.d./"));
+	ValueOf(LONG_VALUES + Value, Text);
+	if (!TestFound(Data, Text)) {
+		CheckValue(Data, Value);
+	}
+	/*The DB is still updated after the power loss*/
+	CHECK(UpdateTo(LONG_VALUES + Value + 1) == UPDATE_SUCCESSFUL);
+	CheckValue(MicrocDB_Find(S("c.d./")), LONG_VALUES + Value + 1);
+	return 0;
+}
+
+int main(void) {
+	uint32_t Loss;
+
+	Value = FlashEmuBoot(Pin);
+	CHECK(Value > 1 && Value < LONG_VALUES);
+	CHECK_BOOT(Reboot);
+
+	/*The power is lost at every step of the update which reclaims the superseded copies*/
+	Value = FlashEmuBoot(Fill);
+	CHECK(Value > 1 && Value < LONG_VALUES);
+	memcpy(Image, (void*) (uintptr_t) FLASH_EMU_BASE, FLASH_EMU_SIZE);
+	for (Loss = 1; Loss < 400; Loss++) {
+		memcpy((void*) (uintptr_t) FLASH_EMU_BASE, Image, FLASH_EMU_SIZE);
+		FlashEmuPowerLossAfter(Loss);
+		FlashEmuBoot(Reclaim);
+		CHECK_BOOT(CheckReclaimed);
+	}
+	return 0;
+}
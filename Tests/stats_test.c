@@ -0,0 +1,37 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The engine statistics count the calls and the work done by every type of call.
+ *
+ * CONFIG MICROCDB_STATS 1
+ * */
+
+#include "test.h"
+
+int main(void) {
+	microcDB_Stats Insert, Find, Update, All;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	MicrocDB_ResetStats();
+	CHECK(MicrocDB_Insert(S("{'a':{'b':1,'c':'xyz'},'d':[1,2,3]}/"), 1) == STORE_SUCCESS);
+	CHECK_FOUND(MicrocDB_Find(S("a.c./")), "xyz");
+	CHECK(MicrocDB_Find(S("e./")).DBstatus == NOT_FOUND);
+	CHECK(MicrocDB_Update(S("a.b./"), S("2/")) == UPDATE_SUCCESSFUL);
+
+	MicrocDB_GetStats(STATS_OP_INSERT, &Insert);
+	MicrocDB_GetStats(STATS_OP_FIND, &Find);
+	MicrocDB_GetStats(STATS_OP_UPDATE, &Update);
+	MicrocDB_GetStats(STATS_OP_COUNT, &All);
+
+	CHECK(Insert.Calls == 1 && Find.Calls == 2 && Update.Calls == 1);
+	CHECK(Insert.WordsProgrammed > 0 && Insert.PageErases == 0);
+	CHECK(Find.ParserBytes > 0 && Find.PageErases == 0 && Find.WordsProgrammed == 0);
+	/*The same length update rewrites the page of value*/
+	CHECK(Update.PageErases == 1 && Update.PageWrites == 1 && Update.ShiftPagesMoved == 0);
+	CHECK(All.Calls == 4 && All.ParserBytes == Insert.ParserBytes + Find.ParserBytes + Update.ParserBytes);
+	CHECK(All.PageErases == FlashEmuCounts().PageErases);
+
+	MicrocDB_ResetStats();
+	MicrocDB_GetStats(STATS_OP_COUNT, &All);
+	CHECK(All.Calls == 0 && All.ParserBytes == 0);
+	return 0;
+}
@@ -0,0 +1,238 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The members which are not accessed are moved to the cold tier and found there, and a member found frequently is
+ *      			 moved back. A query whose key was never moved doesn't read the cold tier. When the power is lost at any flash
+ *      			 operation of moving a member, every member is found after the reset and the next members are moved after the record
+ *      			 which was not completely written. The members of every document are moved and moved back to their document, a step
+ *      			 does one page operation of the job, and the records of the members moved again are reclaimed when the cold tier is
+ *      			 full, also when the power is lost while reclaiming. The cold tier is erased with DB.
+ *
+ * CONFIG MICROCDB_UPDATE_JOBS 1
+ * CONFIG MICROCDB_JOB_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_JOB_END_ADDR 0x0800C7FF
+ * CONFIG MICROCDB_TIERING 1
+ * CONFIG MICROCDB_COLD_START_ADDR 0x0800C800
+ * CONFIG MICROCDB_COLD_END_ADDR 0x0800CFFF
+ * CONFIG MICROCDB_TIER_HOT_BYTES (*(volatile uint32_t*) 0x0803FFFC)
+ * CONFIG MICROCDB_TIER_AGE_STEPS 2
+ * CONFIG MICROCDB_TIER_PROMOTE_HITS 3
+ * CONFIG MICROCDB_TIER_STEP_PAGE_OPS 1
+ * CONFIG MICROCDB_KEY_INDEX_SIZE 8
+ * CONFIG MICROCDB_OBJECT_SLACK 16
+ * CONFIG MICROCDB_STATS 1
+ * */
+
+#include "test.h"
+
+#define STEPS 16 /*The calls of MicrocDB_TierStep() after which the members are moved*/
+#define CYCLES 100 /*The moves of a member to the cold tier and back, more than its records which fit in a bank*/
+#define HOT_BYTES 96 /*They are read from the last word of flash so the boots change them, like the application whose working set changes*/
+#define BANK1_GENERATION ((uint8_t*) MICROCDB_COLD_START_ADDR + ((MICROCDB_COLD_END_ADDR + 1 - MICROCDB_COLD_START_ADDR) / 2))
+
+static uint8_t Image[FLASH_EMU_SIZE];
+static uint32_t Pendings; /*The steps which left the job pending*/
+
+static int InCold(microcDB_Data Data) {
+	return Data.DBStartptr >= (uint8_t*) MICROCDB_COLD_START_ADDR
+			&& Data.DBStartptr <= (uint8_t*) MICROCDB_COLD_END_ADDR;
+}
+
+#define LONG_A "value of a which is long, it is moved to make space for the member b"
+
+/*
+ * This function steps till the job of the step is completed. While it is pending the DB is not read.
+ */
+static microcDB_Status Step(void) {
+	microcDB_Status Status;
+
+	while ((Status = MicrocDB_TierStep()) == UPDATE_PENDING) {
+		CHECK(MicrocDB_Find(S("d./")).DBstatus == UPDATE_PENDING);
+		Pendings++;
+	}
+	return Status;
+}
+
+static void CheckAll(void) {
+	CHECK_FOUND(MicrocDB_Find(S("a./")), LONG_A);
+	CHECK_FOUND(MicrocDB_Find(S("b.c./")), "value of b which is long");
+	CHECK_FOUND(MicrocDB_Find(S("d./")), "4");
+}
+
+/*
+ * This function gives the bytes parsed by the find of the query which is not in DB.
+ */
+static uint32_t MissBytes(uint8_t *query) {
+	microcDB_Stats Find;
+
+	MicrocDB_ResetStats();
+	CHECK(MicrocDB_Find(query).DBstatus != FOUND_SUCCESS);
+	MicrocDB_GetStats(STATS_OP_FIND, &Find);
+	return Find.ParserBytes;
+}
+
+static int Insert(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'a':'" LONG_A "','b':{'c':'value of b which is long'},'d':4}/"), 1) == STORE_SUCCESS);
+	CheckAll();
+	return 0;
+}
+
+static int Demote(void) {
+	int i;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+
+	/*b is not accessed so it is moved*/
+	for (i = 0; i < STEPS; i++) {
+		CHECK_FOUND(MicrocDB_Find(S("a./")), LONG_A);
+		CHECK_FOUND(MicrocDB_Find(S("d./")), "4");
+		CHECK(Step() != UPDATE_FAILED);
+	}
+	CHECK(InCold(MicrocDB_Find(S("b.c./"))));
+	CHECK(MicrocDB_Update(S("b.c./"), S("'x'/")) == DATA_IS_COLD);
+	CheckAll();
+	return 0;
+}
+
+static int Promote(void) {
+	int i;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(InCold(MicrocDB_Find(S("b.c./"))));
+
+	/*The key which was never moved is not searched in the cold tier, so the length of the query doesn't matter*/
+	CHECK(MissBytes(S("e./")) == MissBytes(S("e_key_which_is_much_longer_than_the_other./")));
+
+	/*b is found frequently so it is moved back once a is moved to make space for it*/
+	for (i = 0; i < STEPS; i++) {
+		CHECK_FOUND(MicrocDB_Find(S("b.c./")), "value of b which is long");
+		CHECK_FOUND(MicrocDB_Find(S("b.c./")), "value of b which is long");
+		CHECK(Step() != UPDATE_FAILED);
+	}
+	CHECK(!InCold(MicrocDB_Find(S("b.c./"))));
+	CHECK(InCold(MicrocDB_Find(S("a./"))));
+	CheckAll();
+	CHECK(MicrocDB_Update(S("b.c./"), S("'x'/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("b.c./")), "x");
+	return 0;
+}
+
+static void CheckDocuments(void) {
+	CHECK_FOUND(MicrocDB_Find(S("d./")), "4");
+	CHECK_FOUND(MicrocDB_Find(S("e.f./")), "value of e");
+	CHECK_FOUND(MicrocDB_Find(S("g./")), "7");
+}
+
+static int InsertDocuments(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_Insert(S("{'d':4}/"), 1) == STORE_SUCCESS);
+	CHECK(MicrocDB_Insert(S("{'e':{'f':'value of e'},'g':7}/"), 1) == STORE_SUCCESS);
+	CheckDocuments();
+	return 0;
+}
+
+/*
+ * This function moves e of the second document to the cold tier and back.
+ */
+static int Cycle(void) {
+	int i;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	Pendings = 0;
+
+	/*e is not found while the DB has to be smaller*/
+	MICROCDB_TIER_HOT_BYTES = 0;
+	for (i = 0; i < STEPS; i++) {
+		CHECK_FOUND(MicrocDB_Find(S("d./")), "4");
+		CHECK_FOUND(MicrocDB_Find(S("g./")), "7");
+		CHECK(Step() != UPDATE_FAILED);
+	}
+	CHECK(InCold(MicrocDB_Find(S("e.f./"))));
+	CheckDocuments();
+
+	/*e is moved back after g in its document once it is found frequently*/
+	MICROCDB_TIER_HOT_BYTES = HOT_BYTES;
+	for (i = 0; i < STEPS && InCold(MicrocDB_Find(S("e.f./"))); i++) {
+		CHECK_FOUND(MicrocDB_Find(S("e.f./")), "value of e");
+		CHECK_FOUND(MicrocDB_Find(S("d./")), "4");
+		CHECK(Step() != UPDATE_FAILED);
+	}
+	CHECK(!InCold(MicrocDB_Find(S("e.f./"))));
+	CHECK(MicrocDB_Find(S("e.f./")).DBStartptr > MicrocDB_Find(S("g./")).DBStartptr);
+	CheckDocuments();
+	CHECK(Pendings > 0);
+	return 0;
+}
+
+static int AfterLoss(void) {
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(Step() != UPDATE_FAILED);
+	CheckDocuments();
+	return 0;
+}
+
+static int EraseAll(void) {
+	/*The flag of DB asks Init to erase it with the cold tier*/
+	CHECK(HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, MICROCDB_END_ADDR - 1, 0xDBFF) == HAL_OK);
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(*(uint32_t*) BANK1_GENERATION == 0xFFFFFFFF);
+	CHECK(MicrocDB_Insert(S("{'d':5}/"), 1) == STORE_SUCCESS);
+	CHECK(FlashAddresscntr < MICROCDB_COLD_START_ADDR);
+	CHECK_FOUND(MicrocDB_Find(S("d./")), "5");
+	return 0;
+}
+
+int main(void) {
+	flash_emu_Counts Counts;
+	uint32_t Operations, Loss;
+
+	MICROCDB_TIER_HOT_BYTES = HOT_BYTES;
+	CHECK_BOOT(Insert);
+	memcpy(Image, (void*) (uintptr_t) FLASH_EMU_BASE, FLASH_EMU_SIZE);
+
+	/*The flash operations of moving b without power loss*/
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed;
+	CHECK_BOOT(Demote);
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed - Operations;
+
+	/*The power is lost at every operation of moving, then b is moved again if it is still in DB*/
+	for (Loss = 1; Loss < Operations; Loss++) {
+		memcpy((void*) (uintptr_t) FLASH_EMU_BASE, Image, FLASH_EMU_SIZE);
+		FlashEmuPowerLossAfter(Loss);
+		CHECK(FlashEmuBoot(Demote) == 0);
+		CHECK_BOOT(Demote);
+	}
+	CHECK_BOOT(Promote);
+
+	/*The records of e are reclaimed when the bank is full. The image before the cycle which reclaimed is kept*/
+	FlashEmuErase();
+	MICROCDB_TIER_HOT_BYTES = HOT_BYTES;
+	CHECK_BOOT(InsertDocuments);
+	for (Loss = 0; Loss < CYCLES && *(uint32_t*) BANK1_GENERATION == 0xFFFFFFFF; Loss++) {
+		memcpy(Image, (void*) (uintptr_t) FLASH_EMU_BASE, FLASH_EMU_SIZE);
+		CHECK_BOOT(Cycle);
+	}
+	CHECK(Loss < CYCLES);
+	for (Loss = 0; Loss < 4 * CYCLES; Loss++) {
+		CHECK_BOOT(Cycle);
+	}
+
+	/*The power is lost at every 7th operation of the cycle which reclaimed*/
+	memcpy((void*) (uintptr_t) FLASH_EMU_BASE, Image, FLASH_EMU_SIZE);
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed;
+	CHECK_BOOT(Cycle);
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed - Operations;
+	for (Loss = 1; Loss < Operations; Loss += 7) {
+		memcpy((void*) (uintptr_t) FLASH_EMU_BASE, Image, FLASH_EMU_SIZE);
+		FlashEmuPowerLossAfter(Loss);
+		CHECK(FlashEmuBoot(Cycle) == 0);
+		CHECK_BOOT(AfterLoss);
+		CHECK_BOOT(Cycle);
+	}
+	CHECK_BOOT(EraseAll);
+	return 0;
+}
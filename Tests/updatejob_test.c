@@ -0,0 +1,117 @@
+/*
+ * 		Author: Mrunal Ahirao
+ *      Description: The update job rewrites a bounded number of pages per step and the DB is not read till it completes. When the
+ *      			 power is lost at any flash operation of the job, MicrocDB_Init() completes it if its journal was written, otherwise
+ *      			 the DB is as before the update.
+ *
+ * CONFIG MICROCDB_UPDATE_JOBS 1
+ * CONFIG MICROCDB_JOB_START_ADDR 0x0800C000
+ * CONFIG MICROCDB_JOB_END_ADDR 0x0800C7FF
+ * */
+
+#include "test.h"
+
+#define MEMBER_SIZE 700 /*The long members make the document span 3 pages*/
+
+static uint8_t Image[FLASH_EMU_SIZE];
+static char Long[3][MEMBER_SIZE + 1];
+
+/*
+ * This function checks all the members of document. The value of a is the new one if the update was done.
+ */
+static int CheckDocument(int Updated) {
+	CHECK_FOUND(MicrocDB_Find(S("a./")), Updated ? "the new value of a" : "x");
+	CHECK_FOUND(MicrocDB_Find(S("b./")), Long[0]);
+	CHECK_FOUND(MicrocDB_Find(S("c./")), Long[1]);
+	CHECK_FOUND(MicrocDB_Find(S("d./")), Long[2]);
+	CHECK_FOUND(MicrocDB_Find(S("e./")), "5");
+	return 1;
+}
+
+static int Insert(void) {
+	static uint8_t Document[4 * MEMBER_SIZE];
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	sprintf((char*) Document, "{'a':'x','b':'%s','c':'%s','d':'%s','e':5}/", Long[0], Long[1], Long[2]);
+	CHECK(MicrocDB_Insert(Document, 1) == STORE_SUCCESS);
+	CheckDocument(0);
+	return 0;
+}
+
+static int Update(void) {
+	microcDB_UpdateJob Job;
+	microcDB_Status Status;
+	flash_emu_Counts Before, After;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	CHECK(MicrocDB_UpdateBegin(S("a./"), S("'the new value of a'/"), &Job) == UPDATE_PENDING);
+	CHECK(Job.Pages == 3 && Job.PagesDone == 0);
+	CHECK(MicrocDB_Update(S("e./"), S("6/")) == UPDATE_PENDING);
+
+	/*Every step erases at most the page of its operation, and the DB is not read while it is partly shifted*/
+	do {
+		Before = FlashEmuCounts();
+		Status = MicrocDB_UpdateStep(&Job, 1);
+		After = FlashEmuCounts();
+		CHECK(After.PageErases - Before.PageErases <= 1);
+		CHECK(After.HalfWordsProgrammed - Before.HalfWordsProgrammed <= FLASH_PAGE_SIZE / 2 + 1);
+		if (Status == UPDATE_PENDING) {
+			CHECK(MicrocDB_Find(S("e./")).DBstatus == UPDATE_PENDING);
+		}
+	} while (Status == UPDATE_PENDING);
+	CHECK(Status == UPDATE_SUCCESSFUL);
+	CHECK(Job.PagesDone == Job.Pages);
+	CheckDocument(1);
+	return 0;
+}
+
+static int Reboot(void) {
+	microcDB_UpdateJob Job;
+	microcDB_Data Data;
+	microcDB_Status Status;
+
+	CHECK(MicrocDB_Init() == INIT_CMPLT);
+	Data = MicrocDB_Find(S("a./"));
+	CHECK(Data.DBstatus == FOUND_SUCCESS);
+	CheckDocument(Data.DBEndptr != Data.DBStartptr); /*The old value is a single char*/
+
+	/*The DB is written again after the job, and the journal of the next job is written over the one interrupted before its magic*/
+	CHECK(MicrocDB_Update(S("e./"), S("7/")) == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("e./")), "7");
+	CHECK(MicrocDB_UpdateBegin(S("e./"), S("777/"), &Job) == UPDATE_PENDING);
+	do {
+		Status = MicrocDB_UpdateStep(&Job, 1);
+	} while (Status == UPDATE_PENDING);
+	CHECK(Status == UPDATE_SUCCESSFUL);
+	CHECK_FOUND(MicrocDB_Find(S("e./")), "777");
+	return 0;
+}
+
+int main(void) {
+	flash_emu_Counts Counts;
+	uint32_t Operations, Loss;
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		memset(Long[i], 'p' + i, MEMBER_SIZE);
+	}
+	CHECK_BOOT(Insert);
+	memcpy(Image, (void*) (uintptr_t) FLASH_EMU_BASE, FLASH_EMU_SIZE);
+
+	/*The flash operations of the job without power loss*/
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed;
+	CHECK_BOOT(Update);
+	Counts = FlashEmuCounts();
+	Operations = Counts.PageErases + Counts.HalfWordsProgrammed - Operations;
+	CHECK_BOOT(Reboot);
+
+	/*The power is lost at every operation of the job*/
+	for (Loss = 1; Loss < Operations; Loss++) {
+		memcpy((void*) (uintptr_t) FLASH_EMU_BASE, Image, FLASH_EMU_SIZE);
+		FlashEmuPowerLossAfter(Loss);
+		CHECK(FlashEmuBoot(Update) == 0);
+		CHECK_BOOT(Reboot);
+	}
+	return 0;
+}